@@ -0,0 +1,192 @@
+/**
+  ******************************************************************************
+  * @file           : mcu_port.h
+  * @brief          : Core intrinsics used by the MIDI modules, with portable
+  *                   fallbacks so the same sources also build on a host PC.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MCU_PORT_H
+#define __MCU_PORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+#if defined(__ICCARM__) || defined(__ARM_ARCH)
+#include "stm32h7xx.h"
+#define MCU_TARGET                1U
+#else
+#define MCU_TARGET                0U
+#endif
+
+/* Exported macro ------------------------------------------------------------*/
+
+#if (MCU_TARGET == 1U)
+/* Single-cycle CLZ on the Cortex-M7 */
+#define MCU_CLZ(x)                __CLZ(x)
+/* DWT cycle counter, running once MCU_CycleCounterInit() has been called */
+#define MCU_CYCLES()              (DWT->CYCCNT)
+/* Non-zero in handler mode */
+#define MCU_IN_ISR()              (__get_IPSR() != 0U)
+#else
+static inline uint32_t MCU_CLZ(uint32_t x)
+{
+  return (x != 0U) ? (uint32_t)__builtin_clz(x) : 32U;
+}
+#if defined(MCU_HOST_CLOCK)
+/* Host tests that replay a timeline set the counter and the context */
+extern volatile uint32_t mcu_host_cycles;
+extern volatile uint8_t mcu_host_in_isr;
+#define MCU_CYCLES()              (mcu_host_cycles)
+#define MCU_IN_ISR()              (mcu_host_in_isr != 0U)
+#else
+#if defined(__x86_64__) || defined(__i386__)
+#define MCU_CYCLES()              ((uint32_t)__builtin_ia32_rdtsc())
+#else
+#define MCU_CYCLES()              0U
+#endif
+#define MCU_IN_ISR()              0U
+#endif /* MCU_HOST_CLOCK */
+#endif
+
+/* Two signed 16-bit lanes per word. On target these are the ARMv7E-M SIMD
+   instructions; SSUB16 sets the per-lane GE flags that SEL then reads. */
+#if (MCU_TARGET == 1U)
+#define MCU_USAT(x, bits)         __USAT((x), (bits))
+
+static inline uint32_t MCU_QSUB16(uint32_t a, uint32_t b)
+{
+  return __QSUB16(a, b);
+}
+
+/* |a| per lane, saturated */
+static inline uint32_t MCU_ABS16(uint32_t a)
+{
+  uint32_t neg = __QSUB16(0U, a);
+
+  (void)__SSUB16(a, 0U);
+  return __SEL(a, neg);
+}
+
+static inline uint32_t MCU_MAX16(uint32_t a, uint32_t b)
+{
+  (void)__SSUB16(a, b);
+  return __SEL(a, b);
+}
+
+/* 0xFFFF in each lane where a >= b */
+static inline uint32_t MCU_GE16(uint32_t a, uint32_t b)
+{
+  (void)__SSUB16(a, b);
+  return __SEL(0xFFFFFFFFU, 0U);
+}
+#else
+static inline int32_t MCU_USAT(int32_t x, uint32_t bits)
+{
+  int32_t max = (int32_t)((1UL << bits) - 1U);
+
+  return (x < 0) ? 0 : ((x > max) ? max : x);
+}
+
+static inline int32_t mcu_lane16(uint32_t a, uint32_t lane)
+{
+  return (int32_t)(int16_t)(a >> (16U * lane));
+}
+
+static inline uint32_t mcu_pack16(int32_t lo, int32_t hi)
+{
+  return (uint32_t)(uint16_t)lo | ((uint32_t)(uint16_t)hi << 16);
+}
+
+static inline int32_t mcu_sat16(int32_t x)
+{
+  return (x > 32767) ? 32767 : ((x < -32768) ? -32768 : x);
+}
+
+static inline uint32_t MCU_QSUB16(uint32_t a, uint32_t b)
+{
+  return mcu_pack16(mcu_sat16(mcu_lane16(a, 0U) - mcu_lane16(b, 0U)),
+                    mcu_sat16(mcu_lane16(a, 1U) - mcu_lane16(b, 1U)));
+}
+
+static inline uint32_t MCU_ABS16(uint32_t a)
+{
+  int32_t lo = mcu_lane16(a, 0U), hi = mcu_lane16(a, 1U);
+
+  return mcu_pack16(mcu_sat16((lo < 0) ? -lo : lo), mcu_sat16((hi < 0) ? -hi : hi));
+}
+
+static inline uint32_t MCU_MAX16(uint32_t a, uint32_t b)
+{
+  return mcu_pack16((mcu_lane16(a, 0U) >= mcu_lane16(b, 0U)) ? mcu_lane16(a, 0U) : mcu_lane16(b, 0U),
+                    (mcu_lane16(a, 1U) >= mcu_lane16(b, 1U)) ? mcu_lane16(a, 1U) : mcu_lane16(b, 1U));
+}
+
+static inline uint32_t MCU_GE16(uint32_t a, uint32_t b)
+{
+  return ((mcu_lane16(a, 0U) >= mcu_lane16(b, 0U)) ? 0x0000FFFFU : 0U) |
+         ((mcu_lane16(a, 1U) >= mcu_lane16(b, 1U)) ? 0xFFFF0000U : 0U);
+}
+#endif
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Start the DWT cycle counter used by the MCU_CYCLES() probes
+  */
+static inline void MCU_CycleCounterInit(void)
+{
+#if (MCU_TARGET == 1U)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR = 0xC5ACCE55U;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+/**
+  * @brief  Mask interrupts around a short critical section
+  * @retval previous PRIMASK, to hand back to MCU_IrqRestore()
+  */
+static inline uint32_t MCU_IrqSave(void)
+{
+#if (MCU_TARGET == 1U)
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  return primask;
+#else
+  return 0U;
+#endif
+}
+
+static inline void MCU_IrqRestore(uint32_t primask)
+{
+#if (MCU_TARGET == 1U)
+  __set_PRIMASK(primask);
+#else
+  (void)primask;
+#endif
+}
+
+/**
+  * @brief  Number of bits set in a word (the M7 has no POPCNT instruction)
+  */
+static inline uint32_t MCU_PopCount(uint32_t x)
+{
+  x = x - ((x >> 1) & 0x55555555U);
+  x = (x & 0x33333333U) + ((x >> 2) & 0x33333333U);
+  x = (x + (x >> 4)) & 0x0F0F0F0FU;
+  return (x * 0x01010101U) >> 24;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MCU_PORT_H */
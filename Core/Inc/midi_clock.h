@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file           : midi_clock.h
+  * @brief          : Header for midi_clock.c file.
+  *                   24 PPQN MIDI clock generator driven by a timer compare.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_CLOCK_H
+#define __MIDI_CLOCK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+#define MIDI_CLOCK_PPQN           24U
+#define MIDI_CLOCK_PER_SPP        6U     /* clocks per song position unit */
+
+/* Timer counts the next compare must be ahead of the counter */
+#ifndef MIDI_CLOCK_MIN_LEAD
+#define MIDI_CLOCK_MIN_LEAD       64U
+#endif /* MIDI_CLOCK_MIN_LEAD */
+
+#define MIDI_CLOCK_TEMPO_MIN      2000U  /* 20.00 BPM */
+#define MIDI_CLOCK_TEMPO_MAX      30000U /* 300.00 BPM */
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef void (*MIDI_ClockSendTypeDef)(uint32_t event);
+
+typedef struct
+{
+  uint32_t clocks;       /* F8 emitted */
+  uint32_t late_max;     /* handler entry after the ideal time, timer counts */
+  uint32_t late_sum;
+  uint32_t overruns;     /* ticks handled more than a period late */
+} MIDI_ClockStatsTypeDef;
+
+typedef struct
+{
+  uint64_t period;       /* timer counts per clock, 16 fractional bits */
+  uint64_t next;         /* ideal time of the next clock, same format */
+  uint32_t timer_hz;
+  uint32_t tempo;        /* BPM * 100 */
+  volatile uint32_t position;  /* clocks since song start */
+  volatile uint8_t running;
+  volatile uint8_t pending;    /* start/continue sent with the next clock */
+  volatile uint8_t free_run;   /* also send clocks while the song is stopped */
+  uint8_t  cable;
+  MIDI_ClockSendTypeDef send;
+  MIDI_ClockStatsTypeDef stats;
+} MIDI_ClockTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void MIDI_Clock_Init(MIDI_ClockTypeDef *pc, uint8_t cable, uint32_t timer_hz,
+                     MIDI_ClockSendTypeDef send);
+void MIDI_Clock_SetTempo(MIDI_ClockTypeDef *pc, uint32_t tempo);
+void MIDI_Clock_SetFreeRun(MIDI_ClockTypeDef *pc, uint8_t enable);
+void MIDI_Clock_Start(MIDI_ClockTypeDef *pc);
+void MIDI_Clock_Stop(MIDI_ClockTypeDef *pc);
+void MIDI_Clock_Continue(MIDI_ClockTypeDef *pc);
+int8_t MIDI_Clock_SetSongPosition(MIDI_ClockTypeDef *pc, uint16_t spp);
+uint16_t MIDI_Clock_GetSongPosition(const MIDI_ClockTypeDef *pc);
+uint32_t MIDI_Clock_Begin(MIDI_ClockTypeDef *pc, uint32_t now);
+uint32_t MIDI_Clock_Tick(MIDI_ClockTypeDef *pc, uint32_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_CLOCK_H */
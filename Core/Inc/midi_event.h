@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file           : midi_event.h
+  * @brief          : Helpers for the 32-bit USB-MIDI event words passed to
+  *                   USBMIDI_send() and found in the OUT endpoint buffer.
+  *
+  *                   An event is stored most significant byte first:
+  *                   [31:28] cable number, [27:24] code index number (CIN),
+  *                   [23:16] MIDI status, [15:8] data 1, [7:0] data 2.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_EVENT_H
+#define __MIDI_EVENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Code Index Numbers (USB-MIDI 1.0, table 4-1) */
+#define MIDI_CIN_MISC             0x0U
+#define MIDI_CIN_CABLE_EVENT      0x1U
+#define MIDI_CIN_SYSCOM_2         0x2U
+#define MIDI_CIN_SYSCOM_3         0x3U
+#define MIDI_CIN_SYSEX_START      0x4U
+#define MIDI_CIN_SYSEX_END_1      0x5U
+#define MIDI_CIN_SYSEX_END_2      0x6U
+#define MIDI_CIN_SYSEX_END_3      0x7U
+#define MIDI_CIN_NOTE_OFF         0x8U
+#define MIDI_CIN_NOTE_ON          0x9U
+#define MIDI_CIN_POLY_PRESSURE    0xAU
+#define MIDI_CIN_CONTROL_CHANGE   0xBU
+#define MIDI_CIN_PROGRAM_CHANGE   0xCU
+#define MIDI_CIN_CHANNEL_PRESSURE 0xDU
+#define MIDI_CIN_PITCH_BEND       0xEU
+#define MIDI_CIN_SINGLE_BYTE      0xFU
+
+#define MIDI_NUM_CABLES           16U
+#define MIDI_NUM_CHANNELS         16U
+#define MIDI_NUM_NOTES            128U
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define MIDI_EVENT(cable, cin, status, d1, d2) \
+  ((((uint32_t)(cable) & 0xFU) << 28) | (((uint32_t)(cin) & 0xFU) << 24) | \
+   (((uint32_t)(status) & 0xFFU) << 16) | (((uint32_t)(d1) & 0xFFU) << 8) | \
+   ((uint32_t)(d2) & 0xFFU))
+
+/* Channel voice message with the CIN taken from the status nibble */
+#define MIDI_EVENT_CHANNEL(cable, status, d1, d2) \
+  MIDI_EVENT((cable), ((status) >> 4), (status), (d1), (d2))
+
+#define MIDI_EVENT_CABLE(ev)      (((ev) >> 28) & 0xFU)
+#define MIDI_EVENT_CIN(ev)        (((ev) >> 24) & 0xFU)
+#define MIDI_EVENT_STATUS(ev)     (((ev) >> 16) & 0xFFU)
+#define MIDI_EVENT_CHANNEL_NUM(ev) (((ev) >> 16) & 0x0FU)
+#define MIDI_EVENT_DATA1(ev)      (((ev) >> 8) & 0xFFU)
+#define MIDI_EVENT_DATA2(ev)      ((ev) & 0xFFU)
+
+/* Assemble an event from the four bytes of an OUT endpoint packet */
+#define MIDI_EVENT_FROM_BYTES(p) \
+  (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+   ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_EVENT_H */
@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file           : midi_follow.h
+  * @brief          : Header for midi_follow.c file.
+  *                   Tempo and phase tracking of an incoming MIDI clock.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_FOLLOW_H
+#define __MIDI_FOLLOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Loop gains are 2^-(1+stage) and 2^-(3+2*stage), damping 0.707 at every
+   stage; the loop narrows one stage per MIDI_FOLLOW_STAGE_CLOCKS clocks */
+#ifndef MIDI_FOLLOW_STAGES
+#define MIDI_FOLLOW_STAGES        3U
+#endif /* MIDI_FOLLOW_STAGES */
+#ifndef MIDI_FOLLOW_STAGE_CLOCKS
+#define MIDI_FOLLOW_STAGE_CLOCKS  24U
+#endif /* MIDI_FOLLOW_STAGE_CLOCKS */
+
+/* A clock further than this from the prediction restarts acquisition */
+#define MIDI_FOLLOW_RESYNC_DIV    2U      /* half a period */
+
+/* No clock for this many periods means the master is gone */
+#define MIDI_FOLLOW_TIMEOUT_CLOCKS  8U
+
+/* The published period has 4 fractional bits, so a clock may last up to
+   2^28 counts: 1.3 s at 200 MHz, under 2 BPM. Slower clocks restart
+   acquisition. */
+#define MIDI_FOLLOW_PERIOD_FRAC   4U
+#define MIDI_FOLLOW_PERIOD_MAX    (0xFFFFFFFFUL >> MIDI_FOLLOW_PERIOD_FRAC)
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct
+{
+  uint32_t clocks;
+  uint32_t resyncs;
+  uint32_t jitter_max;   /* largest |arrival - prediction| once locked, counts */
+  uint32_t jitter_sum;
+} MIDI_FollowStatsTypeDef;
+
+typedef struct
+{
+  /* loop state, written by MIDI_Follow_Event() only */
+  uint64_t period;       /* counts per clock, 16 fractional bits */
+  uint64_t predict;      /* expected arrival of the next clock, same format */
+  uint32_t last_raw;
+  uint16_t count;        /* clocks since acquisition started */
+  uint8_t  stage;
+  /* published state, read through the sequence counter */
+  volatile uint32_t seq;
+  volatile uint32_t beat_time;   /* filtered time of the last clock */
+  volatile uint32_t beat_period; /* counts per clock, 4 fractional bits */
+  volatile uint32_t position;    /* clocks since song start */
+  volatile uint8_t  locked;
+  volatile uint8_t  running;
+  uint32_t timer_hz;
+  MIDI_FollowStatsTypeDef stats;
+} MIDI_FollowTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void MIDI_Follow_Init(MIDI_FollowTypeDef *pf, uint32_t timer_hz);
+void MIDI_Follow_Event(MIDI_FollowTypeDef *pf, uint32_t event, uint32_t now);
+uint8_t MIDI_Follow_IsLocked(const MIDI_FollowTypeDef *pf, uint32_t now);
+uint32_t MIDI_Follow_GetTempo(const MIDI_FollowTypeDef *pf);
+uint32_t MIDI_Follow_GetPosition(const MIDI_FollowTypeDef *pf, uint32_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_FOLLOW_H */
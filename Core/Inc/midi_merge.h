@@ -0,0 +1,94 @@
+/**
+  ******************************************************************************
+  * @file           : midi_merge.h
+  * @brief          : Header for midi_merge.c file.
+  *                   Merges several event streams into one output at message
+  *                   boundaries, keeping SysEx atomic per cable.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_MERGE_H
+#define __MIDI_MERGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+#ifndef MIDI_MERGE_NUM_SOURCES
+#define MIDI_MERGE_NUM_SOURCES    8U
+#endif /* MIDI_MERGE_NUM_SOURCES */
+
+/* Queue depths, in events; powers of two */
+#ifndef MIDI_MERGE_QUEUE_LEN
+#define MIDI_MERGE_QUEUE_LEN      64U
+#endif /* MIDI_MERGE_QUEUE_LEN */
+#ifndef MIDI_MERGE_RT_QUEUE_LEN
+#define MIDI_MERGE_RT_QUEUE_LEN   8U
+#endif /* MIDI_MERGE_RT_QUEUE_LEN */
+
+/* A SysEx whose source stays silent this long is terminated with F7 */
+#ifndef MIDI_MERGE_SYSEX_TIMEOUT_MS
+#define MIDI_MERGE_SYSEX_TIMEOUT_MS  100U
+#endif /* MIDI_MERGE_SYSEX_TIMEOUT_MS */
+
+#define MIDI_MERGE_NO_SOURCE      0xFFU
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef void (*MIDI_MergeOutTypeDef)(uint32_t event);
+
+typedef struct
+{
+  uint32_t event;
+  uint32_t stamp;  /* MCU_CYCLES() at push */
+} MIDI_MergeEntryTypeDef;
+
+typedef struct
+{
+  uint32_t events;
+  uint32_t rt_events;
+  uint32_t overflows;     /* pushes refused on a full queue */
+  uint32_t blocked;       /* cables held back by another source's SysEx, per pass */
+  uint32_t discarded;     /* tail of an aborted SysEx */
+  uint32_t latency_max;   /* push to output, in CPU cycles */
+  uint32_t latency_sum;
+} MIDI_MergeStatsTypeDef;
+
+typedef struct
+{
+  MIDI_MergeEntryTypeDef queue[MIDI_MERGE_QUEUE_LEN];
+  MIDI_MergeEntryTypeDef rt[MIDI_MERGE_RT_QUEUE_LEN];
+  volatile uint16_t wp, rp;
+  volatile uint8_t  rt_wp, rt_rp;
+  uint8_t  weight;       /* events per round, 0 parks the source */
+  uint16_t discard;      /* cables whose aborted SysEx tail is dropped */
+  MIDI_MergeStatsTypeDef stats;
+} MIDI_MergeSourceTypeDef;
+
+typedef struct
+{
+  MIDI_MergeSourceTypeDef src[MIDI_MERGE_NUM_SOURCES];
+  MIDI_MergeOutTypeDef out;
+  uint8_t  owner[MIDI_NUM_CABLES];   /* source inside a SysEx on that cable */
+  uint32_t owner_ms[MIDI_NUM_CABLES];
+  uint32_t sysex_aborts;
+} MIDI_MergeTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void MIDI_Merge_Init(MIDI_MergeTypeDef *pm, MIDI_MergeOutTypeDef out);
+void MIDI_Merge_SetWeight(MIDI_MergeTypeDef *pm, uint8_t src, uint8_t weight);
+int8_t MIDI_Merge_Push(MIDI_MergeTypeDef *pm, uint8_t src, uint32_t event);
+uint32_t MIDI_Merge_Process(MIDI_MergeTypeDef *pm, uint32_t now_ms, uint32_t budget);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_MERGE_H */
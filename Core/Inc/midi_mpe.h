@@ -0,0 +1,99 @@
+/**
+  ******************************************************************************
+  * @file           : midi_mpe.h
+  * @brief          : Header for midi_mpe.c file.
+  *                   MIDI Polyphonic Expression zone manager.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_MPE_H
+#define __MIDI_MPE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Per-note controller budget: one full 64-byte FS packet (16 events) per ms */
+#ifndef MPE_EVENTS_PER_MS
+#define MPE_EVENTS_PER_MS         16U
+#endif /* MPE_EVENTS_PER_MS */
+
+/* Largest burst of controller events released after an idle period */
+#ifndef MPE_EVENTS_BURST
+#define MPE_EVENTS_BURST          32
+#endif /* MPE_EVENTS_BURST */
+
+#define MPE_ZONE_LOWER            0U  /* manager channel 1, members upwards */
+#define MPE_ZONE_UPPER            1U  /* manager channel 16, members downwards */
+
+#define MPE_NO_CHANNEL            0xFFU
+
+#define MPE_BEND_CENTER           8192U
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef void (*MPE_SendTypeDef)(uint32_t event);
+
+typedef struct
+{
+  uint8_t  note;       /* sounding note, MPE_NO_CHANNEL when free */
+  uint8_t  pressure;
+  uint8_t  timbre;
+  uint8_t  dirty;      /* controllers waiting for bandwidth */
+  uint16_t bend;
+  uint8_t  prev;       /* links of the free or busy list */
+  uint8_t  next;
+} MPE_VoiceTypeDef;
+
+typedef struct
+{
+  uint32_t note_on;
+  uint32_t steals;
+  uint32_t ctrl_sent;
+  uint32_t ctrl_coalesced;  /* updates overwritten before they were sent */
+  uint32_t alloc_cycles_max;
+  uint32_t alloc_cycles_sum;
+} MPE_StatsTypeDef;
+
+typedef struct
+{
+  MPE_VoiceTypeDef voice[MIDI_NUM_CHANNELS];  /* indexed by MIDI channel */
+  MPE_SendTypeDef  send;
+  uint8_t  cable;
+  uint8_t  manager;
+  uint8_t  members;
+  uint8_t  free_head;  /* least recently released member channel */
+  uint8_t  free_tail;
+  uint8_t  busy_head;  /* oldest sounding member channel */
+  uint8_t  busy_tail;
+  uint8_t  rr;         /* round-robin cursor over dirty channels */
+  uint16_t dirty_mask;
+  int32_t  tokens;
+  uint32_t last_ms;
+  MPE_StatsTypeDef stats;
+} MPE_ZoneTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void MPE_Init(MPE_ZoneTypeDef *pz, uint8_t cable, uint8_t zone, uint8_t members,
+              MPE_SendTypeDef send);
+void MPE_Configure(MPE_ZoneTypeDef *pz, uint8_t bend_range);
+uint8_t MPE_NoteOn(MPE_ZoneTypeDef *pz, uint8_t note, uint8_t velocity,
+                   uint16_t bend, uint8_t pressure, uint8_t timbre);
+void MPE_NoteOff(MPE_ZoneTypeDef *pz, uint8_t ch, uint8_t velocity);
+void MPE_SetBend(MPE_ZoneTypeDef *pz, uint8_t ch, uint16_t bend);
+void MPE_SetPressure(MPE_ZoneTypeDef *pz, uint8_t ch, uint8_t pressure);
+void MPE_SetTimbre(MPE_ZoneTypeDef *pz, uint8_t ch, uint8_t timbre);
+void MPE_Process(MPE_ZoneTypeDef *pz, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_MPE_H */
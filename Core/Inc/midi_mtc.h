@@ -0,0 +1,128 @@
+/**
+  ******************************************************************************
+  * @file           : midi_mtc.h
+  * @brief          : Header for midi_mtc.c file.
+  *                   MIDI Time Code generator and chase engine.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_MTC_H
+#define __MIDI_MTC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Frame rates, as coded in the hours byte */
+#define MTC_RATE_24               0U
+#define MTC_RATE_25               1U
+#define MTC_RATE_2997DF           2U
+#define MTC_RATE_30               3U
+
+/* Timer counts the next compare must be ahead of the counter */
+#ifndef MTC_MIN_LEAD
+#define MTC_MIN_LEAD              64U
+#endif /* MTC_MIN_LEAD */
+
+/* The chase engine drops lock after this many missing quarter frames */
+#ifndef MTC_CHASE_TIMEOUT_QF
+#define MTC_CHASE_TIMEOUT_QF      8U
+#endif /* MTC_CHASE_TIMEOUT_QF */
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct
+{
+  uint8_t hours;
+  uint8_t minutes;
+  uint8_t seconds;
+  uint8_t frames;
+  uint8_t rate;
+} MTC_TimeTypeDef;
+
+typedef void (*MTC_SendTypeDef)(uint32_t event);
+
+typedef struct
+{
+  uint32_t quarter_frames;
+  uint32_t late_max;     /* handler entry after the ideal time, timer counts */
+  uint32_t late_sum;
+} MTC_GenStatsTypeDef;
+
+typedef struct
+{
+  uint64_t period;       /* timer counts per quarter frame, 16 fractional bits */
+  uint64_t next;
+  uint32_t timer_hz;
+  volatile uint32_t frame;     /* frames since 00:00:00:00 */
+  uint8_t  nibble[8];    /* frame latched at piece 0, split into pieces */
+  uint8_t  piece;
+  uint8_t  rate;
+  uint8_t  cable;
+  volatile uint8_t running;
+  MTC_SendTypeDef send;        /* quarter frames, from the timer interrupt */
+  MTC_SendTypeDef send_sysex;  /* full frame messages, from thread context */
+  MTC_GenStatsTypeDef stats;
+} MTC_GenTypeDef;
+
+typedef struct
+{
+  uint32_t quarter_frames;
+  uint32_t full_frames;
+  uint32_t resyncs;      /* broken quarter frame sequences and jumps */
+  uint32_t lock_counts;  /* first quarter frame to lock, timer counts */
+  uint32_t drift_max;    /* |arrival - prediction| once locked, timer counts */
+  uint32_t drift_sum;
+} MTC_ChaseStatsTypeDef;
+
+typedef struct
+{
+  /* assembly, written by MTC_Chase_Event() only */
+  uint8_t  nibble[8];
+  uint8_t  expect;       /* next piece of the sequence, 8 when idle */
+  uint8_t  sysex[10];
+  uint8_t  sysex_len;
+  uint32_t timer_hz;
+  uint64_t period;       /* counts per quarter frame, 16 fractional bits */
+  uint64_t predict;      /* expected arrival of the next quarter frame */
+  uint32_t first_time;
+  uint8_t  seeking;      /* first_time is valid */
+  /* published state, read through the sequence counter */
+  volatile uint32_t seq;
+  volatile uint32_t anchor_time;
+  volatile uint32_t anchor_qf;   /* quarter frames since 00:00:00:00 */
+  volatile uint32_t anchor_period;  /* counts per quarter frame, 4 fractional bits */
+  volatile uint8_t  locked;
+  volatile uint8_t  rate;
+  MTC_ChaseStatsTypeDef stats;
+} MTC_ChaseTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+uint32_t MTC_TimeToFrames(const MTC_TimeTypeDef *pt);
+void MTC_FramesToTime(uint32_t frames, uint8_t rate, MTC_TimeTypeDef *pt);
+
+void MTC_Gen_Init(MTC_GenTypeDef *pg, uint8_t cable, uint8_t rate, uint32_t timer_hz,
+                  MTC_SendTypeDef send, MTC_SendTypeDef send_sysex);
+void MTC_Gen_Locate(MTC_GenTypeDef *pg, uint32_t frame);
+void MTC_Gen_Start(MTC_GenTypeDef *pg);
+void MTC_Gen_Stop(MTC_GenTypeDef *pg);
+uint32_t MTC_Gen_Begin(MTC_GenTypeDef *pg, uint32_t now);
+uint32_t MTC_Gen_Tick(MTC_GenTypeDef *pg, uint32_t now);
+
+void MTC_Chase_Init(MTC_ChaseTypeDef *pc, uint32_t timer_hz);
+void MTC_Chase_Event(MTC_ChaseTypeDef *pc, uint32_t event, uint32_t now);
+uint8_t MTC_Chase_IsLocked(const MTC_ChaseTypeDef *pc, uint32_t now);
+uint32_t MTC_Chase_GetPosition(const MTC_ChaseTypeDef *pc, uint32_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_MTC_H */
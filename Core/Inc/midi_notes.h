@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file           : midi_notes.h
+  * @brief          : Header for midi_notes.c file.
+  *                   Bitset of the notes sounding on every cable/channel.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_NOTES_H
+#define __MIDI_NOTES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Cables tracked per direction; one word set is 16 x 128 bits = 256 bytes.
+   All of them by default, as a user may number its cables anywhere in the
+   16; the USB MIDI interface checks it covers its own. */
+#ifndef MIDI_NOTES_NUM_CABLES
+#define MIDI_NOTES_NUM_CABLES     MIDI_NUM_CABLES
+#endif /* MIDI_NOTES_NUM_CABLES */
+
+#define MIDI_NOTES_WORDS          (MIDI_NUM_NOTES / 32U)
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+  * Note n of a channel lives in word (n >> 5) at bit (31 - (n & 31)), so the
+  * lowest sounding note of a word is found with a single CLZ. chan_mask keeps
+  * one bit per channel that has at least one note on, which lets scans skip
+  * silent channels without touching their words.
+  */
+typedef struct
+{
+  uint32_t bits[MIDI_NOTES_NUM_CABLES][MIDI_NUM_CHANNELS][MIDI_NOTES_WORDS];
+  uint16_t chan_mask[MIDI_NOTES_NUM_CABLES];
+} MIDI_NotesTypeDef;
+
+/* Receives the note-off events produced by MIDI_Notes_Flush() */
+typedef void (*MIDI_NotesEmitTypeDef)(uint32_t event);
+
+/* Exported functions prototypes ---------------------------------------------*/
+void MIDI_Notes_Reset(MIDI_NotesTypeDef *pn);
+void MIDI_Notes_Set(MIDI_NotesTypeDef *pn, uint8_t cable, uint8_t ch, uint8_t note);
+void MIDI_Notes_Clear(MIDI_NotesTypeDef *pn, uint8_t cable, uint8_t ch, uint8_t note);
+uint8_t MIDI_Notes_IsOn(const MIDI_NotesTypeDef *pn, uint8_t cable, uint8_t ch, uint8_t note);
+void MIDI_Notes_Update(MIDI_NotesTypeDef *pn, uint32_t event);
+uint32_t MIDI_Notes_Count(const MIDI_NotesTypeDef *pn, uint8_t cable, uint8_t ch);
+uint32_t MIDI_Notes_CountAll(const MIDI_NotesTypeDef *pn, uint8_t cable);
+int16_t MIDI_Notes_Next(const MIDI_NotesTypeDef *pn, uint8_t cable, uint8_t ch, uint8_t from);
+uint32_t MIDI_Notes_Flush(MIDI_NotesTypeDef *pn, uint8_t cable, MIDI_NotesEmitTypeDef emit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_NOTES_H */
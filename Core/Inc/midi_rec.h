@@ -0,0 +1,132 @@
+/**
+  ******************************************************************************
+  * @file           : midi_rec.h
+  * @brief          : Header for midi_rec.c file.
+  *                   Compact RAM recorder of the USB-MIDI traffic, exported
+  *                   as a Standard MIDI File.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_REC_H
+#define __MIDI_REC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Tracks of the recording, one per direction */
+#define MIDI_REC_OUT              0U      /* to the host */
+#define MIDI_REC_IN               1U      /* from the host */
+#define MIDI_REC_TRACKS           2U
+
+/* Resolution of the delta times; must divide 500000 (the default tempo) */
+#ifndef MIDI_REC_TICK_US
+#define MIDI_REC_TICK_US          1000U
+#endif /* MIDI_REC_TICK_US */
+
+/* Capture queues between the producers and the encoder, power of two */
+#ifndef MIDI_REC_QUEUE_LEN
+#define MIDI_REC_QUEUE_LEN        64U
+#endif /* MIDI_REC_QUEUE_LEN */
+
+/* Largest SysEx piece stored as one SMF event */
+#ifndef MIDI_REC_SYSEX_CHUNK
+#define MIDI_REC_SYSEX_CHUNK      48U
+#endif /* MIDI_REC_SYSEX_CHUNK */
+
+/* File bytes per export SysEx message, a multiple of 7 */
+#define MIDI_REC_EXPORT_BLOCK     42U
+
+/* Filter bits */
+#define MIDI_REC_SKIP_CLOCK       0x01U   /* timing clock, F8 */
+#define MIDI_REC_SKIP_SENSE       0x02U   /* active sensing, FE */
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef void (*MIDI_RecSendTypeDef)(uint32_t event);
+
+typedef struct
+{
+  uint32_t event;
+  uint32_t stamp;        /* MCU_CYCLES() at capture */
+} MIDI_RecEntryTypeDef;
+
+/* Single producer queue: thread mode, or the interrupts, which all run at
+   the same priority and so never preempt one another */
+typedef struct
+{
+  MIDI_RecEntryTypeDef entry[MIDI_REC_QUEUE_LEN];
+  volatile uint16_t wp, rp;
+} MIDI_RecQueueTypeDef;
+
+typedef struct
+{
+  uint32_t events;       /* events stored */
+  uint32_t bytes;        /* SMF track bytes used */
+  uint32_t overflows;    /* lost on a full capture queue */
+  uint32_t truncated;    /* lost on a full buffer */
+} MIDI_RecTrackStatsTypeDef;
+
+typedef struct
+{
+  MIDI_RecQueueTypeDef q_thread, q_isr;
+  uint8_t  *buf;
+  uint32_t size;
+  uint32_t len;
+  uint32_t tick;         /* absolute tick of the last stored event */
+  uint32_t sx_tick;      /* tick of the first byte in sx[] */
+  uint8_t  status;       /* running status, 0 after SysEx and meta events */
+  uint8_t  cable;        /* last port prefix, 0xFF before the first */
+  uint8_t  sx_len;
+  uint8_t  sx_cable;
+  uint8_t  sx[MIDI_REC_SYSEX_CHUNK];
+  MIDI_RecTrackStatsTypeDef stats;
+} MIDI_RecTrackTypeDef;
+
+typedef struct
+{
+  uint32_t capture_cycles_max;  /* cost of one capture, any context */
+  uint32_t encode_cycles_max;   /* cost of storing one event */
+  uint32_t encode_cycles_sum;
+} MIDI_RecStatsTypeDef;
+
+typedef struct
+{
+  MIDI_RecTrackTypeDef track[MIDI_REC_TRACKS];
+  uint32_t cycles_per_tick;
+  uint32_t base_cycles;  /* MCU_CYCLES() at tick base_tick */
+  uint32_t base_tick;
+  volatile uint8_t recording;
+  uint8_t  filter;
+  /* export, a read cursor over the file */
+  uint8_t  exporting;
+  uint16_t export_block;
+  uint32_t export_offset;
+  MIDI_RecStatsTypeDef stats;
+} MIDI_RecorderTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void MIDI_Rec_Init(MIDI_RecorderTypeDef *pr, uint8_t *buf, uint32_t size, uint32_t cpu_hz);
+void MIDI_Rec_Start(MIDI_RecorderTypeDef *pr);
+void MIDI_Rec_Stop(MIDI_RecorderTypeDef *pr);
+void MIDI_Rec_Capture(MIDI_RecorderTypeDef *pr, uint8_t track, uint32_t event);
+void MIDI_Rec_Process(MIDI_RecorderTypeDef *pr);
+
+uint32_t MIDI_Rec_FileSize(const MIDI_RecorderTypeDef *pr);
+uint32_t MIDI_Rec_Read(const MIDI_RecorderTypeDef *pr, uint32_t offset, uint8_t *dst, uint32_t len);
+void MIDI_Rec_ExportStart(MIDI_RecorderTypeDef *pr);
+uint8_t MIDI_Rec_ExportSysEx(MIDI_RecorderTypeDef *pr, uint8_t cable,
+                             MIDI_RecSendTypeDef send, uint32_t room);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_REC_H */
@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file           : midi_route.h
+  * @brief          : Header for midi_route.c file.
+  *                   Routing matrix between USB cables and internal ports.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_ROUTE_H
+#define __MIDI_ROUTE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Port numbers, shared by sources and destinations */
+#define MIDI_PORT_USB(n)          ((uint8_t)(n))          /* USB cable 0..15 */
+#define MIDI_PORT_INTERNAL(n)     ((uint8_t)(16U + (n)))  /* generators 0..7 */
+#define MIDI_PORT_UART(n)         ((uint8_t)(24U + (n)))  /* DIN ports 0..7 */
+#define MIDI_ROUTE_NUM_PORTS      32U
+
+#ifndef MIDI_ROUTE_MAX
+#define MIDI_ROUTE_MAX            32U
+#endif /* MIDI_ROUTE_MAX */
+
+/* Channel filters: one bit per MIDI channel */
+#define MIDI_ROUTE_CH(ch)         ((uint16_t)(1U << (ch)))
+#define MIDI_ROUTE_CH_ALL         0xFFFFU
+
+/* Message type filters: one bit per USB-MIDI code index number */
+#define MIDI_ROUTE_TYPE(cin)      ((uint16_t)(1U << (cin)))
+#define MIDI_ROUTE_TYPE_NOTES     (MIDI_ROUTE_TYPE(MIDI_CIN_NOTE_OFF) | MIDI_ROUTE_TYPE(MIDI_CIN_NOTE_ON))
+#define MIDI_ROUTE_TYPE_VOICE     ((uint16_t)0x7F00U)     /* CIN 0x8..0xE */
+#define MIDI_ROUTE_TYPE_SYSEX     ((uint16_t)0x00F0U)     /* CIN 0x4..0x7 */
+#define MIDI_ROUTE_TYPE_SYSTEM    ((uint16_t)0x800CU)     /* CIN 0x2, 0x3, 0xF */
+#define MIDI_ROUTE_TYPE_ALL       0xFFFFU
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct
+{
+  uint8_t  src;
+  uint8_t  dst;
+  uint16_t channels;   /* applied to channel voice messages only */
+  uint16_t types;
+} MIDI_RouteTypeDef;
+
+/* Delivers an event to a destination port */
+typedef void (*MIDI_RouteSinkTypeDef)(uint8_t port, uint32_t event);
+
+typedef struct
+{
+  uint32_t events;
+  uint32_t deliveries;
+  uint32_t cycles_max;  /* worst lookup + dispatch, sinks excluded */
+  uint32_t cycles_sum;
+} MIDI_RouteStatsTypeDef;
+
+/* Exported variables --------------------------------------------------------*/
+extern MIDI_RouteStatsTypeDef MIDI_RouteStats;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void MIDI_Route_Init(void);
+int8_t MIDI_Route_Add(uint8_t src, uint8_t dst, uint16_t channels, uint16_t types);
+void MIDI_Route_Remove(uint8_t src, uint8_t dst);
+void MIDI_Route_Compile(void);
+void MIDI_Route_SetSink(uint8_t port, MIDI_RouteSinkTypeDef sink);
+uint32_t MIDI_Route_Lookup(uint8_t src, uint32_t event);
+void MIDI_Route_Process(uint8_t src, uint32_t event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_ROUTE_H */
@@ -0,0 +1,85 @@
+/**
+  ******************************************************************************
+  * @file           : midi_smf.h
+  * @brief          : Header for midi_smf.c file.
+  *                   Standard MIDI File player streaming from mapped memory.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_SMF_H
+#define __MIDI_SMF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+#ifndef SMF_MAX_TRACKS
+#define SMF_MAX_TRACKS            32U
+#endif /* SMF_MAX_TRACKS */
+
+#define SMF_TEMPO_DEFAULT         500000UL  /* us per quarter note, 120 BPM */
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef void (*SMF_SendTypeDef)(uint32_t event);
+
+/* Read position of one track inside the mapped image */
+typedef struct
+{
+  const uint8_t *p;      /* status or data of the next event */
+  const uint8_t *end;
+  uint32_t tick;         /* absolute tick of the next event */
+  uint8_t  status;       /* running status */
+} SMF_TrackTypeDef;
+
+typedef struct
+{
+  uint32_t events;
+  uint32_t late_max;     /* output after the scheduled time, us */
+  uint32_t cycles_max;   /* worst parse + merge + output of one event */
+  uint32_t cycles_sum;
+} SMF_StatsTypeDef;
+
+typedef struct
+{
+  const uint8_t *image;
+  uint32_t size;
+  SMF_TrackTypeDef track[SMF_MAX_TRACKS];
+  uint8_t  heap[SMF_MAX_TRACKS];  /* track indexes, min-heap on next tick */
+  uint8_t  heap_len;
+  uint8_t  tracks;
+  uint8_t  cable;
+  uint8_t  playing;
+  uint8_t  smpte;        /* division is SMPTE, tempo meta events ignored */
+  uint8_t  carry_len;    /* SysEx bytes waiting for a full packet */
+  uint8_t  carry[2];
+  const uint8_t *sysex_p;   /* rest of a SysEx cut short by the budget */
+  const uint8_t *sysex_end;
+  uint32_t division;     /* ticks per quarter note, or per 100 s if SMPTE */
+  uint32_t tempo;        /* us per quarter note */
+  uint32_t tick_base;    /* tick and time of the last tempo change */
+  uint32_t us_base;
+  uint32_t start_us;
+  SMF_SendTypeDef send;
+  SMF_StatsTypeDef stats;
+} SMF_PlayerTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+int8_t SMF_Open(SMF_PlayerTypeDef *pp, const uint8_t *image, uint32_t size,
+                uint8_t cable, SMF_SendTypeDef send);
+void SMF_Start(SMF_PlayerTypeDef *pp, uint32_t now_us);
+void SMF_Stop(SMF_PlayerTypeDef *pp);
+uint32_t SMF_Process(SMF_PlayerTypeDef *pp, uint32_t now_us, uint32_t budget);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_SMF_H */
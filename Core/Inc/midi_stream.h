@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file           : midi_stream.h
+  * @brief          : Header for midi_stream.c file.
+  *                   Conversion between USB-MIDI event words and the raw
+  *                   MIDI 1.0 byte stream, with running status.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_STREAM_H
+#define __MIDI_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Longest encoding of one event */
+#define MIDI_STREAM_MAX_BYTES     3U
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef void (*MIDI_StreamSendTypeDef)(uint32_t event);
+
+typedef struct
+{
+  uint8_t  status;       /* running status on the wire, 0 if none */
+  uint32_t events;
+  uint32_t bytes;
+  uint32_t elided;       /* status bytes left out by running status */
+} MIDI_StreamEncTypeDef;
+
+typedef struct
+{
+  uint32_t events;
+  uint32_t sysex_bytes;
+  uint32_t errors;       /* stray data bytes, cut SysEx, undefined status */
+} MIDI_StreamStatsTypeDef;
+
+typedef struct
+{
+  uint8_t  status;       /* running status or pending system common, 0 if none */
+  uint8_t  sysex;        /* between F0 and F7 */
+  uint8_t  len;          /* bytes in buf */
+  uint8_t  need;         /* data bytes of the pending message */
+  uint8_t  buf[3];
+  uint8_t  cable;        /* of the events produced */
+  MIDI_StreamSendTypeDef send;
+  MIDI_StreamStatsTypeDef stats;
+} MIDI_StreamParserTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void MIDI_Stream_EncInit(MIDI_StreamEncTypeDef *pe);
+uint8_t MIDI_Stream_Encode(MIDI_StreamEncTypeDef *pe, uint32_t event, uint8_t *out);
+void MIDI_Stream_ParseInit(MIDI_StreamParserTypeDef *pp, uint8_t cable, MIDI_StreamSendTypeDef send);
+void MIDI_Stream_Parse(MIDI_StreamParserTypeDef *pp, const uint8_t *buf, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_STREAM_H */
@@ -0,0 +1,114 @@
+/**
+  ******************************************************************************
+  * @file           : midi_xform.h
+  * @brief          : Header for midi_xform.c file.
+  *                   Table driven velocity curves, note maps and channel maps.
+  *
+  *                   Tables are 128 (16 for channels) byte arrays. The
+  *                   MIDI_XFORM_TABLE128() generator expands a per-entry
+  *                   macro into a const initializer, so curves written with
+  *                   the value macros below are computed by the compiler
+  *                   and stored in flash:
+  *
+  *                     #define SOFT(x)  MIDI_XFORM_EXP_VAL(x, 2.5)
+  *                     const uint8_t soft_curve[128] = { MIDI_XFORM_TABLE128(SOFT) };
+  *
+  *                   The MIDI_Xform_Build*() functions fill RAM tables with
+  *                   the same shapes at run time for user presets.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MIDI_XFORM_H
+#define __MIDI_XFORM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Note map entry that removes the note */
+#define MIDI_XFORM_NOTE_DROP      0xFFU
+
+/* Returned by MIDI_Xform_Apply() for a removed event (CIN 0 is never sent) */
+#define MIDI_XFORM_DROP           0x00000000UL
+
+/* Curvature of the built-in exponential curves */
+#ifndef MIDI_XFORM_EXP_SOFT
+#define MIDI_XFORM_EXP_SOFT       2.0
+#endif /* MIDI_XFORM_EXP_SOFT */
+#ifndef MIDI_XFORM_EXP_HARD
+#define MIDI_XFORM_EXP_HARD       (-2.0)
+#endif /* MIDI_XFORM_EXP_HARD */
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define MIDI_XFORM_T8(F, b)  F((b) + 0), F((b) + 1), F((b) + 2), F((b) + 3), \
+                             F((b) + 4), F((b) + 5), F((b) + 6), F((b) + 7)
+#define MIDI_XFORM_T32(F, b) MIDI_XFORM_T8(F, (b) + 0), MIDI_XFORM_T8(F, (b) + 8), \
+                             MIDI_XFORM_T8(F, (b) + 16), MIDI_XFORM_T8(F, (b) + 24)
+#define MIDI_XFORM_TABLE16(F)  MIDI_XFORM_T8(F, 0), MIDI_XFORM_T8(F, 8)
+#define MIDI_XFORM_TABLE128(F) MIDI_XFORM_T32(F, 0), MIDI_XFORM_T32(F, 32), \
+                               MIDI_XFORM_T32(F, 64), MIDI_XFORM_T32(F, 96)
+
+#define MIDI_XFORM_CLAMP(v)  ((uint8_t)(((v) < 0) ? 0 : (((v) > 127) ? 127 : (v))))
+
+/* e^x by a 16 term Horner series, a constant expression for |x| <= 4 */
+#define MIDI_XFORM_EXP_H(x, n, r)  (1.0 + (x) / (n) * (r))
+#define MIDI_XFORM_EXP(x) \
+  MIDI_XFORM_EXP_H(x, 1, MIDI_XFORM_EXP_H(x, 2, MIDI_XFORM_EXP_H(x, 3, MIDI_XFORM_EXP_H(x, 4, \
+  MIDI_XFORM_EXP_H(x, 5, MIDI_XFORM_EXP_H(x, 6, MIDI_XFORM_EXP_H(x, 7, MIDI_XFORM_EXP_H(x, 8, \
+  MIDI_XFORM_EXP_H(x, 9, MIDI_XFORM_EXP_H(x, 10, MIDI_XFORM_EXP_H(x, 11, MIDI_XFORM_EXP_H(x, 12, \
+  MIDI_XFORM_EXP_H(x, 13, MIDI_XFORM_EXP_H(x, 14, MIDI_XFORM_EXP_H(x, 15, MIDI_XFORM_EXP_H(x, 16, \
+  1.0))))))))))))))))
+
+/* 127 * (e^(a*x/127) - 1) / (e^a - 1): a > 0 soft, a < 0 hard, a != 0 */
+#define MIDI_XFORM_EXP_VAL(x, a) \
+  MIDI_XFORM_CLAMP((int)(127.0 * (MIDI_XFORM_EXP((a) * (x) / 127.0) - 1.0) / \
+                         (MIDI_XFORM_EXP(a) - 1.0) + 0.5))
+
+/* Linear interpolation between two breakpoints */
+#define MIDI_XFORM_LERP(x, x0, y0, x1, y1) \
+  ((y0) + (((y1) - (y0)) * ((x) - (x0)) + ((x1) - (x0)) / 2) / ((x1) - (x0)))
+
+/* Piecewise linear curve through (0,y0) (x1,y1) (x2,y2) (127,y3) */
+#define MIDI_XFORM_PWL_VAL(x, y0, x1, y1, x2, y2, y3) \
+  MIDI_XFORM_CLAMP(((x) <= (x1)) ? MIDI_XFORM_LERP(x, 0, y0, x1, y1) : \
+                   ((x) <= (x2)) ? MIDI_XFORM_LERP(x, x1, y1, x2, y2) : \
+                                   MIDI_XFORM_LERP(x, x2, y2, 127, y3))
+
+/* Note map moving every note by t semitones, dropping what falls out */
+#define MIDI_XFORM_TRANSPOSE_VAL(x, t) \
+  ((uint8_t)((((x) + (t)) < 0) || (((x) + (t)) > 127) ? (int)MIDI_XFORM_NOTE_DROP : ((x) + (t))))
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct
+{
+  const uint8_t *velocity;  /* 128 entries, applied to note on velocity */
+  const uint8_t *note;      /* 128 entries, MIDI_XFORM_NOTE_DROP removes */
+  const uint8_t *channel;   /* 16 entries */
+} MIDI_XformTypeDef;
+
+/* Exported variables --------------------------------------------------------*/
+extern const uint8_t MIDI_XformIdentity[128];
+extern const uint8_t MIDI_XformVelSoft[128];
+extern const uint8_t MIDI_XformVelHard[128];
+extern const uint8_t MIDI_XformChanIdentity[16];
+
+/* Exported functions prototypes ---------------------------------------------*/
+uint32_t MIDI_Xform_Apply(const MIDI_XformTypeDef *px, uint32_t event);
+void MIDI_Xform_BuildExp(uint8_t *table, float curve);
+void MIDI_Xform_BuildBreakpoints(uint8_t *table, const uint8_t *points, uint8_t count);
+void MIDI_Xform_BuildNoteMap(uint8_t *table, int8_t transpose, uint8_t low, uint8_t high);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MIDI_XFORM_H */
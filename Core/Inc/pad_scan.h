@@ -0,0 +1,158 @@
+/**
+  ******************************************************************************
+  * @file           : pad_scan.h
+  * @brief          : Header for pad_scan.c file.
+  *                   Strike detection on the marimba bar pickups.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PAD_SCAN_H
+#define __PAD_SCAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "midi_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+#ifndef PAD_MAX_PADS
+#define PAD_MAX_PADS              16U
+#endif /* PAD_MAX_PADS */
+
+/* Pickups are biased at mid-scale, so a swing is at most half the range */
+#define PAD_FULL_SCALE            32767U
+
+/* Resting level follows the input with a time constant of 2^n samples. It
+   is updated once per block, from the block mean, for the pads that stayed
+   idle through the whole block. */
+#define PAD_BASELINE_SHIFT        10U
+
+/* After the mask window a bar may still ring above its threshold: the
+   retrigger level starts at the strike peak and decays with a time
+   constant of 2^n samples, slower than the ring-out of a bar. The decay is
+   applied once per block. */
+#ifndef PAD_RETRIGGER_SHIFT
+#define PAD_RETRIGGER_SHIFT       10U
+#endif /* PAD_RETRIGGER_SHIFT */
+
+/* Default windows: the peak is searched for PAD_SCAN_US after the
+   threshold crossing, then the pad ignores its own ringing for PAD_MASK_US */
+#define PAD_SCAN_US               1500U
+#define PAD_MASK_US               30000U
+
+/* Idle pads are watched at one frame every PAD_WATCH_US, which bounds the
+   extra detection latency; see PAD_SetWatch() */
+#ifndef PAD_WATCH_US
+#define PAD_WATCH_US              250U
+#endif /* PAD_WATCH_US */
+
+/* Crosstalk: a strike is dropped when its peak is at most the coupling
+   share of a strike on another pad that ended less than PAD_XTALK_US ago */
+#ifndef PAD_XTALK_US
+#define PAD_XTALK_US              10000U
+#endif /* PAD_XTALK_US */
+
+/* Calibration keeps the largest coupling seen times PAD_XTALK_MARGIN / 4 */
+#define PAD_XTALK_MARGIN          6U
+
+/* Note events of one block, put in time order before they are sent */
+#ifndef PAD_PENDING_LEN
+#define PAD_PENDING_LEN           (4U * PAD_MAX_PADS)
+#endif /* PAD_PENDING_LEN */
+
+/* Pad states */
+#define PAD_IDLE                  0U
+#define PAD_SCAN                  1U
+#define PAD_MASK                  2U
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef void (*PAD_SendTypeDef)(uint32_t event);
+
+typedef struct
+{
+  uint8_t  note;
+  uint16_t threshold;    /* strike level above the resting level, counts */
+  uint16_t full;         /* peak that gives velocity 127, counts */
+  uint32_t vel_scale;    /* 126 / (full - threshold), 16 fractional bits */
+} PAD_ConfigTypeDef;
+
+typedef struct
+{
+  int32_t  baseline;     /* resting level, 8 fractional bits */
+  uint32_t floor;        /* retrigger level, 16 fractional bits */
+  uint16_t peak;
+  uint16_t count;        /* samples left in the scan or mask window */
+  uint8_t  state;
+  uint8_t  velocity;     /* of the last strike, 0 if it was crosstalk */
+  uint32_t end;          /* frame of the last scan end */
+  uint32_t xt_time;      /* frame of the last strike sent */
+  uint16_t xt_peak;      /* and its peak */
+  uint8_t  watch;        /* first pad of a pair: in watch mode */
+  uint8_t  skip;         /* and frames to skip at the next block */
+} PAD_StateTypeDef;
+
+typedef struct
+{
+  uint32_t time;         /* frame */
+  uint16_t peak;         /* 0 for a note off */
+  uint8_t  pad;
+} PAD_PendingTypeDef;
+
+typedef struct
+{
+  uint32_t strikes;
+  uint32_t suppressed;   /* dropped as crosstalk */
+  uint32_t pending_full; /* events sent out of time order */
+  uint32_t samples;      /* per pad */
+  uint32_t scanned;      /* pad samples looked at, all pads */
+  uint32_t blocks;
+  uint32_t cycles_max;   /* one block, all pads */
+  uint32_t cycles_sum;
+} PAD_StatsTypeDef;
+
+typedef struct
+{
+  PAD_ConfigTypeDef cfg[PAD_MAX_PADS];
+  PAD_StateTypeDef st[PAD_MAX_PADS];
+  uint8_t  pads;         /* samples per frame of the input */
+  uint8_t  cable;
+  uint8_t  channel;
+  uint16_t scan_samples;
+  uint16_t mask_samples;
+  uint8_t  watch_step;   /* frames between watch samples, 1 for none */
+  uint32_t sample_hz;    /* frames per second */
+  const uint8_t *curve;  /* velocity map, 128 entries */
+  PAD_SendTypeDef send;
+  /* coupling from pad [src] into pad [dst], 1/256 steps: 256 bytes, kept
+     next to the pad state in DTCM for the scan interrupt */
+  uint8_t  xt[PAD_MAX_PADS][PAD_MAX_PADS];
+  uint8_t  xt_calibrate;
+  uint32_t xt_samples;
+  uint32_t frame;        /* frames scanned so far */
+  PAD_PendingTypeDef pend[PAD_PENDING_LEN];
+  uint8_t  npend;
+  PAD_StatsTypeDef stats;
+} PAD_ScannerTypeDef;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void PAD_Init(PAD_ScannerTypeDef *ps, uint8_t pads, uint32_t sample_hz,
+              uint8_t cable, uint8_t channel, PAD_SendTypeDef send);
+void PAD_SetPad(PAD_ScannerTypeDef *ps, uint8_t pad, uint8_t note,
+                uint16_t threshold, uint16_t full);
+void PAD_SetTimes(PAD_ScannerTypeDef *ps, uint32_t scan_us, uint32_t mask_us);
+void PAD_SetWatch(PAD_ScannerTypeDef *ps, uint32_t watch_us);
+void PAD_XtalkSet(PAD_ScannerTypeDef *ps, uint8_t src, uint8_t dst, uint8_t coupling);
+void PAD_XtalkCalibrate(PAD_ScannerTypeDef *ps, uint8_t enable);
+void PAD_Process(PAD_ScannerTypeDef *ps, const uint16_t *frames, uint32_t nframes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PAD_SCAN_H */
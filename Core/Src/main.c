@@ -1,275 +1,683 @@
-/* USER CODE BEGIN Header */
-/**
-  ******************************************************************************
-  * @file           : main.c
-  * @brief          : Main program body
-  ******************************************************************************
-  * @attention
-  *
-  * Copyright (c) 2024 STMicroelectronics.
-  * All rights reserved.
-  *
-  * This software is licensed under terms that can be found in the LICENSE file
-  * in the root directory of this software component.
-  * If no LICENSE file comes with this software, it is provided AS-IS.
-  *
-  ******************************************************************************
-  */
-/* USER CODE END Header */
-/* Includes ------------------------------------------------------------------*/
-#include "main.h"
-#include "memorymap.h"
-#include "usb_device.h"
-#include "gpio.h"
-
-/* Private includes ----------------------------------------------------------*/
-/* USER CODE BEGIN Includes */
-#include "usbd_midi_if.h"
-/* USER CODE END Includes */
-
-/* Private typedef -----------------------------------------------------------*/
-/* USER CODE BEGIN PTD */
-
-/* USER CODE END PTD */
-
-/* Private define ------------------------------------------------------------*/
-/* USER CODE BEGIN PD */
-
-/* USER CODE END PD */
-
-/* Private macro -------------------------------------------------------------*/
-/* USER CODE BEGIN PM */
-
-/* USER CODE END PM */
-
-/* Private variables ---------------------------------------------------------*/
-
-/* USER CODE BEGIN PV */
-
-/* USER CODE END PV */
-
-/* Private function prototypes -----------------------------------------------*/
-void SystemClock_Config(void);
-static void MPU_Config(void);
-/* USER CODE BEGIN PFP */
-
-/* USER CODE END PFP */
-
-/* Private user code ---------------------------------------------------------*/
-/* USER CODE BEGIN 0 */
-uint8_t send = 0;
-/* USER CODE END 0 */
-
-/**
-  * @brief  The application entry point.
-  * @retval int
-  */
-int main(void)
-{
-
-  /* USER CODE BEGIN 1 */
-
-  /* USER CODE END 1 */
-
-  /* MPU Configuration--------------------------------------------------------*/
-  MPU_Config();
-
-  /* Enable the CPU Cache */
-
-  /* Enable I-Cache---------------------------------------------------------*/
-  SCB_EnableICache();
-
-  /* Enable D-Cache---------------------------------------------------------*/
-  SCB_EnableDCache();
-
-  /* MCU Configuration--------------------------------------------------------*/
-
-  /* Reset of all peripherals, Initializes the Flash interface and the Systick. */
-  HAL_Init();
-
-  /* USER CODE BEGIN Init */
-
-  /* USER CODE END Init */
-
-  /* Configure the system clock */
-  SystemClock_Config();
-
-  /* USER CODE BEGIN SysInit */
-
-  /* USER CODE END SysInit */
-
-  /* Initialize all configured peripherals */
-  MX_GPIO_Init();
-  MX_USB_DEVICE_Init();
-  /* USER CODE BEGIN 2 */
-
-  /* USER CODE END 2 */
-
-  /* Infinite loop */
-  /* USER CODE BEGIN WHILE */
-  while (1)
-  {
-    if(send)
-    USBMIDI_send(0x0BB90012);
-    USBMIDI_polling();
-    /* USER CODE END WHILE */
-
-    /* USER CODE BEGIN 3 */
-  }
-  /* USER CODE END 3 */
-}
-
-/**
-  * @brief System Clock Configuration
-  * @retval None
-  */
-void SystemClock_Config(void)
-{
-  RCC_OscInitTypeDef RCC_OscInitStruct = {0};
-  RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
-
-  /** Supply configuration update enable
-  */
-  HAL_PWREx_ConfigSupply(PWR_LDO_SUPPLY);
-
-  /** Configure the main internal regulator output voltage
-  */
-  __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE1);
-
-  while(!__HAL_PWR_GET_FLAG(PWR_FLAG_VOSRDY)) {}
-
-  /** Initializes the RCC Oscillators according to the specified parameters
-  * in the RCC_OscInitTypeDef structure.
-  */
-  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI48|RCC_OSCILLATORTYPE_HSE;
-  RCC_OscInitStruct.HSEState = RCC_HSE_ON;
-  RCC_OscInitStruct.HSI48State = RCC_HSI48_ON;
-  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
-  RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSE;
-  RCC_OscInitStruct.PLL.PLLM = 1;
-  RCC_OscInitStruct.PLL.PLLN = 100;
-  RCC_OscInitStruct.PLL.PLLP = 2;
-  RCC_OscInitStruct.PLL.PLLQ = 4;
-  RCC_OscInitStruct.PLL.PLLR = 2;
-  RCC_OscInitStruct.PLL.PLLRGE = RCC_PLL1VCIRANGE_3;
-  RCC_OscInitStruct.PLL.PLLVCOSEL = RCC_PLL1VCOWIDE;
-  RCC_OscInitStruct.PLL.PLLFRACN = 0;
-  if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
-  {
-    Error_Handler();
-  }
-
-  /** Initializes the CPU, AHB and APB buses clocks
-  */
-  RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
-                              |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2
-                              |RCC_CLOCKTYPE_D3PCLK1|RCC_CLOCKTYPE_D1PCLK1;
-  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
-  RCC_ClkInitStruct.SYSCLKDivider = RCC_SYSCLK_DIV1;
-  RCC_ClkInitStruct.AHBCLKDivider = RCC_HCLK_DIV2;
-  RCC_ClkInitStruct.APB3CLKDivider = RCC_APB3_DIV2;
-  RCC_ClkInitStruct.APB1CLKDivider = RCC_APB1_DIV2;
-  RCC_ClkInitStruct.APB2CLKDivider = RCC_APB2_DIV2;
-  RCC_ClkInitStruct.APB4CLKDivider = RCC_APB4_DIV2;
-
-  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_2) != HAL_OK)
-  {
-    Error_Handler();
-  }
-}
-
-/* USER CODE BEGIN 4 */
-
-/* USER CODE END 4 */
-
- /* MPU Configuration */
-
-void MPU_Config(void)
-{
-  MPU_Region_InitTypeDef MPU_InitStruct = {0};
-
-  /* Disables the MPU */
-  HAL_MPU_Disable();
-
-  /** Initializes and configures the Region and the memory to be protected
-  */
-  MPU_InitStruct.Enable = MPU_REGION_ENABLE;
-  MPU_InitStruct.Number = MPU_REGION_NUMBER0;
-  MPU_InitStruct.BaseAddress = 0x0;
-  MPU_InitStruct.Size = MPU_REGION_SIZE_4GB;
-  MPU_InitStruct.SubRegionDisable = 0x87;
-  MPU_InitStruct.TypeExtField = MPU_TEX_LEVEL0;
-  MPU_InitStruct.AccessPermission = MPU_REGION_NO_ACCESS;
-  MPU_InitStruct.DisableExec = MPU_INSTRUCTION_ACCESS_DISABLE;
-  MPU_InitStruct.IsShareable = MPU_ACCESS_SHAREABLE;
-  MPU_InitStruct.IsCacheable = MPU_ACCESS_NOT_CACHEABLE;
-  MPU_InitStruct.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
-
-  HAL_MPU_ConfigRegion(&MPU_InitStruct);
-
-  /** Initializes and configures the Region and the memory to be protected
-  */
-  MPU_InitStruct.Number = MPU_REGION_NUMBER1;
-  MPU_InitStruct.BaseAddress = 0x30000000;
-  MPU_InitStruct.Size = MPU_REGION_SIZE_512KB;
-  MPU_InitStruct.SubRegionDisable = 0x0;
-  MPU_InitStruct.TypeExtField = MPU_TEX_LEVEL1;
-  MPU_InitStruct.AccessPermission = MPU_REGION_FULL_ACCESS;
-  MPU_InitStruct.DisableExec = MPU_INSTRUCTION_ACCESS_ENABLE;
-  MPU_InitStruct.IsShareable = MPU_ACCESS_NOT_SHAREABLE;
-
-  HAL_MPU_ConfigRegion(&MPU_InitStruct);
-
-  /** Initializes and configures the Region and the memory to be protected
-  */
-  MPU_InitStruct.Number = MPU_REGION_NUMBER2;
-  MPU_InitStruct.BaseAddress = 0x20000000;
-  MPU_InitStruct.Size = MPU_REGION_SIZE_128KB;
-  MPU_InitStruct.IsCacheable = MPU_ACCESS_CACHEABLE;
-  MPU_InitStruct.IsBufferable = MPU_ACCESS_BUFFERABLE;
-
-  HAL_MPU_ConfigRegion(&MPU_InitStruct);
-
-  /** Initializes and configures the Region and the memory to be protected
-  */
-  MPU_InitStruct.Number = MPU_REGION_NUMBER3;
-  MPU_InitStruct.BaseAddress = 0x24000000;
-  MPU_InitStruct.Size = MPU_REGION_SIZE_512KB;
-
-  HAL_MPU_ConfigRegion(&MPU_InitStruct);
-  /* Enables the MPU */
-  HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
-
-}
-
-/**
-  * @brief  This function is executed in case of error occurrence.
-  * @retval None
-  */
-void Error_Handler(void)
-{
-  /* USER CODE BEGIN Error_Handler_Debug */
-  /* User can add his own implementation to report the HAL error return state */
-  __disable_irq();
-  while (1)
-  {
-  }
-  /* USER CODE END Error_Handler_Debug */
-}
-
-#ifdef  USE_FULL_ASSERT
-/**
-  * @brief  Reports the name of the source file and the source line number
-  *         where the assert_param error has occurred.
-  * @param  file: pointer to the source file name
-  * @param  line: assert_param error line source number
-  * @retval None
-  */
-void assert_failed(uint8_t *file, uint32_t line)
-{
-  /* USER CODE BEGIN 6 */
-  /* User can add his own implementation to report the file name and line number,
-     ex: printf("Wrong parameters value: file %s on line %d\r\n", file, line) */
-  /* USER CODE END 6 */
-}
-#endif /* USE_FULL_ASSERT */
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : main.c
+  * @brief          : Main program body
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "adc.h"
+#include "dma.h"
+#include "memorymap.h"
+#include "tim.h"
+#include "usb_device.h"
+#include "gpio.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include <string.h>
+#include "usbd_midi_if.h"
+#include "mcu_port.h"
+#include "midi_route.h"
+#include "midi_xform.h"
+#include "midi_merge.h"
+#include "midi_clock.h"
+#include "midi_follow.h"
+#include "midi_mtc.h"
+#include "midi_smf.h"
+#include "midi_rec.h"
+#include "pad_scan.h"
+#include "midi_mpe.h"
+#ifdef USE_USBD_COMPOSITE
+#include "usbd_cdc_if.h"
+#endif /* USE_USBD_COMPOSITE */
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+/* USER CODE END PTD */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+/* Producers sharing the USB IN endpoint, highest priority first. MTC
+   quarter frames come from the timer interrupt and full frames from the
+   main loop, so each has a source of its own. */
+#define MERGE_SRC_MTC_QF  0U
+#define MERGE_SRC_ROUTE   1U
+#define MERGE_SRC_MTC     2U
+#define MERGE_SRC_SMF     3U
+#define MERGE_SRC_REC     4U
+#define MERGE_SRC_PADS    5U
+
+/* Cable of the clock and time code: the first one of the second endpoint
+   pair when there is one, so a bulk dump on cable 0 cannot delay them */
+#if (USBD_MIDI_NUM_CABLES_2 > 0)
+#define SYNC_CABLE        USBD_MIDI_NUM_CABLES
+#else
+#define SYNC_CABLE        0U
+#endif
+
+/* ADC frames per DMA half buffer, one scan per half transfer interrupt */
+#define PAD_BLOCK_FRAMES  16U
+
+/* The bars play through a lower MPE zone on cable 0, one member channel
+   per bar so every strike can sound its own note. Comment out to send
+   all bars on channel 1. */
+#define PAD_MPE_MEMBERS   ADC1_CHANNELS
+#define PAD_MPE_BEND_RANGE 48U
+
+/* RAM for the recorder, shared by the two directions */
+#define REC_BUF_SIZE      32768U
+
+/* Define to the address and size of a Standard MIDI File in memory to play
+   it. The linker leaves AXI SRAM (MPU region 3) free, so an image loaded
+   there by the debugger works as is. MPU region 0 forbids 0x60000000 to
+   0xDFFFFFFF: a file in memory-mapped QSPI flash (0x90000000) also needs
+   QUADSPI set up and an MPU region for its window in Marimba.ioc. */
+/* #define SMF_IMAGE_ADDR    0x24000000UL */
+/* #define SMF_IMAGE_SIZE    0x00080000UL */
+
+/* Counter snapshots sent on the CDC port of the composite device */
+#define TELEMETRY_PERIOD_MS       100U
+#define TELEMETRY_USB_MIDI        (USBCDC_STREAM_USER + 0U)  /* USBMIDI_StatsTypeDef */
+#define TELEMETRY_PADS            (USBCDC_STREAM_USER + 1U)  /* PAD_StatsTypeDef */
+#define TELEMETRY_CDC             (USBCDC_STREAM_USER + 2U)  /* USBCDC_StatsTypeDef */
+/* USER CODE END PD */
+
+/* Private macro -------------------------------------------------------------*/
+/* USER CODE BEGIN PM */
+
+/* USER CODE END PM */
+
+/* Private variables ---------------------------------------------------------*/
+
+/* USER CODE BEGIN PV */
+
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+void SystemClock_Config(void);
+static void MPU_Config(void);
+/* USER CODE BEGIN PFP */
+
+/* USER CODE END PFP */
+
+/* Private user code ---------------------------------------------------------*/
+/* USER CODE BEGIN 0 */
+uint8_t send = 0;
+
+/* Everything going to the host is merged here */
+MIDI_MergeTypeDef usb_merge;
+
+/* Take of the USB traffic; set rec_export to send it to the host as SMF */
+MIDI_RecorderTypeDef usb_rec;
+static uint8_t rec_buf[REC_BUF_SIZE];
+volatile uint8_t rec_export = 0;
+
+/* While the CDC port of the composite device is open in MIDI mode, it
+   carries its cable in place of the MIDI endpoint */
+static uint8_t cdc_midi_out(uint32_t event)
+{
+#ifdef USE_USBD_COMPOSITE
+  if ((MIDI_EVENT_CABLE(event) == USBCDC_MIDI_CABLE) && USBCDC_midi_is_open())
+  {
+    (void)USBCDC_midi_send(event);
+    return 1U;
+  }
+#else
+  UNUSED(event);
+#endif /* USE_USBD_COMPOSITE */
+  return 0U;
+}
+
+/* Outputs to the host, through the recorder */
+static void usb_out(uint32_t event)
+{
+  MIDI_Rec_Capture(&usb_rec, MIDI_REC_OUT, event);
+  if (!cdc_midi_out(event))
+  {
+    USBMIDI_send(event);
+  }
+}
+
+/* Single byte real time messages only (F8..FF): they may cut into a SysEx,
+   anything else must go through the merge */
+static void usb_out_priority(uint32_t event)
+{
+  MIDI_Rec_Capture(&usb_rec, MIDI_REC_OUT, event);
+  if (!cdc_midi_out(event))
+  {
+    USBMIDI_send_priority(event);
+  }
+}
+
+/* Events the merge may output now, whichever way they leave */
+static uint32_t usb_tx_free(void)
+{
+  uint32_t room = USBMIDI_tx_free();
+
+#ifdef USE_USBD_COMPOSITE
+  if (USBCDC_midi_is_open() && (USBCDC_midi_tx_free() < room))
+  {
+    room = USBCDC_midi_tx_free();
+  }
+#endif /* USE_USBD_COMPOSITE */
+  return room;
+}
+
+static void rec_sysex(uint32_t event)
+{
+  MIDI_Merge_Push(&usb_merge, MERGE_SRC_REC, event);
+}
+
+/* Events the merge can still take from a source */
+static uint32_t merge_room(uint8_t src)
+{
+  return MIDI_MERGE_QUEUE_LEN - (uint16_t)(usb_merge.src[src].wp - usb_merge.src[src].rp);
+}
+
+/* Marimba bars on ADC1, scanned from the DMA interrupt. The buffer sits in
+   D2 SRAM1: DMA1 cannot reach DTCM, and the MPU leaves that region
+   uncached, so no cache maintenance is needed before a scan. */
+#pragma location = ".dma_buffer"
+static uint16_t pad_buf[2U * PAD_BLOCK_FRAMES * ADC1_CHANNELS];
+PAD_ScannerTypeDef usb_pads;
+
+static void pad_out(uint32_t event)
+{
+  MIDI_Merge_Push(&usb_merge, MERGE_SRC_PADS, event);
+}
+
+#ifdef PAD_MPE_MEMBERS
+/* Used from the ADC interrupt only, once MPE_Configure() has run */
+MPE_ZoneTypeDef usb_mpe;
+static uint8_t pad_mpe_ch[MIDI_NUM_NOTES];
+
+static void pad_send(uint32_t event)
+{
+  uint8_t note = (uint8_t)(MIDI_EVENT_DATA1(event) & 0x7FU);
+  uint8_t ch = pad_mpe_ch[note];
+
+  if ((MIDI_EVENT_CIN(event) == MIDI_CIN_NOTE_ON) && (MIDI_EVENT_DATA2(event) != 0U))
+  {
+    pad_mpe_ch[note] = MPE_NoteOn(&usb_mpe, note, (uint8_t)MIDI_EVENT_DATA2(event),
+                                  MPE_BEND_CENTER, 0U, 64U);
+  }
+  else if ((MIDI_EVENT_CIN(event) == MIDI_CIN_NOTE_ON) ||
+           (MIDI_EVENT_CIN(event) == MIDI_CIN_NOTE_OFF))
+  {
+    /* the channel may have been stolen by a later note since */
+    if ((ch != MPE_NO_CHANNEL) && (usb_mpe.voice[ch].note == note))
+    {
+      MPE_NoteOff(&usb_mpe, ch, (uint8_t)MIDI_EVENT_DATA2(event));
+    }
+    pad_mpe_ch[note] = MPE_NO_CHANNEL;
+  }
+  else
+  {
+    pad_out(event);
+  }
+}
+#else
+#define pad_send          pad_out
+#endif /* PAD_MPE_MEMBERS */
+
+/* Clock master on SYNC_CABLE, paced by TIM2 channel 1 */
+MIDI_ClockTypeDef usb_clock;
+
+/* Tempo and position of the host clock, timestamped with TIM2 */
+MIDI_FollowTypeDef usb_follow;
+
+/* MTC out on TIM2 channel 2, and chase of the host time code. Quarter
+   frames are system common messages: they go through the merge ahead of
+   the other sources, and wait for the end of a SysEx on their cable. */
+MTC_GenTypeDef usb_mtc;
+MTC_ChaseTypeDef usb_chase;
+
+static void mtc_quarter_frame(uint32_t event)
+{
+  MIDI_Merge_Push(&usb_merge, MERGE_SRC_MTC_QF, event);
+}
+
+/* Full frame messages go through the merge to stay clear of other SysEx */
+static void mtc_sysex(uint32_t event)
+{
+  MIDI_Merge_Push(&usb_merge, MERGE_SRC_MTC, event);
+}
+
+/* Song player on cable 0, read in place from mapped flash */
+SMF_PlayerTypeDef usb_smf;
+
+static void smf_send(uint32_t event)
+{
+  MIDI_Merge_Push(&usb_merge, MERGE_SRC_SMF, event);
+}
+
+/* Microseconds from TIM2, carrying the remainder of the division */
+static uint32_t smf_now_us(void)
+{
+  static uint32_t last, rem, us;
+  uint32_t now = __HAL_TIM_GET_COUNTER(&htim2);
+  uint32_t per_us = TIM2_GetClockFreq() / 1000000U;
+
+  rem += now - last;
+  last = now;
+  us += rem / per_us;
+  rem %= per_us;
+  return us;
+}
+
+/* Output shaping of the USB IN cables, presets swap the table pointers */
+MIDI_XformTypeDef out_xform = { MIDI_XformIdentity, MIDI_XformIdentity, MIDI_XformChanIdentity };
+
+/* Routing sink for the USB IN cables */
+static void usb_sink(uint8_t port, uint32_t event)
+{
+  event = MIDI_Xform_Apply(&out_xform, event);
+  if (event != MIDI_XFORM_DROP)
+  {
+    MIDI_Merge_Push(&usb_merge, MERGE_SRC_ROUTE, (event & 0x0FFFFFFFUL) | ((uint32_t)port << 28));
+  }
+}
+
+/* Everything received from the host enters the routing matrix */
+static void usb_in(uint32_t event)
+{
+  MIDI_Rec_Capture(&usb_rec, MIDI_REC_IN, event);
+  MIDI_Route_Process(MIDI_PORT_USB(MIDI_EVENT_CABLE(event)), event);
+}
+
+int USB_MIDI_decoder(uint8_t *Buf, uint32_t Len)
+{
+  for (; Len >= 4; Len -= 4, Buf += 4)
+  {
+    usb_in(MIDI_EVENT_FROM_BYTES(Buf));
+  }
+  return 1;
+}
+
+/* Timing messages from the host, in the OUT endpoint interrupt so they are
+   stamped on arrival. Clocks and quarter frames are consumed; transport,
+   song position and real time SysEx (MTC full frames) are also passed on
+   to the router. Song position is taken here with the transport, so a
+   stop, locate, continue from the host reaches the follower in order. */
+int USB_MIDI_isr_decoder(uint32_t event)
+{
+  uint32_t now = __HAL_TIM_GET_COUNTER(&htim2);
+  int consumed;
+
+  switch (MIDI_EVENT_CIN(event))
+  {
+    case MIDI_CIN_SINGLE_BYTE:
+      MIDI_Follow_Event(&usb_follow, event, now);
+      consumed = (MIDI_EVENT_STATUS(event) == 0xF8U);
+      break;
+
+    case MIDI_CIN_SYSCOM_2:
+      MTC_Chase_Event(&usb_chase, event, now);
+      consumed = (MIDI_EVENT_STATUS(event) == 0xF1U);
+      break;
+
+    case MIDI_CIN_SYSCOM_3:
+      MIDI_Follow_Event(&usb_follow, event, now);
+      consumed = 0;
+      break;
+
+    default:
+      MTC_Chase_Event(&usb_chase, event, now);
+      consumed = 0;
+      break;
+  }
+  /* the rest is recorded when it reaches USB_MIDI_decoder() */
+  if (consumed)
+  {
+    MIDI_Rec_Capture(&usb_rec, MIDI_REC_IN, event);
+  }
+  return consumed;
+}
+
+#ifdef USE_USBD_COMPOSITE
+/* Raw MIDI from the CDC port, parsed in the main loop. The follower and the
+   chase belong to the OUT endpoint interrupt, so the clock, transport and
+   time code of this port are routed like any other message. */
+void USB_CDC_midi_receive(uint32_t event)
+{
+  usb_in(event);
+}
+
+/* Snapshots go out only while a reader holds the port open */
+static void telemetry_process(uint32_t now)
+{
+  static uint32_t last;
+
+  if (((uint32_t)(now - last) < TELEMETRY_PERIOD_MS) || !USBCDC_is_open())
+  {
+    return;
+  }
+  last = now;
+  (void)USBCDC_write(TELEMETRY_USB_MIDI, &USBMIDI_Stats, sizeof(USBMIDI_Stats));
+  (void)USBCDC_write(TELEMETRY_PADS, &usb_pads.stats, sizeof(usb_pads.stats));
+  (void)USBCDC_write(TELEMETRY_CDC, &USBCDC_Stats, sizeof(USBCDC_Stats));
+}
+#endif /* USE_USBD_COMPOSITE */
+/* USER CODE END 0 */
+
+/**
+  * @brief  The application entry point.
+  * @retval int
+  */
+int main(void)
+{
+
+  /* USER CODE BEGIN 1 */
+
+  /* USER CODE END 1 */
+
+  /* MPU Configuration--------------------------------------------------------*/
+  MPU_Config();
+
+  /* Enable the CPU Cache */
+
+  /* Enable I-Cache---------------------------------------------------------*/
+  SCB_EnableICache();
+
+  /* Enable D-Cache---------------------------------------------------------*/
+  SCB_EnableDCache();
+
+  /* MCU Configuration--------------------------------------------------------*/
+
+  /* Reset of all peripherals, Initializes the Flash interface and the Systick. */
+  HAL_Init();
+
+  /* USER CODE BEGIN Init */
+
+  /* USER CODE END Init */
+
+  /* Configure the system clock */
+  SystemClock_Config();
+
+  /* USER CODE BEGIN SysInit */
+  MCU_CycleCounterInit();
+  /* USER CODE END SysInit */
+
+  /* Initialize all configured peripherals */
+  MX_GPIO_Init();
+  MX_DMA_Init();
+  MX_USB_DEVICE_Init();
+  MX_TIM2_Init();
+  MX_ADC1_Init();
+  /* USER CODE BEGIN 2 */
+  MIDI_Rec_Init(&usb_rec, rec_buf, sizeof(rec_buf), SystemCoreClock);
+  MIDI_Rec_Start(&usb_rec);
+  MIDI_Merge_Init(&usb_merge, usb_out);
+  MIDI_Route_Init();
+  MIDI_Route_SetSink(MIDI_PORT_USB(0), usb_sink);
+  MIDI_Route_Add(MIDI_PORT_INTERNAL(0), MIDI_PORT_USB(0), MIDI_ROUTE_CH_ALL, MIDI_ROUTE_TYPE_ALL);
+  MIDI_Route_Compile();
+
+  MIDI_Clock_Init(&usb_clock, SYNC_CABLE, TIM2_GetClockFreq(), usb_out_priority);
+  MIDI_Follow_Init(&usb_follow, TIM2_GetClockFreq());
+  MTC_Gen_Init(&usb_mtc, SYNC_CABLE, MTC_RATE_25, TIM2_GetClockFreq(), mtc_quarter_frame, mtc_sysex);
+  MTC_Chase_Init(&usb_chase, TIM2_GetClockFreq());
+  USBMIDI_set_rx_isr_classes(USBMIDI_RX_CLASS_REALTIME | USBMIDI_RX_CLASS_COMMON |
+                             USBMIDI_RX_CLASS_SYSEX_RT);
+  __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1,
+                        MIDI_Clock_Begin(&usb_clock, __HAL_TIM_GET_COUNTER(&htim2)));
+  HAL_TIM_OC_Start_IT(&htim2, TIM_CHANNEL_1);
+  __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_2,
+                        MTC_Gen_Begin(&usb_mtc, __HAL_TIM_GET_COUNTER(&htim2)));
+  HAL_TIM_OC_Start_IT(&htim2, TIM_CHANNEL_2);
+
+  PAD_Init(&usb_pads, ADC1_CHANNELS, ADC1_GetFrameFreq(), 0, 0, pad_send);
+#ifdef PAD_MPE_MEMBERS
+  memset(pad_mpe_ch, MPE_NO_CHANNEL, sizeof(pad_mpe_ch));
+  MPE_Init(&usb_mpe, 0U, MPE_ZONE_LOWER, PAD_MPE_MEMBERS, pad_out);
+  MPE_Configure(&usb_mpe, PAD_MPE_BEND_RANGE);
+#endif /* PAD_MPE_MEMBERS */
+  if (HAL_ADCEx_Calibration_Start(&hadc1, ADC_CALIB_OFFSET, ADC_SINGLE_ENDED) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  HAL_ADC_Start_DMA(&hadc1, (uint32_t *)pad_buf, 2U * PAD_BLOCK_FRAMES * ADC1_CHANNELS);
+#ifdef SMF_IMAGE_ADDR
+  if (SMF_Open(&usb_smf, (const uint8_t *)SMF_IMAGE_ADDR, SMF_IMAGE_SIZE, 0, smf_send) == 0)
+  {
+    SMF_Start(&usb_smf, smf_now_us());
+  }
+#endif /* SMF_IMAGE_ADDR */
+  /* USER CODE END 2 */
+
+  /* Infinite loop */
+  /* USER CODE BEGIN WHILE */
+  while (1)
+  {
+    if(send)
+    MIDI_Route_Process(MIDI_PORT_INTERNAL(0), 0x0BB90012);
+    SMF_Process(&usb_smf, smf_now_us(), merge_room(MERGE_SRC_SMF));
+    MIDI_Rec_Process(&usb_rec);
+    if (rec_export)
+    {
+      rec_export = 0;
+      MIDI_Rec_ExportStart(&usb_rec);
+    }
+    MIDI_Rec_ExportSysEx(&usb_rec, 0, rec_sysex, merge_room(MERGE_SRC_REC));
+    MIDI_Merge_Process(&usb_merge, HAL_GetTick(), usb_tx_free());
+    USBMIDI_polling();
+#ifdef USE_USBD_COMPOSITE
+    USBCDC_polling();
+    telemetry_process(HAL_GetTick());
+#endif /* USE_USBD_COMPOSITE */
+    /* USER CODE END WHILE */
+
+    /* USER CODE BEGIN 3 */
+  }
+  /* USER CODE END 3 */
+}
+
+/**
+  * @brief System Clock Configuration
+  * @retval None
+  */
+void SystemClock_Config(void)
+{
+  RCC_OscInitTypeDef RCC_OscInitStruct = {0};
+  RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
+
+  /** Supply configuration update enable
+  */
+  HAL_PWREx_ConfigSupply(PWR_LDO_SUPPLY);
+
+  /** Configure the main internal regulator output voltage
+  */
+  __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE1);
+
+  while(!__HAL_PWR_GET_FLAG(PWR_FLAG_VOSRDY)) {}
+
+  /** Initializes the RCC Oscillators according to the specified parameters
+  * in the RCC_OscInitTypeDef structure.
+  */
+  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI48|RCC_OSCILLATORTYPE_HSE;
+  RCC_OscInitStruct.HSEState = RCC_HSE_ON;
+  RCC_OscInitStruct.HSI48State = RCC_HSI48_ON;
+  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+  RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+  RCC_OscInitStruct.PLL.PLLM = 1;
+  RCC_OscInitStruct.PLL.PLLN = 100;
+  RCC_OscInitStruct.PLL.PLLP = 2;
+  RCC_OscInitStruct.PLL.PLLQ = 4;
+  RCC_OscInitStruct.PLL.PLLR = 2;
+  RCC_OscInitStruct.PLL.PLLRGE = RCC_PLL1VCIRANGE_3;
+  RCC_OscInitStruct.PLL.PLLVCOSEL = RCC_PLL1VCOWIDE;
+  RCC_OscInitStruct.PLL.PLLFRACN = 0;
+  if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /** Initializes the CPU, AHB and APB buses clocks
+  */
+  RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
+                              |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2
+                              |RCC_CLOCKTYPE_D3PCLK1|RCC_CLOCKTYPE_D1PCLK1;
+  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+  RCC_ClkInitStruct.SYSCLKDivider = RCC_SYSCLK_DIV1;
+  RCC_ClkInitStruct.AHBCLKDivider = RCC_HCLK_DIV2;
+  RCC_ClkInitStruct.APB3CLKDivider = RCC_APB3_DIV2;
+  RCC_ClkInitStruct.APB1CLKDivider = RCC_APB1_DIV2;
+  RCC_ClkInitStruct.APB2CLKDivider = RCC_APB2_DIV2;
+  RCC_ClkInitStruct.APB4CLKDivider = RCC_APB4_DIV2;
+
+  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_2) != HAL_OK)
+  {
+    Error_Handler();
+  }
+}
+
+/* USER CODE BEGIN 4 */
+/* TIM2 compares: channel 1 paces MIDI clock, channel 2 MTC quarter frames */
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim)
+{
+  if (htim->Instance != TIM2)
+  {
+    return;
+  }
+  if (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_1)
+  {
+    __HAL_TIM_SET_COMPARE(htim, TIM_CHANNEL_1,
+                          MIDI_Clock_Tick(&usb_clock, __HAL_TIM_GET_COUNTER(htim)));
+  }
+  else if (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_2)
+  {
+    __HAL_TIM_SET_COMPARE(htim, TIM_CHANNEL_2,
+                          MTC_Gen_Tick(&usb_mtc, __HAL_TIM_GET_COUNTER(htim)));
+  }
+}
+
+/* ADC1 DMA halves: scan the half the DMA has just left */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+  if (hadc->Instance == ADC1)
+  {
+    PAD_Process(&usb_pads, &pad_buf[0], PAD_BLOCK_FRAMES);
+#ifdef PAD_MPE_MEMBERS
+    MPE_Process(&usb_mpe, HAL_GetTick());
+#endif /* PAD_MPE_MEMBERS */
+  }
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+  if (hadc->Instance == ADC1)
+  {
+    PAD_Process(&usb_pads, &pad_buf[PAD_BLOCK_FRAMES * ADC1_CHANNELS], PAD_BLOCK_FRAMES);
+#ifdef PAD_MPE_MEMBERS
+    MPE_Process(&usb_mpe, HAL_GetTick());
+#endif /* PAD_MPE_MEMBERS */
+  }
+}
+/* USER CODE END 4 */
+
+ /* MPU Configuration */
+
+void MPU_Config(void)
+{
+  MPU_Region_InitTypeDef MPU_InitStruct = {0};
+
+  /* Disables the MPU */
+  HAL_MPU_Disable();
+
+  /** Initializes and configures the Region and the memory to be protected
+  */
+  MPU_InitStruct.Enable = MPU_REGION_ENABLE;
+  MPU_InitStruct.Number = MPU_REGION_NUMBER0;
+  MPU_InitStruct.BaseAddress = 0x0;
+  MPU_InitStruct.Size = MPU_REGION_SIZE_4GB;
+  MPU_InitStruct.SubRegionDisable = 0x87;
+  MPU_InitStruct.TypeExtField = MPU_TEX_LEVEL0;
+  MPU_InitStruct.AccessPermission = MPU_REGION_NO_ACCESS;
+  MPU_InitStruct.DisableExec = MPU_INSTRUCTION_ACCESS_DISABLE;
+  MPU_InitStruct.IsShareable = MPU_ACCESS_SHAREABLE;
+  MPU_InitStruct.IsCacheable = MPU_ACCESS_NOT_CACHEABLE;
+  MPU_InitStruct.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
+
+  HAL_MPU_ConfigRegion(&MPU_InitStruct);
+
+  /** Initializes and configures the Region and the memory to be protected
+  */
+  MPU_InitStruct.Number = MPU_REGION_NUMBER1;
+  MPU_InitStruct.BaseAddress = 0x30000000;
+  MPU_InitStruct.Size = MPU_REGION_SIZE_512KB;
+  MPU_InitStruct.SubRegionDisable = 0x0;
+  MPU_InitStruct.TypeExtField = MPU_TEX_LEVEL1;
+  MPU_InitStruct.AccessPermission = MPU_REGION_FULL_ACCESS;
+  MPU_InitStruct.DisableExec = MPU_INSTRUCTION_ACCESS_ENABLE;
+  MPU_InitStruct.IsShareable = MPU_ACCESS_NOT_SHAREABLE;
+
+  HAL_MPU_ConfigRegion(&MPU_InitStruct);
+
+  /** Initializes and configures the Region and the memory to be protected
+  */
+  MPU_InitStruct.Number = MPU_REGION_NUMBER2;
+  MPU_InitStruct.BaseAddress = 0x20000000;
+  MPU_InitStruct.Size = MPU_REGION_SIZE_128KB;
+  MPU_InitStruct.IsCacheable = MPU_ACCESS_CACHEABLE;
+  MPU_InitStruct.IsBufferable = MPU_ACCESS_BUFFERABLE;
+
+  HAL_MPU_ConfigRegion(&MPU_InitStruct);
+
+  /** Initializes and configures the Region and the memory to be protected
+  */
+  MPU_InitStruct.Number = MPU_REGION_NUMBER3;
+  MPU_InitStruct.BaseAddress = 0x24000000;
+  MPU_InitStruct.Size = MPU_REGION_SIZE_512KB;
+
+  HAL_MPU_ConfigRegion(&MPU_InitStruct);
+  /* Enables the MPU */
+  HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
+
+}
+
+/**
+  * @brief  This function is executed in case of error occurrence.
+  * @retval None
+  */
+void Error_Handler(void)
+{
+  /* USER CODE BEGIN Error_Handler_Debug */
+  /* User can add his own implementation to report the HAL error return state */
+  __disable_irq();
+  while (1)
+  {
+  }
+  /* USER CODE END Error_Handler_Debug */
+}
+
+#ifdef  USE_FULL_ASSERT
+/**
+  * @brief  Reports the name of the source file and the source line number
+  *         where the assert_param error has occurred.
+  * @param  file: pointer to the source file name
+  * @param  line: assert_param error line source number
+  * @retval None
+  */
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  /* USER CODE BEGIN 6 */
+  /* User can add his own implementation to report the file name and line number,
+     ex: printf("Wrong parameters value: file %s on line %d\r\n", file, line) */
+  /* USER CODE END 6 */
+}
+#endif /* USE_FULL_ASSERT */
@@ -0,0 +1,220 @@
+/**
+  ******************************************************************************
+  * @file           : midi_clock.c
+  * @brief          : 24 PPQN MIDI clock generator driven by a timer compare.
+  *
+  *                   The time of the next clock is kept as a phase
+  *                   accumulator in timer counts with 16 fractional bits,
+  *                   so a tempo like 133.33 BPM does not drift however long
+  *                   it runs; only the compare value is rounded. The owner
+  *                   of the timer calls MIDI_Clock_Tick() from the compare
+  *                   interrupt and loads the value it returns into the
+  *                   compare register; nothing here touches hardware.
+  *
+  *                   Start and continue are sent from the tick, right before
+  *                   the clock that opens the song, as the spec requires.
+  *                   Lateness of every tick against its ideal time is kept
+  *                   in the stats, in timer counts.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "midi_clock.h"
+#include "mcu_port.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STATUS_SONG_POSITION      0xF2U
+#define STATUS_CLOCK              0xF8U
+#define STATUS_START              0xFAU
+#define STATUS_CONTINUE           0xFBU
+#define STATUS_STOP               0xFCU
+
+/* Private functions ---------------------------------------------------------*/
+
+static void send_realtime(MIDI_ClockTypeDef *pc, uint8_t status)
+{
+  pc->send(MIDI_EVENT(pc->cable, MIDI_CIN_SINGLE_BYTE, status, 0U, 0U));
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Initialize a stopped clock at 120 BPM
+  * @param  pc: clock instance
+  * @param  cable: USB-MIDI cable of the emitted events
+  * @param  timer_hz: counting frequency of the compare timer
+  * @param  send: output, called from the timer interrupt for clocks
+  * @retval None
+  */
+void MIDI_Clock_Init(MIDI_ClockTypeDef *pc, uint8_t cable, uint32_t timer_hz,
+                     MIDI_ClockSendTypeDef send)
+{
+  memset(pc, 0, sizeof(*pc));
+  pc->cable = cable & 0x0FU;
+  pc->timer_hz = timer_hz;
+  pc->send = send;
+  MIDI_Clock_SetTempo(pc, 12000U);
+}
+
+/**
+  * @brief  Change the tempo, effective from the clock after the next one
+  * @param  pc: clock instance
+  * @param  tempo: BPM * 100, clamped to MIDI_CLOCK_TEMPO_MIN..MAX
+  * @retval None
+  */
+void MIDI_Clock_SetTempo(MIDI_ClockTypeDef *pc, uint32_t tempo)
+{
+  uint64_t period;
+  uint32_t primask;
+
+  if (tempo < MIDI_CLOCK_TEMPO_MIN)
+  {
+    tempo = MIDI_CLOCK_TEMPO_MIN;
+  }
+  else if (tempo > MIDI_CLOCK_TEMPO_MAX)
+  {
+    tempo = MIDI_CLOCK_TEMPO_MAX;
+  }
+  /* counts per clock = timer_hz * 60 * 100 / (tempo * 24) */
+  period = (((uint64_t)pc->timer_hz * 6000U) << 16) / ((uint64_t)tempo * MIDI_CLOCK_PPQN);
+
+  /* the compare interrupt reads the 64-bit period: never let it see half */
+  primask = MCU_IrqSave();
+  pc->tempo = tempo;
+  pc->period = period;
+  MCU_IrqRestore(primask);
+}
+
+/**
+  * @brief  Choose whether clocks are sent while the song is stopped. Off by
+  *         default: the timer keeps its phase but only a running song, or
+  *         the clock that starts it, goes out.
+  * @param  pc: clock instance
+  * @param  enable: non-zero to send clocks all the time
+  * @retval None
+  */
+void MIDI_Clock_SetFreeRun(MIDI_ClockTypeDef *pc, uint8_t enable)
+{
+  pc->free_run = (enable != 0U) ? 1U : 0U;
+}
+
+/**
+  * @brief  Start the song from the beginning at the next clock
+  */
+void MIDI_Clock_Start(MIDI_ClockTypeDef *pc)
+{
+  pc->position = 0U;
+  pc->pending = STATUS_START;
+}
+
+/**
+  * @brief  Stop the song. Clocks stop with it unless free running.
+  */
+void MIDI_Clock_Stop(MIDI_ClockTypeDef *pc)
+{
+  pc->pending = 0U;
+  pc->running = 0U;
+  send_realtime(pc, STATUS_STOP);
+}
+
+/**
+  * @brief  Resume the song from the current position at the next clock
+  */
+void MIDI_Clock_Continue(MIDI_ClockTypeDef *pc)
+{
+  pc->pending = STATUS_CONTINUE;
+}
+
+/**
+  * @brief  Move the song position and announce it
+  * @param  pc: clock instance
+  * @param  spp: position in sixteenth notes, 0..16383
+  * @retval 0 on success, -1 while the song is running
+  */
+int8_t MIDI_Clock_SetSongPosition(MIDI_ClockTypeDef *pc, uint16_t spp)
+{
+  if (pc->running || pc->pending)
+  {
+    return -1;
+  }
+  spp &= 0x3FFFU;
+  pc->position = (uint32_t)spp * MIDI_CLOCK_PER_SPP;
+  pc->send(MIDI_EVENT(pc->cable, MIDI_CIN_SYSCOM_3, STATUS_SONG_POSITION,
+                      spp & 0x7FU, spp >> 7));
+  return 0;
+}
+
+/**
+  * @brief  Current song position in sixteenth notes
+  */
+uint16_t MIDI_Clock_GetSongPosition(const MIDI_ClockTypeDef *pc)
+{
+  return (uint16_t)((pc->position / MIDI_CLOCK_PER_SPP) & 0x3FFFU);
+}
+
+/**
+  * @brief  Align the phase accumulator on the timer before enabling the
+  *         compare interrupt
+  * @param  pc: clock instance
+  * @param  now: timer counter
+  * @retval first compare value
+  */
+uint32_t MIDI_Clock_Begin(MIDI_ClockTypeDef *pc, uint32_t now)
+{
+  pc->next = (uint64_t)(now + MIDI_CLOCK_MIN_LEAD) << 16;
+  return (uint32_t)(pc->next >> 16);
+}
+
+/**
+  * @brief  Timer compare interrupt: emit a clock if the song runs or the
+  *         clock is free running, and schedule the next one
+  * @param  pc: clock instance
+  * @param  now: timer counter at interrupt entry
+  * @retval next compare value
+  */
+uint32_t MIDI_Clock_Tick(MIDI_ClockTypeDef *pc, uint32_t now)
+{
+  uint32_t period = (uint32_t)(pc->period >> 16);
+  uint32_t late = now - (uint32_t)(pc->next >> 16);
+  uint32_t compare;
+
+  if (pc->pending)
+  {
+    send_realtime(pc, pc->pending);
+    pc->pending = 0U;
+    pc->running = 1U;
+  }
+  if (pc->running)
+  {
+    send_realtime(pc, STATUS_CLOCK);
+    pc->position++;
+    pc->stats.clocks++;
+  }
+  else if (pc->free_run)
+  {
+    send_realtime(pc, STATUS_CLOCK);
+    pc->stats.clocks++;
+  }
+
+  if (late > period)
+  {
+    /* stalled for more than a clock: restart the phase from now */
+    pc->stats.overruns++;
+    pc->next = (uint64_t)now << 16;
+    late = 0U;
+  }
+  pc->stats.late_sum += late;
+  if (late > pc->stats.late_max)
+  {
+    pc->stats.late_max = late;
+  }
+
+  pc->next += pc->period;
+  compare = (uint32_t)(pc->next >> 16);
+  if ((int32_t)(compare - now) < (int32_t)MIDI_CLOCK_MIN_LEAD)
+  {
+    compare = now + MIDI_CLOCK_MIN_LEAD;
+  }
+  return compare;
+}
@@ -0,0 +1,262 @@
+/**
+  ******************************************************************************
+  * @file           : midi_follow.c
+  * @brief          : Tempo and phase tracking of an incoming MIDI clock.
+  *
+  *                   Clocks from the host are timestamped when the OUT
+  *                   packet is handled, so they carry the 1 ms frame grid of
+  *                   the bus and every clock of a packet shares one stamp.
+  *                   A second order loop (phase and period, both in timer
+  *                   counts with 16 fractional bits) predicts the next
+  *                   arrival and corrects both terms from the error. It
+  *                   starts wide to acquire quickly and narrows in stages to
+  *                   average the USB jitter away.
+  *
+  *                   The filtered beat time and period are published with a
+  *                   sequence counter, so the main loop can read a
+  *                   consistent pair while the interrupt keeps updating.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "midi_follow.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STATUS_SONG_POSITION      0xF2U
+#define STATUS_CLOCK              0xF8U
+#define STATUS_START              0xFAU
+#define STATUS_CONTINUE           0xFBU
+#define STATUS_STOP               0xFCU
+
+/* Private functions ---------------------------------------------------------*/
+
+static void publish(MIDI_FollowTypeDef *pf, uint64_t beat, uint8_t advance)
+{
+  pf->seq++;
+  pf->beat_time = (uint32_t)(beat >> 16);
+  pf->beat_period = (uint32_t)(pf->period >> (16U - MIDI_FOLLOW_PERIOD_FRAC));
+  if (advance)
+  {
+    pf->position++;
+  }
+  pf->locked = (pf->count >= MIDI_FOLLOW_STAGE_CLOCKS) ? 1U : 0U;
+  pf->seq++;
+}
+
+/* Acquire again from this clock, which still counts for the position */
+static void restart(MIDI_FollowTypeDef *pf, uint32_t now)
+{
+  pf->last_raw = now;
+  pf->count = 1U;
+  pf->stage = 0U;
+  pf->seq++;
+  if (pf->running)
+  {
+    pf->position++;
+  }
+  pf->locked = 0U;
+  pf->seq++;
+}
+
+static void clock(MIDI_FollowTypeDef *pf, uint32_t now)
+{
+  uint64_t beat;
+  int64_t err;
+  uint32_t jitter;
+
+  pf->stats.clocks++;
+  if (pf->count == 0U)
+  {
+    restart(pf, now);
+    return;
+  }
+  if (pf->count == 1U)
+  {
+    if ((now - pf->last_raw) > MIDI_FOLLOW_PERIOD_MAX)
+    {
+      restart(pf, now);
+      return;
+    }
+    /* first interval seeds the period */
+    pf->period = (uint64_t)(now - pf->last_raw) << 16;
+    pf->predict = ((uint64_t)now << 16) + pf->period;
+    pf->count = 2U;
+    publish(pf, (uint64_t)now << 16, pf->running);
+    return;
+  }
+
+  err = ((int64_t)(int32_t)(now - (uint32_t)(pf->predict >> 16)) << 16) -
+        (int64_t)(pf->predict & 0xFFFFU);
+  jitter = (uint32_t)(((err < 0) ? -err : err) >> 16);
+  if ((pf->period == 0U) ||
+      ((uint64_t)jitter > (pf->period >> 16) / MIDI_FOLLOW_RESYNC_DIV))
+  {
+    pf->stats.resyncs++;
+    restart(pf, now);
+    return;
+  }
+
+  if (pf->locked)
+  {
+    pf->stats.jitter_sum += jitter;
+    if (jitter > pf->stats.jitter_max)
+    {
+      pf->stats.jitter_max = jitter;
+    }
+  }
+
+  /* err >> n on a negative value rounds towards -inf, which is fine here */
+  beat = pf->predict + (uint64_t)(err >> (1U + pf->stage));
+  pf->period += (uint64_t)(err >> (3U + 2U * pf->stage));
+  if ((pf->period >> 16) > MIDI_FOLLOW_PERIOD_MAX)
+  {
+    pf->stats.resyncs++;
+    restart(pf, now);
+    return;
+  }
+  pf->predict = beat + pf->period;
+
+  if (pf->count < 0xFFFFU)
+  {
+    pf->count++;
+  }
+  if (((pf->count % MIDI_FOLLOW_STAGE_CLOCKS) == 0U) && (pf->stage < (MIDI_FOLLOW_STAGES - 1U)))
+  {
+    pf->stage++;
+  }
+  publish(pf, beat, pf->running);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Initialize a follower, unlocked and stopped
+  * @param  pf: follower instance
+  * @param  timer_hz: frequency of the timestamps given to MIDI_Follow_Event()
+  * @retval None
+  */
+void MIDI_Follow_Init(MIDI_FollowTypeDef *pf, uint32_t timer_hz)
+{
+  memset(pf, 0, sizeof(*pf));
+  pf->timer_hz = timer_hz;
+}
+
+/**
+  * @brief  Feed a received event; only clock, transport and song position
+  *         are looked at. Call from a single context, normally the OUT
+  *         endpoint interrupt, so that song position keeps its place
+  *         between stop and continue.
+  * @param  pf: follower instance
+  * @param  event: USB-MIDI event word
+  * @param  now: arrival timestamp
+  * @retval None
+  */
+void MIDI_Follow_Event(MIDI_FollowTypeDef *pf, uint32_t event, uint32_t now)
+{
+  switch (MIDI_EVENT_STATUS(event))
+  {
+    case STATUS_CLOCK:
+      clock(pf, now);
+      break;
+
+    case STATUS_START:
+      pf->position = 0U;
+      pf->running = 1U;
+      break;
+
+    case STATUS_CONTINUE:
+      pf->running = 1U;
+      break;
+
+    case STATUS_STOP:
+      pf->running = 0U;
+      break;
+
+    case STATUS_SONG_POSITION:
+      if (!pf->running)
+      {
+        pf->position = (MIDI_EVENT_DATA1(event) | (MIDI_EVENT_DATA2(event) << 7)) * 6U;
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+  * @brief  Whether the loop has settled and the master is still sending
+  */
+uint8_t MIDI_Follow_IsLocked(const MIDI_FollowTypeDef *pf, uint32_t now)
+{
+  uint32_t seq, beat, period;
+  int32_t age;
+  uint8_t locked;
+
+  do
+  {
+    seq = pf->seq;
+    beat = pf->beat_time;
+    period = pf->beat_period;
+    locked = pf->locked;
+  } while ((seq & 1U) || (seq != pf->seq));
+
+  /* the filtered beat may lie slightly after the raw arrival */
+  age = (int32_t)(now - beat);
+  if (age < 0)
+  {
+    age = 0;
+  }
+  return locked &&
+         (((uint64_t)age << MIDI_FOLLOW_PERIOD_FRAC) <
+          (uint64_t)period * MIDI_FOLLOW_TIMEOUT_CLOCKS);
+}
+
+/**
+  * @brief  Filtered tempo
+  * @retval BPM * 100, 0 before the first interval
+  */
+uint32_t MIDI_Follow_GetTempo(const MIDI_FollowTypeDef *pf)
+{
+  uint32_t period = pf->beat_period;
+
+  if (period == 0U)
+  {
+    return 0U;
+  }
+  /* timer_hz * 60 * 100 / (24 * period), period has 4 fractional bits */
+  return (uint32_t)((((uint64_t)pf->timer_hz * 6000U) << MIDI_FOLLOW_PERIOD_FRAC) /
+                    ((uint64_t)period * 24U));
+}
+
+/**
+  * @brief  Song position extrapolated to a timestamp
+  * @param  pf: follower instance
+  * @param  now: timestamp, same timebase as the events
+  * @retval clocks since song start with 16 fractional bits, modulo 2^16
+  *         clocks; the fraction holds at the next clock if it is late
+  */
+uint32_t MIDI_Follow_GetPosition(const MIDI_FollowTypeDef *pf, uint32_t now)
+{
+  uint32_t seq, beat, period, position;
+  uint64_t frac = 0U;
+
+  do
+  {
+    seq = pf->seq;
+    beat = pf->beat_time;
+    period = pf->beat_period;
+    position = pf->position;
+  } while ((seq & 1U) || (seq != pf->seq));
+
+  if (pf->running && (period != 0U) && ((int32_t)(now - beat) > 0))
+  {
+    frac = ((uint64_t)(now - beat) << (16U + MIDI_FOLLOW_PERIOD_FRAC)) / period;
+    if (frac > 0xFFFFU)
+    {
+      frac = 0xFFFFU;
+    }
+  }
+  return (position << 16) + (uint32_t)frac;
+}
@@ -0,0 +1,332 @@
+/**
+  ******************************************************************************
+  * @file           : midi_merge.c
+  * @brief          : Merges several event streams into one output.
+  *
+  *                   Every producer owns a source with a single-producer
+  *                   queue, so it may push from an interrupt while
+  *                   MIDI_Merge_Process() drains from the main loop.
+  *                   USB-MIDI events are already whole messages except
+  *                   SysEx, so the merge only has to keep SysEx packets of
+  *                   one cable together: the first CIN 0x4 packet makes its
+  *                   source owner of the cable until the end packet, and
+  *                   other sources wait for that cable meanwhile. Real-time
+  *                   messages go to a separate queue per source and are
+  *                   sent first on every pass, SysEx or not.
+  *
+  *                   Order is kept per cable, not across cables: the events
+  *                   of a source waiting for a cable stay queued, those it
+  *                   has for other cables pass them, so two sources each
+  *                   inside a SysEx cannot hold each other up. A SysEx is
+  *                   terminated once its source has had nothing queued for
+  *                   the cable for MIDI_MERGE_SYSEX_TIMEOUT_MS.
+  *
+  *                   Sources are served in index order, each up to its
+  *                   weight per round, until the round makes no progress or
+  *                   the output budget is spent. All memory is static.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "midi_merge.h"
+#include "mcu_port.h"
+
+/* Private define ------------------------------------------------------------*/
+#define QUEUE_MASK                (MIDI_MERGE_QUEUE_LEN - 1U)
+#define RT_QUEUE_MASK             (MIDI_MERGE_RT_QUEUE_LEN - 1U)
+/* Queue entry already sent out of order: CIN 0 with no data, which is
+   never a message */
+#define ENTRY_TAKEN               0UL
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint8_t is_realtime(uint32_t event)
+{
+  return (MIDI_EVENT_CIN(event) == MIDI_CIN_SINGLE_BYTE) &&
+         (MIDI_EVENT_STATUS(event) >= 0xF8U);
+}
+
+static uint8_t is_sysex(uint32_t cin)
+{
+  return (cin >= MIDI_CIN_SYSEX_START) && (cin <= MIDI_CIN_SYSEX_END_3);
+}
+
+static void emit(MIDI_MergeTypeDef *pm, MIDI_MergeSourceTypeDef *ps,
+                 const MIDI_MergeEntryTypeDef *pe)
+{
+  uint32_t dt;
+
+  pm->out(pe->event);
+  dt = MCU_CYCLES() - pe->stamp;
+  ps->stats.events++;
+  ps->stats.latency_sum += dt;
+  if (dt > ps->stats.latency_max)
+  {
+    ps->stats.latency_max = dt;
+  }
+}
+
+/* Cables a source has events queued for */
+static uint16_t queued_cables(const MIDI_MergeSourceTypeDef *ps)
+{
+  uint16_t pos, wp = ps->wp, cables = 0U;
+  uint32_t event;
+
+  for (pos = ps->rp; pos != wp; pos++)
+  {
+    event = ps->queue[pos & QUEUE_MASK].event;
+    if (event != ENTRY_TAKEN)
+    {
+      cables |= (uint16_t)(1U << MIDI_EVENT_CABLE(event));
+    }
+  }
+  return cables;
+}
+
+/* Terminate SysEx whose source went quiet on the cable, and drop the rest
+   of it later. The time runs from the last pass that found something of
+   the owner queued for the cable, so an output that takes nothing does
+   not abort a SysEx. */
+static void check_timeouts(MIDI_MergeTypeDef *pm, uint32_t now_ms)
+{
+  MIDI_MergeSourceTypeDef *ps;
+  uint16_t queued[MIDI_MERGE_NUM_SOURCES];
+  uint16_t known = 0U;
+  uint32_t cable;
+  uint8_t i;
+
+  for (cable = 0U; cable < MIDI_NUM_CABLES; cable++)
+  {
+    i = pm->owner[cable];
+    if (i == MIDI_MERGE_NO_SOURCE)
+    {
+      continue;
+    }
+    ps = &pm->src[i];
+    if (!(known & (1U << i)))
+    {
+      queued[i] = queued_cables(ps);
+      known |= (uint16_t)(1U << i);
+    }
+    if (queued[i] & (1U << cable))
+    {
+      pm->owner_ms[cable] = now_ms;
+    }
+    else if ((now_ms - pm->owner_ms[cable]) > MIDI_MERGE_SYSEX_TIMEOUT_MS)
+    {
+      pm->out(MIDI_EVENT(cable, MIDI_CIN_SYSEX_END_1, 0xF7U, 0U, 0U));
+      ps->discard |= (uint16_t)(1U << cable);
+      pm->owner[cable] = MIDI_MERGE_NO_SOURCE;
+      pm->sysex_aborts++;
+    }
+  }
+}
+
+/* Find the oldest event of a source that may go out now; 0 if none.
+   Cables held by another source's SysEx are skipped with all their events,
+   and the tail of an aborted SysEx is dropped on the way. */
+static uint8_t next_event(MIDI_MergeTypeDef *pm, MIDI_MergeSourceTypeDef *ps, uint8_t src,
+                          uint16_t *ppos)
+{
+  uint16_t pos, wp = ps->wp, held = 0U;
+  uint32_t event, cable, cin;
+
+  for (pos = ps->rp; pos != wp; pos++)
+  {
+    event = ps->queue[pos & QUEUE_MASK].event;
+    if (event == ENTRY_TAKEN)
+    {
+      continue;
+    }
+    cable = MIDI_EVENT_CABLE(event);
+    cin = MIDI_EVENT_CIN(event);
+    if (held & (1U << cable))
+    {
+      continue;
+    }
+
+    if (ps->discard & (1U << cable))
+    {
+      /* an F0 starts the next SysEx, the source gave up on the old one */
+      if (is_sysex(cin) && (MIDI_EVENT_STATUS(event) != 0xF0U))
+      {
+        /* tail of a SysEx that was already terminated */
+        if (cin != MIDI_CIN_SYSEX_START)
+        {
+          ps->discard &= (uint16_t)~(1U << cable);
+        }
+        ps->queue[pos & QUEUE_MASK].event = ENTRY_TAKEN;
+        ps->stats.discarded++;
+        continue;
+      }
+      ps->discard &= (uint16_t)~(1U << cable);
+    }
+
+    if ((pm->owner[cable] != MIDI_MERGE_NO_SOURCE) && (pm->owner[cable] != src))
+    {
+      held |= (uint16_t)(1U << cable);
+      ps->stats.blocked++;
+      continue;
+    }
+    *ppos = pos;
+    return 1U;
+  }
+  return 0U;
+}
+
+/* Free the entries taken so far from the front of the queue */
+static void release(MIDI_MergeSourceTypeDef *ps)
+{
+  uint16_t wp = ps->wp;
+
+  while ((ps->rp != wp) && (ps->queue[ps->rp & QUEUE_MASK].event == ENTRY_TAKEN))
+  {
+    ps->rp++;
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Empty all sources; every source starts with weight 1
+  * @param  pm: merge instance
+  * @param  out: receives the merged stream
+  * @retval None
+  */
+void MIDI_Merge_Init(MIDI_MergeTypeDef *pm, MIDI_MergeOutTypeDef out)
+{
+  uint8_t i;
+
+  memset(pm, 0, sizeof(*pm));
+  pm->out = out;
+  memset(pm->owner, MIDI_MERGE_NO_SOURCE, sizeof(pm->owner));
+  for (i = 0U; i < MIDI_MERGE_NUM_SOURCES; i++)
+  {
+    pm->src[i].weight = 1U;
+  }
+}
+
+/**
+  * @brief  Set how many events a source may send per round.
+  *         Lower source indexes are served first in each round.
+  */
+void MIDI_Merge_SetWeight(MIDI_MergeTypeDef *pm, uint8_t src, uint8_t weight)
+{
+  if (src < MIDI_MERGE_NUM_SOURCES)
+  {
+    pm->src[src].weight = weight;
+  }
+}
+
+/**
+  * @brief  Queue an event on a source. One producer per source, which may
+  *         be an interrupt handler.
+  * @param  pm: merge instance
+  * @param  src: source index
+  * @param  event: USB-MIDI event word, a CIN 0 word with no data is ignored
+  * @retval 0 on success, -1 if the queue is full
+  */
+int8_t MIDI_Merge_Push(MIDI_MergeTypeDef *pm, uint8_t src, uint32_t event)
+{
+  MIDI_MergeSourceTypeDef *ps = &pm->src[src % MIDI_MERGE_NUM_SOURCES];
+  MIDI_MergeEntryTypeDef *pe;
+
+  if ((event & 0x0FFFFFFFUL) == ENTRY_TAKEN)
+  {
+    return 0;
+  }
+  if (is_realtime(event))
+  {
+    if ((uint8_t)(ps->rt_wp - ps->rt_rp) >= MIDI_MERGE_RT_QUEUE_LEN)
+    {
+      ps->stats.overflows++;
+      return -1;
+    }
+    pe = &ps->rt[ps->rt_wp & RT_QUEUE_MASK];
+    pe->event = event;
+    pe->stamp = MCU_CYCLES();
+    ps->rt_wp++;
+    return 0;
+  }
+
+  if ((uint16_t)(ps->wp - ps->rp) >= MIDI_MERGE_QUEUE_LEN)
+  {
+    ps->stats.overflows++;
+    return -1;
+  }
+  pe = &ps->queue[ps->wp & QUEUE_MASK];
+  pe->event = event;
+  pe->stamp = MCU_CYCLES();
+  ps->wp++;
+  return 0;
+}
+
+/**
+  * @brief  Move queued events to the output
+  * @param  pm: merge instance
+  * @param  now_ms: current time, for the SysEx timeout
+  * @param  budget: most events to output in this call
+  * @retval number of events output
+  */
+uint32_t MIDI_Merge_Process(MIDI_MergeTypeDef *pm, uint32_t now_ms, uint32_t budget)
+{
+  MIDI_MergeSourceTypeDef *ps;
+  MIDI_MergeEntryTypeDef *pe;
+  uint32_t sent = 0U, quota, cable, cin;
+  uint16_t pos;
+  uint8_t i, progress;
+
+  /* Real-time first, it may cut through anything */
+  for (i = 0U; i < MIDI_MERGE_NUM_SOURCES; i++)
+  {
+    ps = &pm->src[i];
+    while ((ps->rt_rp != ps->rt_wp) && (sent < budget))
+    {
+      emit(pm, ps, &ps->rt[ps->rt_rp & RT_QUEUE_MASK]);
+      ps->stats.rt_events++;
+      ps->rt_rp++;
+      sent++;
+    }
+  }
+
+  check_timeouts(pm, now_ms);
+
+  do
+  {
+    progress = 0U;
+    for (i = 0U; i < MIDI_MERGE_NUM_SOURCES; i++)
+    {
+      ps = &pm->src[i];
+      for (quota = ps->weight; (quota > 0U) && (sent < budget); )
+      {
+        if (!next_event(pm, ps, i, &pos))
+        {
+          release(ps);
+          break;
+        }
+        pe = &ps->queue[pos & QUEUE_MASK];
+        cable = MIDI_EVENT_CABLE(pe->event);
+        cin = MIDI_EVENT_CIN(pe->event);
+
+        emit(pm, ps, pe);
+        pe->event = ENTRY_TAKEN;
+        release(ps);
+        if (cin == MIDI_CIN_SYSEX_START)
+        {
+          pm->owner[cable] = i;
+          pm->owner_ms[cable] = now_ms;
+        }
+        else
+        {
+          pm->owner[cable] = MIDI_MERGE_NO_SOURCE;
+        }
+        quota--;
+        sent++;
+        progress = 1U;
+      }
+    }
+  } while (progress && (sent < budget));
+
+  return sent;
+}
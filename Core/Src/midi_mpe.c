@@ -0,0 +1,382 @@
+/**
+  ******************************************************************************
+  * @file           : midi_mpe.c
+  * @brief          : MIDI Polyphonic Expression zone manager.
+  *                   Gives every sounding note its own member channel so it
+  *                   can carry pitch bend, channel pressure and CC74 timbre.
+  *
+  *                   Free member channels are kept in LRU order, so a new
+  *                   note gets the channel whose release tail is oldest; if
+  *                   every channel is busy the oldest note is stolen. Both
+  *                   lists are intrusive and indexed by channel, so
+  *                   allocation and release are O(1).
+  *
+  *                   Per-note controller updates only mark the value dirty.
+  *                   MPE_Process() sends them round-robin over the channels
+  *                   under a token bucket of MPE_EVENTS_PER_MS, so a burst of
+  *                   expression data can never crowd note on/off out of the
+  *                   IN endpoint; intermediate values are simply coalesced.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "midi_mpe.h"
+#include "mcu_port.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DIRTY_BEND                0x01U
+#define DIRTY_PRESSURE            0x02U
+#define DIRTY_TIMBRE              0x04U
+
+#define CC_DATA_ENTRY_MSB         6U
+#define CC_DATA_ENTRY_LSB         38U
+#define CC_TIMBRE                 74U
+#define CC_RPN_LSB                100U
+#define CC_RPN_MSB                101U
+
+#define RPN_PITCH_BEND_RANGE      0U
+#define RPN_MPE_CONFIGURATION     6U
+#define RPN_NULL                  0x7FU
+
+/* Private functions ---------------------------------------------------------*/
+
+static void send_cc(MPE_ZoneTypeDef *pz, uint8_t ch, uint8_t cc, uint8_t value)
+{
+  pz->send(MIDI_EVENT_CHANNEL(pz->cable, 0xB0U | ch, cc, value));
+}
+
+static void send_rpn(MPE_ZoneTypeDef *pz, uint8_t ch, uint8_t rpn, uint8_t msb, uint8_t lsb)
+{
+  send_cc(pz, ch, CC_RPN_MSB, 0U);
+  send_cc(pz, ch, CC_RPN_LSB, rpn);
+  send_cc(pz, ch, CC_DATA_ENTRY_MSB, msb);
+  send_cc(pz, ch, CC_DATA_ENTRY_LSB, lsb);
+  send_cc(pz, ch, CC_RPN_MSB, RPN_NULL);
+  send_cc(pz, ch, CC_RPN_LSB, RPN_NULL);
+}
+
+static void send_bend(MPE_ZoneTypeDef *pz, uint8_t ch, uint16_t bend)
+{
+  pz->send(MIDI_EVENT_CHANNEL(pz->cable, 0xE0U | ch, bend & 0x7FU, (bend >> 7) & 0x7FU));
+}
+
+static void send_pressure(MPE_ZoneTypeDef *pz, uint8_t ch, uint8_t pressure)
+{
+  pz->send(MIDI_EVENT_CHANNEL(pz->cable, 0xD0U | ch, pressure & 0x7FU, 0U));
+}
+
+static void list_push(MPE_ZoneTypeDef *pz, uint8_t *head, uint8_t *tail, uint8_t ch)
+{
+  MPE_VoiceTypeDef *v = &pz->voice[ch];
+
+  v->next = MPE_NO_CHANNEL;
+  v->prev = *tail;
+  if (*tail != MPE_NO_CHANNEL)
+  {
+    pz->voice[*tail].next = ch;
+  }
+  else
+  {
+    *head = ch;
+  }
+  *tail = ch;
+}
+
+static void list_remove(MPE_ZoneTypeDef *pz, uint8_t *head, uint8_t *tail, uint8_t ch)
+{
+  MPE_VoiceTypeDef *v = &pz->voice[ch];
+
+  if (v->prev != MPE_NO_CHANNEL)
+  {
+    pz->voice[v->prev].next = v->next;
+  }
+  else
+  {
+    *head = v->next;
+  }
+  if (v->next != MPE_NO_CHANNEL)
+  {
+    pz->voice[v->next].prev = v->prev;
+  }
+  else
+  {
+    *tail = v->prev;
+  }
+  v->prev = MPE_NO_CHANNEL;
+  v->next = MPE_NO_CHANNEL;
+}
+
+static void voice_release(MPE_ZoneTypeDef *pz, uint8_t ch)
+{
+  MPE_VoiceTypeDef *v = &pz->voice[ch];
+
+  v->note = MPE_NO_CHANNEL;
+  v->dirty = 0U;
+  pz->dirty_mask &= (uint16_t)~(1U << ch);
+}
+
+static void mark_dirty(MPE_ZoneTypeDef *pz, uint8_t ch, uint8_t flag)
+{
+  MPE_VoiceTypeDef *v = &pz->voice[ch];
+
+  if (v->dirty & flag)
+  {
+    pz->stats.ctrl_coalesced++;
+  }
+  v->dirty |= flag;
+  pz->dirty_mask |= (uint16_t)(1U << ch);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Initialise a zone and put all its member channels in the free pool
+  * @param  pz: zone
+  * @param  cable: USB-MIDI cable the zone is sent on
+  * @param  zone: MPE_ZONE_LOWER or MPE_ZONE_UPPER
+  * @param  members: number of member channels, 1..15
+  * @param  send: event sink, normally USBMIDI_send
+  * @retval None
+  */
+void MPE_Init(MPE_ZoneTypeDef *pz, uint8_t cable, uint8_t zone, uint8_t members,
+              MPE_SendTypeDef send)
+{
+  uint8_t i, ch;
+
+  if (members < 1U)
+  {
+    members = 1U;
+  }
+  if (members > (MIDI_NUM_CHANNELS - 1U))
+  {
+    members = MIDI_NUM_CHANNELS - 1U;
+  }
+
+  pz->send = send;
+  pz->cable = cable;
+  pz->members = members;
+  pz->manager = (zone == MPE_ZONE_UPPER) ? (MIDI_NUM_CHANNELS - 1U) : 0U;
+  pz->free_head = pz->free_tail = MPE_NO_CHANNEL;
+  pz->busy_head = pz->busy_tail = MPE_NO_CHANNEL;
+  pz->rr = 0U;
+  pz->dirty_mask = 0U;
+  pz->tokens = MPE_EVENTS_BURST;
+  pz->last_ms = 0U;
+  pz->stats = (MPE_StatsTypeDef){0};
+
+  for (i = 0U; i < MIDI_NUM_CHANNELS; i++)
+  {
+    pz->voice[i].note = MPE_NO_CHANNEL;
+    pz->voice[i].pressure = 0U;
+    pz->voice[i].timbre = 64U;
+    pz->voice[i].dirty = 0U;
+    pz->voice[i].bend = MPE_BEND_CENTER;
+    pz->voice[i].prev = MPE_NO_CHANNEL;
+    pz->voice[i].next = MPE_NO_CHANNEL;
+  }
+
+  for (i = 1U; i <= members; i++)
+  {
+    ch = (zone == MPE_ZONE_UPPER) ? (uint8_t)(pz->manager - i) : i;
+    list_push(pz, &pz->free_head, &pz->free_tail, ch);
+  }
+}
+
+/**
+  * @brief  Send the MPE Configuration Message, then the pitch bend range on
+  *         every member channel, sounding or not
+  * @param  pz: zone
+  * @param  bend_range: member channel pitch bend range in semitones (48 is
+  *         the MPE default)
+  * @retval None
+  */
+void MPE_Configure(MPE_ZoneTypeDef *pz, uint8_t bend_range)
+{
+  uint8_t i, ch;
+
+  send_rpn(pz, pz->manager, RPN_MPE_CONFIGURATION, pz->members, 0U);
+  for (i = 1U; i <= pz->members; i++)
+  {
+    ch = (pz->manager == 0U) ? i : (uint8_t)(pz->manager - i);
+    send_rpn(pz, ch, RPN_PITCH_BEND_RANGE, bend_range, 0U);
+  }
+}
+
+/**
+  * @brief  Start a note on the least recently used member channel.
+  *         The initial expression state is sent ahead of the note on, as the
+  *         MPE specification asks, and is not subject to the rate limit.
+  * @retval member channel carrying the note (the handle for later calls)
+  */
+uint8_t MPE_NoteOn(MPE_ZoneTypeDef *pz, uint8_t note, uint8_t velocity,
+                   uint16_t bend, uint8_t pressure, uint8_t timbre)
+{
+  MPE_VoiceTypeDef *v;
+  uint32_t t0 = MCU_CYCLES();
+  uint32_t dt;
+  uint8_t ch;
+
+  ch = pz->free_head;
+  if (ch != MPE_NO_CHANNEL)
+  {
+    list_remove(pz, &pz->free_head, &pz->free_tail, ch);
+  }
+  else
+  {
+    /* Every member channel is sounding: steal the oldest note */
+    ch = pz->busy_head;
+    list_remove(pz, &pz->busy_head, &pz->busy_tail, ch);
+    pz->send(MIDI_EVENT_CHANNEL(pz->cable, 0x80U | ch, pz->voice[ch].note, 0x40U));
+    voice_release(pz, ch);
+    pz->stats.steals++;
+    pz->tokens--;
+  }
+  list_push(pz, &pz->busy_head, &pz->busy_tail, ch);
+
+  dt = MCU_CYCLES() - t0;
+  pz->stats.alloc_cycles_sum += dt;
+  if (dt > pz->stats.alloc_cycles_max)
+  {
+    pz->stats.alloc_cycles_max = dt;
+  }
+
+  v = &pz->voice[ch];
+  v->note = note & 0x7FU;
+  v->bend = bend & 0x3FFFU;
+  v->pressure = pressure & 0x7FU;
+  v->timbre = timbre & 0x7FU;
+
+  send_bend(pz, ch, v->bend);
+  send_pressure(pz, ch, v->pressure);
+  send_cc(pz, ch, CC_TIMBRE, v->timbre);
+  pz->send(MIDI_EVENT_CHANNEL(pz->cable, 0x90U | ch, v->note, velocity & 0x7FU));
+  pz->tokens -= 4;
+  pz->stats.note_on++;
+
+  return ch;
+}
+
+/**
+  * @brief  Stop the note on a member channel and return it to the free pool
+  * @param  ch: channel returned by MPE_NoteOn()
+  * @retval None
+  */
+void MPE_NoteOff(MPE_ZoneTypeDef *pz, uint8_t ch, uint8_t velocity)
+{
+  if ((ch >= MIDI_NUM_CHANNELS) || (pz->voice[ch].note == MPE_NO_CHANNEL))
+  {
+    return;
+  }
+
+  pz->send(MIDI_EVENT_CHANNEL(pz->cable, 0x80U | ch, pz->voice[ch].note, velocity & 0x7FU));
+  pz->tokens--;
+  voice_release(pz, ch);
+  list_remove(pz, &pz->busy_head, &pz->busy_tail, ch);
+  list_push(pz, &pz->free_head, &pz->free_tail, ch);
+}
+
+/**
+  * @brief  Update the 14-bit pitch bend of a sounding note
+  */
+void MPE_SetBend(MPE_ZoneTypeDef *pz, uint8_t ch, uint16_t bend)
+{
+  if ((ch < MIDI_NUM_CHANNELS) && (pz->voice[ch].note != MPE_NO_CHANNEL))
+  {
+    pz->voice[ch].bend = bend & 0x3FFFU;
+    mark_dirty(pz, ch, DIRTY_BEND);
+  }
+}
+
+/**
+  * @brief  Update the pressure of a sounding note
+  */
+void MPE_SetPressure(MPE_ZoneTypeDef *pz, uint8_t ch, uint8_t pressure)
+{
+  if ((ch < MIDI_NUM_CHANNELS) && (pz->voice[ch].note != MPE_NO_CHANNEL))
+  {
+    pz->voice[ch].pressure = pressure & 0x7FU;
+    mark_dirty(pz, ch, DIRTY_PRESSURE);
+  }
+}
+
+/**
+  * @brief  Update the timbre (CC74) of a sounding note
+  */
+void MPE_SetTimbre(MPE_ZoneTypeDef *pz, uint8_t ch, uint8_t timbre)
+{
+  if ((ch < MIDI_NUM_CHANNELS) && (pz->voice[ch].note != MPE_NO_CHANNEL))
+  {
+    pz->voice[ch].timbre = timbre & 0x7FU;
+    mark_dirty(pz, ch, DIRTY_TIMBRE);
+  }
+}
+
+/**
+  * @brief  Send pending per-note controllers within the bandwidth budget.
+  *         Call from the main loop.
+  * @param  now_ms: current time in milliseconds (HAL_GetTick())
+  * @retval None
+  */
+void MPE_Process(MPE_ZoneTypeDef *pz, uint32_t now_ms)
+{
+  MPE_VoiceTypeDef *v;
+  uint32_t elapsed = now_ms - pz->last_ms;
+  uint32_t refill;
+  uint32_t m;
+  uint8_t ch;
+
+  pz->last_ms = now_ms;
+  /* Note traffic is sent at once and may overdraw the bucket; the debt is
+     not carried over, the budget stays within 0..MPE_EVENTS_BURST */
+  if (pz->tokens < 0)
+  {
+    pz->tokens = 0;
+  }
+  /* milliseconds to fill the bucket, compared first so the product
+     cannot overflow after a long idle */
+  refill = ((uint32_t)(MPE_EVENTS_BURST - pz->tokens) + MPE_EVENTS_PER_MS - 1U) / MPE_EVENTS_PER_MS;
+  if (elapsed >= refill)
+  {
+    pz->tokens = MPE_EVENTS_BURST;
+  }
+  else
+  {
+    pz->tokens += (int32_t)(elapsed * MPE_EVENTS_PER_MS);
+  }
+
+  while ((pz->tokens > 0) && (pz->dirty_mask != 0U))
+  {
+    /* Next dirty channel at or after the round-robin cursor */
+    m = pz->dirty_mask & ~((1UL << pz->rr) - 1U);
+    if (m == 0U)
+    {
+      m = pz->dirty_mask;
+    }
+    ch = (uint8_t)(31U - MCU_CLZ(m & (~m + 1U)));
+    v = &pz->voice[ch];
+
+    if (v->dirty & DIRTY_BEND)
+    {
+      v->dirty &= (uint8_t)~DIRTY_BEND;
+      send_bend(pz, ch, v->bend);
+    }
+    else if (v->dirty & DIRTY_PRESSURE)
+    {
+      v->dirty &= (uint8_t)~DIRTY_PRESSURE;
+      send_pressure(pz, ch, v->pressure);
+    }
+    else
+    {
+      v->dirty &= (uint8_t)~DIRTY_TIMBRE;
+      send_cc(pz, ch, CC_TIMBRE, v->timbre);
+    }
+
+    if (v->dirty == 0U)
+    {
+      pz->dirty_mask &= (uint16_t)~(1U << ch);
+    }
+    pz->rr = (uint8_t)((ch + 1U) & 0x0FU);
+    pz->tokens--;
+    pz->stats.ctrl_sent++;
+  }
+}
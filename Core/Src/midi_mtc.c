@@ -0,0 +1,511 @@
+/**
+  ******************************************************************************
+  * @file           : midi_mtc.c
+  * @brief          : MIDI Time Code generator and chase engine.
+  *
+  *                   Positions are counted in frames since 00:00:00:00 and
+  *                   only turned into hh:mm:ss:ff (drop frame aware) at the
+  *                   edges, so both directions work on plain integers.
+  *
+  *                   The generator shares the phase accumulator scheme of
+  *                   the MIDI clock: quarter frames are paced by a timer
+  *                   compare with 16 fractional bits of period, which keeps
+  *                   29.97 fps exact. The 8 pieces describe the frame at
+  *                   piece 0, latched once per cycle as the spec requires.
+  *
+  *                   The chase engine reassembles forward quarter frame
+  *                   cycles and full frame SysEx. Once a cycle decodes, every
+  *                   further quarter frame advances the position by one and
+  *                   runs a phase/period loop on its arrival time, so the
+  *                   position can be read between messages.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "midi_mtc.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STATUS_QUARTER_FRAME      0xF1U
+
+/* Chase loop gains: damping 0.707 */
+#define CHASE_KP_SHIFT            2U
+#define CHASE_KI_SHIFT            5U
+
+/* Fractional bits of the published period. The loop period may stray an
+   eighth from the nominal one, which keeps it well inside 32 bits. */
+#define CHASE_PERIOD_FRAC         4U
+#define CHASE_PERIOD_SLACK_DIV    8U
+
+/* Private variables ---------------------------------------------------------*/
+static const uint8_t fps[4] = { 24U, 25U, 30U, 30U };
+static const uint32_t frames_per_day[4] = { 2073600UL, 2160000UL, 2589408UL, 2592000UL };
+
+/* Private functions ---------------------------------------------------------*/
+
+/* Timer counts per quarter frame, 16 fractional bits */
+static uint64_t qf_period(uint32_t timer_hz, uint8_t rate)
+{
+  if (rate == MTC_RATE_2997DF)
+  {
+    return (((uint64_t)timer_hz * 1001U) << 16) / (30000U * 4U);
+  }
+  return ((uint64_t)timer_hz << 16) / (fps[rate] * 4U);
+}
+
+static void split(MTC_GenTypeDef *pg)
+{
+  MTC_TimeTypeDef t;
+
+  MTC_FramesToTime(pg->frame, pg->rate, &t);
+  pg->nibble[0] = t.frames & 0x0FU;
+  pg->nibble[1] = t.frames >> 4;
+  pg->nibble[2] = t.seconds & 0x0FU;
+  pg->nibble[3] = t.seconds >> 4;
+  pg->nibble[4] = t.minutes & 0x0FU;
+  pg->nibble[5] = t.minutes >> 4;
+  pg->nibble[6] = t.hours & 0x0FU;
+  pg->nibble[7] = (uint8_t)((t.hours >> 4) | (t.rate << 1));
+}
+
+static void publish(MTC_ChaseTypeDef *pc, uint32_t time, uint32_t qf, uint8_t locked)
+{
+  pc->seq++;
+  pc->anchor_time = time;
+  pc->anchor_qf = qf;
+  pc->anchor_period = (uint32_t)(pc->period >> (16U - CHASE_PERIOD_FRAC));
+  pc->locked = locked;
+  pc->seq++;
+}
+
+static void anchor(MTC_ChaseTypeDef *pc, uint32_t now, uint32_t qf, uint8_t rate)
+{
+  if (!pc->locked || (rate != pc->rate))
+  {
+    pc->period = qf_period(pc->timer_hz, rate);
+  }
+  pc->rate = rate;
+  pc->predict = ((uint64_t)now << 16) + pc->period;
+  publish(pc, now, qf, 1U);
+}
+
+/* One more quarter frame while locked: advance and correct the loop */
+static void track(MTC_ChaseTypeDef *pc, uint32_t now)
+{
+  uint64_t beat, nominal;
+  int64_t err;
+  uint32_t drift;
+
+  err = ((int64_t)(int32_t)(now - (uint32_t)(pc->predict >> 16)) << 16) -
+        (int64_t)(pc->predict & 0xFFFFU);
+  drift = (uint32_t)(((err < 0) ? -err : err) >> 16);
+  if (drift > (uint32_t)(pc->period >> 17))
+  {
+    /* missing or extra quarter frames: wait for the next full cycle */
+    pc->stats.resyncs++;
+    pc->seeking = 0U;
+    publish(pc, pc->anchor_time, pc->anchor_qf, 0U);
+    return;
+  }
+
+  pc->stats.drift_sum += drift;
+  if (drift > pc->stats.drift_max)
+  {
+    pc->stats.drift_max = drift;
+  }
+  beat = pc->predict + (uint64_t)(err >> CHASE_KP_SHIFT);
+  pc->period += (uint64_t)(err >> CHASE_KI_SHIFT);
+  nominal = qf_period(pc->timer_hz, pc->rate);
+  if ((pc->period > nominal + nominal / CHASE_PERIOD_SLACK_DIV) ||
+      (pc->period < nominal - nominal / CHASE_PERIOD_SLACK_DIV))
+  {
+    /* not running at the rate it claims: wait for the next full cycle */
+    pc->stats.resyncs++;
+    pc->seeking = 0U;
+    pc->period = nominal;
+    publish(pc, pc->anchor_time, pc->anchor_qf, 0U);
+    return;
+  }
+  pc->predict = beat + pc->period;
+  publish(pc, (uint32_t)(beat >> 16), pc->anchor_qf + 1U, 1U);
+}
+
+static void quarter_frame(MTC_ChaseTypeDef *pc, uint8_t data, uint32_t now)
+{
+  uint8_t piece = data >> 4;
+  MTC_TimeTypeDef t;
+  uint32_t qf;
+
+  pc->stats.quarter_frames++;
+  if (pc->locked)
+  {
+    track(pc, now);
+  }
+  else if (!pc->seeking)
+  {
+    pc->first_time = now;
+    pc->seeking = 1U;
+  }
+
+  if (piece == 0U)
+  {
+    pc->expect = 0U;
+  }
+  if (piece != pc->expect)
+  {
+    if (pc->expect != 8U)
+    {
+      pc->stats.resyncs++;
+    }
+    pc->expect = 8U;
+    return;
+  }
+  pc->nibble[piece] = data & 0x0FU;
+  pc->expect++;
+  if (piece != 7U)
+  {
+    return;
+  }
+
+  /* a whole cycle: it described the frame at piece 0, this is piece 7 */
+  t.frames = pc->nibble[0] | (uint8_t)(pc->nibble[1] << 4);
+  t.seconds = pc->nibble[2] | (uint8_t)(pc->nibble[3] << 4);
+  t.minutes = pc->nibble[4] | (uint8_t)(pc->nibble[5] << 4);
+  t.hours = pc->nibble[6] | (uint8_t)((pc->nibble[7] & 0x01U) << 4);
+  t.rate = (pc->nibble[7] >> 1) & 0x03U;
+  qf = MTC_TimeToFrames(&t) * 4U + 7U;
+  pc->expect = 8U;
+
+  if (pc->locked && (qf == pc->anchor_qf) && (t.rate == pc->rate))
+  {
+    return;
+  }
+  if (pc->locked)
+  {
+    pc->stats.resyncs++;  /* the master jumped */
+  }
+  else if (pc->seeking)
+  {
+    pc->stats.lock_counts = now - pc->first_time;
+    pc->seeking = 0U;
+  }
+  anchor(pc, now, qf, t.rate);
+}
+
+static void full_frame(MTC_ChaseTypeDef *pc, uint32_t now)
+{
+  const uint8_t *p = pc->sysex;
+  MTC_TimeTypeDef t;
+
+  /* F0 7F <device> 01 01 hh mm ss ff F7 */
+  if ((pc->sysex_len != 10U) || (p[1] != 0x7FU) || (p[3] != 0x01U) ||
+      (p[4] != 0x01U) || (p[9] != 0xF7U))
+  {
+    return;
+  }
+  t.hours = p[5] & 0x1FU;
+  t.rate = (p[5] >> 5) & 0x03U;
+  t.minutes = p[6];
+  t.seconds = p[7];
+  t.frames = p[8];
+  pc->stats.full_frames++;
+  pc->expect = 8U;
+  pc->seeking = 0U;
+  pc->rate = t.rate;
+  pc->period = qf_period(pc->timer_hz, t.rate);
+  publish(pc, now, MTC_TimeToFrames(&t) * 4U, 0U);
+}
+
+static void sysex_packet(MTC_ChaseTypeDef *pc, uint32_t event, uint32_t now)
+{
+  uint32_t cin = MIDI_EVENT_CIN(event);
+  uint8_t bytes[3];
+  uint8_t n, i;
+
+  bytes[0] = (uint8_t)MIDI_EVENT_STATUS(event);
+  bytes[1] = (uint8_t)MIDI_EVENT_DATA1(event);
+  bytes[2] = (uint8_t)MIDI_EVENT_DATA2(event);
+  n = (cin == MIDI_CIN_SYSEX_START) ? 3U : (uint8_t)(cin - MIDI_CIN_SYSEX_END_1 + 1U);
+
+  if (bytes[0] == 0xF0U)
+  {
+    pc->sysex_len = 0U;
+  }
+  for (i = 0U; i < n; i++)
+  {
+    if (pc->sysex_len < sizeof(pc->sysex))
+    {
+      pc->sysex[pc->sysex_len] = bytes[i];
+    }
+    if (pc->sysex_len < 0xFFU)
+    {
+      pc->sysex_len++;
+    }
+  }
+  if (cin != MIDI_CIN_SYSEX_START)
+  {
+    full_frame(pc, now);
+    pc->sysex_len = 0U;
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Frames since 00:00:00:00 of a time code, drop frame aware
+  */
+uint32_t MTC_TimeToFrames(const MTC_TimeTypeDef *pt)
+{
+  uint8_t rate = pt->rate & 0x03U;
+  uint32_t minutes = pt->hours * 60U + pt->minutes;
+  uint32_t frames = (minutes * 60U + pt->seconds) * fps[rate] + pt->frames;
+
+  if (rate == MTC_RATE_2997DF)
+  {
+    /* frames 0 and 1 are skipped every minute except each tenth */
+    frames -= 2U * (minutes - minutes / 10U);
+  }
+  return frames;
+}
+
+/**
+  * @brief  Time code of a frame count, drop frame aware
+  */
+void MTC_FramesToTime(uint32_t frames, uint8_t rate, MTC_TimeTypeDef *pt)
+{
+  uint32_t d, m;
+
+  rate &= 0x03U;
+  frames %= frames_per_day[rate];
+  if (rate == MTC_RATE_2997DF)
+  {
+    /* 17982 frames per ten minutes, 1798 per dropping minute */
+    d = frames / 17982U;
+    m = frames % 17982U;
+    frames += 18U * d + ((m < 2U) ? 0U : 2U * ((m - 2U) / 1798U));
+  }
+  pt->rate = rate;
+  pt->frames = (uint8_t)(frames % fps[rate]);
+  frames /= fps[rate];
+  pt->seconds = (uint8_t)(frames % 60U);
+  frames /= 60U;
+  pt->minutes = (uint8_t)(frames % 60U);
+  pt->hours = (uint8_t)((frames / 60U) % 24U);
+}
+
+/**
+  * @brief  Initialize a stopped generator at 00:00:00:00
+  * @param  pg: generator instance
+  * @param  cable: USB-MIDI cable of the emitted events
+  * @param  rate: MTC_RATE_xx
+  * @param  timer_hz: counting frequency of the compare timer
+  * @param  send: quarter frame output, called from the timer interrupt
+  * @param  send_sysex: full frame output, called from MTC_Gen_Locate()
+  * @retval None
+  */
+void MTC_Gen_Init(MTC_GenTypeDef *pg, uint8_t cable, uint8_t rate, uint32_t timer_hz,
+                  MTC_SendTypeDef send, MTC_SendTypeDef send_sysex)
+{
+  memset(pg, 0, sizeof(*pg));
+  pg->cable = cable & 0x0FU;
+  pg->rate = rate & 0x03U;
+  pg->timer_hz = timer_hz;
+  pg->period = qf_period(timer_hz, pg->rate);
+  pg->send = send;
+  pg->send_sysex = send_sysex;
+}
+
+/**
+  * @brief  Stop and move to a frame, announced with a full frame message
+  */
+void MTC_Gen_Locate(MTC_GenTypeDef *pg, uint32_t frame)
+{
+  MTC_TimeTypeDef t;
+  uint8_t c = pg->cable;
+
+  pg->running = 0U;
+  pg->frame = frame % frames_per_day[pg->rate];
+  pg->piece = 0U;
+
+  MTC_FramesToTime(pg->frame, pg->rate, &t);
+  pg->send_sysex(MIDI_EVENT(c, MIDI_CIN_SYSEX_START, 0xF0U, 0x7FU, 0x7FU));
+  pg->send_sysex(MIDI_EVENT(c, MIDI_CIN_SYSEX_START, 0x01U, 0x01U,
+                            (uint32_t)(pg->rate << 5) | t.hours));
+  pg->send_sysex(MIDI_EVENT(c, MIDI_CIN_SYSEX_START, t.minutes, t.seconds, t.frames));
+  pg->send_sysex(MIDI_EVENT(c, MIDI_CIN_SYSEX_END_1, 0xF7U, 0U, 0U));
+}
+
+/**
+  * @brief  Run from the current frame, starting a new quarter frame cycle
+  */
+void MTC_Gen_Start(MTC_GenTypeDef *pg)
+{
+  pg->piece = 0U;
+  pg->running = 1U;
+}
+
+/**
+  * @brief  Stop sending quarter frames, the position is kept
+  */
+void MTC_Gen_Stop(MTC_GenTypeDef *pg)
+{
+  pg->running = 0U;
+}
+
+/**
+  * @brief  Align the phase accumulator on the timer before enabling the
+  *         compare interrupt
+  * @param  pg: generator instance
+  * @param  now: timer counter
+  * @retval first compare value
+  */
+uint32_t MTC_Gen_Begin(MTC_GenTypeDef *pg, uint32_t now)
+{
+  pg->next = (uint64_t)(now + MTC_MIN_LEAD) << 16;
+  return (uint32_t)(pg->next >> 16);
+}
+
+/**
+  * @brief  Emit a quarter frame if running. Call from the timer compare
+  *         interrupt.
+  * @param  pg: generator instance
+  * @param  now: timer counter at interrupt entry
+  * @retval next compare value
+  */
+uint32_t MTC_Gen_Tick(MTC_GenTypeDef *pg, uint32_t now)
+{
+  uint32_t late = now - (uint32_t)(pg->next >> 16);
+  uint32_t compare;
+
+  if (pg->running)
+  {
+    if (pg->piece == 0U)
+    {
+      split(pg);
+    }
+    pg->send(MIDI_EVENT(pg->cable, MIDI_CIN_SYSCOM_2, STATUS_QUARTER_FRAME,
+                        ((uint32_t)pg->piece << 4) | pg->nibble[pg->piece], 0U));
+    pg->piece = (pg->piece + 1U) & 0x07U;
+    if ((pg->piece & 0x03U) == 0U)
+    {
+      pg->frame = (pg->frame + 1U) % frames_per_day[pg->rate];
+    }
+
+    pg->stats.quarter_frames++;
+    pg->stats.late_sum += late;
+    if (late > pg->stats.late_max)
+    {
+      pg->stats.late_max = late;
+    }
+  }
+
+  if (late > (uint32_t)(pg->period >> 16))
+  {
+    /* stalled for more than a quarter frame: restart the phase from now */
+    pg->next = (uint64_t)now << 16;
+  }
+  pg->next += pg->period;
+  compare = (uint32_t)(pg->next >> 16);
+  if ((int32_t)(compare - now) < (int32_t)MTC_MIN_LEAD)
+  {
+    compare = now + MTC_MIN_LEAD;
+  }
+  return compare;
+}
+
+/**
+  * @brief  Initialize an unlocked chase engine
+  * @param  pc: chase instance
+  * @param  timer_hz: frequency of the timestamps given to MTC_Chase_Event()
+  * @retval None
+  */
+void MTC_Chase_Init(MTC_ChaseTypeDef *pc, uint32_t timer_hz)
+{
+  memset(pc, 0, sizeof(*pc));
+  pc->timer_hz = timer_hz;
+  pc->expect = 8U;
+  pc->period = qf_period(timer_hz, MTC_RATE_30);
+}
+
+/**
+  * @brief  Feed a received event; quarter frames and SysEx are looked at.
+  *         Call from a single context.
+  * @param  pc: chase instance
+  * @param  event: USB-MIDI event word
+  * @param  now: arrival timestamp
+  * @retval None
+  */
+void MTC_Chase_Event(MTC_ChaseTypeDef *pc, uint32_t event, uint32_t now)
+{
+  uint32_t cin = MIDI_EVENT_CIN(event);
+
+  if ((cin == MIDI_CIN_SYSCOM_2) && (MIDI_EVENT_STATUS(event) == STATUS_QUARTER_FRAME))
+  {
+    quarter_frame(pc, (uint8_t)MIDI_EVENT_DATA1(event), now);
+  }
+  else if ((cin >= MIDI_CIN_SYSEX_START) && (cin <= MIDI_CIN_SYSEX_END_3))
+  {
+    sysex_packet(pc, event, now);
+  }
+}
+
+/**
+  * @brief  Whether quarter frames are being followed
+  */
+uint8_t MTC_Chase_IsLocked(const MTC_ChaseTypeDef *pc, uint32_t now)
+{
+  uint32_t seq, time, period;
+  int32_t age;
+  uint8_t locked;
+
+  do
+  {
+    seq = pc->seq;
+    time = pc->anchor_time;
+    period = pc->anchor_period;
+    locked = pc->locked;
+  } while ((seq & 1U) || (seq != pc->seq));
+
+  age = (int32_t)(now - time);
+  if (age < 0)
+  {
+    age = 0;
+  }
+  return locked && (((uint64_t)age << CHASE_PERIOD_FRAC) <
+                    (uint64_t)period * MTC_CHASE_TIMEOUT_QF);
+}
+
+/**
+  * @brief  Position extrapolated to a timestamp
+  * @param  pc: chase instance
+  * @param  now: timestamp, same timebase as the events
+  * @retval frames since 00:00:00:00 with 8 fractional bits; the position
+  *         holds at the next quarter frame if it is late, and does not move
+  *         while unlocked
+  */
+uint32_t MTC_Chase_GetPosition(const MTC_ChaseTypeDef *pc, uint32_t now)
+{
+  uint32_t seq, time, period, qf;
+  uint64_t frac = 0U;
+  uint8_t locked;
+
+  do
+  {
+    seq = pc->seq;
+    time = pc->anchor_time;
+    period = pc->anchor_period;
+    qf = pc->anchor_qf;
+    locked = pc->locked;
+  } while ((seq & 1U) || (seq != pc->seq));
+
+  if (locked && (period != 0U) && ((int32_t)(now - time) > 0))
+  {
+    /* 64 steps per quarter frame */
+    frac = ((uint64_t)(now - time) << (6U + CHASE_PERIOD_FRAC)) / period;
+    if (frac > 63U)
+    {
+      frac = 63U;
+    }
+  }
+  return qf * 64U + (uint32_t)frac;
+}
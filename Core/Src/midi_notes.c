@@ -0,0 +1,238 @@
+/**
+  ******************************************************************************
+  * @file           : midi_notes.c
+  * @brief          : Active-note tracker.
+  *                   Keeps one bit per cable/channel/note for the notes that
+  *                   are currently sounding, so panic handling, voice
+  *                   stealing and reconnect clean-up can release exactly the
+  *                   notes that are held.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "midi_notes.h"
+#include "mcu_port.h"
+
+/* Private define ------------------------------------------------------------*/
+#define CC_ALL_SOUND_OFF          120U
+#define CC_ALL_NOTES_OFF          123U
+
+/* Private macro -------------------------------------------------------------*/
+#define NOTE_WORD(n)              ((uint32_t)(n) >> 5)
+#define NOTE_MASK(n)              (0x80000000UL >> ((n) & 31U))
+
+/* Private functions ---------------------------------------------------------*/
+
+static void clear_channel(MIDI_NotesTypeDef *pn, uint8_t cable, uint8_t ch)
+{
+  uint32_t *w = pn->bits[cable][ch];
+
+  w[0] = 0U;
+  w[1] = 0U;
+  w[2] = 0U;
+  w[3] = 0U;
+  pn->chan_mask[cable] &= (uint16_t)~(1U << ch);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Forget every note on every cable
+  * @param  pn: tracker
+  * @retval None
+  */
+void MIDI_Notes_Reset(MIDI_NotesTypeDef *pn)
+{
+  memset(pn, 0, sizeof(*pn));
+}
+
+/**
+  * @brief  Mark a note as sounding
+  * @param  pn: tracker
+  * @param  cable: USB-MIDI cable number
+  * @param  ch: MIDI channel 0..15
+  * @param  note: note number 0..127
+  * @retval None
+  */
+void MIDI_Notes_Set(MIDI_NotesTypeDef *pn, uint8_t cable, uint8_t ch, uint8_t note)
+{
+  pn->bits[cable][ch][NOTE_WORD(note)] |= NOTE_MASK(note);
+  pn->chan_mask[cable] |= (uint16_t)(1U << ch);
+}
+
+/**
+  * @brief  Mark a note as released
+  * @param  pn: tracker
+  * @param  cable: USB-MIDI cable number
+  * @param  ch: MIDI channel 0..15
+  * @param  note: note number 0..127
+  * @retval None
+  */
+void MIDI_Notes_Clear(MIDI_NotesTypeDef *pn, uint8_t cable, uint8_t ch, uint8_t note)
+{
+  uint32_t *w = pn->bits[cable][ch];
+
+  w[NOTE_WORD(note)] &= ~NOTE_MASK(note);
+  if ((w[0] | w[1] | w[2] | w[3]) == 0U)
+  {
+    pn->chan_mask[cable] &= (uint16_t)~(1U << ch);
+  }
+}
+
+/**
+  * @brief  Test whether a note is sounding
+  * @retval 1 if the note is on, 0 otherwise
+  */
+uint8_t MIDI_Notes_IsOn(const MIDI_NotesTypeDef *pn, uint8_t cable, uint8_t ch, uint8_t note)
+{
+  return (pn->bits[cable][ch][NOTE_WORD(note)] & NOTE_MASK(note)) ? 1U : 0U;
+}
+
+/**
+  * @brief  Apply a USB-MIDI event to the tracker.
+  *         Note on/off set and clear bits, All Notes Off and All Sound Off
+  *         clear the channel, everything else is ignored.
+  * @param  pn: tracker
+  * @param  event: event word as passed to USBMIDI_send()
+  * @retval None
+  */
+void MIDI_Notes_Update(MIDI_NotesTypeDef *pn, uint32_t event)
+{
+  uint8_t cable = (uint8_t)MIDI_EVENT_CABLE(event);
+  uint8_t ch = (uint8_t)MIDI_EVENT_CHANNEL_NUM(event);
+  uint8_t d1 = (uint8_t)(MIDI_EVENT_DATA1(event) & 0x7FU);
+
+  if (cable >= MIDI_NOTES_NUM_CABLES)
+  {
+    return;
+  }
+
+  switch (MIDI_EVENT_CIN(event))
+  {
+    case MIDI_CIN_NOTE_ON:
+      if (MIDI_EVENT_DATA2(event) != 0U)
+      {
+        MIDI_Notes_Set(pn, cable, ch, d1);
+        break;
+      }
+      /* Velocity 0 is a note off */
+      MIDI_Notes_Clear(pn, cable, ch, d1);
+      break;
+
+    case MIDI_CIN_NOTE_OFF:
+      MIDI_Notes_Clear(pn, cable, ch, d1);
+      break;
+
+    case MIDI_CIN_CONTROL_CHANGE:
+      if ((d1 == CC_ALL_NOTES_OFF) || (d1 == CC_ALL_SOUND_OFF))
+      {
+        clear_channel(pn, cable, ch);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+  * @brief  Number of notes sounding on one channel
+  * @retval note count
+  */
+uint32_t MIDI_Notes_Count(const MIDI_NotesTypeDef *pn, uint8_t cable, uint8_t ch)
+{
+  const uint32_t *w = pn->bits[cable][ch];
+
+  return MCU_PopCount(w[0]) + MCU_PopCount(w[1]) +
+         MCU_PopCount(w[2]) + MCU_PopCount(w[3]);
+}
+
+/**
+  * @brief  Number of notes sounding on all channels of a cable
+  * @retval note count
+  */
+uint32_t MIDI_Notes_CountAll(const MIDI_NotesTypeDef *pn, uint8_t cable)
+{
+  uint32_t mask = pn->chan_mask[cable];
+  uint32_t count = 0U;
+  uint32_t ch;
+
+  while (mask != 0U)
+  {
+    ch = 31U - MCU_CLZ(mask);
+    mask &= ~(1UL << ch);
+    count += MIDI_Notes_Count(pn, cable, (uint8_t)ch);
+  }
+  return count;
+}
+
+/**
+  * @brief  Find the lowest sounding note at or above a given note
+  * @param  from: first note number to consider
+  * @retval note number, or -1 if none
+  */
+int16_t MIDI_Notes_Next(const MIDI_NotesTypeDef *pn, uint8_t cable, uint8_t ch, uint8_t from)
+{
+  const uint32_t *w = pn->bits[cable][ch];
+  uint32_t idx = NOTE_WORD(from);
+  uint32_t word;
+
+  if (from >= MIDI_NUM_NOTES)
+  {
+    return -1;
+  }
+
+  /* Mask off the notes below 'from' in the first word */
+  word = w[idx] & (0xFFFFFFFFUL >> (from & 31U));
+  for (;;)
+  {
+    if (word != 0U)
+    {
+      return (int16_t)((idx << 5) + MCU_CLZ(word));
+    }
+    if (++idx >= MIDI_NOTES_WORDS)
+    {
+      return -1;
+    }
+    word = w[idx];
+  }
+}
+
+/**
+  * @brief  Emit a note off for every sounding note of a cable and clear them.
+  *         Only channels flagged in chan_mask are visited and each word is
+  *         consumed bit by bit with CLZ, so the cost is proportional to the
+  *         number of held notes rather than to 16 x 128.
+  * @param  pn: tracker
+  * @param  cable: USB-MIDI cable number
+  * @param  emit: called once per generated note off event
+  * @retval number of note off events emitted
+  */
+uint32_t MIDI_Notes_Flush(MIDI_NotesTypeDef *pn, uint8_t cable, MIDI_NotesEmitTypeDef emit)
+{
+  uint32_t mask = pn->chan_mask[cable];
+  uint32_t count = 0U;
+  uint32_t ch, i, word, bit;
+
+  pn->chan_mask[cable] = 0U;
+  while (mask != 0U)
+  {
+    ch = 31U - MCU_CLZ(mask);
+    mask &= ~(1UL << ch);
+
+    for (i = 0U; i < MIDI_NOTES_WORDS; i++)
+    {
+      word = pn->bits[cable][ch][i];
+      pn->bits[cable][ch][i] = 0U;
+      while (word != 0U)
+      {
+        bit = MCU_CLZ(word);
+        word &= ~(0x80000000UL >> bit);
+        emit(MIDI_EVENT(cable, MIDI_CIN_NOTE_OFF, 0x80U | ch, (i << 5) + bit, 0U));
+        count++;
+      }
+    }
+  }
+  return count;
+}
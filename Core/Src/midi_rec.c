@@ -0,0 +1,577 @@
+/**
+  ******************************************************************************
+  * @file           : midi_rec.c
+  * @brief          : Compact RAM recorder of the USB-MIDI traffic.
+  *
+  *                   Capture only stamps the event word with the cycle
+  *                   counter and queues it: one queue for thread mode and
+  *                   one for the interrupts, which share a priority, so each
+  *                   queue has a single producer and no lock is needed.
+  *
+  *                   MIDI_Rec_Process() merges the two queues in stamp order
+  *                   and stores the events directly as SMF track data:
+  *                   variable length delta times and running status, which
+  *                   is 3 bytes for a typical note or controller instead of
+  *                   a 4 byte stamp plus the 4 byte event word. SysEx is
+  *                   gathered into pieces of MIDI_REC_SYSEX_CHUNK bytes,
+  *                   other system messages use the F7 escape, and the cable
+  *                   is a port prefix meta event written on change only.
+  *
+  *                   The buffer fills linearly, like a tape: when it is full
+  *                   further events are counted and dropped, so the exported
+  *                   file always starts at the beginning of the take.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "midi_rec.h"
+#include "mcu_port.h"
+
+/* Private define ------------------------------------------------------------*/
+#define QUEUE_MASK                (MIDI_REC_QUEUE_LEN - 1U)
+#define NO_CABLE                  0xFFU
+#define SMF_DIVISION              (500000U / MIDI_REC_TICK_US)
+#define SMF_HEADER_LEN            14U
+#define SMF_CHUNK_LEN             8U
+#define SMF_EOT_LEN               4U
+#define EXPORT_ID                 0x7DU   /* non-commercial manufacturer ID */
+
+#if ((MIDI_REC_QUEUE_LEN & QUEUE_MASK) != 0U)
+#error "MIDI_REC_QUEUE_LEN must be a power of two"
+#endif
+#if ((500000U % MIDI_REC_TICK_US) != 0U) || (SMF_DIVISION > 0x7FFFU)
+#error "MIDI_REC_TICK_US must divide 500000 into at most 0x7FFF ticks"
+#endif
+#if (MIDI_REC_SYSEX_CHUNK < 3U) || (MIDI_REC_SYSEX_CHUNK > 127U)
+#error "MIDI_REC_SYSEX_CHUNK must be 3 to 127 bytes"
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+static const uint8_t smf_eot[SMF_EOT_LEN] = { 0x00U, 0xFFU, 0x2FU, 0x00U };
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint8_t put_vlq(uint8_t *p, uint32_t v)
+{
+  uint8_t n = 0U, i;
+  uint8_t tmp[5];
+
+  do
+  {
+    tmp[n++] = (uint8_t)(v & 0x7FU);
+    v >>= 7;
+  } while (v != 0U);
+  for (i = 0U; i < n; i++)
+  {
+    p[i] = tmp[n - 1U - i] | ((i < (n - 1U)) ? 0x80U : 0U);
+  }
+  return n;
+}
+
+static void put_be32(uint8_t *p, uint32_t v)
+{
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
+
+/* Append one SMF event: channel messages take running status, F0 and F7
+   are followed by the length of data[]; 0 when the buffer is full */
+static uint8_t put_event(MIDI_RecTrackTypeDef *pt, uint32_t tick, uint8_t cable,
+                         uint8_t status, const uint8_t *data, uint8_t len)
+{
+  uint8_t head[16];
+  uint8_t n = 0U;
+  uint32_t delta = ((int32_t)(tick - pt->tick) > 0) ? (tick - pt->tick) : 0U;
+
+  if (cable != pt->cable)
+  {
+    n += put_vlq(&head[n], delta);
+    head[n++] = 0xFFU;
+    head[n++] = 0x21U;
+    head[n++] = 0x01U;
+    head[n++] = cable;
+    delta = 0U;
+    pt->status = 0U;  /* meta events cancel running status */
+  }
+  n += put_vlq(&head[n], delta);
+  if (status < 0xF0U)
+  {
+    if (status != pt->status)
+    {
+      head[n++] = status;
+    }
+  }
+  else
+  {
+    head[n++] = status;
+    head[n++] = len;
+  }
+
+  if ((pt->size - pt->len) < ((uint32_t)n + len))
+  {
+    pt->stats.truncated++;
+    return 0U;
+  }
+  memcpy(&pt->buf[pt->len], head, n);
+  memcpy(&pt->buf[pt->len + n], data, len);
+  pt->len += (uint32_t)n + len;
+  pt->cable = cable;
+  pt->status = (status < 0xF0U) ? status : 0U;
+  if ((int32_t)(tick - pt->tick) > 0)
+  {
+    pt->tick = tick;
+  }
+  return 1U;
+}
+
+/* Store the gathered SysEx bytes; the first piece of a message keeps F0 as
+   its status, the following ones are F7 continuations */
+static void sx_flush(MIDI_RecTrackTypeDef *pt)
+{
+  if (pt->sx_len == 0U)
+  {
+    return;
+  }
+  if (pt->sx[0] == 0xF0U)
+  {
+    (void)put_event(pt, pt->sx_tick, pt->sx_cable, 0xF0U, &pt->sx[1], pt->sx_len - 1U);
+  }
+  else
+  {
+    (void)put_event(pt, pt->sx_tick, pt->sx_cable, 0xF7U, pt->sx, pt->sx_len);
+  }
+  pt->sx_len = 0U;
+}
+
+static void sx_append(MIDI_RecTrackTypeDef *pt, uint32_t tick, uint8_t cable,
+                      const uint8_t *data, uint8_t len)
+{
+  if ((pt->sx_cable != cable) || (data[0] == 0xF0U) ||
+      ((pt->sx_len + len) > MIDI_REC_SYSEX_CHUNK))
+  {
+    sx_flush(pt);
+  }
+  if (pt->sx_len == 0U)
+  {
+    pt->sx_tick = tick;
+  }
+  pt->sx_cable = cable;
+  memcpy(&pt->sx[pt->sx_len], data, len);
+  pt->sx_len += len;
+}
+
+static void store(MIDI_RecorderTypeDef *pr, MIDI_RecTrackTypeDef *pt, uint32_t event, uint32_t tick)
+{
+  uint8_t cable = (uint8_t)MIDI_EVENT_CABLE(event);
+  uint8_t cin = (uint8_t)MIDI_EVENT_CIN(event);
+  uint8_t b[3];
+  uint8_t len;
+
+  b[0] = (uint8_t)MIDI_EVENT_STATUS(event);
+  b[1] = (uint8_t)MIDI_EVENT_DATA1(event);
+  b[2] = (uint8_t)MIDI_EVENT_DATA2(event);
+
+  switch (cin)
+  {
+    case MIDI_CIN_SYSEX_START:
+      sx_append(pt, tick, cable, b, 3U);
+      pt->stats.events++;
+      return;
+
+    case MIDI_CIN_SYSEX_END_1:
+    case MIDI_CIN_SYSEX_END_2:
+    case MIDI_CIN_SYSEX_END_3:
+      if ((cin != MIDI_CIN_SYSEX_END_1) || (b[0] == 0xF7U))
+      {
+        sx_append(pt, tick, cable, b, (uint8_t)(cin - MIDI_CIN_SYSEX_END_1 + 1U));
+        sx_flush(pt);
+        pt->sx_cable = NO_CABLE;
+        pt->stats.events++;
+        return;
+      }
+      len = 1U;   /* single byte system common */
+      break;
+
+    case MIDI_CIN_SYSCOM_2:
+      len = 2U;
+      break;
+
+    case MIDI_CIN_SYSCOM_3:
+      len = 3U;
+      break;
+
+    case MIDI_CIN_SINGLE_BYTE:
+      if (((b[0] == 0xF8U) && (pr->filter & MIDI_REC_SKIP_CLOCK)) ||
+          ((b[0] == 0xFEU) && (pr->filter & MIDI_REC_SKIP_SENSE)))
+      {
+        return;
+      }
+      len = 1U;
+      break;
+
+    case MIDI_CIN_MISC:
+    case MIDI_CIN_CABLE_EVENT:
+      return;
+
+    default:
+      /* channel message, SysEx pieces pending on this cable go first */
+      if (pt->sx_cable == cable)
+      {
+        sx_flush(pt);
+      }
+      if (put_event(pt, tick, cable, b[0], &b[1],
+                    (cin == MIDI_CIN_PROGRAM_CHANGE) || (cin == MIDI_CIN_CHANNEL_PRESSURE) ? 1U : 2U))
+      {
+        pt->stats.events++;
+      }
+      return;
+  }
+
+  /* system common and real-time, as F7 escapes; real-time may interleave
+     with SysEx, so the gathered part is stored ahead of it */
+  sx_flush(pt);
+  if (put_event(pt, tick, cable, 0xF7U, b, len))
+  {
+    pt->stats.events++;
+  }
+}
+
+static uint32_t stamp_to_tick(const MIDI_RecorderTypeDef *pr, uint32_t stamp)
+{
+  uint32_t d = stamp - pr->base_cycles;
+
+  if ((int32_t)d < 0)
+  {
+    d = 0U;
+  }
+  return pr->base_tick + d / pr->cycles_per_tick;
+}
+
+static void drain(MIDI_RecorderTypeDef *pr, MIDI_RecTrackTypeDef *pt)
+{
+  MIDI_RecQueueTypeDef *pq;
+  MIDI_RecEntryTypeDef *pa, *pb;
+  uint32_t n, t0, dt;
+
+  for (n = 0U; n < (2U * MIDI_REC_QUEUE_LEN); n++)
+  {
+    pa = (pt->q_thread.rp != pt->q_thread.wp) ? &pt->q_thread.entry[pt->q_thread.rp & QUEUE_MASK] : NULL;
+    pb = (pt->q_isr.rp != pt->q_isr.wp) ? &pt->q_isr.entry[pt->q_isr.rp & QUEUE_MASK] : NULL;
+    if ((pa == NULL) && (pb == NULL))
+    {
+      break;
+    }
+    if ((pa == NULL) || ((pb != NULL) && ((int32_t)(pb->stamp - pa->stamp) < 0)))
+    {
+      pa = pb;
+      pq = &pt->q_isr;
+    }
+    else
+    {
+      pq = &pt->q_thread;
+    }
+
+    t0 = MCU_CYCLES();
+    store(pr, pt, pa->event, stamp_to_tick(pr, pa->stamp));
+    dt = MCU_CYCLES() - t0;
+    pq->rp++;
+
+    pr->stats.encode_cycles_sum += dt;
+    if (dt > pr->stats.encode_cycles_max)
+    {
+      pr->stats.encode_cycles_max = dt;
+    }
+  }
+  pt->stats.bytes = pt->len;
+}
+
+/* Copy the part of [src, src + seg_len) that falls in the requested window,
+   seg_base being the file offset of src */
+static void read_seg(const uint8_t *src, uint32_t seg_len, uint32_t *seg_base,
+                     uint32_t offset, uint8_t *dst, uint32_t len, uint32_t *done)
+{
+  uint32_t at = offset + *done;
+  uint32_t n;
+
+  if ((*done < len) && (at >= *seg_base) && (at < (*seg_base + seg_len)))
+  {
+    n = *seg_base + seg_len - at;
+    if (n > (len - *done))
+    {
+      n = len - *done;
+    }
+    memcpy(&dst[*done], &src[at - *seg_base], n);
+    *done += n;
+  }
+  *seg_base += seg_len;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Set up a recorder; the buffer is shared evenly by the tracks
+  * @param  pr: recorder instance
+  * @param  buf: storage for the SMF track data
+  * @param  size: size of buf in bytes
+  * @param  cpu_hz: rate of MCU_CYCLES()
+  * @retval None
+  */
+void MIDI_Rec_Init(MIDI_RecorderTypeDef *pr, uint8_t *buf, uint32_t size, uint32_t cpu_hz)
+{
+  uint8_t i;
+
+  memset(pr, 0, sizeof(*pr));
+  for (i = 0U; i < MIDI_REC_TRACKS; i++)
+  {
+    pr->track[i].buf = buf + i * (size / MIDI_REC_TRACKS);
+    pr->track[i].size = size / MIDI_REC_TRACKS;
+    pr->track[i].cable = NO_CABLE;
+    pr->track[i].sx_cable = NO_CABLE;
+  }
+  pr->cycles_per_tick = (uint32_t)(((uint64_t)cpu_hz * MIDI_REC_TICK_US) / 1000000U);
+  if (pr->cycles_per_tick == 0U)
+  {
+    pr->cycles_per_tick = 1U;
+  }
+  pr->filter = MIDI_REC_SKIP_CLOCK | MIDI_REC_SKIP_SENSE;
+}
+
+/**
+  * @brief  Start a new take, discarding the previous one
+  */
+void MIDI_Rec_Start(MIDI_RecorderTypeDef *pr)
+{
+  MIDI_RecTrackTypeDef *pt;
+  uint8_t i;
+
+  pr->recording = 0U;
+  pr->exporting = 0U;
+  for (i = 0U; i < MIDI_REC_TRACKS; i++)
+  {
+    pt = &pr->track[i];
+    pt->q_thread.rp = pt->q_thread.wp;
+    pt->q_isr.rp = pt->q_isr.wp;
+    pt->len = 0U;
+    pt->tick = 0U;
+    pt->status = 0U;
+    pt->cable = NO_CABLE;
+    pt->sx_len = 0U;
+    pt->sx_cable = NO_CABLE;
+    memset(&pt->stats, 0, sizeof(pt->stats));
+  }
+  memset(&pr->stats, 0, sizeof(pr->stats));
+  pr->base_cycles = MCU_CYCLES();
+  pr->base_tick = 0U;
+  pr->recording = 1U;
+}
+
+/**
+  * @brief  End the take, storing what is still queued
+  */
+void MIDI_Rec_Stop(MIDI_RecorderTypeDef *pr)
+{
+  uint8_t i;
+
+  if (!pr->recording)
+  {
+    return;
+  }
+  MIDI_Rec_Process(pr);
+  pr->recording = 0U;
+  for (i = 0U; i < MIDI_REC_TRACKS; i++)
+  {
+    drain(pr, &pr->track[i]);
+    sx_flush(&pr->track[i]);
+    pr->track[i].stats.bytes = pr->track[i].len;
+  }
+}
+
+/**
+  * @brief  Record an event. Callable from thread mode and from interrupts
+  *         of one priority level.
+  * @param  pr: recorder instance
+  * @param  track: MIDI_REC_OUT or MIDI_REC_IN
+  * @param  event: USB-MIDI event word
+  * @retval None
+  */
+void MIDI_Rec_Capture(MIDI_RecorderTypeDef *pr, uint8_t track, uint32_t event)
+{
+  uint32_t stamp = MCU_CYCLES();
+  MIDI_RecTrackTypeDef *pt = &pr->track[track % MIDI_REC_TRACKS];
+  MIDI_RecQueueTypeDef *pq = MCU_IN_ISR() ? &pt->q_isr : &pt->q_thread;
+  MIDI_RecEntryTypeDef *pe;
+  uint32_t dt;
+
+  if (!pr->recording)
+  {
+    return;
+  }
+  if ((uint16_t)(pq->wp - pq->rp) >= MIDI_REC_QUEUE_LEN)
+  {
+    pt->stats.overflows++;
+    return;
+  }
+  pe = &pq->entry[pq->wp & QUEUE_MASK];
+  pe->event = event;
+  pe->stamp = stamp;
+  pq->wp++;
+
+  dt = MCU_CYCLES() - stamp;
+  if (dt > pr->stats.capture_cycles_max)
+  {
+    pr->stats.capture_cycles_max = dt;
+  }
+}
+
+/**
+  * @brief  Store the captured events, from the main loop. Must run at least
+  *         once per wrap of the cycle counter (10 s at 400 MHz).
+  * @param  pr: recorder instance
+  * @retval None
+  */
+void MIDI_Rec_Process(MIDI_RecorderTypeDef *pr)
+{
+  uint32_t now = MCU_CYCLES();
+  uint32_t ticks;
+  uint8_t i;
+
+  if (!pr->recording)
+  {
+    return;
+  }
+  for (i = 0U; i < MIDI_REC_TRACKS; i++)
+  {
+    drain(pr, &pr->track[i]);
+  }
+  /* move the time base in whole ticks, so no rounding accumulates */
+  ticks = (now - pr->base_cycles) / pr->cycles_per_tick;
+  pr->base_tick += ticks;
+  pr->base_cycles += ticks * pr->cycles_per_tick;
+}
+
+/**
+  * @brief  Size of the take as a Standard MIDI File
+  */
+uint32_t MIDI_Rec_FileSize(const MIDI_RecorderTypeDef *pr)
+{
+  uint32_t size = SMF_HEADER_LEN;
+  uint8_t i;
+
+  for (i = 0U; i < MIDI_REC_TRACKS; i++)
+  {
+    size += SMF_CHUNK_LEN + pr->track[i].len + SMF_EOT_LEN;
+  }
+  return size;
+}
+
+/**
+  * @brief  Read part of the take as a format 1 Standard MIDI File, one track
+  *         per direction. The file is assembled on the fly, so any
+  *         transport can pull it in pieces of its own size.
+  * @param  pr: recorder instance, stopped
+  * @param  offset: file offset of the first byte
+  * @param  dst: destination
+  * @param  len: bytes wanted
+  * @retval bytes copied, less than len at the end of the file
+  */
+uint32_t MIDI_Rec_Read(const MIDI_RecorderTypeDef *pr, uint32_t offset, uint8_t *dst, uint32_t len)
+{
+  uint8_t hdr[SMF_HEADER_LEN] = { 'M', 'T', 'h', 'd', 0U, 0U, 0U, 6U,
+                                  0U, 1U, 0U, MIDI_REC_TRACKS,
+                                  (uint8_t)(SMF_DIVISION >> 8), (uint8_t)SMF_DIVISION };
+  uint8_t chunk[SMF_CHUNK_LEN] = { 'M', 'T', 'r', 'k' };
+  uint32_t base = 0U, done = 0U;
+  uint8_t i;
+
+  read_seg(hdr, SMF_HEADER_LEN, &base, offset, dst, len, &done);
+  for (i = 0U; i < MIDI_REC_TRACKS; i++)
+  {
+    put_be32(&chunk[4], pr->track[i].len + SMF_EOT_LEN);
+    read_seg(chunk, SMF_CHUNK_LEN, &base, offset, dst, len, &done);
+    read_seg(pr->track[i].buf, pr->track[i].len, &base, offset, dst, len, &done);
+    read_seg(smf_eot, SMF_EOT_LEN, &base, offset, dst, len, &done);
+  }
+  return done;
+}
+
+/**
+  * @brief  Stop recording and rewind the SysEx export
+  */
+void MIDI_Rec_ExportStart(MIDI_RecorderTypeDef *pr)
+{
+  MIDI_Rec_Stop(pr);
+  pr->export_offset = 0U;
+  pr->export_block = 0U;
+  pr->exporting = 1U;
+}
+
+/**
+  * @brief  Send the next block of the file as SysEx:
+  *         F0 7D <block, 2 x 7 bits> <data, 7 bytes packed in 8> F7.
+  *         A block shorter than MIDI_REC_EXPORT_BLOCK bytes is the last one.
+  * @param  pr: recorder instance
+  * @param  cable: USB-MIDI cable of the export
+  * @param  send: output of the packets
+  * @param  room: packets the output can take now
+  * @retval 1 while the export is running
+  */
+uint8_t MIDI_Rec_ExportSysEx(MIDI_RecorderTypeDef *pr, uint8_t cable,
+                             MIDI_RecSendTypeDef send, uint32_t room)
+{
+  uint8_t raw[MIDI_REC_EXPORT_BLOCK];
+  uint8_t msg[5U + MIDI_REC_EXPORT_BLOCK + MIDI_REC_EXPORT_BLOCK / 7U];
+  uint32_t len, n = 0U, i, j, rest;
+  uint8_t *msb;
+
+  if (!pr->exporting)
+  {
+    return 0U;
+  }
+  if (room < ((sizeof(msg) + 2U) / 3U))
+  {
+    return 1U;
+  }
+
+  len = MIDI_Rec_Read(pr, pr->export_offset, raw, MIDI_REC_EXPORT_BLOCK);
+  msg[n++] = 0xF0U;
+  msg[n++] = EXPORT_ID;
+  msg[n++] = (uint8_t)((pr->export_block >> 7) & 0x7FU);
+  msg[n++] = (uint8_t)(pr->export_block & 0x7FU);
+  for (i = 0U; i < len; i += 7U)
+  {
+    msb = &msg[n++];
+    *msb = 0U;
+    for (j = 0U; (j < 7U) && ((i + j) < len); j++)
+    {
+      *msb |= (uint8_t)((raw[i + j] >> 7) << j);
+      msg[n++] = raw[i + j] & 0x7FU;
+    }
+  }
+  msg[n++] = 0xF7U;
+
+  cable &= 0x0FU;
+  for (i = 0U; i < n; i += 3U)
+  {
+    rest = n - i;
+    if (rest > 3U)
+    {
+      send(MIDI_EVENT(cable, MIDI_CIN_SYSEX_START, msg[i], msg[i + 1U], msg[i + 2U]));
+    }
+    else
+    {
+      send(MIDI_EVENT(cable, MIDI_CIN_SYSEX_END_1 + rest - 1U, msg[i],
+                      (rest > 1U) ? msg[i + 1U] : 0U, (rest > 2U) ? msg[i + 2U] : 0U));
+    }
+  }
+
+  pr->export_offset += len;
+  pr->export_block++;
+  if (len < MIDI_REC_EXPORT_BLOCK)
+  {
+    pr->exporting = 0U;
+  }
+  return pr->exporting;
+}
@@ -0,0 +1,224 @@
+/**
+  ******************************************************************************
+  * @file           : midi_route.c
+  * @brief          : Routing matrix between USB cables and internal ports.
+  *
+  *                   Routes are edited as a list of (source, destination,
+  *                   channel filter, type filter) entries, at most one per
+  *                   source/destination pair. MIDI_Route_Compile() folds the
+  *                   list into two bitmap tables per source port:
+  *                     type_dst[cin]  destinations accepting that CIN
+  *                     chan_dst[ch]   destinations accepting that channel
+  *                   Because a pair has a single route, the AND of the two
+  *                   words is exactly the set of destinations for an event,
+  *                   so a lookup is two loads whatever the number of routes.
+  *
+  *                   Tables are double buffered and swapped with a single
+  *                   pointer store, so routes can be recompiled while events
+  *                   are flowing.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "midi_route.h"
+#include "mcu_port.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t type_dst[16];
+  uint32_t chan_dst[MIDI_NUM_CHANNELS];
+} MIDI_RouteSrcTypeDef;
+
+typedef struct
+{
+  MIDI_RouteSrcTypeDef src[MIDI_ROUTE_NUM_PORTS];
+} MIDI_RouteTableTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define NO_ROUTE                  0xFFU
+
+/* Private variables ---------------------------------------------------------*/
+static MIDI_RouteTypeDef routes[MIDI_ROUTE_MAX];
+static uint8_t route_count;
+static MIDI_RouteTableTypeDef tables[2];
+static MIDI_RouteTableTypeDef * volatile active;
+static MIDI_RouteSinkTypeDef sinks[MIDI_ROUTE_NUM_PORTS];
+
+MIDI_RouteStatsTypeDef MIDI_RouteStats;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint8_t find_route(uint8_t src, uint8_t dst)
+{
+  uint8_t i;
+
+  for (i = 0U; i < route_count; i++)
+  {
+    if ((routes[i].src == src) && (routes[i].dst == dst))
+    {
+      return i;
+    }
+  }
+  return NO_ROUTE;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Drop all routes and sinks
+  * @retval None
+  */
+void MIDI_Route_Init(void)
+{
+  route_count = 0U;
+  memset(tables, 0, sizeof(tables));
+  memset(sinks, 0, sizeof(sinks));
+  memset(&MIDI_RouteStats, 0, sizeof(MIDI_RouteStats));
+  active = &tables[0];
+}
+
+/**
+  * @brief  Add a route, or replace the filters of an existing one.
+  *         Takes effect at the next MIDI_Route_Compile().
+  * @param  src: source port
+  * @param  dst: destination port
+  * @param  channels: MIDI_ROUTE_CH() mask, applied to channel voice messages
+  * @param  types: MIDI_ROUTE_TYPE() mask
+  * @retval 0 on success, -1 if the port is invalid or the route list is full
+  */
+int8_t MIDI_Route_Add(uint8_t src, uint8_t dst, uint16_t channels, uint16_t types)
+{
+  uint8_t i;
+
+  if ((src >= MIDI_ROUTE_NUM_PORTS) || (dst >= MIDI_ROUTE_NUM_PORTS))
+  {
+    return -1;
+  }
+
+  i = find_route(src, dst);
+  if (i == NO_ROUTE)
+  {
+    if (route_count >= MIDI_ROUTE_MAX)
+    {
+      return -1;
+    }
+    i = route_count++;
+  }
+
+  routes[i].src = src;
+  routes[i].dst = dst;
+  routes[i].channels = channels;
+  routes[i].types = types;
+  return 0;
+}
+
+/**
+  * @brief  Remove the route between two ports, if any.
+  *         Takes effect at the next MIDI_Route_Compile().
+  */
+void MIDI_Route_Remove(uint8_t src, uint8_t dst)
+{
+  uint8_t i = find_route(src, dst);
+
+  if (i != NO_ROUTE)
+  {
+    routes[i] = routes[--route_count];
+  }
+}
+
+/**
+  * @brief  Build the lookup tables from the route list and make them live.
+  *         Call from thread context only.
+  * @retval None
+  */
+void MIDI_Route_Compile(void)
+{
+  MIDI_RouteTableTypeDef *pt = (active == &tables[0]) ? &tables[1] : &tables[0];
+  MIDI_RouteSrcTypeDef *ps;
+  uint32_t bit, k;
+  uint8_t i;
+
+  memset(pt, 0, sizeof(*pt));
+  for (i = 0U; i < route_count; i++)
+  {
+    ps = &pt->src[routes[i].src];
+    bit = 1UL << routes[i].dst;
+    for (k = 0U; k < 16U; k++)
+    {
+      if (routes[i].types & (1U << k))
+      {
+        ps->type_dst[k] |= bit;
+      }
+      if (routes[i].channels & (1U << k))
+      {
+        ps->chan_dst[k] |= bit;
+      }
+    }
+  }
+
+  active = pt;
+}
+
+/**
+  * @brief  Register the output function of a destination port
+  */
+void MIDI_Route_SetSink(uint8_t port, MIDI_RouteSinkTypeDef sink)
+{
+  if (port < MIDI_ROUTE_NUM_PORTS)
+  {
+    sinks[port] = sink;
+  }
+}
+
+/**
+  * @brief  Destinations of an event
+  * @param  src: source port
+  * @param  event: USB-MIDI event word
+  * @retval bitmask of destination ports
+  */
+uint32_t MIDI_Route_Lookup(uint8_t src, uint32_t event)
+{
+  const MIDI_RouteSrcTypeDef *ps = &active->src[src & (MIDI_ROUTE_NUM_PORTS - 1U)];
+  uint32_t cin = MIDI_EVENT_CIN(event);
+  uint32_t dst = ps->type_dst[cin];
+
+  if ((cin >= MIDI_CIN_NOTE_OFF) && (cin <= MIDI_CIN_PITCH_BEND))
+  {
+    dst &= ps->chan_dst[MIDI_EVENT_CHANNEL_NUM(event)];
+  }
+  return dst;
+}
+
+/**
+  * @brief  Deliver an event to every destination routed from its source
+  * @param  src: source port
+  * @param  event: USB-MIDI event word
+  * @retval None
+  */
+void MIDI_Route_Process(uint8_t src, uint32_t event)
+{
+  uint32_t t0 = MCU_CYCLES();
+  uint32_t dst = MIDI_Route_Lookup(src, event);
+  uint32_t dt = MCU_CYCLES() - t0;
+  uint32_t port;
+
+  MIDI_RouteStats.events++;
+  MIDI_RouteStats.cycles_sum += dt;
+  if (dt > MIDI_RouteStats.cycles_max)
+  {
+    MIDI_RouteStats.cycles_max = dt;
+  }
+
+  while (dst != 0U)
+  {
+    port = 31U - MCU_CLZ(dst);
+    dst &= ~(1UL << port);
+    if (sinks[port] != NULL)
+    {
+      sinks[port]((uint8_t)port, event);
+      MIDI_RouteStats.deliveries++;
+    }
+  }
+}
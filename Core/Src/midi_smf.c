@@ -0,0 +1,448 @@
+/**
+  ******************************************************************************
+  * @file           : midi_smf.c
+  * @brief          : Standard MIDI File player streaming from mapped memory.
+  *
+  *                   The file stays where it is (internal flash or QSPI in
+  *                   memory-mapped mode) and is read in place: a track is
+  *                   just a read pointer, its running status and the
+  *                   absolute tick of its next event, 16 bytes of RAM.
+  *                   Only the delta time of the next event is decoded ahead.
+  *
+  *                   Tracks are merged with a binary min-heap keyed on
+  *                   (next tick, track index), so each event costs
+  *                   O(log tracks) and same-tick events keep track order;
+  *                   a tempo change in track 0 therefore lands before notes
+  *                   of other tracks at the same tick. Ticks become
+  *                   microseconds through the last tempo change, which is
+  *                   always in the past because events leave in tick order.
+  *
+  *                   A SysEx leaves a packet at a time against the budget
+  *                   of the caller and resumes where it stopped, so a long
+  *                   one never needs more room than the output has.
+  *
+  *                   Every read is bounds checked; a malformed track simply
+  *                   ends.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "midi_smf.h"
+#include "mcu_port.h"
+
+/* Private define ------------------------------------------------------------*/
+#define META_END_OF_TRACK         0x2FU
+#define META_TEMPO                0x51U
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t be32(const uint8_t *p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint8_t read_vlq(const uint8_t **pp, const uint8_t *end, uint32_t *value)
+{
+  const uint8_t *p = *pp;
+  uint32_t v = 0U;
+  uint8_t i;
+
+  for (i = 0U; i < 4U; i++)
+  {
+    if (p >= end)
+    {
+      return 0U;
+    }
+    v = (v << 7) | (*p & 0x7FU);
+    if ((*p++ & 0x80U) == 0U)
+    {
+      *pp = p;
+      *value = v;
+      return 1U;
+    }
+  }
+  return 0U;
+}
+
+static uint8_t earlier(const SMF_PlayerTypeDef *pp, uint8_t a, uint8_t b)
+{
+  uint32_t ta = pp->track[a].tick, tb = pp->track[b].tick;
+
+  return (ta < tb) || ((ta == tb) && (a < b));
+}
+
+static void sift_up(SMF_PlayerTypeDef *pp, uint8_t i)
+{
+  uint8_t parent, t = pp->heap[i];
+
+  while (i > 0U)
+  {
+    parent = (uint8_t)((i - 1U) >> 1);
+    if (!earlier(pp, t, pp->heap[parent]))
+    {
+      break;
+    }
+    pp->heap[i] = pp->heap[parent];
+    i = parent;
+  }
+  pp->heap[i] = t;
+}
+
+static void sift_down(SMF_PlayerTypeDef *pp, uint8_t i)
+{
+  uint8_t child, t = pp->heap[i];
+
+  for (;;)
+  {
+    child = (uint8_t)(2U * i + 1U);
+    if (child >= pp->heap_len)
+    {
+      break;
+    }
+    if (((child + 1U) < pp->heap_len) && earlier(pp, pp->heap[child + 1U], pp->heap[child]))
+    {
+      child++;
+    }
+    if (!earlier(pp, pp->heap[child], t))
+    {
+      break;
+    }
+    pp->heap[i] = pp->heap[child];
+    i = child;
+  }
+  pp->heap[i] = t;
+}
+
+static uint32_t tick_to_us(const SMF_PlayerTypeDef *pp, uint32_t tick)
+{
+  return pp->us_base +
+         (uint32_t)(((uint64_t)(tick - pp->tick_base) * pp->tempo) / pp->division);
+}
+
+/* Decode the delta time of the next event; 0 when the track is over */
+static uint8_t advance(SMF_TrackTypeDef *pt)
+{
+  uint32_t delta;
+
+  if (!read_vlq(&pt->p, pt->end, &delta))
+  {
+    return 0U;
+  }
+  pt->tick += delta;
+  return 1U;
+}
+
+/* Output packets of the pending SysEx bytes while the budget lasts */
+static void sysex_out(SMF_PlayerTypeDef *pp, uint32_t *budget)
+{
+  const uint8_t *data = pp->sysex_p;
+  uint8_t buf[3];
+  uint8_t n = pp->carry_len;
+
+  buf[0] = pp->carry[0];
+  buf[1] = pp->carry[1];
+  while ((data < pp->sysex_end) && (*budget > 0U))
+  {
+    buf[n++] = *data;
+    if (*data++ == 0xF7U)
+    {
+      pp->send(MIDI_EVENT(pp->cable, MIDI_CIN_SYSEX_END_1 + n - 1U, buf[0],
+                          (n > 1U) ? buf[1] : 0U, (n > 2U) ? buf[2] : 0U));
+      n = 0U;
+      (*budget)--;
+    }
+    else if (n == 3U)
+    {
+      pp->send(MIDI_EVENT(pp->cable, MIDI_CIN_SYSEX_START, buf[0], buf[1], buf[2]));
+      n = 0U;
+      (*budget)--;
+    }
+  }
+  pp->carry_len = n;
+  pp->carry[0] = buf[0];
+  pp->carry[1] = buf[1];
+  pp->sysex_p = (data < pp->sysex_end) ? data : NULL;
+}
+
+/* Output the event at pt->p, or the rest of a SysEx the budget cut short;
+   0 when the track is over or malformed */
+static uint8_t play_event(SMF_PlayerTypeDef *pp, SMF_TrackTypeDef *pt, uint32_t *budget)
+{
+  const uint8_t *p = pt->p;
+  uint32_t len, tick;
+  uint8_t status, type, d1, d2 = 0U;
+
+  if (pp->sysex_p != NULL)
+  {
+    sysex_out(pp, budget);
+    return 1U;
+  }
+  if (p >= pt->end)
+  {
+    return 0U;
+  }
+  status = *p;
+  if (status & 0x80U)
+  {
+    p++;
+  }
+  else
+  {
+    status = pt->status;  /* running status */
+  }
+
+  if (status < 0xF0U)
+  {
+    if ((status < 0x80U) || (p >= pt->end))
+    {
+      return 0U;
+    }
+    d1 = *p++;
+    if (((status & 0xE0U) != 0xC0U))
+    {
+      if (p >= pt->end)
+      {
+        return 0U;
+      }
+      d2 = *p++;
+    }
+    pt->status = status;
+    pt->p = p;
+    pp->send(MIDI_EVENT_CHANNEL(pp->cable, status, d1 & 0x7FU, d2 & 0x7FU));
+    (*budget)--;
+    return 1U;
+  }
+
+  pt->status = 0U;
+  if (status == 0xFFU)
+  {
+    if (p >= pt->end)
+    {
+      return 0U;
+    }
+    type = *p++;
+    if (!read_vlq(&p, pt->end, &len) || (len > (uint32_t)(pt->end - p)))
+    {
+      return 0U;
+    }
+    if (type == META_END_OF_TRACK)
+    {
+      return 0U;
+    }
+    if ((type == META_TEMPO) && (len == 3U) && !pp->smpte)
+    {
+      tick = pt->tick;
+      pp->us_base = tick_to_us(pp, tick);
+      pp->tick_base = tick;
+      pp->tempo = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+      if (pp->tempo == 0U)
+      {
+        pp->tempo = SMF_TEMPO_DEFAULT;
+      }
+    }
+    pt->p = p + len;
+    (*budget)--;
+    return 1U;
+  }
+
+  if ((status == 0xF0U) || (status == 0xF7U))
+  {
+    if (!read_vlq(&p, pt->end, &len) || (len > (uint32_t)(pt->end - p)))
+    {
+      return 0U;
+    }
+    if (status == 0xF0U)
+    {
+      pp->carry_len = 1U;
+      pp->carry[0] = status;
+    }
+    pp->sysex_p = p;
+    pp->sysex_end = p + len;
+    pt->p = p + len;
+    sysex_out(pp, budget);
+    return 1U;
+  }
+
+  return 0U;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Check a mapped SMF image and index its tracks
+  * @param  pp: player instance
+  * @param  image: start of the file, read in place until SMF_Stop()
+  * @param  size: file size in bytes
+  * @param  cable: USB-MIDI cable of the output
+  * @param  send: output of the events
+  * @retval 0 on success, -1 if the image is not a usable SMF
+  */
+int8_t SMF_Open(SMF_PlayerTypeDef *pp, const uint8_t *image, uint32_t size,
+                uint8_t cable, SMF_SendTypeDef send)
+{
+  const uint8_t *p, *end = image + size;
+  uint32_t len, division;
+  uint16_t ntracks, i;
+  int8_t fps;
+
+  memset(pp, 0, sizeof(*pp));
+  if ((size < 14U) || (memcmp(image, "MThd", 4) != 0) || (be32(image + 4) < 6U) ||
+      (be32(image + 4) > size - 8U))
+  {
+    return -1;
+  }
+  ntracks = (uint16_t)((image[10] << 8) | image[11]);
+  division = (uint32_t)((image[12] << 8) | image[13]);
+  if ((division & 0x8000U) != 0U)
+  {
+    /* SMPTE: -frames per second, ticks per frame */
+    fps = (int8_t)image[12];
+    pp->smpte = 1U;
+    pp->division = (uint32_t)((fps == -29) ? 2997 : (-fps * 100)) * (division & 0xFFU);
+    pp->tempo = 100000000UL;
+  }
+  else
+  {
+    pp->division = division;
+    pp->tempo = SMF_TEMPO_DEFAULT;
+  }
+  if (pp->division == 0U)
+  {
+    return -1;
+  }
+
+  p = image + 8 + be32(image + 4);
+  for (i = 0U; (i < ntracks) && (pp->tracks < SMF_MAX_TRACKS); i++)
+  {
+    if ((uint32_t)(end - p) < 8U)
+    {
+      break;
+    }
+    len = be32(p + 4);
+    if (len > (uint32_t)(end - (p + 8)))
+    {
+      len = (uint32_t)(end - (p + 8));
+    }
+    if (memcmp(p, "MTrk", 4) == 0)
+    {
+      pp->track[pp->tracks].p = p + 8;
+      pp->track[pp->tracks].end = p + 8 + len;
+      pp->tracks++;
+    }
+    p += 8 + len;
+  }
+  if (pp->tracks == 0U)
+  {
+    return -1;
+  }
+
+  pp->image = image;
+  pp->size = size;
+  pp->cable = cable & 0x0FU;
+  pp->send = send;
+  return 0;
+}
+
+/**
+  * @brief  Play from the beginning
+  * @param  pp: player instance, opened
+  * @param  now_us: current time in microseconds
+  * @retval None
+  */
+void SMF_Start(SMF_PlayerTypeDef *pp, uint32_t now_us)
+{
+  const uint8_t *image = pp->image;
+  uint8_t i;
+
+  if (image == NULL)
+  {
+    return;
+  }
+  /* rewind every track to its first event */
+  if (SMF_Open(pp, image, pp->size, pp->cable, pp->send) != 0)
+  {
+    return;
+  }
+  for (i = 0U; i < pp->tracks; i++)
+  {
+    if (advance(&pp->track[i]))
+    {
+      pp->heap[pp->heap_len++] = i;
+      sift_up(pp, (uint8_t)(pp->heap_len - 1U));
+    }
+  }
+  pp->start_us = now_us;
+  pp->playing = (pp->heap_len > 0U) ? 1U : 0U;
+}
+
+/**
+  * @brief  Stop playing; notes left sounding are the caller's to release
+  */
+void SMF_Stop(SMF_PlayerTypeDef *pp)
+{
+  pp->playing = 0U;
+  pp->heap_len = 0U;
+  pp->sysex_p = NULL;
+}
+
+/**
+  * @brief  Output every event that is due
+  * @param  pp: player instance
+  * @param  now_us: current time in microseconds
+  * @param  budget: most USB-MIDI packets to output in this call; a meta
+  *         event counts as one. A SysEx that does not fit goes on at the
+  *         next call.
+  * @retval budget used
+  */
+uint32_t SMF_Process(SMF_PlayerTypeDef *pp, uint32_t now_us, uint32_t budget)
+{
+  SMF_TrackTypeDef *pt;
+  uint32_t elapsed = now_us - pp->start_us;
+  uint32_t left = budget, due, t0, dt;
+
+  while (pp->playing && (left > 0U))
+  {
+    pt = &pp->track[pp->heap[0]];
+    due = tick_to_us(pp, pt->tick);
+    if ((int32_t)(elapsed - due) < 0)
+    {
+      break;
+    }
+
+    t0 = MCU_CYCLES();
+    if (!play_event(pp, pt, &left) || ((pp->sysex_p == NULL) && !advance(pt)))
+    {
+      pp->heap[0] = pp->heap[--pp->heap_len];
+      if (pp->heap_len > 0U)
+      {
+        sift_down(pp, 0U);
+      }
+      else
+      {
+        pp->playing = 0U;
+      }
+    }
+    else if (pp->sysex_p == NULL)
+    {
+      sift_down(pp, 0U);
+    }
+    /* else out of budget inside a SysEx: the track stays on top */
+    dt = MCU_CYCLES() - t0;
+
+    if (pp->sysex_p == NULL)
+    {
+      pp->stats.events++;
+    }
+    pp->stats.cycles_sum += dt;
+    if (dt > pp->stats.cycles_max)
+    {
+      pp->stats.cycles_max = dt;
+    }
+    if ((elapsed - due) > pp->stats.late_max)
+    {
+      pp->stats.late_max = elapsed - due;
+    }
+  }
+  return budget - left;
+}
@@ -0,0 +1,265 @@
+/**
+  ******************************************************************************
+  * @file           : midi_stream.c
+  * @brief          : Conversion between USB-MIDI event words and the raw
+  *                   MIDI 1.0 byte stream, with running status.
+  *
+  *                   USB-MIDI spends four bytes on every event: a 3-byte
+  *                   channel message goes out as 4, a 2-byte one as 4, and
+  *                   SysEx carries 3 payload bytes per 4. The raw stream
+  *                   sends only the MIDI bytes and leaves out a channel
+  *                   status equal to the previous one, so a bulk dump is
+  *                   about 25% smaller and a run of notes or controllers
+  *                   on one channel close to half.
+  *
+  *                   The encoder is the only one to know what the far end
+  *                   takes as running status: its bytes must reach the wire
+  *                   in order and completely, or the encoder be reset with
+  *                   the receiver. The parser handles everything a MIDI 1.0
+  *                   stream may contain, including real time bytes inside
+  *                   a message or a SysEx; one stream is one cable.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "midi_stream.h"
+
+/* Private variables ---------------------------------------------------------*/
+
+/* MIDI bytes carried by each code index number; cable events and the
+   reserved CIN 0 have no byte stream form */
+static const uint8_t cin_len[16] =
+{
+  0U, 0U, 2U, 3U, 3U, 1U, 2U, 3U, 3U, 3U, 3U, 3U, 2U, 2U, 3U, 1U
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/* Output the SysEx bytes in buf: a continuation packet, or the last one
+   when they end with F7 */
+static void sysex_out(MIDI_StreamParserTypeDef *pp)
+{
+  uint8_t len = pp->len;
+  uint8_t cin = MIDI_CIN_SYSEX_START;
+
+  if (pp->buf[len - 1U] == 0xF7U)
+  {
+    cin = (uint8_t)(MIDI_CIN_SYSEX_END_1 + len - 1U);
+    pp->sysex = 0U;
+  }
+  pp->send(MIDI_EVENT(pp->cable, cin, pp->buf[0],
+                      (len > 1U) ? pp->buf[1] : 0U, (len > 2U) ? pp->buf[2] : 0U));
+  pp->stats.events++;
+  pp->len = 0U;
+}
+
+static void status_in(MIDI_StreamParserTypeDef *pp, uint8_t c)
+{
+  if (pp->sysex)
+  {
+    pp->buf[pp->len++] = 0xF7U;
+    pp->stats.sysex_bytes++;
+    if (c != 0xF7U)
+    {
+      /* any other status ends the SysEx; the F7 is supplied */
+      pp->stats.errors++;
+    }
+    sysex_out(pp);
+    if (c == 0xF7U)
+    {
+      return;
+    }
+  }
+  pp->len = 0U;
+
+  if (c < 0xF0U)
+  {
+    pp->status = c;
+    pp->need = ((c & 0xE0U) == 0xC0U) ? 1U : 2U;
+    return;
+  }
+
+  pp->status = 0U;
+  switch (c)
+  {
+    case 0xF0U:
+      pp->sysex = 1U;
+      pp->buf[0] = c;
+      pp->len = 1U;
+      pp->stats.sysex_bytes++;
+      break;
+
+    case 0xF1U:
+    case 0xF3U:
+      pp->status = c;
+      pp->need = 1U;
+      break;
+
+    case 0xF2U:
+      pp->status = c;
+      pp->need = 2U;
+      break;
+
+    case 0xF6U:
+      pp->send(MIDI_EVENT(pp->cable, MIDI_CIN_SYSEX_END_1, c, 0U, 0U));
+      pp->stats.events++;
+      break;
+
+    default:
+      /* F4, F5, and F7 outside of a SysEx */
+      pp->stats.errors++;
+      break;
+  }
+}
+
+static void data_in(MIDI_StreamParserTypeDef *pp, uint8_t c)
+{
+  uint8_t status = pp->status;
+  uint8_t d2;
+
+  if (pp->sysex)
+  {
+    pp->buf[pp->len++] = c;
+    pp->stats.sysex_bytes++;
+    if (pp->len == 3U)
+    {
+      sysex_out(pp);
+    }
+    return;
+  }
+  if (status == 0U)
+  {
+    pp->stats.errors++;
+    return;
+  }
+
+  pp->buf[pp->len++] = c;
+  if (pp->len < pp->need)
+  {
+    return;
+  }
+  d2 = (pp->need == 2U) ? pp->buf[1] : 0U;
+  if (status < 0xF0U)
+  {
+    pp->send(MIDI_EVENT_CHANNEL(pp->cable, status, pp->buf[0], d2));
+  }
+  else
+  {
+    /* system common messages do not set running status */
+    pp->send(MIDI_EVENT(pp->cable, (pp->need == 1U) ? MIDI_CIN_SYSCOM_2 : MIDI_CIN_SYSCOM_3,
+                        status, pp->buf[0], d2));
+    pp->status = 0U;
+  }
+  pp->stats.events++;
+  pp->len = 0U;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Reset an encoder, the next channel message is sent with its status
+  * @param  pe: encoder instance
+  * @retval None
+  */
+void MIDI_Stream_EncInit(MIDI_StreamEncTypeDef *pe)
+{
+  memset(pe, 0, sizeof(*pe));
+}
+
+/**
+  * @brief  Encode one event for the byte stream
+  * @param  pe: encoder instance
+  * @param  event: USB-MIDI event, the cable is ignored
+  * @param  out: room for MIDI_STREAM_MAX_BYTES
+  * @retval Number of bytes written to out, 0 for events without a byte form
+  */
+uint8_t MIDI_Stream_Encode(MIDI_StreamEncTypeDef *pe, uint32_t event, uint8_t *out)
+{
+  uint8_t cin = (uint8_t)MIDI_EVENT_CIN(event);
+  uint8_t len = cin_len[cin];
+  uint8_t b[MIDI_STREAM_MAX_BYTES];
+  uint8_t i, first = 0U;
+
+  if (len == 0U)
+  {
+    return 0U;
+  }
+  b[0] = (uint8_t)MIDI_EVENT_STATUS(event);
+  b[1] = (uint8_t)MIDI_EVENT_DATA1(event);
+  b[2] = (uint8_t)MIDI_EVENT_DATA2(event);
+
+  if ((cin >= MIDI_CIN_NOTE_OFF) && (cin <= MIDI_CIN_PITCH_BEND))
+  {
+    if (b[0] == pe->status)
+    {
+      first = 1U;
+      pe->elided++;
+    }
+    pe->status = b[0];
+  }
+  else
+  {
+    /* system common and SysEx cancel running status, real time does not */
+    for (i = 0U; i < len; i++)
+    {
+      if ((b[i] >= 0x80U) && (b[i] < 0xF8U))
+      {
+        pe->status = 0U;
+      }
+    }
+  }
+
+  for (i = first; i < len; i++)
+  {
+    *out++ = b[i];
+  }
+  pe->events++;
+  pe->bytes += (uint32_t)(len - first);
+  return (uint8_t)(len - first);
+}
+
+/**
+  * @brief  Reset a parser
+  * @param  pp: parser instance
+  * @param  cable: USB-MIDI cable given to the events
+  * @param  send: output of the events
+  * @retval None
+  */
+void MIDI_Stream_ParseInit(MIDI_StreamParserTypeDef *pp, uint8_t cable, MIDI_StreamSendTypeDef send)
+{
+  memset(pp, 0, sizeof(*pp));
+  pp->cable = cable;
+  pp->send = send;
+}
+
+/**
+  * @brief  Turn stream bytes into events; messages may span calls
+  * @param  pp: parser instance
+  * @param  buf: stream bytes
+  * @param  len: number of bytes
+  * @retval None
+  */
+void MIDI_Stream_Parse(MIDI_StreamParserTypeDef *pp, const uint8_t *buf, uint32_t len)
+{
+  uint8_t c;
+
+  while (len--)
+  {
+    c = *buf++;
+    if (c >= 0xF8U)
+    {
+      /* real time bytes may sit anywhere and leave the rest untouched */
+      pp->send(MIDI_EVENT(pp->cable, MIDI_CIN_SINGLE_BYTE, c, 0U, 0U));
+      pp->stats.events++;
+    }
+    else if (c & 0x80U)
+    {
+      status_in(pp, c);
+    }
+    else
+    {
+      data_in(pp, c);
+    }
+  }
+}
@@ -0,0 +1,167 @@
+/**
+  ******************************************************************************
+  * @file           : midi_xform.c
+  * @brief          : Table driven velocity curves, note maps and channel maps.
+  *
+  *                   All the arithmetic of a transform lives in its tables,
+  *                   so MIDI_Xform_Apply() costs at most three byte loads
+  *                   per channel voice event. Presets swap table pointers;
+  *                   note offs sent after a note map change are mapped with
+  *                   the new table, so change note maps between phrases or
+  *                   flush the notes first.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "midi_xform.h"
+
+/* Private define ------------------------------------------------------------*/
+#define IDENTITY(x)               ((uint8_t)(x))
+#define VEL_SOFT(x)               MIDI_XFORM_EXP_VAL(x, MIDI_XFORM_EXP_SOFT)
+#define VEL_HARD(x)               MIDI_XFORM_EXP_VAL(x, MIDI_XFORM_EXP_HARD)
+
+/* Exported variables --------------------------------------------------------*/
+const uint8_t MIDI_XformIdentity[128] = { MIDI_XFORM_TABLE128(IDENTITY) };
+const uint8_t MIDI_XformVelSoft[128] = { MIDI_XFORM_TABLE128(VEL_SOFT) };
+const uint8_t MIDI_XformVelHard[128] = { MIDI_XFORM_TABLE128(VEL_HARD) };
+const uint8_t MIDI_XformChanIdentity[16] = { MIDI_XFORM_TABLE16(IDENTITY) };
+
+/* Private functions ---------------------------------------------------------*/
+
+static float exp_series(float x)
+{
+  float r = 1.0f;
+  uint32_t n;
+
+  for (n = 16U; n > 0U; n--)
+  {
+    r = 1.0f + x / (float)n * r;
+  }
+  return r;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Apply a transform to an event
+  * @param  px: tables to apply
+  * @param  event: USB-MIDI event word
+  * @retval transformed event, or MIDI_XFORM_DROP if the note map removed it
+  */
+uint32_t MIDI_Xform_Apply(const MIDI_XformTypeDef *px, uint32_t event)
+{
+  uint32_t cin = MIDI_EVENT_CIN(event);
+  /* data bytes come from the host as they are: keep the lookups in the
+     128-entry tables */
+  uint32_t d1 = MIDI_EVENT_DATA1(event) & 0x7FU;
+  uint32_t d2 = MIDI_EVENT_DATA2(event) & 0x7FU;
+  uint32_t ch;
+
+  if ((cin < MIDI_CIN_NOTE_OFF) || (cin > MIDI_CIN_PITCH_BEND))
+  {
+    return event;
+  }
+
+  ch = px->channel[MIDI_EVENT_CHANNEL_NUM(event)];
+  if (cin <= MIDI_CIN_POLY_PRESSURE)
+  {
+    d1 = px->note[d1];
+    if (d1 == MIDI_XFORM_NOTE_DROP)
+    {
+      return MIDI_XFORM_DROP;
+    }
+    if ((cin == MIDI_CIN_NOTE_ON) && (d2 != 0U))
+    {
+      d2 = px->velocity[d2];
+      /* a zero would turn the note on into a note off */
+      d2 += (d2 == 0U);
+    }
+  }
+
+  return (event & 0xFFF00000UL) | (ch << 16) | (d1 << 8) | d2;
+}
+
+/**
+  * @brief  Fill a velocity table with 127 * (e^(c*v/127) - 1) / (e^c - 1)
+  * @param  table: 128 entries
+  * @param  curve: curvature in [-4, 4], > 0 soft, < 0 hard, 0 linear
+  * @retval None
+  */
+void MIDI_Xform_BuildExp(uint8_t *table, float curve)
+{
+  float scale;
+  float v;
+  uint32_t i;
+
+  if ((curve > -0.01f) && (curve < 0.01f))
+  {
+    for (i = 0U; i < 128U; i++)
+    {
+      table[i] = (uint8_t)i;
+    }
+    return;
+  }
+
+  scale = 127.0f / (exp_series(curve) - 1.0f);
+  for (i = 0U; i < 128U; i++)
+  {
+    v = scale * (exp_series(curve * (float)i / 127.0f) - 1.0f) + 0.5f;
+    table[i] = MIDI_XFORM_CLAMP((int32_t)v);
+  }
+}
+
+/**
+  * @brief  Fill a table with a piecewise linear curve
+  * @param  table: 128 entries
+  * @param  points: count (x, y) pairs with increasing x; the first segment
+  *         is extended down to 0 and the last one up to 127
+  * @param  count: number of pairs, at least 1
+  * @retval None
+  */
+void MIDI_Xform_BuildBreakpoints(uint8_t *table, const uint8_t *points, uint8_t count)
+{
+  int32_t x0 = 0, y0 = points[1];
+  int32_t x1, y1;
+  uint32_t i, k = 0U;
+
+  for (i = 0U; i < 128U; i++)
+  {
+    while ((k < count) && ((int32_t)i > points[2U * k]))
+    {
+      x0 = points[2U * k];
+      y0 = points[2U * k + 1U];
+      k++;
+    }
+    if (k < count)
+    {
+      x1 = points[2U * k];
+      y1 = points[2U * k + 1U];
+    }
+    else
+    {
+      x1 = 127;
+      y1 = y0;
+    }
+    table[i] = (x1 == x0) ? MIDI_XFORM_CLAMP(y1) :
+               MIDI_XFORM_CLAMP(MIDI_XFORM_LERP((int32_t)i, x0, y0, x1, y1));
+  }
+}
+
+/**
+  * @brief  Fill a note map with a key range and a transposition
+  * @param  table: 128 entries
+  * @param  transpose: semitones added to every note in range
+  * @param  low: lowest note kept, before transposition
+  * @param  high: highest note kept, before transposition
+  * @retval None
+  */
+void MIDI_Xform_BuildNoteMap(uint8_t *table, int8_t transpose, uint8_t low, uint8_t high)
+{
+  uint32_t i;
+
+  for (i = 0U; i < 128U; i++)
+  {
+    table[i] = ((i < low) || (i > high)) ? MIDI_XFORM_NOTE_DROP :
+               MIDI_XFORM_TRANSPOSE_VAL((int32_t)i, transpose);
+  }
+}
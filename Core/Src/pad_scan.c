@@ -0,0 +1,567 @@
+/**
+  ******************************************************************************
+  * @file           : pad_scan.c
+  * @brief          : Strike detection on the marimba bar pickups.
+  *
+  *                   Input is a block of interleaved frames, one 16-bit
+  *                   sample per pad, as the ADC scan sequence leaves them in
+  *                   the DMA buffer. Each pad goes through three states:
+  *                   idle, where the resting level is tracked and the swing
+  *                   around it is compared to the pad threshold; scan, where
+  *                   the peak swing is held for scan_samples; and mask, where
+  *                   the bar rings out and is ignored for mask_samples. The
+  *                   note on leaves at the end of the scan window with a
+  *                   velocity from the peak, the note off at the end of the
+  *                   mask window. Back in idle, a strike must also clear
+  *                   a retrigger level that decays from the last peak, so
+  *                   the tail of the ringing bar does not strike again.
+  *
+  *                   Pads are scanned two at a time, one per 16-bit lane of
+  *                   a word, with the ARMv7E-M SIMD instructions behind the
+  *                   mcu_port.h lane helpers. The resting level and the
+  *                   retrigger decay are updated once per block.
+  *
+  *                   A strike on one bar also moves the pickups of its
+  *                   neighbours. The note events of a block are held until
+  *                   all pads are scanned, then sent in time order; a
+  *                   strike whose peak is at most the coupled share of a
+  *                   recent strike on another pad is dropped instead.
+  *
+  *                   Nothing here touches the hardware, so the same code
+  *                   runs on a host against recorded sample files.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "pad_scan.h"
+#include "midi_xform.h"
+#include "mcu_port.h"
+
+/* Private define ------------------------------------------------------------*/
+#define PAD_THRESHOLD_DEFAULT     1000U
+#define PAD_NOTE_DEFAULT          60U
+
+/* Frame index of a window end that is not pending */
+#define PAD_NEVER                 0x7FFFFFFF
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint16_t us_to_samples(uint32_t us, uint32_t sample_hz)
+{
+  uint32_t n = (uint32_t)(((uint64_t)us * sample_hz + 500000U) / 1000000U);
+
+  if (n == 0U)
+  {
+    n = 1U;
+  }
+  return (n > 0xFFFFU) ? 0xFFFFU : (uint16_t)n;
+}
+
+static uint8_t velocity(const PAD_ScannerTypeDef *ps, const PAD_ConfigTypeDef *pc, uint32_t peak)
+{
+  uint32_t d = ((peak < pc->full) ? peak : pc->full) - pc->threshold;
+  uint32_t v = (uint32_t)MCU_USAT((int32_t)(1U + ((d * pc->vel_scale) >> 16)), 7U);
+
+  v = ps->curve[v];
+  return (v != 0U) ? (uint8_t)v : 1U;
+}
+
+/* Lowest swing that starts a strike on an idle pad: above both the threshold
+   and the retrigger level. Kept below 0x8000 for the signed lane compare. */
+static uint32_t trigger(const PAD_ConfigTypeDef *pc, const PAD_StateTypeDef *st)
+{
+  uint32_t t = st->floor >> 16;
+
+  if (t < pc->threshold)
+  {
+    t = pc->threshold;
+  }
+  t++;
+  return (t > 0x7FFFU) ? 0x7FFFU : t;
+}
+
+/* Samples of two neighbouring pads as two signed lanes centred on mid-scale */
+static inline uint32_t load_pair(const uint16_t *x, uint32_t single)
+{
+  uint32_t w;
+
+  if (single != 0U)
+  {
+    w = *x;
+  }
+  else
+  {
+    memcpy(&w, x, sizeof(w));
+  }
+  return w ^ 0x80008000U;
+}
+
+static inline uint32_t lane_get(uint32_t w, uint32_t l)
+{
+  return (w >> (16U * l)) & 0xFFFFU;
+}
+
+static inline uint32_t lane_set(uint32_t w, uint32_t l, uint32_t v)
+{
+  return (w & ~(0xFFFFU << (16U * l))) | ((v & 0xFFFFU) << (16U * l));
+}
+
+/* Strongest coupled level from the strikes of the other pads that are still
+   recent at frame time, or still being scanned: a pad in watch mode may
+   finish its strike after the crosstalk it caused. The source pad goes to
+   *src, PAD_MAX_PADS if there is none. In calibration, the raw peak of the
+   strongest strike instead of the coupled level. */
+static uint32_t xtalk_level(const PAD_ScannerTypeDef *ps, uint8_t pad, uint32_t time, uint8_t *src)
+{
+  const PAD_StateTypeDef *sq;
+  uint32_t level = 0U, l, peak;
+  uint8_t q;
+
+  *src = PAD_MAX_PADS;
+  for (q = 0U; q < ps->pads; q++)
+  {
+    sq = &ps->st[q];
+    if (q == pad)
+    {
+      continue;
+    }
+    if (sq->state == PAD_SCAN)
+    {
+      peak = sq->peak;
+    }
+    else if ((time - sq->xt_time) <= ps->xt_samples)
+    {
+      peak = sq->xt_peak;
+    }
+    else
+    {
+      continue;
+    }
+    l = (ps->xt_calibrate != 0U) ? peak : ((peak * ps->xt[q][pad]) >> 8);
+    if (l > level)
+    {
+      level = l;
+      *src = q;
+    }
+  }
+  return level;
+}
+
+/* Send or drop one note event. A strike at or below the coupled level of a
+   recent neighbour is crosstalk: the pad goes back to idle with its
+   retrigger level at the dropped peak, so the rest of the coupled ringing
+   stays below it. */
+static void pending_send(PAD_ScannerTypeDef *ps, const PAD_PendingTypeDef *e)
+{
+  PAD_StateTypeDef *st = &ps->st[e->pad];
+  const PAD_ConfigTypeDef *pc = &ps->cfg[e->pad];
+  uint32_t level, c;
+  uint8_t src;
+
+  if (e->peak == 0U)
+  {
+    if (st->velocity != 0U)
+    {
+      ps->send(MIDI_EVENT_CHANNEL(ps->cable, 0x80U | ps->channel, pc->note, 0x40U));
+    }
+    return;
+  }
+
+  level = xtalk_level(ps, e->pad, e->time, &src);
+  /* half the source or more is a second strike, not crosstalk */
+  if ((ps->xt_calibrate != 0U) && ((2U * (uint32_t)e->peak) < level))
+  {
+    c = (((uint32_t)e->peak << 8) / level) * PAD_XTALK_MARGIN / 4U;
+    c = (c > 0xFFU) ? 0xFFU : c;
+    if (c > ps->xt[src][e->pad])
+    {
+      ps->xt[src][e->pad] = (uint8_t)c;
+    }
+  }
+  if (e->peak <= level)
+  {
+    st->velocity = 0U;
+    ps->stats.suppressed++;
+    if ((st->state == PAD_MASK) && (st->end == e->time))
+    {
+      st->state = PAD_IDLE;
+    }
+    return;
+  }
+
+  st->velocity = velocity(ps, pc, e->peak);
+  st->xt_peak = e->peak;
+  st->xt_time = e->time;
+  ps->send(MIDI_EVENT_CHANNEL(ps->cable, 0x90U | ps->channel, pc->note, st->velocity));
+  ps->stats.strikes++;
+}
+
+static void pending_push(PAD_ScannerTypeDef *ps, uint8_t pad, uint32_t time, uint16_t peak)
+{
+  PAD_PendingTypeDef *e;
+
+  if (ps->npend >= PAD_PENDING_LEN)
+  {
+    PAD_PendingTypeDef now = { time, peak, pad };
+
+    ps->stats.pending_full++;
+    pending_send(ps, &now);
+    return;
+  }
+  e = &ps->pend[ps->npend++];
+  e->time = time;
+  e->peak = peak;
+  e->pad = pad;
+}
+
+/* Time order; at the same frame note offs first, then strikes from the
+   strongest down, so that a source comes before its crosstalk */
+static uint8_t pending_before(const PAD_PendingTypeDef *a, const PAD_PendingTypeDef *b)
+{
+  if (a->time != b->time)
+  {
+    return ((int32_t)(a->time - b->time) < 0) ? 1U : 0U;
+  }
+  if (a->peak == 0U)
+  {
+    return (b->peak != 0U) ? 1U : 0U;
+  }
+  return ((b->peak != 0U) && (a->peak > b->peak)) ? 1U : 0U;
+}
+
+/* The pairs are scanned one after the other over the whole block, so the
+   events of a block only leave once they are all known, in time order */
+static void pending_flush(PAD_ScannerTypeDef *ps)
+{
+  PAD_PendingTypeDef e;
+  uint8_t i, j;
+
+  for (i = 1U; i < ps->npend; i++)
+  {
+    e = ps->pend[i];
+    for (j = i; (j > 0U) && (pending_before(&e, &ps->pend[j - 1U]) != 0U); j--)
+    {
+      ps->pend[j] = ps->pend[j - 1U];
+    }
+    ps->pend[j] = e;
+  }
+  for (i = 0U; i < ps->npend; i++)
+  {
+    pending_send(ps, &ps->pend[i]);
+  }
+  ps->npend = 0U;
+}
+
+/* Window ends of the two lanes: a strike starting, the end of a scan or the
+   end of a mask. Returns the frame of the next pending one. */
+static int32_t scan_event(PAD_ScannerTypeDef *ps, uint8_t pad, uint32_t lanes, int32_t f,
+                          uint32_t hit, uint32_t env, uint32_t *peak, uint32_t *trig,
+                          uint32_t *idle, uint32_t *quiet, int32_t *due)
+{
+  PAD_StateTypeDef *st;
+  uint32_t l, m;
+
+  for (l = 0U; l < lanes; l++)
+  {
+    st = &ps->st[pad + l];
+    m = 0xFFFFU << (16U * l);
+    if ((hit & m) != 0U)
+    {
+      st->state = PAD_SCAN;
+      *peak = lane_set(*peak, l, lane_get(env, l));
+      *idle &= ~m;
+      *quiet &= ~m;
+      due[l] = f + (int32_t)ps->scan_samples;
+    }
+    else if (due[l] == f)
+    {
+      if (st->state == PAD_SCAN)
+      {
+        st->peak = (uint16_t)lane_get(*peak, l);
+        st->floor = (uint32_t)st->peak << 16;
+        st->end = ps->frame + (uint32_t)f;
+        st->state = PAD_MASK;
+        due[l] = f + (int32_t)ps->mask_samples;
+        pending_push(ps, (uint8_t)(pad + l), st->end, st->peak);
+      }
+      else
+      {
+        pending_push(ps, (uint8_t)(pad + l), ps->frame + (uint32_t)f, 0U);
+        st->state = PAD_IDLE;
+        *trig = lane_set(*trig, l, trigger(&ps->cfg[pad + l], st));
+        *idle |= m;
+        due[l] = PAD_NEVER;
+      }
+    }
+  }
+  return (due[0] < due[1]) ? due[0] : due[1];
+}
+
+/* One or two pads, lane 0 at frames[pad] and lane 1 at frames[pad + 1]. The
+   per-sample work is branch free: the swing around the resting level, the
+   running peak and the threshold compare each take one SIMD operation for
+   both pads. Anything else happens at a crossing or a window end only.
+   A pair in watch mode only looks at every watch_step-th frame, and goes
+   back to every frame once a sample is past half its trigger level: the
+   ringing of a weak strike could otherwise alias the watch samples onto
+   its zero crossings for a few periods. */
+static inline void scan_pair(PAD_ScannerTypeDef *ps, uint8_t pad, const uint16_t *x,
+                             uint32_t n, uint32_t single)
+{
+  uint32_t lanes = (single != 0U) ? 1U : 2U;
+  uint32_t all = (single != 0U) ? 0x0000FFFFU : 0xFFFFFFFFU;
+  uint32_t base = 0U, peak = 0U, trig = 0x7FFF7FFFU, idle = 0U, quiet;
+  int32_t due[2] = { PAD_NEVER, PAD_NEVER };
+  int32_t sum[2] = { 0, 0 };
+  int32_t next, f, m = 0;
+  uint32_t l, w, env, hit, decay, step = 1U;
+  PAD_StateTypeDef *st;
+
+  for (l = 0U; l < lanes; l++)
+  {
+    st = &ps->st[pad + l];
+    base = lane_set(base, l, (uint32_t)((st->baseline >> 8) - 32768));
+    peak = lane_set(peak, l, st->peak);
+    if (st->state == PAD_IDLE)
+    {
+      trig = lane_set(trig, l, trigger(&ps->cfg[pad + l], st));
+      idle |= 0xFFFFU << (16U * l);
+    }
+    else
+    {
+      due[l] = (int32_t)st->count - 1;
+    }
+  }
+  quiet = idle;
+  next = (due[0] < due[1]) ? due[0] : due[1];
+
+  f = 0;
+  if (ps->st[pad].watch != 0U)
+  {
+    step = ps->watch_step;
+    f = ps->st[pad].skip;
+    x += (uint32_t)f * ps->pads;
+  }
+  for (; f < (int32_t)n; f += (int32_t)step, x += step * ps->pads)
+  {
+    w = load_pair(x, single);
+    env = MCU_ABS16(MCU_QSUB16(w, base));
+    peak = MCU_MAX16(env, peak);
+    hit = MCU_GE16(env, trig) & idle;
+    sum[0] += (int16_t)w;
+    sum[1] += (int32_t)w >> 16;
+    m++;
+    if ((hit != 0U) || (f == next))
+    {
+      next = scan_event(ps, pad, lanes, f, hit, env, &peak, &trig, &idle, &quiet, due);
+      step = 1U;
+    }
+    else if ((step > 1U) && ((MCU_GE16(env, (trig >> 1) & 0x7FFF7FFFU) & idle) != 0U))
+    {
+      step = 1U;
+    }
+  }
+  ps->stats.scanned += (uint32_t)m * lanes;
+
+  /* Watch mode once the pair was idle all block and the retrigger levels
+     of both pads are back down to their thresholds */
+  ps->st[pad].watch = ((ps->watch_step > 1U) && (quiet == all)) ? 1U : 0U;
+  for (l = 0U; l < lanes; l++)
+  {
+    st = &ps->st[pad + l];
+    st->peak = (uint16_t)lane_get(peak, l);
+    if (st->state != PAD_IDLE)
+    {
+      st->count = (uint16_t)(due[l] - (int32_t)n + 1);
+      continue;
+    }
+    decay = (st->floor >> PAD_RETRIGGER_SHIFT) * n;
+    st->floor = ((n < (1UL << PAD_RETRIGGER_SHIFT)) && (decay < st->floor)) ? (st->floor - decay) : 0U;
+    if ((st->floor >> 16) > ps->cfg[pad + l].threshold)
+    {
+      ps->st[pad].watch = 0U;
+    }
+    if (((quiet & (0xFFFFU << (16U * l))) == 0U) || (m == 0))
+    {
+      continue;
+    }
+    if (m < (1L << PAD_BASELINE_SHIFT))
+    {
+      st->baseline += (int32_t)((((int64_t)(sum[l] + 32768 * m) << 8) -
+                                 (int64_t)st->baseline * m) >> PAD_BASELINE_SHIFT);
+    }
+    else
+    {
+      st->baseline = (int32_t)(((int64_t)(sum[l] + 32768 * m) << 8) / m);
+    }
+  }
+  ps->st[pad].skip = (ps->st[pad].watch != 0U) ? (uint8_t)(f - (int32_t)n) : 0U;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Set up a scanner with default pads: notes from middle C upwards
+  * @param  ps: scanner instance
+  * @param  pads: samples per input frame, at most PAD_MAX_PADS
+  * @param  sample_hz: frames per second
+  * @param  cable: USB-MIDI cable of the notes
+  * @param  channel: MIDI channel of the notes, 0 to 15
+  * @param  send: output of the note events, called from PAD_Process()
+  * @retval None
+  */
+void PAD_Init(PAD_ScannerTypeDef *ps, uint8_t pads, uint32_t sample_hz,
+              uint8_t cable, uint8_t channel, PAD_SendTypeDef send)
+{
+  uint8_t i;
+
+  memset(ps, 0, sizeof(*ps));
+  ps->pads = (pads > PAD_MAX_PADS) ? PAD_MAX_PADS : pads;
+  ps->cable = cable & 0x0FU;
+  ps->channel = channel & 0x0FU;
+  ps->sample_hz = sample_hz;
+  ps->curve = MIDI_XformIdentity;
+  ps->send = send;
+  for (i = 0U; i < ps->pads; i++)
+  {
+    PAD_SetPad(ps, i, (uint8_t)(PAD_NOTE_DEFAULT + i), PAD_THRESHOLD_DEFAULT, PAD_FULL_SCALE);
+    ps->st[i].baseline = (int32_t)((PAD_FULL_SCALE + 1U) << 8);
+  }
+  PAD_SetTimes(ps, PAD_SCAN_US, PAD_MASK_US);
+  ps->xt_samples = us_to_samples(PAD_XTALK_US, sample_hz);
+  PAD_SetWatch(ps, PAD_WATCH_US);
+}
+
+/**
+  * @brief  Configure one pad
+  * @param  ps: scanner instance
+  * @param  pad: pad index
+  * @param  note: MIDI note of the bar
+  * @param  threshold: swing that starts a strike, counts
+  * @param  full: peak swing that gives velocity 127, above threshold
+  * @retval None
+  */
+void PAD_SetPad(PAD_ScannerTypeDef *ps, uint8_t pad, uint8_t note,
+                uint16_t threshold, uint16_t full)
+{
+  PAD_ConfigTypeDef *pc;
+
+  if (pad >= PAD_MAX_PADS)
+  {
+    return;
+  }
+  pc = &ps->cfg[pad];
+  pc->note = note & 0x7FU;
+  pc->threshold = threshold;
+  pc->full = (full > threshold) ? full : (uint16_t)(threshold + 1U);
+  pc->vel_scale = ((126UL << 16) + pc->full - pc->threshold - 1U) / (uint32_t)(pc->full - pc->threshold);
+}
+
+/**
+  * @brief  Set the peak search and retrigger mask windows
+  * @param  ps: scanner instance
+  * @param  scan_us: peak search after the threshold crossing
+  * @param  mask_us: lockout after the note on
+  * @retval None
+  */
+void PAD_SetTimes(PAD_ScannerTypeDef *ps, uint32_t scan_us, uint32_t mask_us)
+{
+  ps->scan_samples = us_to_samples(scan_us, ps->sample_hz);
+  ps->mask_samples = us_to_samples(mask_us, ps->sample_hz);
+}
+
+/**
+  * @brief  Set the sample spacing of the pads in watch mode
+  * @note   A pair of pads that is idle, and whose retrigger levels have
+  *         decayed to their thresholds, only looks at one frame every
+  *         watch_us. A strike is then seen at most watch_us late, after
+  *         which the pair is back to every frame until it settles again.
+  * @param  ps: scanner instance
+  * @param  watch_us: spacing of the watch samples, 0 to scan every frame
+  * @retval None
+  */
+void PAD_SetWatch(PAD_ScannerTypeDef *ps, uint32_t watch_us)
+{
+  uint16_t step = (watch_us != 0U) ? us_to_samples(watch_us, ps->sample_hz) : 1U;
+  uint8_t i;
+
+  ps->watch_step = (step > 0xFFU) ? 0xFFU : (uint8_t)step;
+  for (i = 0U; i < PAD_MAX_PADS; i++)
+  {
+    ps->st[i].watch = 0U;
+    ps->st[i].skip = 0U;
+  }
+}
+
+/**
+  * @brief  Set the crosstalk coupling between two pads
+  * @param  ps: scanner instance
+  * @param  src: struck pad
+  * @param  dst: pad that picks up part of its swing
+  * @param  coupling: share of the src peak that dst may see, 1/256 steps
+  * @retval None
+  */
+void PAD_XtalkSet(PAD_ScannerTypeDef *ps, uint8_t src, uint8_t dst, uint8_t coupling)
+{
+  if ((src < PAD_MAX_PADS) && (dst < PAD_MAX_PADS) && (src != dst))
+  {
+    ps->xt[src][dst] = coupling;
+  }
+}
+
+/**
+  * @brief  Learn the crosstalk couplings from the playing
+  * @note   While enabled, the bars are to be struck one at a time: a strike
+  *         that follows a stronger one on another pad within PAD_XTALK_US
+  *         is taken as crosstalk and dropped, and the coupling of the pair
+  *         raised to its peak ratio with a PAD_XTALK_MARGIN margin; a ratio
+  *         of one half or more is a second strike and is not learned.
+  *         Enabling starts from an empty matrix; disabling keeps what was
+  *         learned.
+  * @param  ps: scanner instance
+  * @param  enable: non-zero to learn
+  * @retval None
+  */
+void PAD_XtalkCalibrate(PAD_ScannerTypeDef *ps, uint8_t enable)
+{
+  if ((enable != 0U) && (ps->xt_calibrate == 0U))
+  {
+    memset(ps->xt, 0, sizeof(ps->xt));
+  }
+  ps->xt_calibrate = (enable != 0U) ? 1U : 0U;
+}
+
+/**
+  * @brief  Scan a block of samples, from the DMA half transfer interrupts
+  * @param  ps: scanner instance
+  * @param  frames: nframes frames of ps->pads samples each
+  * @param  nframes: frames in the block
+  * @retval None
+  */
+void PAD_Process(PAD_ScannerTypeDef *ps, const uint16_t *frames, uint32_t nframes)
+{
+  uint32_t t0 = MCU_CYCLES();
+  uint32_t dt;
+  uint8_t i;
+
+  for (i = 0U; (uint32_t)i + 1U < ps->pads; i += 2U)
+  {
+    scan_pair(ps, i, &frames[i], nframes, 0U);
+  }
+  if (i < ps->pads)
+  {
+    scan_pair(ps, i, &frames[i], nframes, 1U);
+  }
+  pending_flush(ps);
+  ps->frame += nframes;
+
+  dt = MCU_CYCLES() - t0;
+  ps->stats.samples += nframes;
+  ps->stats.blocks++;
+  ps->stats.cycles_sum += dt;
+  if (dt > ps->stats.cycles_max)
+  {
+    ps->stats.cycles_max = dt;
+  }
+}
@@ -0,0 +1,91 @@
+/**
+  ******************************************************************************
+  * @file    usbd_composite_builder.h
+  * @brief   Header for the usbd_composite_builder.c file: configuration
+  *          descriptor of a composite device, put together from the classes
+  *          registered with USBD_RegisterClassComposite().
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USBD_COMPOSITE_BUILDER_H__
+#define __USBD_COMPOSITE_BUILDER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include  "usbd_ioreq.h"
+
+#ifdef USE_USBD_COMPOSITE
+
+/** @addtogroup STM32_USB_DEVICE_LIBRARY
+  * @{
+  */
+
+/** @defgroup USBD_CMPSIT
+  * @brief Composite class builder
+  * @{
+  */
+
+/** @defgroup USBD_CMPSIT_Exported_Defines
+  * @{
+  */
+
+/* Room for the configuration descriptor of one speed: the classes that do
+   not fit are left out of the configuration */
+#ifndef USBD_CMPSIT_MAX_CONFDESC_SZ
+#define USBD_CMPSIT_MAX_CONFDESC_SZ                  300U
+#endif /* USBD_CMPSIT_MAX_CONFDESC_SZ */
+
+/* CDC ACM function: association, communication interface with its
+   functional descriptors and notification endpoint, data interface with
+   its two bulk endpoints */
+#define USBD_CMPSIT_CDC_DESC_SIZ                     66U
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CMPSIT_Exported_Variables
+  * @{
+  */
+
+/* Only the descriptor callbacks are set: requests and transfers go to the
+   registered classes themselves */
+extern USBD_ClassTypeDef USBD_CMPSIT;
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CMPSIT_Exported_Functions
+  * @{
+  */
+uint8_t  USBD_CMPSIT_AddClass(USBD_HandleTypeDef *pdev, USBD_ClassTypeDef *pclass,
+                              USBD_CompositeClassTypeDef class, uint8_t cfgidx);
+uint32_t USBD_CMPSIT_SetClassID(USBD_HandleTypeDef *pdev, USBD_CompositeClassTypeDef Class,
+                                uint32_t Instance);
+uint32_t USBD_CMPSIT_GetClassID(USBD_HandleTypeDef *pdev, USBD_CompositeClassTypeDef Class,
+                                uint32_t Instance);
+uint8_t  USBD_CMPST_ClearConfDesc(USBD_HandleTypeDef *pdev);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_USBD_COMPOSITE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* __USBD_COMPOSITE_BUILDER_H__ */
@@ -0,0 +1,529 @@
+/**
+  ******************************************************************************
+  * @file    usbd_composite_builder.c
+  * @brief   Configuration descriptor of a composite device.
+  *
+  *          Each class registered with USBD_RegisterClassComposite() is
+  *          appended to the configuration: it takes the next free interface
+  *          numbers and the endpoint addresses given at registration, in the
+  *          order of the class (MIDI: IN, OUT, then IN, OUT of the
+  *          second pair if USBD_MIDI_NUM_CABLES_2 is set; CDC: IN, OUT,
+  *          CMD). The
+  *          endpoint and interface tables of the class are filled for the
+  *          request and transfer routing of the core.
+  *
+  *          Supported classes: CLASS_TYPE_MIDI, CLASS_TYPE_CDC.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_composite_builder.h"
+
+#ifdef USE_USBD_COMPOSITE
+#include "usbd_midi.h"
+#include "usbd_cdc.h"
+
+/** @addtogroup STM32_USB_DEVICE_LIBRARY
+  * @{
+  */
+
+/** @defgroup USBD_CMPSIT
+  * @brief Composite class builder
+  * @{
+  */
+
+/** @defgroup USBD_CMPSIT_Private_Defines
+  * @{
+  */
+#if (USBD_SELF_POWERED == 1U)
+#define USBD_CMPSIT_CFG_ATTRIBUTES                   0xC0U  /* Self Powered */
+#else
+#define USBD_CMPSIT_CFG_ATTRIBUTES                   0x80U  /* Bus Powered */
+#endif /* USBD_SELF_POWERED */
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CMPSIT_Private_FunctionPrototypes
+  * @{
+  */
+static uint8_t *USBD_CMPSIT_GetFSCfgDesc(uint16_t *length);
+static uint8_t *USBD_CMPSIT_GetHSCfgDesc(uint16_t *length);
+static uint8_t *USBD_CMPSIT_GetOtherSpeedCfgDesc(uint16_t *length);
+static uint8_t *USBD_CMPSIT_GetDeviceQualifierDescriptor(uint16_t *length);
+static void USBD_CMPSIT_SetEp(USBD_CompositeElementTypeDef *pcls, uint8_t add,
+                              uint8_t type, uint16_t size);
+static void USBD_CMPSIT_FuncDesc(const USBD_CompositeElementTypeDef *pcls,
+                                 uint8_t *pdesc, uint8_t speed);
+static uint16_t USBD_CMPSIT_CDCDesc(uint8_t *pdesc, uint8_t if0, uint8_t in_ep,
+                                    uint8_t out_ep, uint8_t cmd_ep, uint16_t mps);
+static void USBD_CMPSIT_SetConfHeader(uint8_t *pdesc, uint16_t total, uint8_t num_if);
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CMPSIT_Private_Variables
+  * @{
+  */
+USBD_ClassTypeDef USBD_CMPSIT =
+{
+  NULL,                 /* Init */
+  NULL,                 /* DeInit */
+  NULL,                 /* Setup */
+  NULL,                 /* EP0_TxSent */
+  NULL,                 /* EP0_RxReady */
+  NULL,                 /* DataIn */
+  NULL,                 /* DataOut */
+  NULL,                 /* SOF */
+  NULL,
+  NULL,
+  USBD_CMPSIT_GetHSCfgDesc,
+  USBD_CMPSIT_GetFSCfgDesc,
+  USBD_CMPSIT_GetOtherSpeedCfgDesc,
+  USBD_CMPSIT_GetDeviceQualifierDescriptor,
+};
+
+/* Length of the configuration built so far, the same at both speeds */
+static uint16_t USBD_CMPSIT_CfgDescSz = 0U;
+
+/* The full speed image is also the other speed one of a high speed device:
+   the core rewrites the descriptor type when it serves it */
+__ALIGN_BEGIN static uint8_t USBD_CMPSIT_FSCfgDesc[USBD_CMPSIT_MAX_CONFDESC_SZ] __ALIGN_END;
+#ifdef USE_USB_HS
+__ALIGN_BEGIN static uint8_t USBD_CMPSIT_HSCfgDesc[USBD_CMPSIT_MAX_CONFDESC_SZ] __ALIGN_END;
+#endif /* USE_USB_HS */
+
+/* USB Standard Device Qualifier Descriptor: functions grouped by IAD */
+__ALIGN_BEGIN static uint8_t USBD_CMPSIT_DeviceQualifierDesc[USB_LEN_DEV_QUALIFIER_DESC] __ALIGN_END =
+{
+  USB_LEN_DEV_QUALIFIER_DESC,
+  USB_DESC_TYPE_DEVICE_QUALIFIER,
+  0x00,
+  0x02,
+  0xEF,                                     /* bDeviceClass: Miscellaneous */
+  0x02,                                     /* bDeviceSubClass: Common Class */
+  0x01,                                     /* bDeviceProtocol: Interface Association */
+  0x40,
+  0x01,
+  0x00,
+};
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CMPSIT_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  USBD_CMPSIT_AddClass
+  *         Append a registered class to the configuration descriptor and
+  *         fill its interface and endpoint tables
+  * @param  pdev: device instance, classId the slot of the class
+  * @param  pclass: class callbacks
+  * @param  class: type of the class
+  * @param  cfgidx: configuration index, unused: there is one configuration
+  * @retval status
+  */
+uint8_t USBD_CMPSIT_AddClass(USBD_HandleTypeDef *pdev, USBD_ClassTypeDef *pclass,
+                             USBD_CompositeClassTypeDef class, uint8_t cfgidx)
+{
+  USBD_CompositeElementTypeDef *pcls = &pdev->tclasslist[pdev->classId];
+  uint8_t *pep = pcls->EpAdd;
+  uint16_t size;
+  uint8_t if0 = 0U;
+
+  UNUSED(pclass);
+  UNUSED(cfgidx);
+
+  switch (class)
+  {
+    case CLASS_TYPE_MIDI:
+      size = (uint16_t)USB_MIDI_FUNC_DESC_SIZ;
+      break;
+
+    case CLASS_TYPE_CDC:
+      size = USBD_CMPSIT_CDC_DESC_SIZ;
+      break;
+
+    default:
+      return (uint8_t)USBD_FAIL;
+  }
+
+  if (pep == NULL)
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  if (USBD_CMPSIT_CfgDescSz == 0U)
+  {
+    USBD_CMPSIT_CfgDescSz = USB_LEN_CFG_DESC;
+  }
+
+  if (((uint32_t)USBD_CMPSIT_CfgDescSz + size) > USBD_CMPSIT_MAX_CONFDESC_SZ)
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  /* Interfaces are numbered in the order the classes were added */
+  for (uint32_t i = 0U; i < pdev->classId; i++)
+  {
+    if (pdev->tclasslist[i].Active == 1U)
+    {
+      if0 += (uint8_t)pdev->tclasslist[i].NumIf;
+    }
+  }
+
+  pcls->ClassType = class;
+  pcls->ClassId = pdev->classId;
+  pcls->NumEps = 0U;
+  pcls->NumIf = 2U;
+  pcls->Ifs[0] = if0;
+  pcls->Ifs[1] = if0 + 1U;
+
+  if (class == CLASS_TYPE_MIDI)
+  {
+    pcls->CurrPcktSze = MIDI_DATA_FS_MAX_PACKET_SIZE;
+    USBD_CMPSIT_SetEp(pcls, pep[0], USBD_EP_TYPE_BULK, MIDI_DATA_FS_MAX_PACKET_SIZE);
+    USBD_CMPSIT_SetEp(pcls, pep[1], USBD_EP_TYPE_BULK, MIDI_DATA_FS_MAX_PACKET_SIZE);
+#if (USBD_MIDI_NUM_PIPES > 1U)
+    USBD_CMPSIT_SetEp(pcls, pep[2], USBD_EP_TYPE_BULK, MIDI_DATA_FS_MAX_PACKET_SIZE);
+    USBD_CMPSIT_SetEp(pcls, pep[3], USBD_EP_TYPE_BULK, MIDI_DATA_FS_MAX_PACKET_SIZE);
+#endif /* USBD_MIDI_NUM_PIPES */
+  }
+  else
+  {
+    pcls->CurrPcktSze = CDC_DATA_FS_MAX_PACKET_SIZE;
+    USBD_CMPSIT_SetEp(pcls, pep[0], USBD_EP_TYPE_BULK, CDC_DATA_FS_MAX_PACKET_SIZE);
+    USBD_CMPSIT_SetEp(pcls, pep[1], USBD_EP_TYPE_BULK, CDC_DATA_FS_MAX_PACKET_SIZE);
+    USBD_CMPSIT_SetEp(pcls, pep[2], USBD_EP_TYPE_INTR, CDC_CMD_PACKET_SIZE);
+  }
+
+  USBD_CMPSIT_FuncDesc(pcls, &USBD_CMPSIT_FSCfgDesc[USBD_CMPSIT_CfgDescSz], USBD_SPEED_FULL);
+#ifdef USE_USB_HS
+  USBD_CMPSIT_FuncDesc(pcls, &USBD_CMPSIT_HSCfgDesc[USBD_CMPSIT_CfgDescSz], USBD_SPEED_HIGH);
+#endif /* USE_USB_HS */
+  USBD_CMPSIT_CfgDescSz += size;
+
+  USBD_CMPSIT_SetConfHeader(USBD_CMPSIT_FSCfgDesc, USBD_CMPSIT_CfgDescSz, if0 + 2U);
+#ifdef USE_USB_HS
+  USBD_CMPSIT_SetConfHeader(USBD_CMPSIT_HSCfgDesc, USBD_CMPSIT_CfgDescSz, if0 + 2U);
+#endif /* USE_USB_HS */
+
+  pcls->Active = 1U;
+
+  return (uint8_t)USBD_OK;
+}
+
+/**
+  * @brief  USBD_CMPSIT_SetClassID
+  *         Select an instance of a class, for the calls that work on
+  *         pdev->classId such as the RegisterInterface functions
+  * @param  pdev: device instance
+  * @param  Class: type of the class
+  * @param  Instance: 0 for the first class of that type, 1 for the next...
+  * @retval the class ID, 0xFF if there is no such instance
+  */
+uint32_t USBD_CMPSIT_SetClassID(USBD_HandleTypeDef *pdev, USBD_CompositeClassTypeDef Class,
+                                uint32_t Instance)
+{
+  uint32_t idx = USBD_CMPSIT_GetClassID(pdev, Class, Instance);
+
+  if (idx != 0xFFU)
+  {
+    pdev->classId = idx;
+  }
+
+  return idx;
+}
+
+/**
+  * @brief  USBD_CMPSIT_GetClassID
+  *         Find an instance of a class
+  * @param  pdev: device instance
+  * @param  Class: type of the class
+  * @param  Instance: 0 for the first class of that type, 1 for the next...
+  * @retval the class ID, 0xFF if there is no such instance
+  */
+uint32_t USBD_CMPSIT_GetClassID(USBD_HandleTypeDef *pdev, USBD_CompositeClassTypeDef Class,
+                                uint32_t Instance)
+{
+  uint32_t count = 0U;
+
+  for (uint32_t i = 0U; i < pdev->NumClasses; i++)
+  {
+    if ((pdev->tclasslist[i].Active == 1U) && (pdev->tclasslist[i].ClassType == Class))
+    {
+      if (count == Instance)
+      {
+        return i;
+      }
+      count++;
+    }
+  }
+
+  return 0xFFU;
+}
+
+/**
+  * @brief  USBD_CMPST_ClearConfDesc
+  *         Start the configuration over, once all classes are unregistered
+  * @param  pdev: device instance
+  * @retval status
+  */
+uint8_t USBD_CMPST_ClearConfDesc(USBD_HandleTypeDef *pdev)
+{
+  UNUSED(pdev);
+
+  USBD_CMPSIT_CfgDescSz = 0U;
+
+  return (uint8_t)USBD_OK;
+}
+
+/**
+  * @brief  USBD_CMPSIT_SetEp
+  *         Add an endpoint to the table of a class
+  * @param  pcls: class entry
+  * @param  add: endpoint address
+  * @param  type: USBD_EP_TYPE_BULK or USBD_EP_TYPE_INTR
+  * @param  size: packet size at full speed
+  * @retval None
+  */
+static void USBD_CMPSIT_SetEp(USBD_CompositeElementTypeDef *pcls, uint8_t add,
+                              uint8_t type, uint16_t size)
+{
+  USBD_EPTypeDef *pep = &pcls->Eps[pcls->NumEps];
+
+  pep->add = add;
+  pep->type = type;
+  pep->size = (uint8_t)size;
+  pep->is_used = 1U;
+
+  pcls->NumEps++;
+}
+
+/**
+  * @brief  USBD_CMPSIT_FuncDesc
+  *         Write the descriptors of a class at one speed
+  * @param  pcls: class entry, with its interfaces and endpoints set
+  * @param  pdesc: destination
+  * @param  speed: USBD_SPEED_FULL or USBD_SPEED_HIGH
+  * @retval None
+  */
+static void USBD_CMPSIT_FuncDesc(const USBD_CompositeElementTypeDef *pcls,
+                                 uint8_t *pdesc, uint8_t speed)
+{
+  if (pcls->ClassType == CLASS_TYPE_MIDI)
+  {
+    (void)USBD_MIDI_GetFuncDesc(pdesc, pcls->Ifs[0], pcls->Eps[0].add, pcls->Eps[1].add,
+                                pcls->Eps[2].add, pcls->Eps[3].add,
+                                (speed == USBD_SPEED_HIGH) ? MIDI_DATA_HS_MAX_PACKET_SIZE :
+                                MIDI_DATA_FS_MAX_PACKET_SIZE);
+  }
+  else
+  {
+    (void)USBD_CMPSIT_CDCDesc(pdesc, pcls->Ifs[0], pcls->Eps[0].add, pcls->Eps[1].add,
+                              pcls->Eps[2].add,
+                              (speed == USBD_SPEED_HIGH) ? CDC_DATA_HS_MAX_PACKET_SIZE :
+                              CDC_DATA_FS_MAX_PACKET_SIZE);
+  }
+}
+
+/**
+  * @brief  USBD_CMPSIT_CDCDesc
+  *         Write the descriptors of a CDC ACM function
+  * @param  pdesc: destination, USBD_CMPSIT_CDC_DESC_SIZ bytes
+  * @param  if0: number of the communication interface, the data one follows
+  * @param  in_ep: bulk IN endpoint address
+  * @param  out_ep: bulk OUT endpoint address
+  * @param  cmd_ep: notification endpoint address
+  * @param  mps: packet size of the bulk endpoints
+  * @retval number of bytes written
+  */
+static uint16_t USBD_CMPSIT_CDCDesc(uint8_t *pdesc, uint8_t if0, uint8_t in_ep,
+                                    uint8_t out_ep, uint8_t cmd_ep, uint16_t mps)
+{
+  const uint8_t desc[] =
+  {
+    /* Interface Association Descriptor */
+    USB_IAD_DESC_SIZE,                      /* bLength */
+    USB_DESC_TYPE_IAD,                      /* bDescriptorType */
+    if0,                                    /* bFirstInterface */
+    0x02,                                   /* bInterfaceCount */
+    0x02,                                   /* bFunctionClass: Communication Interface Class */
+    0x02,                                   /* bFunctionSubClass: Abstract Control Model */
+    0x01,                                   /* bFunctionProtocol: Common AT commands */
+    0x00,                                   /* iFunction */
+
+    /* Communication Interface Descriptor */
+    USB_LEN_IF_DESC,                        /* bLength */
+    USB_DESC_TYPE_INTERFACE,                /* bDescriptorType: Interface */
+    if0,                                    /* bInterfaceNumber */
+    0x00,                                   /* bAlternateSetting */
+    0x01,                                   /* bNumEndpoints: one notification endpoint */
+    0x02,                                   /* bInterfaceClass: Communication Interface Class */
+    0x02,                                   /* bInterfaceSubClass: Abstract Control Model */
+    0x01,                                   /* bInterfaceProtocol: Common AT commands */
+    0x00,                                   /* iInterface */
+
+    /* Header Functional Descriptor */
+    0x05,                                   /* bLength */
+    0x24,                                   /* bDescriptorType: CS_INTERFACE */
+    0x00,                                   /* bDescriptorSubtype: Header Func Desc */
+    0x10,                                   /* bcdCDC: spec release number 1.10 */
+    0x01,
+
+    /* Call Management Functional Descriptor */
+    0x05,                                   /* bFunctionLength */
+    0x24,                                   /* bDescriptorType: CS_INTERFACE */
+    0x01,                                   /* bDescriptorSubtype: Call Management Func Desc */
+    0x00,                                   /* bmCapabilities: D0+D1 */
+    if0 + 1U,                               /* bDataInterface */
+
+    /* ACM Functional Descriptor */
+    0x04,                                   /* bFunctionLength */
+    0x24,                                   /* bDescriptorType: CS_INTERFACE */
+    0x02,                                   /* bDescriptorSubtype: Abstract Control Management desc */
+    0x02,                                   /* bmCapabilities */
+
+    /* Union Functional Descriptor */
+    0x05,                                   /* bFunctionLength */
+    0x24,                                   /* bDescriptorType: CS_INTERFACE */
+    0x06,                                   /* bDescriptorSubtype: Union func desc */
+    if0,                                    /* bMasterInterface: Communication class interface */
+    if0 + 1U,                               /* bSlaveInterface0: Data Class Interface */
+
+    /* Notification Endpoint Descriptor */
+    USB_LEN_EP_DESC,                        /* bLength */
+    USB_DESC_TYPE_ENDPOINT,                 /* bDescriptorType: Endpoint */
+    cmd_ep,                                 /* bEndpointAddress */
+    0x03,                                   /* bmAttributes: Interrupt */
+    LOBYTE(CDC_CMD_PACKET_SIZE),            /* wMaxPacketSize */
+    HIBYTE(CDC_CMD_PACKET_SIZE),
+    CDC_FS_BINTERVAL,                       /* bInterval */
+
+    /* Data class interface descriptor */
+    USB_LEN_IF_DESC,                        /* bLength */
+    USB_DESC_TYPE_INTERFACE,                /* bDescriptorType: Interface */
+    if0 + 1U,                               /* bInterfaceNumber */
+    0x00,                                   /* bAlternateSetting */
+    0x02,                                   /* bNumEndpoints: Two endpoints used */
+    0x0A,                                   /* bInterfaceClass: CDC */
+    0x00,                                   /* bInterfaceSubClass */
+    0x00,                                   /* bInterfaceProtocol */
+    0x00,                                   /* iInterface */
+
+    /* Endpoint OUT Descriptor */
+    USB_LEN_EP_DESC,                        /* bLength */
+    USB_DESC_TYPE_ENDPOINT,                 /* bDescriptorType: Endpoint */
+    out_ep,                                 /* bEndpointAddress */
+    0x02,                                   /* bmAttributes: Bulk */
+    LOBYTE(mps),                            /* wMaxPacketSize */
+    HIBYTE(mps),
+    0x00,                                   /* bInterval */
+
+    /* Endpoint IN Descriptor */
+    USB_LEN_EP_DESC,                        /* bLength */
+    USB_DESC_TYPE_ENDPOINT,                 /* bDescriptorType: Endpoint */
+    in_ep,                                  /* bEndpointAddress */
+    0x02,                                   /* bmAttributes: Bulk */
+    LOBYTE(mps),                            /* wMaxPacketSize */
+    HIBYTE(mps),
+    0x00                                    /* bInterval */
+  };
+
+  (void)USBD_memcpy(pdesc, desc, sizeof(desc));
+
+  return (uint16_t)sizeof(desc);
+}
+
+/**
+  * @brief  USBD_CMPSIT_SetConfHeader
+  *         Write the Configuration Descriptor at the head of an image
+  * @param  pdesc: image
+  * @param  total: wTotalLength
+  * @param  num_if: bNumInterfaces
+  * @retval None
+  */
+static void USBD_CMPSIT_SetConfHeader(uint8_t *pdesc, uint16_t total, uint8_t num_if)
+{
+  pdesc[0] = USB_LEN_CFG_DESC;              /* bLength */
+  pdesc[1] = USB_DESC_TYPE_CONFIGURATION;   /* bDescriptorType */
+  pdesc[2] = LOBYTE(total);                 /* wTotalLength */
+  pdesc[3] = HIBYTE(total);
+  pdesc[4] = num_if;                        /* bNumInterfaces */
+  pdesc[5] = 0x01;                          /* bConfigurationValue */
+  pdesc[6] = 0x00;                          /* iConfiguration: no string */
+  pdesc[7] = USBD_CMPSIT_CFG_ATTRIBUTES;    /* bmAttributes */
+  pdesc[8] = USBD_MAX_POWER;                /* MaxPower (mA) */
+}
+
+/**
+  * @brief  USBD_CMPSIT_GetFSCfgDesc
+  *         return configuration descriptor
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer
+  */
+static uint8_t *USBD_CMPSIT_GetFSCfgDesc(uint16_t *length)
+{
+  *length = USBD_CMPSIT_CfgDescSz;
+
+  return USBD_CMPSIT_FSCfgDesc;
+}
+
+/**
+  * @brief  USBD_CMPSIT_GetHSCfgDesc
+  *         return configuration descriptor
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer
+  */
+static uint8_t *USBD_CMPSIT_GetHSCfgDesc(uint16_t *length)
+{
+  *length = USBD_CMPSIT_CfgDescSz;
+
+#ifdef USE_USB_HS
+  return USBD_CMPSIT_HSCfgDesc;
+#else
+  /* A full speed core never runs at high speed */
+  return USBD_CMPSIT_FSCfgDesc;
+#endif /* USE_USB_HS */
+}
+
+/**
+  * @brief  USBD_CMPSIT_GetOtherSpeedCfgDesc
+  *         return configuration descriptor
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer
+  */
+static uint8_t *USBD_CMPSIT_GetOtherSpeedCfgDesc(uint16_t *length)
+{
+  *length = USBD_CMPSIT_CfgDescSz;
+
+  return USBD_CMPSIT_FSCfgDesc;
+}
+
+/**
+  * @brief  USBD_CMPSIT_GetDeviceQualifierDescriptor
+  *         return Device Qualifier descriptor
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer
+  */
+static uint8_t *USBD_CMPSIT_GetDeviceQualifierDescriptor(uint16_t *length)
+{
+  *length = (uint16_t)sizeof(USBD_CMPSIT_DeviceQualifierDesc);
+
+  return USBD_CMPSIT_DeviceQualifierDesc;
+}
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_USBD_COMPOSITE */
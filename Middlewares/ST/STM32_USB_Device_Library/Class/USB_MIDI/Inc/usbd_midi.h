@@ -1,161 +1,252 @@
-/**
-  ******************************************************************************
-  * @file    usbd_midi.h
-  * @author  MCD Application Team
-  * @brief   header file for the usbd_midi.c file.
-  ******************************************************************************
-  * @attention
-  *
-  * Copyright (c) 2015 STMicroelectronics.
-  * All rights reserved.
-  *
-  * This software is licensed under terms that can be found in the LICENSE file
-  * in the root directory of this software component.
-  * If no LICENSE file comes with this software, it is provided AS-IS.
-  *
-  ******************************************************************************
-  */
-
-/* Define to prevent recursive inclusion -------------------------------------*/
-#ifndef __USB_MIDI_H
-#define __USB_MIDI_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/* Includes ------------------------------------------------------------------*/
-#include  "usbd_ioreq.h"
-
-/** @addtogroup STM32_USB_DEVICE_LIBRARY
-  * @{
-  */
-
-/** @defgroup usbd_midi
-  * @brief This file is the Header file for usbd_midi.c
-  * @{
-  */
-
-
-/** @defgroup usbd_midi_Exported_Defines
-  * @{
-  */
-#ifndef MIDI_IN_EP
-#define MIDI_IN_EP                                   0x81U  /* EP1 for data IN */
-#endif /* MIDI_IN_EP */
-#ifndef MIDI_OUT_EP
-#define MIDI_OUT_EP                                  0x01U  /* EP1 for data OUT */
-#endif /* MIDI_OUT_EP */
-
-#ifndef MIDI_HS_BINTERVAL
-#define MIDI_HS_BINTERVAL                            0x10U
-#endif /* MIDI_HS_BINTERVAL */
-
-#ifndef MIDI_FS_BINTERVAL
-#define MIDI_FS_BINTERVAL                            0x10U
-#endif /* MIDI_FS_BINTERVAL */
-
-/* CDC Endpoints parameters: you can fine tune these values depending on the needed baudrates and performance. */
-#define MIDI_DATA_HS_MAX_PACKET_SIZE                 512U  /* Endpoint IN & OUT Packet size */
-#define MIDI_DATA_FS_MAX_PACKET_SIZE                 64U  /* Endpoint IN & OUT Packet size */
-
-#define USB_MIDI_CONFIG_DESC_SIZ                     101U
-#define MIDI_DATA_HS_IN_PACKET_SIZE                  MIDI_DATA_HS_MAX_PACKET_SIZE
-#define MIDI_DATA_HS_OUT_PACKET_SIZE                 MIDI_DATA_HS_MAX_PACKET_SIZE
-
-#define MIDI_DATA_FS_IN_PACKET_SIZE                  MIDI_DATA_FS_MAX_PACKET_SIZE
-#define MIDI_DATA_FS_OUT_PACKET_SIZE                 MIDI_DATA_FS_MAX_PACKET_SIZE
-
-#define MIDI_REQ_MAX_DATA_SIZE                       0x7U
-
-
-/**
-  * @}
-  */
-
-
-/** @defgroup USBD_CORE_Exported_TypesDefinitions
-  * @{
-  */
-
-/**
-  * @}
-  */
-typedef struct _USBD_MIDI_Itf
-{
-  int8_t (* Init)(void);
-  int8_t (* DeInit)(void);
-  int8_t (* Control)(uint8_t cmd, uint8_t *pbuf, uint16_t length);
-  int8_t (* Receive)(uint8_t *Buf, uint32_t *Len);
-  int8_t (* TransmitCplt)(uint8_t *Buf, uint32_t *Len, uint8_t epnum);
-} USBD_MIDI_ItfTypeDef;
-
-
-typedef struct
-{
-  uint32_t data[MIDI_DATA_HS_MAX_PACKET_SIZE / 4U];      /* Force 32-bit alignment */
-  uint8_t  CmdOpCode;
-  uint8_t  CmdLength;
-  uint8_t  *RxBuffer;
-  uint8_t  *TxBuffer;
-  uint32_t RxLength;
-  uint32_t TxLength;
-
-  __IO uint32_t TxState;
-  __IO uint32_t RxState;
-} USBD_MIDI_HandleTypeDef;
-
-
-
-/** @defgroup USBD_CORE_Exported_Macros
-  * @{
-  */
-
-/**
-  * @}
-  */
-
-/** @defgroup USBD_CORE_Exported_Variables
-  * @{
-  */
-
-extern USBD_ClassTypeDef USBD_MIDI;
-#define USBD_MIDI_CLASS &USBD_MIDI
-/**
-  * @}
-  */
-
-/** @defgroup USB_CORE_Exported_Functions
-  * @{
-  */
-uint8_t USBD_MIDI_RegisterInterface(USBD_HandleTypeDef *pdev,
-                                   USBD_MIDI_ItfTypeDef *fops);
-
-#ifdef USE_USBD_COMPOSITE
-uint8_t USBD_MIDI_SetTxBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff,
-                             uint32_t length, uint8_t ClassId);
-uint8_t USBD_MIDI_TransmitPacket(USBD_HandleTypeDef *pdev, uint8_t ClassId);
-#else
-uint8_t USBD_MIDI_SetTxBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff,
-                             uint32_t length);
-uint8_t USBD_MIDI_TransmitPacket(USBD_HandleTypeDef *pdev);
-#endif /* USE_USBD_COMPOSITE */
-uint8_t USBD_MIDI_SetRxBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff);
-uint8_t USBD_MIDI_ReceivePacket(USBD_HandleTypeDef *pdev);
-/**
-  * @}
-  */
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif  /* __USB_MIDI_H */
-/**
-  * @}
-  */
-
-/**
-  * @}
-  */
-
+/**
+  ******************************************************************************
+  * @file    usbd_midi.h
+  * @author  MCD Application Team
+  * @brief   header file for the usbd_midi.c file.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2015 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USB_MIDI_H
+#define __USB_MIDI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include  "usbd_ioreq.h"
+
+/** @addtogroup STM32_USB_DEVICE_LIBRARY
+  * @{
+  */
+
+/** @defgroup usbd_midi
+  * @brief This file is the Header file for usbd_midi.c
+  * @{
+  */
+
+
+/** @defgroup usbd_midi_Exported_Defines
+  * @{
+  */
+#ifndef MIDI_IN_EP
+#define MIDI_IN_EP                                   0x81U  /* EP1 for data IN */
+#endif /* MIDI_IN_EP */
+#ifndef MIDI_OUT_EP
+#define MIDI_OUT_EP                                  0x01U  /* EP1 for data OUT */
+#endif /* MIDI_OUT_EP */
+#ifndef MIDI_IN_EP2
+#define MIDI_IN_EP2                                  0x82U  /* EP2 for the second pair */
+#endif /* MIDI_IN_EP2 */
+#ifndef MIDI_OUT_EP2
+#define MIDI_OUT_EP2                                 0x02U
+#endif /* MIDI_OUT_EP2 */
+
+#ifndef MIDI_HS_BINTERVAL
+#define MIDI_HS_BINTERVAL                            0x10U
+#endif /* MIDI_HS_BINTERVAL */
+
+#ifndef MIDI_FS_BINTERVAL
+#define MIDI_FS_BINTERVAL                            0x10U
+#endif /* MIDI_FS_BINTERVAL */
+
+/* CDC Endpoints parameters: you can fine tune these values depending on the needed baudrates and performance. */
+#define MIDI_DATA_HS_MAX_PACKET_SIZE                 512U  /* Endpoint IN & OUT Packet size */
+#define MIDI_DATA_FS_MAX_PACKET_SIZE                 64U  /* Endpoint IN & OUT Packet size */
+
+/* Virtual cables of the MIDIStreaming interface, 1 to 16. Each cable is an
+   embedded IN and OUT jack pair, wired to an external OUT and IN jack pair
+   as on a MIDI adapter. Must be a plain decimal number: the descriptor
+   builder pastes it into a macro name. */
+#ifndef USBD_MIDI_NUM_CABLES
+#define USBD_MIDI_NUM_CABLES                         1
+#endif /* USBD_MIDI_NUM_CABLES */
+#if (USBD_MIDI_NUM_CABLES < 1) || (USBD_MIDI_NUM_CABLES > 16)
+#error "USBD_MIDI_NUM_CABLES must be 1 to 16"
+#endif /* USBD_MIDI_NUM_CABLES */
+
+/* Cables of an optional second bulk endpoint pair, 0 for none. Its jacks
+   are a group of their own, so a long transfer queued on one pair never
+   holds up the events of the other. On the bus each pair numbers its
+   cables from 0. Plain decimal number, as USBD_MIDI_NUM_CABLES. */
+#ifndef USBD_MIDI_NUM_CABLES_2
+#define USBD_MIDI_NUM_CABLES_2                       0
+#endif /* USBD_MIDI_NUM_CABLES_2 */
+#if (USBD_MIDI_NUM_CABLES_2 < 0) || ((USBD_MIDI_NUM_CABLES + USBD_MIDI_NUM_CABLES_2) > 16)
+#error "USBD_MIDI_NUM_CABLES_2 must be 0 to 16 - USBD_MIDI_NUM_CABLES"
+#endif /* USBD_MIDI_NUM_CABLES_2 */
+#if (USBD_MIDI_NUM_CABLES_2 > 0)
+#define USBD_MIDI_NUM_PIPES                          2U
+#else
+#define USBD_MIDI_NUM_PIPES                          1U
+#endif /* USBD_MIDI_NUM_CABLES_2 */
+
+/* Jack IDs of cable n, counted from 1; the cables of the second pair follow
+   those of the first */
+#define USBD_MIDI_JACK_EMB_IN(n)                     ((4U * (n)) - 3U)
+#define USBD_MIDI_JACK_EXT_IN(n)                     ((4U * (n)) - 2U)
+#define USBD_MIDI_JACK_EMB_OUT(n)                    ((4U * (n)) - 1U)
+#define USBD_MIDI_JACK_EXT_OUT(n)                    (4U * (n))
+
+/* Descriptor sizes, all derived from the cable count */
+#define USB_MIDI_IN_JACK_DESC_SIZ                    6U
+#define USB_MIDI_OUT_JACK_DESC_SIZ                   9U   /* one input pin */
+#define USB_MIDI_CABLE_DESC_SIZ                      (2U * (USB_MIDI_IN_JACK_DESC_SIZ + USB_MIDI_OUT_JACK_DESC_SIZ))
+#define USB_MIDI_EP_DESC_SIZ                         9U   /* audio class endpoint */
+#define USB_MIDI_CS_EP_DESC_SIZ(cables)              (4U + (uint32_t)(cables))
+#define USB_MIDI_PIPE_DESC_SIZ(cables)               (2U * (USB_MIDI_EP_DESC_SIZ + USB_MIDI_CS_EP_DESC_SIZ(cables)))
+#define USB_MIDI_AC_HEADER_DESC_SIZ                  9U
+#define USB_MIDI_MS_HEADER_DESC_SIZ                  7U
+#define USB_MIDI_MS_TOTAL_SIZ                        (USB_MIDI_MS_HEADER_DESC_SIZ + \
+                                                      ((uint32_t)(USBD_MIDI_NUM_CABLES + USBD_MIDI_NUM_CABLES_2) * \
+                                                       USB_MIDI_CABLE_DESC_SIZ) + \
+                                                      USB_MIDI_PIPE_DESC_SIZ(USBD_MIDI_NUM_CABLES) + \
+                                                      ((USBD_MIDI_NUM_CABLES_2 > 0) ? \
+                                                       USB_MIDI_PIPE_DESC_SIZ(USBD_MIDI_NUM_CABLES_2) : 0U))
+#define USB_MIDI_FUNC_DESC_SIZ                       ((2U * USB_LEN_IF_DESC) + USB_MIDI_AC_HEADER_DESC_SIZ + \
+                                                      USB_MIDI_MS_TOTAL_SIZ)
+#define USB_MIDI_CONFIG_DESC_SIZ                     (USB_LEN_CFG_DESC + USB_MIDI_FUNC_DESC_SIZ)
+#define MIDI_DATA_HS_IN_PACKET_SIZE                  MIDI_DATA_HS_MAX_PACKET_SIZE
+#define MIDI_DATA_HS_OUT_PACKET_SIZE                 MIDI_DATA_HS_MAX_PACKET_SIZE
+
+#define MIDI_DATA_FS_IN_PACKET_SIZE                  MIDI_DATA_FS_MAX_PACKET_SIZE
+#define MIDI_DATA_FS_OUT_PACKET_SIZE                 MIDI_DATA_FS_MAX_PACKET_SIZE
+
+#define MIDI_REQ_MAX_DATA_SIZE                       0x7U
+
+/* Vendor requests addressed to a MIDI interface (bmRequestType 0x41 / 0xC1,
+   wIndex the interface number) are a bulk control channel: the data stage
+   may be as long as the buffer given to USBD_MIDI_SetVendorBuffer() and is
+   moved in as many EP0 packets as needed, leaving the MIDI endpoints alone */
+
+
+/**
+  * @}
+  */
+
+
+/** @defgroup USBD_CORE_Exported_TypesDefinitions
+  * @{
+  */
+
+/**
+  * @}
+  */
+typedef struct _USBD_MIDI_Itf
+{
+  int8_t (* Init)(void);
+  int8_t (* DeInit)(void);
+  int8_t (* Control)(uint8_t cmd, uint8_t *pbuf, uint16_t length);
+  int8_t (* Receive)(uint8_t *Buf, uint32_t *Len, uint8_t epnum);
+  int8_t (* TransmitCplt)(uint8_t *Buf, uint32_t *Len, uint8_t epnum);
+  /* Device-to-host and no-data requests: called at the SETUP stage with
+     *length the room in pbuf, returns the reply length in *length; a
+     result other than USBD_OK stalls the request.
+     Host-to-device with data: called at the SETUP stage with pbuf NULL
+     and *length the data stage length, where a result other than USBD_OK
+     stalls the request; then again once the whole data stage is in pbuf,
+     when the data is already acknowledged and the result only informs. */
+  int8_t (* Vendor)(USBD_SetupReqTypedef *req, uint8_t *pbuf, uint16_t *length);
+} USBD_MIDI_ItfTypeDef;
+
+
+/* One bulk endpoint pair and its transfers */
+typedef struct
+{
+  uint8_t  InEpAdd;
+  uint8_t  OutEpAdd;
+  uint8_t  *RxBuffer;
+  uint8_t  *TxBuffer;
+  uint32_t RxLength;
+  uint32_t TxLength;
+
+  __IO uint32_t TxState;
+  __IO uint32_t RxState;
+} USBD_MIDI_PipeTypeDef;
+
+typedef struct
+{
+  uint32_t data[MIDI_DATA_HS_MAX_PACKET_SIZE / 4U];      /* Force 32-bit alignment */
+  uint8_t  CmdOpCode;
+  uint8_t  CmdLength;
+  uint8_t  *VendorBuffer;
+  uint16_t VendorSize;
+  uint8_t  VendorPending;                                /* OUT data stage running */
+  USBD_SetupReqTypedef VendorReq;
+
+  USBD_MIDI_PipeTypeDef Pipe[USBD_MIDI_NUM_PIPES];      /* endpoints of this instance */
+} USBD_MIDI_HandleTypeDef;
+
+
+
+/** @defgroup USBD_CORE_Exported_Macros
+  * @{
+  */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CORE_Exported_Variables
+  * @{
+  */
+
+extern USBD_ClassTypeDef USBD_MIDI;
+#define USBD_MIDI_CLASS &USBD_MIDI
+/**
+  * @}
+  */
+
+/** @defgroup USB_CORE_Exported_Functions
+  * @{
+  */
+uint8_t USBD_MIDI_RegisterInterface(USBD_HandleTypeDef *pdev,
+                                   USBD_MIDI_ItfTypeDef *fops);
+
+#ifdef USE_USBD_COMPOSITE
+uint8_t USBD_MIDI_SetTxBuffer(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t *pbuff,
+                             uint32_t length, uint8_t ClassId);
+uint8_t USBD_MIDI_TransmitPacket(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t ClassId);
+uint8_t USBD_MIDI_SetRxBuffer(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t *pbuff,
+                             uint8_t ClassId);
+uint8_t USBD_MIDI_ReceivePacket(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t ClassId);
+uint16_t USBD_MIDI_GetFuncDesc(uint8_t *pdesc, uint8_t ac_if, uint8_t in_ep,
+                               uint8_t out_ep, uint8_t in_ep2, uint8_t out_ep2,
+                               uint16_t mps);
+#else
+uint8_t USBD_MIDI_SetTxBuffer(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t *pbuff,
+                             uint32_t length);
+uint8_t USBD_MIDI_TransmitPacket(USBD_HandleTypeDef *pdev, uint8_t pipe);
+uint8_t USBD_MIDI_SetRxBuffer(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t *pbuff);
+uint8_t USBD_MIDI_ReceivePacket(USBD_HandleTypeDef *pdev, uint8_t pipe);
+#endif /* USE_USBD_COMPOSITE */
+uint8_t USBD_MIDI_SetVendorBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff,
+                                 uint16_t size);
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* __USB_MIDI_H */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
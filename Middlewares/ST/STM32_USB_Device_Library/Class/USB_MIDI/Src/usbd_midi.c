@@ -1,899 +1,1149 @@
-/**
-  ******************************************************************************
-  * @file    usbd_cdc.c
-  * @author  MCD Application Team
-  * @brief   This file provides the high layer firmware functions to manage the
-  *          following functionalities of the USB MIDI Class:
-  *           - Initialization and Configuration of high and low layer
-  *           - Enumeration as MIDI Device (and enumeration for each implemented memory interface)
-  *           - OUT/IN data transfer
-  *           - Error management
-  *
-  ******************************************************************************
-  * @attention
-  *
-  * Copyright (c) 2015 STMicroelectronics.
-  * All rights reserved.
-  *
-  * This software is licensed under terms that can be found in the LICENSE file
-  * in the root directory of this software component.
-  * If no LICENSE file comes with this software, it is provided AS-IS.
-  *
-  ******************************************************************************
-  *  @verbatim
-  *
-  *          ===================================================================
-  *                                USB MIDI Class Driver Description
-  *          ===================================================================
-  *           This driver manages the "Universal Serial Bus Class Definitions for Communications Devices
-  *           Revision 1.2 November 16, 2007" and the sub-protocol specification of "Universal Serial Bus
-  *           Communications Class Subclass Specification for PSTN Devices Revision 1.2 February 9, 2007"
-  *           This driver implements the following aspects of the specification:
-  *             - Device descriptor management
-  *             - Configuration descriptor management
-  *             - Enumeration as MIDI device with 2 data endpoints (IN and OUT)
-  *             - Requests management (as described in section 6.2 in specification)
-  *             - Abstract Control Model compliant
-  *             - Data interface class
-  *
-  *           These aspects may be enriched or modified for a specific user application.
-  *
-  *            This driver doesn't implement the following aspects of the specification
-  *            (but it is possible to manage these features with some modifications on this driver):
-  *             - Any class-specific aspect relative to communication classes should be managed by user application.
-  *             - All communication classes other than PSTN are not managed
-  *
-  *  @endverbatim
-  *
-  ******************************************************************************
-  */
-
-/* BSPDependencies
-- "stm32xxxxx_{eval}{discovery}{nucleo_144}.c"
-- "stm32xxxxx_{eval}{discovery}_io.c"
-EndBSPDependencies */
-
-/* Includes ------------------------------------------------------------------*/
-#include "usbd_midi.h"
-#include "usbd_ctlreq.h"
-
-
-/** @addtogroup STM32_USB_DEVICE_LIBRARY
-  * @{
-  */
-
-
-/** @defgroup USBD_MIDI
-  * @brief usbd core module
-  * @{
-  */
-
-/** @defgroup USBD_MIDI_Private_TypesDefinitions
-  * @{
-  */
-/**
-  * @}
-  */
-
-
-/** @defgroup USBD_MIDI_Private_Defines
-  * @{
-  */
-/**
-  * @}
-  */
-
-
-/** @defgroup USBD_MIDI_Private_Macros
-  * @{
-  */
-
-/**
-  * @}
-  */
-
-
-/** @defgroup USBD_MIDI_Private_FunctionPrototypes
-  * @{
-  */
-
-static uint8_t USBD_MIDI_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx);
-static uint8_t USBD_MIDI_DeInit(USBD_HandleTypeDef *pdev, uint8_t cfgidx);
-static uint8_t USBD_MIDI_Setup(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req);
-static uint8_t USBD_MIDI_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum);
-static uint8_t USBD_MIDI_DataOut(USBD_HandleTypeDef *pdev, uint8_t epnum);
-static uint8_t USBD_MIDI_EP0_RxReady(USBD_HandleTypeDef *pdev);
-#ifndef USE_USBD_COMPOSITE
-static uint8_t *USBD_MIDI_GetFSCfgDesc(uint16_t *length);
-static uint8_t *USBD_MIDI_GetHSCfgDesc(uint16_t *length);
-static uint8_t *USBD_MIDI_GetOtherSpeedCfgDesc(uint16_t *length);
-uint8_t *USBD_MIDI_GetDeviceQualifierDescriptor(uint16_t *length);
-#endif /* USE_USBD_COMPOSITE  */
-
-#ifndef USE_USBD_COMPOSITE
-/* USB Standard Device Descriptor */
-__ALIGN_BEGIN static uint8_t USBD_MIDI_DeviceQualifierDesc[USB_LEN_DEV_QUALIFIER_DESC] __ALIGN_END =
-{
-  USB_LEN_DEV_QUALIFIER_DESC,
-  USB_DESC_TYPE_DEVICE_QUALIFIER,
-  0x00,
-  0x02,
-  0x00,
-  0x00,
-  0x00,
-  0x40,
-  0x01,
-  0x00,
-};
-#endif /* USE_USBD_COMPOSITE  */
-/**
-  * @}
-  */
-
-/** @defgroup USBD_MIDI_Private_Variables
-  * @{
-  */
-
-
-/* USBMIDI interface class callbacks structure */
-USBD_ClassTypeDef  USBD_MIDI =
-{
-  USBD_MIDI_Init,
-  USBD_MIDI_DeInit,
-  USBD_MIDI_Setup,
-  NULL,                 /* EP0_TxSent */
-  USBD_MIDI_EP0_RxReady,
-  USBD_MIDI_DataIn,
-  USBD_MIDI_DataOut,
-  NULL,
-  NULL,
-  NULL,
-#ifdef USE_USBD_COMPOSITE
-  NULL,
-  NULL,
-  NULL,
-  NULL,
-#else
-  USBD_MIDI_GetHSCfgDesc,
-  USBD_MIDI_GetFSCfgDesc,
-  USBD_MIDI_GetOtherSpeedCfgDesc,
-  USBD_MIDI_GetDeviceQualifierDescriptor,
-#endif /* USE_USBD_COMPOSITE  */
-};
-
-#ifndef USE_USBD_COMPOSITE
-/* USB USBMIDI device Configuration Descriptor */
-__ALIGN_BEGIN static uint8_t USBD_MIDI_CfgDesc[USB_MIDI_CONFIG_DESC_SIZ] __ALIGN_END =
-{
-  /* Configuration Descriptor */
-  0x09,                                       /* bLength: Configuration Descriptor size */
-  USB_DESC_TYPE_CONFIGURATION,                /* bDescriptorType: Configuration */
-  USB_MIDI_CONFIG_DESC_SIZ,                    /* wTotalLength */
-  0x00,
-  0x02,                                       /* bNumInterfaces: 2 interfaces */
-  0x01,                                       /* bConfigurationValue: Configuration value */
-  0x00,                                       /* iConfiguration: Index of string descriptor
-                                                 describing the configuration */
-#if (USBD_SELF_POWERED == 1U)
-  0xC0,                                       /* bmAttributes: Bus Powered according to user configuration */
-#else
-  0x80,                                       /* bmAttributes: Bus Powered according to user configuration */
-#endif /* USBD_SELF_POWERED */
-  USBD_MAX_POWER,                             /* MaxPower (mA) */
-
-  /*---------------------------------------------------------------------------*/
-
-  /* Interface Descriptor */
-  0x09,                                       /* bLength: Interface Descriptor size */
-  USB_DESC_TYPE_INTERFACE,                    /* bDescriptorType: Interface */
-  /* Interface descriptor type */
-  0x00,                                       /* bInterfaceNumber: Number of Interface */
-  0x00,                                       /* bAlternateSetting: Alternate setting */
-  0x00,                                       /* bNumEndpoints: One endpoint used */
-  0x01,                                       /* bInterfaceClass: AUDIO Interface Class */
-  0x01,                                       /* bInterfaceSubClass: AUDIO Control */
-  0x00,                                       /* bInterfaceProtocol */
-  0x00,                                       /* iInterface */
-  /* Class-specific AC Interface Descriptor */
-  0x09,                                       /* bLength: Interface Descriptor size */
-  0x24,                                       /* CS_INTERFACE */
-  0x01,                                       /* HEADER subtype. */
-  0x00,                                       /* Revision of class specification - 1.0 */
-  0x01,
-  0x00,                                       /* bLength: Interface Descriptor size */
-  0x09,                                       /* Total size of class specific descriptors */
-  0x01,                                       /* Number of streaming interfaces */
-  0x01,                                       /* MIDIStreaming interface 1 belongs to this
-AudioControl interface */
-  /* MIDIStreaming Interface Descriptors */
-  /* Standard MS Interface Descriptor */
-  0x09,                                       /* bLength: Interface Descriptor size */
-  0x04,                                       /* INTERFACE descriptor */
-  0x01,                                       /* Index of this interface */
-  0x00,                                       /* Index of this alternate setting */
-  0x02,                                       /* 2 endpoints */
-  0x01,                                       /* AUDIO */
-  0x03,                                       /* MIDISTREAMING */
-  0x00,                                       /* bInterfaceProtocol */
-  0x00,                                       /* iInterface */
-
-  /* Class-specific MS Interface Descriptor */
-  0x07,                                       /* bLength: Endpoint Descriptor size */
-  0x24,                                       /* bDescriptorType: CS_INTERFACE */
-  0x01,                                       /* bDescriptorSubtype: MS_HEADER */
-  0x00,                                       /* Revision of this class specification */
-  0x01,
-  0x41,                                       /* Total size of class-specific descriptors */
-  0x00,
-
-  /* MIDI IN Jack Descriptor */
-  /* : MIDI Adapter MIDI IN Jack Descriptor (Embedded) */
-  0x06,                                       /* bLength: Endpoint Descriptor size */
-  0x24,                                       /* bDescriptorType: CS_INTERFACE */
-  0x02,                                       /* bDescriptorSubtype: MIDI_IN_JACK */
-  0x01,                                       /* EMBEDDED */
-  0x01,                                       /* ID of this Jack */
-  0x00,                                       /* iJack: unused */
-  /* MIDI Adapter MIDI IN Jack Descriptor (External) */
-  0x06,                                       /* bLength: Endpoint Descriptor size */
-  0x24,                                       /* bDescriptorType: CS_INTERFACE */
-  0x02,                                       /* bDescriptorSubtype: MIDI_IN_JACK */
-  0x02,                                       /* EXTERNAL */
-  0x02,                                       /* ID of this Jack */
-  0x00,                                       /* iJack: unused */
-
-  /* MIDI Adapter MIDI OUT Jack Descriptor (Embedded) */
-  0x09,                                       /* bLength: Interface Descriptor size */
-  0x24,                                       /* bDescriptorType: CS_INTERFACE */
-  0x03,                                       /* MIDI_OUT_JACK */
-  0x01,                                       /* EMBEDDED */
-  0x03,                                       /* ID of this Jack */
-  0x01,                                       /* Number of Input Pins of this Jack */
-  0x02,                                       /* ID of the Entity to which this Pin is
-connected */
-  0x01,                                       /* Output Pin number of the Entity to which
-this Input Pin is connected */
-  0x00,                                       /* iJack: unused */
-  /* MIDI Adapter MIDI OUT Jack Descriptor (External) */
-  0x09,                                       /* bLength: Interface Descriptor size */
-  0x24,                                       /* bDescriptorType: CS_INTERFACE */
-  0x03,                                       /* MIDI_OUT_JACK */
-  0x02,                                       /* EXTERNAL */
-  0x04,                                       /* ID of this Jack */
-  0x01,                                       /* Number of Input Pins of this Jack */
-  0x01,                                       /* ID of the Entity to which this Pin is
-connected */
-  0x01,                                       /* Output Pin number of the Entity to which
-this Input Pin is connected */
-  0x00,                                       /* iJack: unused */
-
-  /* Bulk OUT Endpoint Descriptors */
-  /* Standard Bulk OUT Endpoint Descriptor */
-  /* MIDI Adapter Standard Bulk OUT Endpoint Descriptor */
-  0x09,                                       /* bLength: Interface Descriptor size */
-  0x05,                                       /* bDescriptorType: ENDPOINT */
-  MIDI_OUT_EP,                                       /* OUT Endpoint 1 */
-  0x02,                                       /* Bulk, not shared. */
-  MIDI_DATA_FS_OUT_PACKET_SIZE,                                       /* 64 bytes per packet */
-  MIDI_DATA_FS_OUT_PACKET_SIZE>>8,
-  0x00,                                       /* Ignored for Bulk. Set to zero */
-  0x00,                                       /* bRefresh: unused */
-  0x00,                                       /* bSynchAddress: unused */
-  /* Class-specific MS Bulk OUT Endpoint Descriptor */
-  0x05,                                       /* bLength: Endpoint Descriptor size */
-  0x25,                                       /* bDescriptorType: CS_ENDPOINT */
-  0x01,                                       /* bDescriptorSubtype: MS_GENERAL */
-  0x01,                                       /* Number of embedded MIDI IN Jacks */
-  0x01,                                       /* ID of the Embedded MIDI IN Jack */
-
-  /* Standard Bulk IN Endpoint Descriptor */
-  /* Standard Bulk IN Endpoint Descriptor */
-  /* MIDI Adapter Standard Bulk OUT Endpoint Descriptor */
-  0x09,                                       /* bLength: Interface Descriptor size */
-  0x05,                                       /* bDescriptorType: ENDPOINT */
-  MIDI_IN_EP,                                       /* IN Endpoint 1 */
-  0x02,                                       /* Bulk, not shared. */
-  MIDI_DATA_FS_IN_PACKET_SIZE,                                       /* 64 bytes per packet */
-  MIDI_DATA_FS_IN_PACKET_SIZE>>8,
-  0x00,                                       /* Ignored for Bulk. Set to zero */
-  0x00,                                       /* bRefresh: unused */
-  0x00,                                       /* bSynchAddress: unused */
-  /* Class-specific MS Bulk IN Endpoint Descriptor */
-  0x05,                                       /* bLength: Endpoint Descriptor size */
-  0x25,                                       /* bDescriptorType: CS_ENDPOINT */
-  0x01,                                       /* bDescriptorSubtype: MS_GENERAL */
-  0x01,                                       /* Number of embedded MIDI IN Jacks */
-  0x03,                                       /* ID of the Embedded MIDI IN Jack */
-};
-#endif /* USE_USBD_COMPOSITE  */
-
-static uint8_t USBMIDIInEpAdd = MIDI_IN_EP;
-static uint8_t USBMIDIOutEpAdd = MIDI_OUT_EP;
-
-/**
-  * @}
-  */
-
-/** @defgroup USBD_MIDI_Private_Functions
-  * @{
-  */
-
-/**
-  * @brief  USBD_MIDI_Init
-  *         Initialize the USBMIDI interface
-  * @param  pdev: device instance
-  * @param  cfgidx: Configuration index
-  * @retval status
-  */
-static uint8_t USBD_MIDI_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
-{
-  UNUSED(cfgidx);
-  USBD_MIDI_HandleTypeDef *husbmidi;
-
-  husbmidi = (USBD_MIDI_HandleTypeDef *)USBD_malloc(sizeof(USBD_MIDI_HandleTypeDef));
-
-  if (husbmidi == NULL)
-  {
-    pdev->pClassDataCmsit[pdev->classId] = NULL;
-    return (uint8_t)USBD_EMEM;
-  }
-
-  (void)USBD_memset(husbmidi, 0, sizeof(USBD_MIDI_HandleTypeDef));
-
-  pdev->pClassDataCmsit[pdev->classId] = (void *)husbmidi;
-  pdev->pClassData = pdev->pClassDataCmsit[pdev->classId];
-
-#ifdef USE_USBD_COMPOSITE
-  /* Get the Endpoints addresses allocated for this class instance */
-  USBMIDIInEpAdd  = USBD_CoreGetEPAdd(pdev, USBD_EP_IN, USBD_EP_TYPE_BULK, (uint8_t)pdev->classId);
-  USBMIDIOutEpAdd = USBD_CoreGetEPAdd(pdev, USBD_EP_OUT, USBD_EP_TYPE_BULK, (uint8_t)pdev->classId);
-#endif /* USE_USBD_COMPOSITE */
-
-  if (pdev->dev_speed == USBD_SPEED_HIGH)
-  {
-    /* Open EP IN */
-    (void)USBD_LL_OpenEP(pdev, USBMIDIInEpAdd, USBD_EP_TYPE_BULK,
-                         MIDI_DATA_HS_IN_PACKET_SIZE);
-
-    pdev->ep_in[USBMIDIInEpAdd & 0xFU].is_used = 1U;
-
-    /* Open EP OUT */
-    (void)USBD_LL_OpenEP(pdev, USBMIDIOutEpAdd, USBD_EP_TYPE_BULK,
-                         MIDI_DATA_HS_OUT_PACKET_SIZE);
-
-    pdev->ep_out[USBMIDIOutEpAdd & 0xFU].is_used = 1U;
-  }
-  else
-  {
-    /* Open EP IN */
-    (void)USBD_LL_OpenEP(pdev, USBMIDIInEpAdd, USBD_EP_TYPE_BULK,
-                         MIDI_DATA_FS_IN_PACKET_SIZE);
-
-    pdev->ep_in[USBMIDIInEpAdd & 0xFU].is_used = 1U;
-
-    /* Open EP OUT */
-    (void)USBD_LL_OpenEP(pdev, USBMIDIOutEpAdd, USBD_EP_TYPE_BULK,
-                         MIDI_DATA_FS_OUT_PACKET_SIZE);
-
-    pdev->ep_out[USBMIDIOutEpAdd & 0xFU].is_used = 1U;
-  }
-
-  husbmidi->RxBuffer = NULL;
-
-  /* Init  physical Interface components */
-  ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->Init();
-
-  /* Init Xfer states */
-  husbmidi->TxState = 0U;
-  husbmidi->RxState = 0U;
-
-  if (husbmidi->RxBuffer == NULL)
-  {
-    return (uint8_t)USBD_EMEM;
-  }
-
-  if (pdev->dev_speed == USBD_SPEED_HIGH)
-  {
-    /* Prepare Out endpoint to receive next packet */
-    (void)USBD_LL_PrepareReceive(pdev, USBMIDIOutEpAdd, husbmidi->RxBuffer,
-                                 MIDI_DATA_HS_OUT_PACKET_SIZE);
-  }
-  else
-  {
-    /* Prepare Out endpoint to receive next packet */
-    (void)USBD_LL_PrepareReceive(pdev, USBMIDIOutEpAdd, husbmidi->RxBuffer,
-                                 MIDI_DATA_FS_OUT_PACKET_SIZE);
-  }
-
-  return (uint8_t)USBD_OK;
-}
-
-/**
-  * @brief  USBD_MIDI_Init
-  *         DeInitialize the USBMIDI layer
-  * @param  pdev: device instance
-  * @param  cfgidx: Configuration index
-  * @retval status
-  */
-static uint8_t USBD_MIDI_DeInit(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
-{
-  UNUSED(cfgidx);
-
-
-#ifdef USE_USBD_COMPOSITE
-  /* Get the Endpoints addresses allocated for this USBMIDI class instance */
-  USBMIDIInEpAdd  = USBD_CoreGetEPAdd(pdev, USBD_EP_IN, USBD_EP_TYPE_BULK, (uint8_t)pdev->classId);
-  USBMIDIOutEpAdd = USBD_CoreGetEPAdd(pdev, USBD_EP_OUT, USBD_EP_TYPE_BULK, (uint8_t)pdev->classId);
-#endif /* USE_USBD_COMPOSITE */
-
-  /* Close EP IN */
-  (void)USBD_LL_CloseEP(pdev, USBMIDIInEpAdd);
-  pdev->ep_in[USBMIDIInEpAdd & 0xFU].is_used = 0U;
-
-  /* Close EP OUT */
-  (void)USBD_LL_CloseEP(pdev, USBMIDIOutEpAdd);
-  pdev->ep_out[USBMIDIOutEpAdd & 0xFU].is_used = 0U;
-
-  /* DeInit  physical Interface components */
-  if (pdev->pClassDataCmsit[pdev->classId] != NULL)
-  {
-    ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->DeInit();
-    (void)USBD_free(pdev->pClassDataCmsit[pdev->classId]);
-    pdev->pClassDataCmsit[pdev->classId] = NULL;
-    pdev->pClassData = NULL;
-  }
-
-  return (uint8_t)USBD_OK;
-}
-
-/**
-  * @brief  USBD_MIDI_Setup
-  *         Handle the USBMIDI specific requests
-  * @param  pdev: instance
-  * @param  req: usb requests
-  * @retval status
-  */
-static uint8_t USBD_MIDI_Setup(USBD_HandleTypeDef *pdev,
-                              USBD_SetupReqTypedef *req)
-{
-  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
-  uint16_t len;
-  uint8_t ifalt = 0U;
-  uint16_t status_info = 0U;
-  USBD_StatusTypeDef ret = USBD_OK;
-
-  if (husbmidi == NULL)
-  {
-    return (uint8_t)USBD_FAIL;
-  }
-
-  switch (req->bmRequest & USB_REQ_TYPE_MASK)
-  {
-    case USB_REQ_TYPE_CLASS:
-      if (req->wLength != 0U)
-      {
-        if ((req->bmRequest & 0x80U) != 0U)
-        {
-          ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->Control(req->bRequest,
-                                                                           (uint8_t *)husbmidi->data,
-                                                                           req->wLength);
-
-          len = MIN(MIDI_REQ_MAX_DATA_SIZE, req->wLength);
-          (void)USBD_CtlSendData(pdev, (uint8_t *)husbmidi->data, len);
-        }
-        else
-        {
-          husbmidi->CmdOpCode = req->bRequest;
-          husbmidi->CmdLength = (uint8_t)MIN(req->wLength, USB_MAX_EP0_SIZE);
-
-          (void)USBD_CtlPrepareRx(pdev, (uint8_t *)husbmidi->data, husbmidi->CmdLength);
-        }
-      }
-      else
-      {
-        ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->Control(req->bRequest,
-                                                                         (uint8_t *)req, 0U);
-      }
-      break;
-
-    case USB_REQ_TYPE_STANDARD:
-      switch (req->bRequest)
-      {
-        case USB_REQ_GET_STATUS:
-          if (pdev->dev_state == USBD_STATE_CONFIGURED)
-          {
-            (void)USBD_CtlSendData(pdev, (uint8_t *)&status_info, 2U);
-          }
-          else
-          {
-            USBD_CtlError(pdev, req);
-            ret = USBD_FAIL;
-          }
-          break;
-
-        case USB_REQ_GET_INTERFACE:
-          if (pdev->dev_state == USBD_STATE_CONFIGURED)
-          {
-            (void)USBD_CtlSendData(pdev, &ifalt, 1U);
-          }
-          else
-          {
-            USBD_CtlError(pdev, req);
-            ret = USBD_FAIL;
-          }
-          break;
-
-        case USB_REQ_SET_INTERFACE:
-          if (pdev->dev_state != USBD_STATE_CONFIGURED)
-          {
-            USBD_CtlError(pdev, req);
-            ret = USBD_FAIL;
-          }
-          break;
-
-        case USB_REQ_CLEAR_FEATURE:
-          break;
-
-        default:
-          USBD_CtlError(pdev, req);
-          ret = USBD_FAIL;
-          break;
-      }
-      break;
-
-    default:
-      USBD_CtlError(pdev, req);
-      ret = USBD_FAIL;
-      break;
-  }
-
-  return (uint8_t)ret;
-}
-
-/**
-  * @brief  USBD_MIDI_DataIn
-  *         Data sent on non-control IN endpoint
-  * @param  pdev: device instance
-  * @param  epnum: endpoint number
-  * @retval status
-  */
-static uint8_t USBD_MIDI_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum)
-{
-  USBD_MIDI_HandleTypeDef *husbmidi;
-  PCD_HandleTypeDef *hpcd = (PCD_HandleTypeDef *)pdev->pData;
-
-  if (pdev->pClassDataCmsit[pdev->classId] == NULL)
-  {
-    return (uint8_t)USBD_FAIL;
-  }
-
-  husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
-
-  if ((pdev->ep_in[epnum & 0xFU].total_length > 0U) &&
-      ((pdev->ep_in[epnum & 0xFU].total_length % hpcd->IN_ep[epnum & 0xFU].maxpacket) == 0U))
-  {
-    /* Update the packet total length */
-    pdev->ep_in[epnum & 0xFU].total_length = 0U;
-
-    /* Send ZLP */
-    (void)USBD_LL_Transmit(pdev, epnum, NULL, 0U);
-  }
-  else
-  {
-    husbmidi->TxState = 0U;
-
-    if (((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->TransmitCplt != NULL)
-    {
-      ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->TransmitCplt(husbmidi->TxBuffer, &husbmidi->TxLength, epnum);
-    }
-  }
-
-  return (uint8_t)USBD_OK;
-}
-
-/**
-  * @brief  USBD_MIDI_DataOut
-  *         Data received on non-control Out endpoint
-  * @param  pdev: device instance
-  * @param  epnum: endpoint number
-  * @retval status
-  */
-static uint8_t USBD_MIDI_DataOut(USBD_HandleTypeDef *pdev, uint8_t epnum)
-{
-  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
-
-  if (pdev->pClassDataCmsit[pdev->classId] == NULL)
-  {
-    return (uint8_t)USBD_FAIL;
-  }
-
-  /* Get the received data length */
-  husbmidi->RxLength = USBD_LL_GetRxDataSize(pdev, epnum);
-
-  /* USB data will be immediately processed, this allow next USB traffic being
-  NAKed till the end of the application Xfer */
-
-  ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->Receive(husbmidi->RxBuffer, &husbmidi->RxLength);
-
-  return (uint8_t)USBD_OK;
-}
-
-/**
-  * @brief  USBD_MIDI_EP0_RxReady
-  *         Handle EP0 Rx Ready event
-  * @param  pdev: device instance
-  * @retval status
-  */
-static uint8_t USBD_MIDI_EP0_RxReady(USBD_HandleTypeDef *pdev)
-{
-  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
-
-  if (husbmidi == NULL)
-  {
-    return (uint8_t)USBD_FAIL;
-  }
-
-  if ((pdev->pUserData[pdev->classId] != NULL) && (husbmidi->CmdOpCode != 0xFFU))
-  {
-    ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->Control(husbmidi->CmdOpCode,
-                                                                     (uint8_t *)husbmidi->data,
-                                                                     (uint16_t)husbmidi->CmdLength);
-    husbmidi->CmdOpCode = 0xFFU;
-  }
-
-  return (uint8_t)USBD_OK;
-}
-#ifndef USE_USBD_COMPOSITE
-/**
-  * @brief  USBD_MIDI_GetFSCfgDesc
-  *         Return configuration descriptor
-  * @param  length : pointer data length
-  * @retval pointer to descriptor buffer
-  */
-static uint8_t *USBD_MIDI_GetFSCfgDesc(uint16_t *length)
-{
-  USBD_EpDescTypeDef *pEpOutDesc = USBD_GetEpDesc(USBD_MIDI_CfgDesc, MIDI_OUT_EP);
-  USBD_EpDescTypeDef *pEpInDesc = USBD_GetEpDesc(USBD_MIDI_CfgDesc, MIDI_IN_EP);
-
-  if (pEpOutDesc != NULL)
-  {
-    pEpOutDesc->wMaxPacketSize = MIDI_DATA_FS_MAX_PACKET_SIZE;
-  }
-
-  if (pEpInDesc != NULL)
-  {
-    pEpInDesc->wMaxPacketSize = MIDI_DATA_FS_MAX_PACKET_SIZE;
-  }
-
-  *length = (uint16_t)sizeof(USBD_MIDI_CfgDesc);
-  return USBD_MIDI_CfgDesc;
-}
-
-/**
-  * @brief  USBD_MIDI_GetHSCfgDesc
-  *         Return configuration descriptor
-  * @param  length : pointer data length
-  * @retval pointer to descriptor buffer
-  */
-static uint8_t *USBD_MIDI_GetHSCfgDesc(uint16_t *length)
-{
-  USBD_EpDescTypeDef *pEpOutDesc = USBD_GetEpDesc(USBD_MIDI_CfgDesc, MIDI_OUT_EP);
-  USBD_EpDescTypeDef *pEpInDesc = USBD_GetEpDesc(USBD_MIDI_CfgDesc, MIDI_IN_EP);
-
-  if (pEpOutDesc != NULL)
-  {
-    pEpOutDesc->wMaxPacketSize = MIDI_DATA_HS_MAX_PACKET_SIZE;
-  }
-
-  if (pEpInDesc != NULL)
-  {
-    pEpInDesc->wMaxPacketSize = MIDI_DATA_HS_MAX_PACKET_SIZE;
-  }
-
-  *length = (uint16_t)sizeof(USBD_MIDI_CfgDesc);
-  return USBD_MIDI_CfgDesc;
-}
-
-/**
-  * @brief  USBD_MIDI_GetOtherSpeedCfgDesc
-  *         Return configuration descriptor
-  * @param  length : pointer data length
-  * @retval pointer to descriptor buffer
-  */
-static uint8_t *USBD_MIDI_GetOtherSpeedCfgDesc(uint16_t *length)
-{
-  USBD_EpDescTypeDef *pEpOutDesc = USBD_GetEpDesc(USBD_MIDI_CfgDesc, MIDI_OUT_EP);
-  USBD_EpDescTypeDef *pEpInDesc = USBD_GetEpDesc(USBD_MIDI_CfgDesc, MIDI_IN_EP);
-
-  if (pEpOutDesc != NULL)
-  {
-    pEpOutDesc->wMaxPacketSize = MIDI_DATA_FS_MAX_PACKET_SIZE;
-  }
-
-  if (pEpInDesc != NULL)
-  {
-    pEpInDesc->wMaxPacketSize = MIDI_DATA_FS_MAX_PACKET_SIZE;
-  }
-
-  *length = (uint16_t)sizeof(USBD_MIDI_CfgDesc);
-  return USBD_MIDI_CfgDesc;
-}
-
-/**
-  * @brief  USBD_MIDI_GetDeviceQualifierDescriptor
-  *         return Device Qualifier descriptor
-  * @param  length : pointer data length
-  * @retval pointer to descriptor buffer
-  */
-uint8_t *USBD_MIDI_GetDeviceQualifierDescriptor(uint16_t *length)
-{
-  *length = (uint16_t)sizeof(USBD_MIDI_DeviceQualifierDesc);
-
-  return USBD_MIDI_DeviceQualifierDesc;
-}
-#endif /* USE_USBD_COMPOSITE  */
-/**
-  * @brief  USBD_MIDI_RegisterInterface
-  * @param  pdev: device instance
-  * @param  fops: CD  Interface callback
-  * @retval status
-  */
-uint8_t USBD_MIDI_RegisterInterface(USBD_HandleTypeDef *pdev,
-                                   USBD_MIDI_ItfTypeDef *fops)
-{
-  if (fops == NULL)
-  {
-    return (uint8_t)USBD_FAIL;
-  }
-
-  pdev->pUserData[pdev->classId] = fops;
-
-  return (uint8_t)USBD_OK;
-}
-
-
-/**
-  * @brief  USBD_MIDI_SetTxBuffer
-  * @param  pdev: device instance
-  * @param  pbuff: Tx Buffer
-  * @param  length: length of data to be sent
-  * @param  ClassId: The Class ID
-  * @retval status
-  */
-#ifdef USE_USBD_COMPOSITE
-uint8_t USBD_MIDI_SetTxBuffer(USBD_HandleTypeDef *pdev,
-                             uint8_t *pbuff, uint32_t length, uint8_t ClassId)
-{
-  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[ClassId];
-#else
-uint8_t USBD_MIDI_SetTxBuffer(USBD_HandleTypeDef *pdev,
-                             uint8_t *pbuff, uint32_t length)
-{
-  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
-#endif /* USE_USBD_COMPOSITE */
-
-  if (husbmidi == NULL)
-  {
-    return (uint8_t)USBD_FAIL;
-  }
-
-  husbmidi->TxBuffer = pbuff;
-  husbmidi->TxLength = length;
-
-  return (uint8_t)USBD_OK;
-}
-
-/**
-  * @brief  USBD_MIDI_SetRxBuffer
-  * @param  pdev: device instance
-  * @param  pbuff: Rx Buffer
-  * @retval status
-  */
-uint8_t USBD_MIDI_SetRxBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff)
-{
-  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
-
-  if (husbmidi == NULL)
-  {
-    return (uint8_t)USBD_FAIL;
-  }
-
-  husbmidi->RxBuffer = pbuff;
-
-  return (uint8_t)USBD_OK;
-}
-
-
-/**
-  * @brief  USBD_MIDI_TransmitPacket
-  *         Transmit packet on IN endpoint
-  * @param  pdev: device instance
-  * @param  ClassId: The Class ID
-  * @retval status
-  */
-#ifdef USE_USBD_COMPOSITE
-uint8_t USBD_MIDI_TransmitPacket(USBD_HandleTypeDef *pdev, uint8_t ClassId)
-{
-  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[ClassId];
-#else
-uint8_t USBD_MIDI_TransmitPacket(USBD_HandleTypeDef *pdev)
-{
-  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
-#endif  /* USE_USBD_COMPOSITE */
-
-  USBD_StatusTypeDef ret = USBD_BUSY;
-
-#ifdef USE_USBD_COMPOSITE
-  /* Get the Endpoints addresses allocated for this class instance */
-  USBMIDIInEpAdd  = USBD_CoreGetEPAdd(pdev, USBD_EP_IN, USBD_EP_TYPE_BULK, ClassId);
-#endif  /* USE_USBD_COMPOSITE */
-
-  if (husbmidi == NULL)
-  {
-    return (uint8_t)USBD_FAIL;
-  }
-
-  if (husbmidi->TxState == 0U)
-  {
-    /* Tx Transfer in progress */
-    husbmidi->TxState = 1U;
-
-    /* Update the packet total length */
-    pdev->ep_in[USBMIDIInEpAdd & 0xFU].total_length = husbmidi->TxLength;
-
-    /* Transmit next packet */
-    (void)USBD_LL_Transmit(pdev, USBMIDIInEpAdd, husbmidi->TxBuffer, husbmidi->TxLength);
-
-    ret = USBD_OK;
-  }
-
-  return (uint8_t)ret;
-}
-
-/**
-  * @brief  USBD_MIDI_ReceivePacket
-  *         prepare OUT Endpoint for reception
-  * @param  pdev: device instance
-  * @retval status
-  */
-uint8_t USBD_MIDI_ReceivePacket(USBD_HandleTypeDef *pdev)
-{
-  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
-
-#ifdef USE_USBD_COMPOSITE
-  /* Get the Endpoints addresses allocated for this class instance */
-  USBMIDIOutEpAdd = USBD_CoreGetEPAdd(pdev, USBD_EP_OUT, USBD_EP_TYPE_BULK, (uint8_t)pdev->classId);
-#endif /* USE_USBD_COMPOSITE */
-
-  if (pdev->pClassDataCmsit[pdev->classId] == NULL)
-  {
-    return (uint8_t)USBD_FAIL;
-  }
-
-  if (pdev->dev_speed == USBD_SPEED_HIGH)
-  {
-    /* Prepare Out endpoint to receive next packet */
-    (void)USBD_LL_PrepareReceive(pdev, USBMIDIOutEpAdd, husbmidi->RxBuffer,
-                                 MIDI_DATA_HS_OUT_PACKET_SIZE);
-  }
-  else
-  {
-    /* Prepare Out endpoint to receive next packet */
-    (void)USBD_LL_PrepareReceive(pdev, USBMIDIOutEpAdd, husbmidi->RxBuffer,
-                                 MIDI_DATA_FS_OUT_PACKET_SIZE);
-  }
-
-  return (uint8_t)USBD_OK;
-}
-/**
-  * @}
-  */
-
-/**
-  * @}
-  */
-
-/**
-  * @}
-  */
-
+/**
+  ******************************************************************************
+  * @file    usbd_cdc.c
+  * @author  MCD Application Team
+  * @brief   This file provides the high layer firmware functions to manage the
+  *          following functionalities of the USB MIDI Class:
+  *           - Initialization and Configuration of high and low layer
+  *           - Enumeration as MIDI Device (and enumeration for each implemented memory interface)
+  *           - OUT/IN data transfer
+  *           - Error management
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2015 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                                USB MIDI Class Driver Description
+  *          ===================================================================
+  *           This driver manages the "Universal Serial Bus Class Definitions for Communications Devices
+  *           Revision 1.2 November 16, 2007" and the sub-protocol specification of "Universal Serial Bus
+  *           Communications Class Subclass Specification for PSTN Devices Revision 1.2 February 9, 2007"
+  *           This driver implements the following aspects of the specification:
+  *             - Device descriptor management
+  *             - Configuration descriptor management
+  *             - Enumeration as MIDI device with 2 data endpoints (IN and OUT)
+  *             - Requests management (as described in section 6.2 in specification)
+  *             - Abstract Control Model compliant
+  *             - Data interface class
+  *
+  *           These aspects may be enriched or modified for a specific user application.
+  *
+  *            This driver doesn't implement the following aspects of the specification
+  *            (but it is possible to manage these features with some modifications on this driver):
+  *             - Any class-specific aspect relative to communication classes should be managed by user application.
+  *             - All communication classes other than PSTN are not managed
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  */
+
+/* BSPDependencies
+- "stm32xxxxx_{eval}{discovery}{nucleo_144}.c"
+- "stm32xxxxx_{eval}{discovery}_io.c"
+EndBSPDependencies */
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_midi.h"
+#include "usbd_ctlreq.h"
+
+
+/** @addtogroup STM32_USB_DEVICE_LIBRARY
+  * @{
+  */
+
+
+/** @defgroup USBD_MIDI
+  * @brief usbd core module
+  * @{
+  */
+
+/** @defgroup USBD_MIDI_Private_TypesDefinitions
+  * @{
+  */
+/**
+  * @}
+  */
+
+
+/** @defgroup USBD_MIDI_Private_Defines
+  * @{
+  */
+/* Endpoint directions, which the core only defines for the composite device */
+#ifndef USBD_EP_IN
+#define USBD_EP_IN                                   0x80U
+#define USBD_EP_OUT                                  0x00U
+#endif /* USBD_EP_IN */
+/**
+  * @}
+  */
+
+
+/** @defgroup USBD_MIDI_Private_Macros
+  * @{
+  */
+
+/**
+  * @}
+  */
+
+
+/** @defgroup USBD_MIDI_Private_FunctionPrototypes
+  * @{
+  */
+
+static uint8_t USBD_MIDI_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx);
+static uint8_t USBD_MIDI_DeInit(USBD_HandleTypeDef *pdev, uint8_t cfgidx);
+static uint8_t USBD_MIDI_Setup(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req);
+static uint8_t USBD_MIDI_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum);
+static uint8_t USBD_MIDI_DataOut(USBD_HandleTypeDef *pdev, uint8_t epnum);
+static uint8_t USBD_MIDI_EP0_RxReady(USBD_HandleTypeDef *pdev);
+static uint8_t USBD_MIDI_VendorSetup(USBD_HandleTypeDef *pdev,
+                                     USBD_MIDI_HandleTypeDef *husbmidi,
+                                     USBD_SetupReqTypedef *req);
+static uint8_t USBD_MIDI_GetEpAdd(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t ep_dir);
+static USBD_MIDI_PipeTypeDef *USBD_MIDI_FindPipe(USBD_MIDI_HandleTypeDef *husbmidi,
+                                                 uint8_t epnum, uint8_t ep_dir);
+#ifndef USE_USBD_COMPOSITE
+static uint8_t *USBD_MIDI_GetFSCfgDesc(uint16_t *length);
+static uint8_t *USBD_MIDI_GetHSCfgDesc(uint16_t *length);
+static uint8_t *USBD_MIDI_GetOtherSpeedCfgDesc(uint16_t *length);
+uint8_t *USBD_MIDI_GetDeviceQualifierDescriptor(uint16_t *length);
+#endif /* USE_USBD_COMPOSITE  */
+
+#ifndef USE_USBD_COMPOSITE
+/* USB Standard Device Descriptor */
+__ALIGN_BEGIN static uint8_t USBD_MIDI_DeviceQualifierDesc[USB_LEN_DEV_QUALIFIER_DESC] __ALIGN_END =
+{
+  USB_LEN_DEV_QUALIFIER_DESC,
+  USB_DESC_TYPE_DEVICE_QUALIFIER,
+  0x00,
+  0x02,
+  0x00,
+  0x00,
+  0x00,
+  0x40,
+  0x01,
+  0x00,
+};
+#endif /* USE_USBD_COMPOSITE  */
+/**
+  * @}
+  */
+
+/** @defgroup USBD_MIDI_Private_Variables
+  * @{
+  */
+
+
+/* USBMIDI interface class callbacks structure */
+USBD_ClassTypeDef  USBD_MIDI =
+{
+  USBD_MIDI_Init,
+  USBD_MIDI_DeInit,
+  USBD_MIDI_Setup,
+  NULL,                 /* EP0_TxSent */
+  USBD_MIDI_EP0_RxReady,
+  USBD_MIDI_DataIn,
+  USBD_MIDI_DataOut,
+  NULL,
+  NULL,
+  NULL,
+#ifdef USE_USBD_COMPOSITE
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+#else
+  USBD_MIDI_GetHSCfgDesc,
+  USBD_MIDI_GetFSCfgDesc,
+  USBD_MIDI_GetOtherSpeedCfgDesc,
+  USBD_MIDI_GetDeviceQualifierDescriptor,
+#endif /* USE_USBD_COMPOSITE  */
+};
+
+#ifndef USE_USBD_COMPOSITE
+#if (USBD_SELF_POWERED == 1U)
+#define USBD_MIDI_CFG_ATTRIBUTES                     0xC0U  /* Self Powered */
+#else
+#define USBD_MIDI_CFG_ATTRIBUTES                     0x80U  /* Bus Powered */
+#endif /* USBD_SELF_POWERED */
+#endif /* USE_USBD_COMPOSITE  */
+
+/* Jack types */
+#define USBD_MIDI_JACK_EMBEDDED                      0x01U
+#define USBD_MIDI_JACK_EXTERNAL                      0x02U
+
+/* m(1) m(2) ... m(n), n a plain decimal number up to 16 */
+#define USBD_MIDI_REP_0(m)
+#define USBD_MIDI_REP_1(m)                           m(1)
+#define USBD_MIDI_REP_2(m)                           USBD_MIDI_REP_1(m) m(2)
+#define USBD_MIDI_REP_3(m)                           USBD_MIDI_REP_2(m) m(3)
+#define USBD_MIDI_REP_4(m)                           USBD_MIDI_REP_3(m) m(4)
+#define USBD_MIDI_REP_5(m)                           USBD_MIDI_REP_4(m) m(5)
+#define USBD_MIDI_REP_6(m)                           USBD_MIDI_REP_5(m) m(6)
+#define USBD_MIDI_REP_7(m)                           USBD_MIDI_REP_6(m) m(7)
+#define USBD_MIDI_REP_8(m)                           USBD_MIDI_REP_7(m) m(8)
+#define USBD_MIDI_REP_9(m)                           USBD_MIDI_REP_8(m) m(9)
+#define USBD_MIDI_REP_10(m)                          USBD_MIDI_REP_9(m) m(10)
+#define USBD_MIDI_REP_11(m)                          USBD_MIDI_REP_10(m) m(11)
+#define USBD_MIDI_REP_12(m)                          USBD_MIDI_REP_11(m) m(12)
+#define USBD_MIDI_REP_13(m)                          USBD_MIDI_REP_12(m) m(13)
+#define USBD_MIDI_REP_14(m)                          USBD_MIDI_REP_13(m) m(14)
+#define USBD_MIDI_REP_15(m)                          USBD_MIDI_REP_14(m) m(15)
+#define USBD_MIDI_REP_16(m)                          USBD_MIDI_REP_15(m) m(16)
+#define USBD_MIDI_REP_N(n, m)                        USBD_MIDI_REP_##n(m)
+#define USBD_MIDI_REP(n, m)                          USBD_MIDI_REP_N(n, m)
+
+#define USBD_MIDI_IN_JACK_DESC(type, id)                                                            \
+  USB_MIDI_IN_JACK_DESC_SIZ,                /* bLength */                                           \
+  0x24,                                     /* bDescriptorType: CS_INTERFACE */                     \
+  0x02,                                     /* bDescriptorSubtype: MIDI_IN_JACK */                  \
+  (type),                                   /* bJackType */                                         \
+  (id),                                     /* bJackID */                                           \
+  0x00,                                     /* iJack: unused */
+
+#define USBD_MIDI_OUT_JACK_DESC(type, id, source)                                                   \
+  USB_MIDI_OUT_JACK_DESC_SIZ,               /* bLength */                                           \
+  0x24,                                     /* bDescriptorType: CS_INTERFACE */                     \
+  0x03,                                     /* bDescriptorSubtype: MIDI_OUT_JACK */                 \
+  (type),                                   /* bJackType */                                         \
+  (id),                                     /* bJackID */                                           \
+  0x01,                                     /* bNrInputPins */                                      \
+  (source),                                 /* baSourceID: entity feeding the pin */                \
+  0x01,                                     /* baSourcePin */                                       \
+  0x00,                                     /* iJack: unused */
+
+/* Cable n: host -> embedded IN -> external OUT, and
+   external IN -> embedded OUT -> host */
+#define USBD_MIDI_CABLE_DESC(n)                                                                     \
+  USBD_MIDI_IN_JACK_DESC(USBD_MIDI_JACK_EMBEDDED, USBD_MIDI_JACK_EMB_IN(n))                         \
+  USBD_MIDI_IN_JACK_DESC(USBD_MIDI_JACK_EXTERNAL, USBD_MIDI_JACK_EXT_IN(n))                         \
+  USBD_MIDI_OUT_JACK_DESC(USBD_MIDI_JACK_EMBEDDED, USBD_MIDI_JACK_EMB_OUT(n), USBD_MIDI_JACK_EXT_IN(n))\
+  USBD_MIDI_OUT_JACK_DESC(USBD_MIDI_JACK_EXTERNAL, USBD_MIDI_JACK_EXT_OUT(n), USBD_MIDI_JACK_EMB_IN(n))
+
+#define USBD_MIDI_EMB_IN_ID(n)                       USBD_MIDI_JACK_EMB_IN(n),
+#define USBD_MIDI_EMB_OUT_ID(n)                      USBD_MIDI_JACK_EMB_OUT(n),
+
+/* The same for the jack group of the second endpoint pair */
+#define USBD_MIDI_CABLE2_DESC(n)                     USBD_MIDI_CABLE_DESC(USBD_MIDI_NUM_CABLES + (n))
+#define USBD_MIDI_EMB_IN_ID2(n)                      USBD_MIDI_JACK_EMB_IN(USBD_MIDI_NUM_CABLES + (n)),
+#define USBD_MIDI_EMB_OUT_ID2(n)                     USBD_MIDI_JACK_EMB_OUT(USBD_MIDI_NUM_CABLES + (n)),
+
+/* Standard bulk endpoint followed by its class-specific descriptor, which
+   lists one embedded jack per cable: the position in the list is the
+   cable number */
+#define USBD_MIDI_EP_DESC(addr, mps, cables, jack_id)                                               \
+  USB_MIDI_EP_DESC_SIZ,                     /* bLength */                                           \
+  USB_DESC_TYPE_ENDPOINT,                   /* bDescriptorType: ENDPOINT */                         \
+  (addr),                                   /* bEndpointAddress */                                  \
+  0x02,                                     /* bmAttributes: Bulk, not shared */                    \
+  LOBYTE(mps),                              /* wMaxPacketSize */                                    \
+  HIBYTE(mps),                                                                                      \
+  0x00,                                     /* bInterval: ignored for Bulk */                       \
+  0x00,                                     /* bRefresh: unused */                                  \
+  0x00,                                     /* bSynchAddress: unused */                             \
+  USB_MIDI_CS_EP_DESC_SIZ(cables),          /* bLength */                                           \
+  0x25,                                     /* bDescriptorType: CS_ENDPOINT */                      \
+  0x01,                                     /* bDescriptorSubtype: MS_GENERAL */                    \
+  (cables),                                 /* bNumEmbMIDIJack */                                   \
+  USBD_MIDI_REP(cables, jack_id)
+
+#if (USBD_MIDI_NUM_PIPES > 1U)
+#define USBD_MIDI_PIPE2_DESC(in_ep2, out_ep2, mps)                                                  \
+  USBD_MIDI_EP_DESC(out_ep2, mps, USBD_MIDI_NUM_CABLES_2, USBD_MIDI_EMB_IN_ID2)                     \
+  USBD_MIDI_EP_DESC(in_ep2, mps, USBD_MIDI_NUM_CABLES_2, USBD_MIDI_EMB_OUT_ID2)
+#else
+#define USBD_MIDI_PIPE2_DESC(in_ep2, out_ep2, mps)
+#endif /* USBD_MIDI_NUM_PIPES */
+
+/* The two interfaces and the endpoints of the function: ac_if is the number
+   of the AudioControl interface, the MIDIStreaming one follows it. in_ep2
+   and out_ep2 are left out without a second endpoint pair. */
+#define USBD_MIDI_FUNC_DESC(ac_if, in_ep, out_ep, in_ep2, out_ep2, mps)                             \
+  /* Standard AC Interface Descriptor */                                                            \
+  USB_LEN_IF_DESC,                          /* bLength: Interface Descriptor size */                \
+  USB_DESC_TYPE_INTERFACE,                  /* bDescriptorType: Interface */                        \
+  (ac_if),                                  /* bInterfaceNumber: Number of Interface */             \
+  0x00,                                     /* bAlternateSetting: Alternate setting */              \
+  0x00,                                     /* bNumEndpoints: no endpoint */                        \
+  0x01,                                     /* bInterfaceClass: AUDIO Interface Class */            \
+  0x01,                                     /* bInterfaceSubClass: AUDIO Control */                 \
+  0x00,                                     /* bInterfaceProtocol */                                \
+  0x00,                                     /* iInterface */                                        \
+  /* Class-specific AC Interface Descriptor */                                                      \
+  USB_MIDI_AC_HEADER_DESC_SIZ,              /* bLength */                                           \
+  0x24,                                     /* bDescriptorType: CS_INTERFACE */                     \
+  0x01,                                     /* bDescriptorSubtype: HEADER */                        \
+  0x00,                                     /* bcdADC: 1.0 */                                       \
+  0x01,                                                                                             \
+  LOBYTE(USB_MIDI_AC_HEADER_DESC_SIZ),      /* wTotalLength of the class-specific descriptors */    \
+  HIBYTE(USB_MIDI_AC_HEADER_DESC_SIZ),                                                              \
+  0x01,                                     /* bInCollection: one streaming interface */            \
+  (ac_if) + 1U,                             /* baInterfaceNr: the MIDIStreaming interface */        \
+  /* Standard MS Interface Descriptor */                                                            \
+  USB_LEN_IF_DESC,                          /* bLength: Interface Descriptor size */                \
+  USB_DESC_TYPE_INTERFACE,                  /* bDescriptorType: Interface */                        \
+  (ac_if) + 1U,                             /* bInterfaceNumber */                                  \
+  0x00,                                     /* bAlternateSetting */                                 \
+  (2U * USBD_MIDI_NUM_PIPES),               /* bNumEndpoints: IN and OUT of each pair */            \
+  0x01,                                     /* bInterfaceClass: AUDIO */                            \
+  0x03,                                     /* bInterfaceSubClass: MIDISTREAMING */                 \
+  0x00,                                     /* bInterfaceProtocol */                                \
+  0x00,                                     /* iInterface */                                        \
+  /* Class-specific MS Interface Descriptor */                                                      \
+  USB_MIDI_MS_HEADER_DESC_SIZ,              /* bLength */                                           \
+  0x24,                                     /* bDescriptorType: CS_INTERFACE */                     \
+  0x01,                                     /* bDescriptorSubtype: MS_HEADER */                     \
+  0x00,                                     /* bcdMSC: 1.0 */                                       \
+  0x01,                                                                                             \
+  LOBYTE(USB_MIDI_MS_TOTAL_SIZ),            /* wTotalLength of the class-specific descriptors */    \
+  HIBYTE(USB_MIDI_MS_TOTAL_SIZ),                                                                    \
+  /* MIDI IN and OUT Jack Descriptors */                                                            \
+  USBD_MIDI_REP(USBD_MIDI_NUM_CABLES, USBD_MIDI_CABLE_DESC)                                         \
+  USBD_MIDI_REP(USBD_MIDI_NUM_CABLES_2, USBD_MIDI_CABLE2_DESC)                                      \
+  /* Bulk OUT Endpoint, into the embedded IN jacks */                                               \
+  USBD_MIDI_EP_DESC(out_ep, mps, USBD_MIDI_NUM_CABLES, USBD_MIDI_EMB_IN_ID)                         \
+  /* Bulk IN Endpoint, from the embedded OUT jacks */                                               \
+  USBD_MIDI_EP_DESC(in_ep, mps, USBD_MIDI_NUM_CABLES, USBD_MIDI_EMB_OUT_ID)                         \
+  /* The same for the second jack group */                                                          \
+  USBD_MIDI_PIPE2_DESC(in_ep2, out_ep2, mps)
+
+#ifndef USE_USBD_COMPOSITE
+/* USB MIDI device Configuration Descriptor, one image per speed: desc_type is
+   USB_DESC_TYPE_CONFIGURATION or USB_DESC_TYPE_OTHER_SPEED_CONFIGURATION and
+   mps the packet size of the bulk endpoints */
+#define USBD_MIDI_CFG_DESC(desc_type, mps)                                                          \
+{                                                                                                   \
+  /* Configuration Descriptor */                                                                    \
+  USB_LEN_CFG_DESC,                         /* bLength: Configuration Descriptor size */            \
+  desc_type,                                /* bDescriptorType: Configuration or Other Speed */     \
+  LOBYTE(USB_MIDI_CONFIG_DESC_SIZ),         /* wTotalLength */                                      \
+  HIBYTE(USB_MIDI_CONFIG_DESC_SIZ),                                                                 \
+  0x02,                                     /* bNumInterfaces: 2 interfaces */                      \
+  0x01,                                     /* bConfigurationValue: Configuration value */          \
+  0x00,                                     /* iConfiguration: no string */                         \
+  USBD_MIDI_CFG_ATTRIBUTES,                 /* bmAttributes: according to user configuration */     \
+  USBD_MAX_POWER,                           /* MaxPower (mA) */                                     \
+  USBD_MIDI_FUNC_DESC(0x00U, MIDI_IN_EP, MIDI_OUT_EP, MIDI_IN_EP2, MIDI_OUT_EP2, mps)              \
+}
+
+/* The images are complete as built and never written, so they stay in flash
+   and are served as they are on every GET_DESCRIPTOR */
+__ALIGN_BEGIN static const uint8_t USBD_MIDI_CfgDescFS[] __ALIGN_END =
+  USBD_MIDI_CFG_DESC(USB_DESC_TYPE_CONFIGURATION, MIDI_DATA_FS_MAX_PACKET_SIZE);
+
+__ALIGN_BEGIN static const uint8_t USBD_MIDI_CfgDescHS[] __ALIGN_END =
+  USBD_MIDI_CFG_DESC(USB_DESC_TYPE_CONFIGURATION, MIDI_DATA_HS_MAX_PACKET_SIZE);
+
+/* A high speed device describes its full speed configuration here */
+__ALIGN_BEGIN static const uint8_t USBD_MIDI_OtherSpeedCfgDesc[] __ALIGN_END =
+  USBD_MIDI_CFG_DESC(USB_DESC_TYPE_OTHER_SPEED_CONFIGURATION, MIDI_DATA_FS_MAX_PACKET_SIZE);
+
+/* Build time checks of the generated images */
+#define USBD_MIDI_STATIC_ASSERT(expr, name)          typedef char USBD_MIDI_Check_##name[(expr) ? 1 : -1]
+
+USBD_MIDI_STATIC_ASSERT(sizeof(USBD_MIDI_CfgDescFS) == USB_MIDI_CONFIG_DESC_SIZ, fs_size);
+USBD_MIDI_STATIC_ASSERT(sizeof(USBD_MIDI_CfgDescHS) == USB_MIDI_CONFIG_DESC_SIZ, hs_size);
+USBD_MIDI_STATIC_ASSERT(sizeof(USBD_MIDI_OtherSpeedCfgDesc) == USB_MIDI_CONFIG_DESC_SIZ, other_size);
+USBD_MIDI_STATIC_ASSERT(MIDI_DATA_FS_MAX_PACKET_SIZE <= 64U, fs_packet);
+USBD_MIDI_STATIC_ASSERT(MIDI_DATA_HS_MAX_PACKET_SIZE <= 512U, hs_packet);
+#endif /* USE_USBD_COMPOSITE  */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_MIDI_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  USBD_MIDI_Init
+  *         Initialize the USBMIDI interface
+  * @param  pdev: device instance
+  * @param  cfgidx: Configuration index
+  * @retval status
+  */
+static uint8_t USBD_MIDI_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
+{
+  UNUSED(cfgidx);
+  USBD_MIDI_HandleTypeDef *husbmidi;
+  USBD_MIDI_PipeTypeDef *hpipe;
+  uint8_t pipe;
+
+  husbmidi = (USBD_MIDI_HandleTypeDef *)USBD_malloc(sizeof(USBD_MIDI_HandleTypeDef));
+
+  if (husbmidi == NULL)
+  {
+    pdev->pClassDataCmsit[pdev->classId] = NULL;
+    return (uint8_t)USBD_EMEM;
+  }
+
+  (void)USBD_memset(husbmidi, 0, sizeof(USBD_MIDI_HandleTypeDef));
+
+  pdev->pClassDataCmsit[pdev->classId] = (void *)husbmidi;
+  pdev->pClassData = pdev->pClassDataCmsit[pdev->classId];
+
+  for (pipe = 0U; pipe < USBD_MIDI_NUM_PIPES; pipe++)
+  {
+    hpipe = &husbmidi->Pipe[pipe];
+
+    /* Get the Endpoints addresses allocated for this class instance */
+    hpipe->InEpAdd  = USBD_MIDI_GetEpAdd(pdev, pipe, USBD_EP_IN);
+    hpipe->OutEpAdd = USBD_MIDI_GetEpAdd(pdev, pipe, USBD_EP_OUT);
+
+    if (pdev->dev_speed == USBD_SPEED_HIGH)
+    {
+      /* Open EP IN */
+      (void)USBD_LL_OpenEP(pdev, hpipe->InEpAdd, USBD_EP_TYPE_BULK,
+                           MIDI_DATA_HS_IN_PACKET_SIZE);
+
+      pdev->ep_in[hpipe->InEpAdd & 0xFU].is_used = 1U;
+
+      /* Open EP OUT */
+      (void)USBD_LL_OpenEP(pdev, hpipe->OutEpAdd, USBD_EP_TYPE_BULK,
+                           MIDI_DATA_HS_OUT_PACKET_SIZE);
+
+      pdev->ep_out[hpipe->OutEpAdd & 0xFU].is_used = 1U;
+    }
+    else
+    {
+      /* Open EP IN */
+      (void)USBD_LL_OpenEP(pdev, hpipe->InEpAdd, USBD_EP_TYPE_BULK,
+                           MIDI_DATA_FS_IN_PACKET_SIZE);
+
+      pdev->ep_in[hpipe->InEpAdd & 0xFU].is_used = 1U;
+
+      /* Open EP OUT */
+      (void)USBD_LL_OpenEP(pdev, hpipe->OutEpAdd, USBD_EP_TYPE_BULK,
+                           MIDI_DATA_FS_OUT_PACKET_SIZE);
+
+      pdev->ep_out[hpipe->OutEpAdd & 0xFU].is_used = 1U;
+    }
+
+    hpipe->RxBuffer = NULL;
+  }
+
+  /* Init  physical Interface components */
+  ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->Init();
+
+  for (pipe = 0U; pipe < USBD_MIDI_NUM_PIPES; pipe++)
+  {
+    hpipe = &husbmidi->Pipe[pipe];
+
+    /* Init Xfer states */
+    hpipe->TxState = 0U;
+    hpipe->RxState = 0U;
+
+    if (hpipe->RxBuffer == NULL)
+    {
+      return (uint8_t)USBD_EMEM;
+    }
+
+    if (pdev->dev_speed == USBD_SPEED_HIGH)
+    {
+      /* Prepare Out endpoint to receive next packet */
+      (void)USBD_LL_PrepareReceive(pdev, hpipe->OutEpAdd, hpipe->RxBuffer,
+                                   MIDI_DATA_HS_OUT_PACKET_SIZE);
+    }
+    else
+    {
+      /* Prepare Out endpoint to receive next packet */
+      (void)USBD_LL_PrepareReceive(pdev, hpipe->OutEpAdd, hpipe->RxBuffer,
+                                   MIDI_DATA_FS_OUT_PACKET_SIZE);
+    }
+  }
+
+  return (uint8_t)USBD_OK;
+}
+
+/**
+  * @brief  USBD_MIDI_Init
+  *         DeInitialize the USBMIDI layer
+  * @param  pdev: device instance
+  * @param  cfgidx: Configuration index
+  * @retval status
+  */
+static uint8_t USBD_MIDI_DeInit(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
+{
+  uint8_t InEpAdd;
+  uint8_t OutEpAdd;
+  uint8_t pipe;
+
+  UNUSED(cfgidx);
+
+  for (pipe = 0U; pipe < USBD_MIDI_NUM_PIPES; pipe++)
+  {
+    /* Get the Endpoints addresses allocated for this USBMIDI class instance:
+       the handle may be gone if its Init failed */
+    InEpAdd  = USBD_MIDI_GetEpAdd(pdev, pipe, USBD_EP_IN);
+    OutEpAdd = USBD_MIDI_GetEpAdd(pdev, pipe, USBD_EP_OUT);
+
+    /* Close EP IN */
+    (void)USBD_LL_CloseEP(pdev, InEpAdd);
+    pdev->ep_in[InEpAdd & 0xFU].is_used = 0U;
+
+    /* Close EP OUT */
+    (void)USBD_LL_CloseEP(pdev, OutEpAdd);
+    pdev->ep_out[OutEpAdd & 0xFU].is_used = 0U;
+  }
+
+  /* DeInit  physical Interface components */
+  if (pdev->pClassDataCmsit[pdev->classId] != NULL)
+  {
+    ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->DeInit();
+    (void)USBD_free(pdev->pClassDataCmsit[pdev->classId]);
+    pdev->pClassDataCmsit[pdev->classId] = NULL;
+    pdev->pClassData = NULL;
+  }
+
+  return (uint8_t)USBD_OK;
+}
+
+/**
+  * @brief  USBD_MIDI_Setup
+  *         Handle the USBMIDI specific requests
+  * @param  pdev: instance
+  * @param  req: usb requests
+  * @retval status
+  */
+static uint8_t USBD_MIDI_Setup(USBD_HandleTypeDef *pdev,
+                              USBD_SetupReqTypedef *req)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
+  uint16_t len;
+  uint8_t ifalt = 0U;
+  uint16_t status_info = 0U;
+  USBD_StatusTypeDef ret = USBD_OK;
+
+  if (husbmidi == NULL)
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  /* A new SETUP ends the data stage of a vendor request left pending */
+  husbmidi->VendorPending = 0U;
+
+  switch (req->bmRequest & USB_REQ_TYPE_MASK)
+  {
+    case USB_REQ_TYPE_CLASS:
+      if (req->wLength != 0U)
+      {
+        if ((req->bmRequest & 0x80U) != 0U)
+        {
+          ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->Control(req->bRequest,
+                                                                           (uint8_t *)husbmidi->data,
+                                                                           req->wLength);
+
+          len = MIN(MIDI_REQ_MAX_DATA_SIZE, req->wLength);
+          (void)USBD_CtlSendData(pdev, (uint8_t *)husbmidi->data, len);
+        }
+        else
+        {
+          husbmidi->CmdOpCode = req->bRequest;
+          husbmidi->CmdLength = (uint8_t)MIN(req->wLength, USB_MAX_EP0_SIZE);
+
+          (void)USBD_CtlPrepareRx(pdev, (uint8_t *)husbmidi->data, husbmidi->CmdLength);
+        }
+      }
+      else
+      {
+        ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->Control(req->bRequest,
+                                                                         (uint8_t *)req, 0U);
+      }
+      break;
+
+    case USB_REQ_TYPE_VENDOR:
+      ret = (USBD_StatusTypeDef)USBD_MIDI_VendorSetup(pdev, husbmidi, req);
+      break;
+
+    case USB_REQ_TYPE_STANDARD:
+      switch (req->bRequest)
+      {
+        case USB_REQ_GET_STATUS:
+          if (pdev->dev_state == USBD_STATE_CONFIGURED)
+          {
+            (void)USBD_CtlSendData(pdev, (uint8_t *)&status_info, 2U);
+          }
+          else
+          {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
+          break;
+
+        case USB_REQ_GET_INTERFACE:
+          if (pdev->dev_state == USBD_STATE_CONFIGURED)
+          {
+            (void)USBD_CtlSendData(pdev, &ifalt, 1U);
+          }
+          else
+          {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
+          break;
+
+        case USB_REQ_SET_INTERFACE:
+          if (pdev->dev_state != USBD_STATE_CONFIGURED)
+          {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
+          break;
+
+        case USB_REQ_CLEAR_FEATURE:
+          break;
+
+        default:
+          USBD_CtlError(pdev, req);
+          ret = USBD_FAIL;
+          break;
+      }
+      break;
+
+    default:
+      USBD_CtlError(pdev, req);
+      ret = USBD_FAIL;
+      break;
+  }
+
+  return (uint8_t)ret;
+}
+
+/**
+  * @brief  USBD_MIDI_VendorSetup
+  *         Start a vendor request. The core splits the data stage into EP0
+  *         packets (USBD_CtlContinueRx / USBD_CtlContinueSendData), so the
+  *         only limit on its length is the vendor buffer.
+  * @param  pdev: device instance
+  * @param  husbmidi: class handle
+  * @param  req: usb request
+  * @retval status
+  */
+static uint8_t USBD_MIDI_VendorSetup(USBD_HandleTypeDef *pdev,
+                                     USBD_MIDI_HandleTypeDef *husbmidi,
+                                     USBD_SetupReqTypedef *req)
+{
+  USBD_MIDI_ItfTypeDef *fops = (USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId];
+  uint16_t len = MIN(req->wLength, husbmidi->VendorSize);
+
+  /* Only interface requests: the core sends the status stage of those */
+  if ((fops == NULL) || (fops->Vendor == NULL) || (husbmidi->VendorBuffer == NULL) ||
+      ((req->bmRequest & 0x1FU) != USB_REQ_RECIPIENT_INTERFACE))
+  {
+    USBD_CtlError(pdev, req);
+    return (uint8_t)USBD_FAIL;
+  }
+
+  if (((req->bmRequest & 0x80U) == 0U) && (req->wLength != 0U))
+  {
+    if (req->wLength > husbmidi->VendorSize)
+    {
+      USBD_CtlError(pdev, req);
+      return (uint8_t)USBD_FAIL;
+    }
+
+    /* Offered without a buffer first: this is the last point where a
+       refusal can still stall the request */
+    len = req->wLength;
+    if (fops->Vendor(req, NULL, &len) != (int8_t)USBD_OK)
+    {
+      USBD_CtlError(pdev, req);
+      return (uint8_t)USBD_FAIL;
+    }
+
+    /* The handler runs again from EP0_RxReady once the last packet is in */
+    husbmidi->VendorReq = *req;
+    husbmidi->VendorPending = 1U;
+    (void)USBD_CtlPrepareRx(pdev, husbmidi->VendorBuffer, req->wLength);
+
+    return (uint8_t)USBD_OK;
+  }
+
+  if (fops->Vendor(req, husbmidi->VendorBuffer, &len) != (int8_t)USBD_OK)
+  {
+    USBD_CtlError(pdev, req);
+    return (uint8_t)USBD_FAIL;
+  }
+
+  if (req->wLength != 0U)
+  {
+    (void)USBD_CtlSendData(pdev, husbmidi->VendorBuffer, MIN(len, req->wLength));
+  }
+
+  return (uint8_t)USBD_OK;
+}
+
+/**
+  * @brief  USBD_MIDI_DataIn
+  *         Data sent on non-control IN endpoint
+  * @param  pdev: device instance
+  * @param  epnum: endpoint number
+  * @retval status
+  */
+static uint8_t USBD_MIDI_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi;
+  USBD_MIDI_PipeTypeDef *hpipe;
+  PCD_HandleTypeDef *hpcd = (PCD_HandleTypeDef *)pdev->pData;
+
+  if (pdev->pClassDataCmsit[pdev->classId] == NULL)
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
+  hpipe = USBD_MIDI_FindPipe(husbmidi, epnum, USBD_EP_IN);
+
+  if (hpipe == NULL)
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  if ((pdev->ep_in[epnum & 0xFU].total_length > 0U) &&
+      ((pdev->ep_in[epnum & 0xFU].total_length % hpcd->IN_ep[epnum & 0xFU].maxpacket) == 0U))
+  {
+    /* Update the packet total length */
+    pdev->ep_in[epnum & 0xFU].total_length = 0U;
+
+    /* Send ZLP */
+    (void)USBD_LL_Transmit(pdev, epnum, NULL, 0U);
+  }
+  else
+  {
+    hpipe->TxState = 0U;
+
+    if (((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->TransmitCplt != NULL)
+    {
+      ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->TransmitCplt(hpipe->TxBuffer, &hpipe->TxLength, epnum);
+    }
+  }
+
+  return (uint8_t)USBD_OK;
+}
+
+/**
+  * @brief  USBD_MIDI_DataOut
+  *         Data received on non-control Out endpoint
+  * @param  pdev: device instance
+  * @param  epnum: endpoint number
+  * @retval status
+  */
+static uint8_t USBD_MIDI_DataOut(USBD_HandleTypeDef *pdev, uint8_t epnum)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
+  USBD_MIDI_PipeTypeDef *hpipe;
+
+  if (pdev->pClassDataCmsit[pdev->classId] == NULL)
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  hpipe = USBD_MIDI_FindPipe(husbmidi, epnum, USBD_EP_OUT);
+
+  if (hpipe == NULL)
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  /* Get the received data length */
+  hpipe->RxLength = USBD_LL_GetRxDataSize(pdev, epnum);
+
+  /* USB data will be immediately processed, this allow next USB traffic being
+  NAKed till the end of the application Xfer */
+
+  ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->Receive(hpipe->RxBuffer, &hpipe->RxLength, epnum);
+
+  return (uint8_t)USBD_OK;
+}
+
+/**
+  * @brief  USBD_MIDI_EP0_RxReady
+  *         Handle EP0 Rx Ready event
+  * @param  pdev: device instance
+  * @retval status
+  */
+static uint8_t USBD_MIDI_EP0_RxReady(USBD_HandleTypeDef *pdev)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
+
+  if (husbmidi == NULL)
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  /* Device requests do not go through USBD_MIDI_Setup(): check that this
+     data stage is the pending one */
+  if ((husbmidi->VendorPending != 0U) &&
+      (pdev->request.bmRequest == husbmidi->VendorReq.bmRequest) &&
+      (pdev->request.bRequest == husbmidi->VendorReq.bRequest) &&
+      (pdev->request.wIndex == husbmidi->VendorReq.wIndex))
+  {
+    uint16_t len = husbmidi->VendorReq.wLength;
+
+    husbmidi->VendorPending = 0U;
+    /* The core sends the status stage next whatever the result: the data
+       is acknowledged by now */
+    (void)((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->Vendor(&husbmidi->VendorReq,
+                                                                          husbmidi->VendorBuffer, &len);
+    return (uint8_t)USBD_OK;
+  }
+
+  if ((pdev->pUserData[pdev->classId] != NULL) && (husbmidi->CmdOpCode != 0xFFU))
+  {
+    ((USBD_MIDI_ItfTypeDef *)pdev->pUserData[pdev->classId])->Control(husbmidi->CmdOpCode,
+                                                                     (uint8_t *)husbmidi->data,
+                                                                     (uint16_t)husbmidi->CmdLength);
+    husbmidi->CmdOpCode = 0xFFU;
+  }
+
+  return (uint8_t)USBD_OK;
+}
+
+/**
+  * @brief  USBD_MIDI_GetEpAdd
+  *         Endpoint of one pair of the class instance being served
+  * @param  pdev: device instance
+  * @param  pipe: endpoint pair, 0 or 1
+  * @param  ep_dir: USBD_EP_IN or USBD_EP_OUT
+  * @retval endpoint address
+  */
+static uint8_t USBD_MIDI_GetEpAdd(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t ep_dir)
+{
+#ifdef USE_USBD_COMPOSITE
+  /* Registered pair by pair, IN then OUT */
+  return pdev->tclasslist[pdev->classId].Eps[(2U * pipe) + ((ep_dir == USBD_EP_IN) ? 0U : 1U)].add;
+#else
+  UNUSED(pdev);
+
+  if (pipe == 0U)
+  {
+    return (ep_dir == USBD_EP_IN) ? MIDI_IN_EP : MIDI_OUT_EP;
+  }
+  return (ep_dir == USBD_EP_IN) ? MIDI_IN_EP2 : MIDI_OUT_EP2;
+#endif /* USE_USBD_COMPOSITE */
+}
+
+/**
+  * @brief  USBD_MIDI_FindPipe
+  *         Endpoint pair a transfer completed on
+  * @param  husbmidi: class instance
+  * @param  epnum: endpoint number
+  * @param  ep_dir: USBD_EP_IN or USBD_EP_OUT
+  * @retval pair, NULL if the endpoint is not one of the instance
+  */
+static USBD_MIDI_PipeTypeDef *USBD_MIDI_FindPipe(USBD_MIDI_HandleTypeDef *husbmidi,
+                                                 uint8_t epnum, uint8_t ep_dir)
+{
+  uint8_t pipe;
+  uint8_t add;
+
+  for (pipe = 0U; pipe < USBD_MIDI_NUM_PIPES; pipe++)
+  {
+    add = (ep_dir == USBD_EP_IN) ? husbmidi->Pipe[pipe].InEpAdd : husbmidi->Pipe[pipe].OutEpAdd;
+    if ((add & 0xFU) == (epnum & 0xFU))
+    {
+      return &husbmidi->Pipe[pipe];
+    }
+  }
+
+  return NULL;
+}
+#ifndef USE_USBD_COMPOSITE
+/**
+  * @brief  USBD_MIDI_GetFSCfgDesc
+  *         Return configuration descriptor
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer
+  */
+static uint8_t *USBD_MIDI_GetFSCfgDesc(uint16_t *length)
+{
+  *length = (uint16_t)sizeof(USBD_MIDI_CfgDescFS);
+  return (uint8_t *)USBD_MIDI_CfgDescFS;
+}
+
+/**
+  * @brief  USBD_MIDI_GetHSCfgDesc
+  *         Return configuration descriptor
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer
+  */
+static uint8_t *USBD_MIDI_GetHSCfgDesc(uint16_t *length)
+{
+  *length = (uint16_t)sizeof(USBD_MIDI_CfgDescHS);
+  return (uint8_t *)USBD_MIDI_CfgDescHS;
+}
+
+/**
+  * @brief  USBD_MIDI_GetOtherSpeedCfgDesc
+  *         Return configuration descriptor
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer
+  */
+static uint8_t *USBD_MIDI_GetOtherSpeedCfgDesc(uint16_t *length)
+{
+  *length = (uint16_t)sizeof(USBD_MIDI_OtherSpeedCfgDesc);
+  return (uint8_t *)USBD_MIDI_OtherSpeedCfgDesc;
+}
+
+/**
+  * @brief  USBD_MIDI_GetDeviceQualifierDescriptor
+  *         return Device Qualifier descriptor
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer
+  */
+uint8_t *USBD_MIDI_GetDeviceQualifierDescriptor(uint16_t *length)
+{
+  *length = (uint16_t)sizeof(USBD_MIDI_DeviceQualifierDesc);
+
+  return USBD_MIDI_DeviceQualifierDesc;
+}
+#endif /* USE_USBD_COMPOSITE  */
+/**
+  * @brief  USBD_MIDI_RegisterInterface
+  * @param  pdev: device instance
+  * @param  fops: CD  Interface callback
+  * @retval status
+  */
+uint8_t USBD_MIDI_RegisterInterface(USBD_HandleTypeDef *pdev,
+                                   USBD_MIDI_ItfTypeDef *fops)
+{
+  if (fops == NULL)
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  pdev->pUserData[pdev->classId] = fops;
+
+  return (uint8_t)USBD_OK;
+}
+
+#ifdef USE_USBD_COMPOSITE
+/**
+  * @brief  USBD_MIDI_GetFuncDesc
+  *         Write the interface and endpoint descriptors of the function,
+  *         for the composite configuration descriptor
+  * @param  pdesc: destination, USB_MIDI_FUNC_DESC_SIZ bytes
+  * @param  ac_if: number of the AudioControl interface
+  * @param  in_ep: bulk IN endpoint address
+  * @param  out_ep: bulk OUT endpoint address
+  * @param  in_ep2: bulk IN endpoint of the second pair, unused without one
+  * @param  out_ep2: bulk OUT endpoint of the second pair, unused without one
+  * @param  mps: packet size of the endpoints
+  * @retval number of bytes written
+  */
+uint16_t USBD_MIDI_GetFuncDesc(uint8_t *pdesc, uint8_t ac_if, uint8_t in_ep,
+                               uint8_t out_ep, uint8_t in_ep2, uint8_t out_ep2,
+                               uint16_t mps)
+{
+  const uint8_t desc[] = { USBD_MIDI_FUNC_DESC(ac_if, in_ep, out_ep, in_ep2, out_ep2, mps) };
+
+#if (USBD_MIDI_NUM_PIPES == 1U)
+  UNUSED(in_ep2);
+  UNUSED(out_ep2);
+#endif /* USBD_MIDI_NUM_PIPES */
+
+  (void)USBD_memcpy(pdesc, desc, sizeof(desc));
+
+  return (uint16_t)sizeof(desc);
+}
+#endif /* USE_USBD_COMPOSITE */
+
+
+/**
+  * @brief  USBD_MIDI_SetTxBuffer
+  * @param  pdev: device instance
+  * @param  pipe: endpoint pair, 0 or 1
+  * @param  pbuff: Tx Buffer
+  * @param  length: length of data to be sent
+  * @param  ClassId: The Class ID
+  * @retval status
+  */
+#ifdef USE_USBD_COMPOSITE
+uint8_t USBD_MIDI_SetTxBuffer(USBD_HandleTypeDef *pdev, uint8_t pipe,
+                             uint8_t *pbuff, uint32_t length, uint8_t ClassId)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[ClassId];
+#else
+uint8_t USBD_MIDI_SetTxBuffer(USBD_HandleTypeDef *pdev, uint8_t pipe,
+                             uint8_t *pbuff, uint32_t length)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
+#endif /* USE_USBD_COMPOSITE */
+
+  if ((husbmidi == NULL) || (pipe >= USBD_MIDI_NUM_PIPES))
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  husbmidi->Pipe[pipe].TxBuffer = pbuff;
+  husbmidi->Pipe[pipe].TxLength = length;
+
+  return (uint8_t)USBD_OK;
+}
+
+/**
+  * @brief  USBD_MIDI_SetRxBuffer
+  * @param  pdev: device instance
+  * @param  pipe: endpoint pair, 0 or 1
+  * @param  pbuff: Rx Buffer
+  * @param  ClassId: The Class ID
+  * @retval status
+  */
+#ifdef USE_USBD_COMPOSITE
+uint8_t USBD_MIDI_SetRxBuffer(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t *pbuff,
+                             uint8_t ClassId)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[ClassId];
+#else
+uint8_t USBD_MIDI_SetRxBuffer(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t *pbuff)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
+#endif /* USE_USBD_COMPOSITE */
+
+  if ((husbmidi == NULL) || (pipe >= USBD_MIDI_NUM_PIPES))
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  husbmidi->Pipe[pipe].RxBuffer = pbuff;
+
+  return (uint8_t)USBD_OK;
+}
+
+
+/**
+  * @brief  USBD_MIDI_SetVendorBuffer
+  * @param  pdev: device instance
+  * @param  pbuff: buffer for the data stage of vendor requests
+  * @param  size: its length, the longest data stage accepted
+  * @retval status
+  */
+uint8_t USBD_MIDI_SetVendorBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff,
+                                 uint16_t size)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
+
+  if (husbmidi == NULL)
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  husbmidi->VendorBuffer = pbuff;
+  husbmidi->VendorSize = size;
+
+  return (uint8_t)USBD_OK;
+}
+
+
+/**
+  * @brief  USBD_MIDI_TransmitPacket
+  *         Transmit packet on IN endpoint
+  * @param  pdev: device instance
+  * @param  pipe: endpoint pair, 0 or 1
+  * @param  ClassId: The Class ID
+  * @retval status
+  */
+#ifdef USE_USBD_COMPOSITE
+uint8_t USBD_MIDI_TransmitPacket(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t ClassId)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[ClassId];
+#else
+uint8_t USBD_MIDI_TransmitPacket(USBD_HandleTypeDef *pdev, uint8_t pipe)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
+#endif  /* USE_USBD_COMPOSITE */
+
+  USBD_StatusTypeDef ret = USBD_BUSY;
+  USBD_MIDI_PipeTypeDef *hpipe;
+
+  if ((husbmidi == NULL) || (pipe >= USBD_MIDI_NUM_PIPES))
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  hpipe = &husbmidi->Pipe[pipe];
+
+  if (hpipe->TxState == 0U)
+  {
+    /* Tx Transfer in progress */
+    hpipe->TxState = 1U;
+
+    /* Update the packet total length */
+    pdev->ep_in[hpipe->InEpAdd & 0xFU].total_length = hpipe->TxLength;
+
+    /* Transmit next packet */
+    (void)USBD_LL_Transmit(pdev, hpipe->InEpAdd, hpipe->TxBuffer, hpipe->TxLength);
+
+    ret = USBD_OK;
+  }
+
+  return (uint8_t)ret;
+}
+
+/**
+  * @brief  USBD_MIDI_ReceivePacket
+  *         prepare OUT Endpoint for reception
+  * @param  pdev: device instance
+  * @param  pipe: endpoint pair, 0 or 1
+  * @param  ClassId: The Class ID
+  * @retval status
+  */
+#ifdef USE_USBD_COMPOSITE
+uint8_t USBD_MIDI_ReceivePacket(USBD_HandleTypeDef *pdev, uint8_t pipe, uint8_t ClassId)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[ClassId];
+#else
+uint8_t USBD_MIDI_ReceivePacket(USBD_HandleTypeDef *pdev, uint8_t pipe)
+{
+  USBD_MIDI_HandleTypeDef *husbmidi = (USBD_MIDI_HandleTypeDef *)pdev->pClassDataCmsit[pdev->classId];
+#endif /* USE_USBD_COMPOSITE */
+
+  USBD_MIDI_PipeTypeDef *hpipe;
+
+  if ((husbmidi == NULL) || (pipe >= USBD_MIDI_NUM_PIPES))
+  {
+    return (uint8_t)USBD_FAIL;
+  }
+
+  hpipe = &husbmidi->Pipe[pipe];
+
+  if (pdev->dev_speed == USBD_SPEED_HIGH)
+  {
+    /* Prepare Out endpoint to receive next packet */
+    (void)USBD_LL_PrepareReceive(pdev, hpipe->OutEpAdd, hpipe->RxBuffer,
+                                 MIDI_DATA_HS_OUT_PACKET_SIZE);
+  }
+  else
+  {
+    /* Prepare Out endpoint to receive next packet */
+    (void)USBD_LL_PrepareReceive(pdev, hpipe->OutEpAdd, hpipe->RxBuffer,
+                                 MIDI_DATA_FS_OUT_PACKET_SIZE);
+  }
+
+  return (uint8_t)USBD_OK;
+}
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
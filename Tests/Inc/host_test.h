@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file           : host_test.h
+  * @brief          : Checks shared by the host tests. Each test is one
+  *                   program; a failed check is reported and counted, and
+  *                   TEST_RESULT() turns the count into the exit status.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_TEST_H
+#define __HOST_TEST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+static unsigned int test_failures;
+
+#define CHECK(cond)                                                           \
+  do                                                                          \
+  {                                                                           \
+    if (!(cond))                                                              \
+    {                                                                         \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);        \
+      test_failures++;                                                        \
+    }                                                                         \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                        \
+  do                                                                          \
+  {                                                                           \
+    unsigned long long va_ = (unsigned long long)(a);                         \
+    unsigned long long vb_ = (unsigned long long)(b);                         \
+    if (va_ != vb_)                                                           \
+    {                                                                         \
+      printf("%s:%d: check failed: %s == %s (0x%llx != 0x%llx)\n",           \
+             __FILE__, __LINE__, #a, #b, va_, vb_);                           \
+      test_failures++;                                                        \
+    }                                                                         \
+  } while (0)
+
+#define TEST_RESULT()                                                         \
+  ((test_failures == 0U) ? (printf("ok\n"), 0) : (printf("%u failed\n", test_failures), 1))
+
+/* Exported functions --------------------------------------------------------*/
+
+/* Wall clock in seconds, for the benchmarks */
+static inline double test_seconds(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_TEST_H */
@@ -0,0 +1,97 @@
+/**
+  ******************************************************************************
+  * @file           : pad_file.h
+  * @brief          : Header for pad_file.c file.
+  *                   Recorded pickup samples for the pad scanner host tests.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PAD_FILE_H
+#define __PAD_FILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "pad_scan.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* ADC1 frame rate with the clocks of Marimba.ioc, see ADC1_GetFrameFreq() */
+#define PADFILE_SAMPLE_HZ         12626U
+#define PADFILE_PADS              8U
+
+/* Frames per PAD_Process() call, as the DMA half transfers deliver them */
+#define PADFILE_BLOCK             16U
+
+/* Pad setup of the recordings: the synthesized strikes span this range */
+#define PADFILE_THRESHOLD         1000U
+#define PADFILE_FULL              28000U
+
+/* A strike counts as detected when the note on leaves within this window */
+#define PADFILE_MATCH_US          10000U
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Interleaved 16-bit little endian frames, one sample per pad, in the order
+   the ADC scan sequence leaves them in the DMA buffer. The strikes that
+   were played, if known, are in a text file next to it, named <file>.truth:
+   one "<seconds> <pad> <peak>" line per strike. */
+typedef struct
+{
+  uint16_t *samples;
+  uint32_t frames;
+  uint8_t  pads;
+  uint32_t sample_hz;
+  double  *truth_time;
+  uint8_t *truth_pad;
+  double  *truth_peak;
+  uint32_t strikes;      /* lines in the truth file, 0 if there is none */
+} PADFILE_RecordingTypeDef;
+
+typedef struct
+{
+  uint32_t frame;        /* end of the block the note on left in */
+  uint8_t  pad;
+  uint8_t  velocity;
+} PADFILE_HitTypeDef;
+
+typedef struct
+{
+  uint32_t strikes;
+  uint32_t detected;
+  uint32_t false_hits;
+  uint32_t vel_off;      /* velocity more than PADFILE_VEL_TOLERANCE off */
+  double   latency_avg_ms;
+  double   latency_max_ms;
+} PADFILE_ScoreTypeDef;
+
+#define PADFILE_VEL_TOLERANCE     12U
+
+/* The block scan of a scanner: PAD_Process() or a reference of it */
+typedef void (*PADFILE_ProcessTypeDef)(PAD_ScannerTypeDef *ps, const uint16_t *frames,
+                                       uint32_t nframes);
+
+/* Exported functions prototypes ---------------------------------------------*/
+int PADFILE_Load(PADFILE_RecordingTypeDef *rec, const char *path, uint8_t pads,
+                 uint32_t sample_hz);
+void PADFILE_Free(PADFILE_RecordingTypeDef *rec);
+void PADFILE_Setup(PAD_ScannerTypeDef *ps, const PADFILE_RecordingTypeDef *rec,
+                   PAD_SendTypeDef send);
+uint32_t PADFILE_Replay(PAD_ScannerTypeDef *ps, const PADFILE_RecordingTypeDef *rec,
+                        PADFILE_HitTypeDef *hits, uint32_t max);
+uint32_t PADFILE_ReplayWith(PAD_ScannerTypeDef *ps, const PADFILE_RecordingTypeDef *rec,
+                            PADFILE_ProcessTypeDef process,
+                            PADFILE_HitTypeDef *hits, uint32_t max);
+void PADFILE_Score(const PAD_ScannerTypeDef *ps, const PADFILE_RecordingTypeDef *rec,
+                   const PADFILE_HitTypeDef *hits, uint32_t nhits,
+                   PADFILE_ScoreTypeDef *score);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PAD_FILE_H */
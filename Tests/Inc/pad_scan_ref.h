@@ -0,0 +1,28 @@
+/**
+  ******************************************************************************
+  * @file           : pad_scan_ref.h
+  * @brief          : Header for pad_scan_ref.c file.
+  *                   Scalar reference of the pad strike detector.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PAD_SCAN_REF_H
+#define __PAD_SCAN_REF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "pad_scan.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+void PADREF_Process(PAD_ScannerTypeDef *ps, const uint16_t *frames, uint32_t nframes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PAD_SCAN_REF_H */
@@ -0,0 +1,71 @@
+/**
+  ******************************************************************************
+  * @file           : usb_sim.h
+  * @brief          : Header for usb_sim.c file.
+  *                   A simulated bus in place of usbd_conf.c and the PCD
+  *                   driver, so the host tests can run the device stack and
+  *                   play the USB host: control transfers on EP0, and bulk
+  *                   packets on the other endpoints, one at a time.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USB_SIM_H
+#define __USB_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "usbd_core.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define USBSIM_EP0_SIZE           512U    /* longest control data stage */
+#define USBSIM_NAK                (-1)    /* USBSIM_In(): nothing queued */
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct
+{
+  uint8_t  *buf;         /* transfer the class queued, NULL if none */
+  uint32_t len;
+  uint32_t sent;
+  uint16_t mps;
+} USBSIM_InEpTypeDef;
+
+typedef struct
+{
+  uint8_t  *buf;         /* armed by USBD_LL_PrepareReceive(), NULL if none */
+  uint32_t size;
+  uint32_t rx_len;
+  uint16_t mps;
+} USBSIM_OutEpTypeDef;
+
+typedef struct
+{
+  USBSIM_InEpTypeDef in[16];
+  USBSIM_OutEpTypeDef out[16];
+  uint8_t  ep0[USBSIM_EP0_SIZE];  /* data stage of the last control IN */
+  uint16_t ep0_len;
+  uint32_t stalls;       /* USBD_LL_StallEP() calls */
+  uint32_t tick;         /* HAL_GetTick(), in ms */
+} USBSIM_BusTypeDef;
+
+/* Exported variables --------------------------------------------------------*/
+extern USBSIM_BusTypeDef USBSIM;
+extern PCD_HandleTypeDef USBSIM_Pcd;
+
+/* Exported functions prototypes ---------------------------------------------*/
+uint8_t USBSIM_Control(USBD_HandleTypeDef *pdev, uint8_t bmRequest, uint8_t bRequest,
+                       uint16_t wValue, uint16_t wIndex, uint16_t wLength, const uint8_t *data);
+uint8_t USBSIM_Enumerate(USBD_HandleTypeDef *pdev, USBD_SpeedTypeDef speed);
+int32_t USBSIM_In(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *dst);
+uint8_t USBSIM_Out(USBD_HandleTypeDef *pdev, uint8_t ep_addr, const uint8_t *data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USB_SIM_H */
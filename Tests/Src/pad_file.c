@@ -0,0 +1,256 @@
+/**
+  ******************************************************************************
+  * @file           : pad_file.c
+  * @brief          : Recorded pickup samples for the pad scanner host tests:
+  *                   loading, replay through a scanner in DMA sized blocks,
+  *                   and scoring of the note ons against the strikes that
+  *                   were played.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pad_file.h"
+
+/* Private variables ---------------------------------------------------------*/
+static const PAD_ScannerTypeDef *replay_ps;
+static PADFILE_HitTypeDef *replay_hits;
+static uint32_t replay_max;
+static uint32_t replay_n;
+static uint32_t replay_frame;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void replay_send(uint32_t event)
+{
+  uint8_t pad;
+
+  if (((MIDI_EVENT_STATUS(event) & 0xF0U) != 0x90U) || (replay_n >= replay_max))
+  {
+    return;
+  }
+  for (pad = 0U; pad < replay_ps->pads; pad++)
+  {
+    if (replay_ps->cfg[pad].note == MIDI_EVENT_DATA1(event))
+    {
+      replay_hits[replay_n].frame = replay_frame;
+      replay_hits[replay_n].pad = pad;
+      replay_hits[replay_n].velocity = (uint8_t)MIDI_EVENT_DATA2(event);
+      replay_n++;
+      return;
+    }
+  }
+}
+
+static void load_truth(PADFILE_RecordingTypeDef *rec, const char *path)
+{
+  char name[1024];
+  FILE *f;
+  double t, peak;
+  unsigned int pad;
+  uint32_t size = 0U;
+
+  snprintf(name, sizeof(name), "%s.truth", path);
+  f = fopen(name, "r");
+  if (f == NULL)
+  {
+    return;
+  }
+  while (fscanf(f, "%lf %u %lf", &t, &pad, &peak) == 3)
+  {
+    if (rec->strikes == size)
+    {
+      size = (size != 0U) ? (2U * size) : 256U;
+      rec->truth_time = realloc(rec->truth_time, size * sizeof(double));
+      rec->truth_pad = realloc(rec->truth_pad, size);
+      rec->truth_peak = realloc(rec->truth_peak, size * sizeof(double));
+    }
+    rec->truth_time[rec->strikes] = t;
+    rec->truth_pad[rec->strikes] = (uint8_t)pad;
+    rec->truth_peak[rec->strikes] = peak;
+    rec->strikes++;
+  }
+  fclose(f);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Read a recording and its truth file, if there is one
+  * @param  rec: recording to fill
+  * @param  path: sample file
+  * @param  pads: samples per frame
+  * @param  sample_hz: frames per second
+  * @retval 0 on success, -1 if the file cannot be read
+  */
+int PADFILE_Load(PADFILE_RecordingTypeDef *rec, const char *path, uint8_t pads,
+                 uint32_t sample_hz)
+{
+  FILE *f;
+  long size;
+
+  memset(rec, 0, sizeof(*rec));
+  f = fopen(path, "rb");
+  if (f == NULL)
+  {
+    return -1;
+  }
+  fseek(f, 0, SEEK_END);
+  size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  rec->pads = pads;
+  rec->sample_hz = sample_hz;
+  rec->frames = (uint32_t)((unsigned long)size / (2UL * pads));
+  rec->samples = malloc((size_t)rec->frames * pads * sizeof(uint16_t) + 1U);
+  if ((rec->samples == NULL) ||
+      (fread(rec->samples, sizeof(uint16_t) * pads, rec->frames, f) != rec->frames))
+  {
+    fclose(f);
+    PADFILE_Free(rec);
+    return -1;
+  }
+  fclose(f);
+  load_truth(rec, path);
+  return 0;
+}
+
+/**
+  * @brief  Release the buffers of a recording
+  * @param  rec: recording
+  * @retval None
+  */
+void PADFILE_Free(PADFILE_RecordingTypeDef *rec)
+{
+  free(rec->samples);
+  free(rec->truth_time);
+  free(rec->truth_pad);
+  free(rec->truth_peak);
+  memset(rec, 0, sizeof(*rec));
+}
+
+/**
+  * @brief  Set a scanner up for a recording: one pad per sample of a frame,
+  *         notes from middle C upwards, the level range of the recordings
+  * @param  ps: scanner instance
+  * @param  rec: recording
+  * @param  send: output of the note events
+  * @retval None
+  */
+void PADFILE_Setup(PAD_ScannerTypeDef *ps, const PADFILE_RecordingTypeDef *rec,
+                   PAD_SendTypeDef send)
+{
+  uint8_t i;
+
+  PAD_Init(ps, rec->pads, rec->sample_hz, 0U, 0U, send);
+  for (i = 0U; i < rec->pads; i++)
+  {
+    PAD_SetPad(ps, i, (uint8_t)(60U + i), PADFILE_THRESHOLD, PADFILE_FULL);
+  }
+}
+
+/**
+  * @brief  Run a recording through a scanner in PADFILE_BLOCK frame blocks
+  * @param  ps: scanner instance, set up for the recording
+  * @param  rec: recording
+  * @param  hits: note ons, in the order they were sent
+  * @param  max: room in hits
+  * @retval number of note ons
+  */
+uint32_t PADFILE_Replay(PAD_ScannerTypeDef *ps, const PADFILE_RecordingTypeDef *rec,
+                        PADFILE_HitTypeDef *hits, uint32_t max)
+{
+  return PADFILE_ReplayWith(ps, rec, PAD_Process, hits, max);
+}
+
+/**
+  * @brief  Run a recording through another block scan of a scanner
+  * @note   The send callback of the scanner is replaced for the run and put
+  *         back afterwards.
+  * @param  ps: scanner instance, set up for the recording
+  * @param  rec: recording
+  * @param  process: block scan
+  * @param  hits: note ons, in the order they were sent
+  * @param  max: room in hits
+  * @retval number of note ons
+  */
+uint32_t PADFILE_ReplayWith(PAD_ScannerTypeDef *ps, const PADFILE_RecordingTypeDef *rec,
+                            PADFILE_ProcessTypeDef process,
+                            PADFILE_HitTypeDef *hits, uint32_t max)
+{
+  PAD_SendTypeDef send = ps->send;
+  uint32_t f;
+
+  replay_ps = ps;
+  replay_hits = hits;
+  replay_max = max;
+  replay_n = 0U;
+  ps->send = replay_send;
+  for (f = 0U; f + PADFILE_BLOCK <= rec->frames; f += PADFILE_BLOCK)
+  {
+    replay_frame = f + PADFILE_BLOCK;
+    process(ps, &rec->samples[(size_t)f * rec->pads], PADFILE_BLOCK);
+  }
+  ps->send = send;
+  return replay_n;
+}
+
+/**
+  * @brief  Match the note ons of a replay against the truth of a recording
+  * @note   Each strike takes the first unused note on of its pad that left
+  *         within PADFILE_MATCH_US of it. The velocity it should have had
+  *         is the peak mapped linearly over the pad range.
+  * @param  ps: scanner the recording was replayed through
+  * @param  rec: recording, with its truth
+  * @param  hits: note ons of the replay
+  * @param  nhits: number of note ons
+  * @param  score: result
+  * @retval None
+  */
+void PADFILE_Score(const PAD_ScannerTypeDef *ps, const PADFILE_RecordingTypeDef *rec,
+                   const PADFILE_HitTypeDef *hits, uint32_t nhits,
+                   PADFILE_ScoreTypeDef *score)
+{
+  uint8_t *used = calloc(nhits + 1U, 1U);
+  const PAD_ConfigTypeDef *pc;
+  double dt, sum = 0.0;
+  uint32_t i, j;
+  int32_t v;
+
+  memset(score, 0, sizeof(*score));
+  score->strikes = rec->strikes;
+  for (i = 0U; i < rec->strikes; i++)
+  {
+    for (j = 0U; j < nhits; j++)
+    {
+      dt = (double)hits[j].frame / rec->sample_hz - rec->truth_time[i];
+      if ((used[j] != 0U) || (hits[j].pad != rec->truth_pad[i]) ||
+          (dt < 0.0) || (dt >= PADFILE_MATCH_US * 1e-6))
+      {
+        continue;
+      }
+      used[j] = 1U;
+      score->detected++;
+      sum += dt;
+      if (dt * 1e3 > score->latency_max_ms)
+      {
+        score->latency_max_ms = dt * 1e3;
+      }
+      pc = &ps->cfg[hits[j].pad];
+      v = 1 + (int32_t)((rec->truth_peak[i] - pc->threshold) * 126.0 / (pc->full - pc->threshold));
+      v = (v > 127) ? 127 : ((v < 1) ? 1 : v);
+      if (abs(v - (int32_t)hits[j].velocity) > (int32_t)PADFILE_VEL_TOLERANCE)
+      {
+        score->vel_off++;
+      }
+      break;
+    }
+  }
+  for (j = 0U; j < nhits; j++)
+  {
+    score->false_hits += (used[j] == 0U) ? 1U : 0U;
+  }
+  score->latency_avg_ms = (score->detected != 0U) ? (sum * 1e3 / score->detected) : 0.0;
+  free(used);
+}
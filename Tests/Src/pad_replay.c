@@ -0,0 +1,220 @@
+/**
+  ******************************************************************************
+  * @file           : pad_replay.c
+  * @brief          : Runs a pickup recording through the pad scanner, scores
+  *                   the note ons against the truth file of the recording
+  *                   and measures the scan throughput.
+  *
+  *                   usage: pad_replay [options] <file.raw>
+  *                     -p pads       samples per frame (8)
+  *                     -r hz         frames per second (12626)
+  *                     -d percent    lowest share of strikes detected (95)
+  *                     -f percent    highest share of false note ons (1)
+  *                     -l ms         highest note on latency (none)
+  *                     -x coupling   crosstalk share between neighbouring
+  *                                   pads, 1/256 steps (0)
+  *                     -c file.raw   learn the crosstalk couplings from
+  *                                   this recording first, see
+  *                                   PAD_XtalkCalibrate()
+  *                     -w us         watch spacing of idle pads, 0 to scan
+  *                                   every frame, see PAD_SetWatch() (250)
+  *                     -b repeats    benchmark: scan the file this many
+  *                                   times more and print the throughput
+  *
+  *                   The exit status is non-zero when the truth file is
+  *                   there and the score is outside the -d / -f / -l
+  *                   limits.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "host_test.h"
+#include "pad_file.h"
+
+/* Private variables ---------------------------------------------------------*/
+static PAD_ScannerTypeDef scanner;
+static PADFILE_RecordingTypeDef rec;
+static uint8_t xtalk[PAD_MAX_PADS][PAD_MAX_PADS];
+static uint32_t watch_us = PAD_WATCH_US;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void discard(uint32_t event)
+{
+  (void)event;
+}
+
+/* The recording setup plus the crosstalk matrix and the watch spacing */
+static void setup(PAD_SendTypeDef send)
+{
+  PADFILE_Setup(&scanner, &rec, send);
+  memcpy(scanner.xt, xtalk, sizeof(xtalk));
+  PAD_SetWatch(&scanner, watch_us);
+}
+
+static void neighbours(uint8_t coupling)
+{
+  uint8_t i;
+
+  for (i = 0U; i + 1U < PAD_MAX_PADS; i++)
+  {
+    xtalk[i][i + 1U] = coupling;
+    xtalk[i + 1U][i] = coupling;
+  }
+}
+
+static int calibrate(const char *path)
+{
+  PADFILE_RecordingTypeDef cal;
+  uint32_t f;
+  uint8_t i, j;
+
+  if (PADFILE_Load(&cal, path, rec.pads, rec.sample_hz) != 0)
+  {
+    return -1;
+  }
+  PADFILE_Setup(&scanner, &cal, discard);
+  PAD_XtalkCalibrate(&scanner, 1U);
+  for (f = 0U; f + PADFILE_BLOCK <= cal.frames; f += PADFILE_BLOCK)
+  {
+    PAD_Process(&scanner, &cal.samples[(size_t)f * cal.pads], PADFILE_BLOCK);
+  }
+  PAD_XtalkCalibrate(&scanner, 0U);
+  memcpy(xtalk, scanner.xt, sizeof(xtalk));
+  printf("%s: couplings learned from %.1f s, 1/256 of the struck pad:\n", path,
+         (double)cal.frames / cal.sample_hz);
+  for (i = 0U; i < rec.pads; i++)
+  {
+    printf("  pad %u:", i);
+    for (j = 0U; j < rec.pads; j++)
+    {
+      printf(" %3u", xtalk[i][j]);
+    }
+    printf("\n");
+  }
+  PADFILE_Free(&cal);
+  return 0;
+}
+
+static void benchmark(uint32_t repeats)
+{
+  double t0, s;
+  uint32_t r, f;
+
+  setup(discard);
+  t0 = test_seconds();
+  for (r = 0U; r < repeats; r++)
+  {
+    for (f = 0U; f + PADFILE_BLOCK <= rec.frames; f += PADFILE_BLOCK)
+    {
+      PAD_Process(&scanner, &rec.samples[(size_t)f * rec.pads], PADFILE_BLOCK);
+    }
+  }
+  s = test_seconds() - t0;
+  printf("scan: %.1f M samples/s per pad, %.1f M samples/s for %u pads, "
+         "%u cycles per %u frame block (max %u), %.0f %% of the samples looked at\n",
+         (double)scanner.stats.samples / s * 1e-6,
+         (double)scanner.stats.samples * rec.pads / s * 1e-6, rec.pads,
+         scanner.stats.cycles_sum / scanner.stats.blocks, PADFILE_BLOCK,
+         scanner.stats.cycles_max,
+         100.0 * scanner.stats.scanned / ((double)scanner.stats.samples * rec.pads));
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+  uint32_t pads = PADFILE_PADS, hz = PADFILE_SAMPLE_HZ, repeats = 0U;
+  double min_detect = 95.0, max_false = 1.0, max_latency = 0.0;
+  const char *cal_path = NULL;
+  PADFILE_ScoreTypeDef score;
+  PADFILE_HitTypeDef *hits;
+  uint32_t nhits;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "p:r:d:f:l:x:c:w:b:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'p':
+        pads = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+
+      case 'r':
+        hz = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+
+      case 'd':
+        min_detect = atof(optarg);
+        break;
+
+      case 'f':
+        max_false = atof(optarg);
+        break;
+
+      case 'l':
+        max_latency = atof(optarg);
+        break;
+
+      case 'x':
+        neighbours((uint8_t)strtoul(optarg, NULL, 0));
+        break;
+
+      case 'c':
+        cal_path = optarg;
+        break;
+
+      case 'w':
+        watch_us = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+
+      case 'b':
+        repeats = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+
+      default:
+        fprintf(stderr, "usage: %s [-p pads] [-r hz] [-d percent] [-f percent] [-l ms] "
+                "[-x coupling] [-c file.raw] [-w us] [-b repeats] <file.raw>\n", argv[0]);
+        return 2;
+    }
+  }
+  if ((optind >= argc) || (pads == 0U) || (pads > PAD_MAX_PADS) ||
+      (PADFILE_Load(&rec, argv[optind], (uint8_t)pads, hz) != 0))
+  {
+    fprintf(stderr, "%s: cannot read a recording\n", argv[0]);
+    return 2;
+  }
+
+  if ((cal_path != NULL) && (calibrate(cal_path) != 0))
+  {
+    fprintf(stderr, "%s: cannot read %s\n", argv[0], cal_path);
+    return 2;
+  }
+
+  hits = malloc((rec.frames / 8U + 1U) * sizeof(*hits));
+  setup(discard);
+  nhits = PADFILE_Replay(&scanner, &rec, hits, rec.frames / 8U + 1U);
+  printf("%s: %.1f s, %u pads, %u note ons, %u dropped as crosstalk\n", argv[optind],
+         (double)rec.frames / rec.sample_hz, rec.pads, nhits, scanner.stats.suppressed);
+  if (rec.strikes != 0U)
+  {
+    PADFILE_Score(&scanner, &rec, hits, nhits, &score);
+    printf("strikes %u, detected %u, false %u, velocity off by more than %u: %u, "
+           "latency %.2f ms average, %.2f ms max\n",
+           score.strikes, score.detected, score.false_hits, PADFILE_VEL_TOLERANCE,
+           score.vel_off, score.latency_avg_ms, score.latency_max_ms);
+    CHECK(score.detected * 100.0 >= min_detect * score.strikes);
+    CHECK(score.false_hits * 100.0 <= max_false * score.strikes);
+    CHECK((max_latency == 0.0) || (score.latency_max_ms <= max_latency));
+  }
+  if (repeats != 0U)
+  {
+    benchmark(repeats);
+  }
+  free(hits);
+  PADFILE_Free(&rec);
+  return TEST_RESULT();
+}
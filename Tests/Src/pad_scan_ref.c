@@ -0,0 +1,127 @@
+/**
+  ******************************************************************************
+  * @file           : pad_scan_ref.c
+  * @brief          : Scalar reference of the pad strike detector.
+  *
+  *                   This is the detector pad_scan.c had before the pads
+  *                   were scanned in SIMD lanes: one pad at a time, one
+  *                   sample at a time, with the resting level and the
+  *                   retrigger level updated per sample and the velocity
+  *                   from a divide. It runs on a scanner set up by
+  *                   PAD_Init() and PAD_SetPad(), and knows nothing of
+  *                   watch mode or crosstalk, so the two are only compared
+  *                   with both off.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "pad_scan_ref.h"
+#include "mcu_port.h"
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint8_t velocity(const PAD_ScannerTypeDef *ps, const PAD_ConfigTypeDef *pc, uint32_t peak)
+{
+  uint32_t v;
+
+  if (peak >= pc->full)
+  {
+    v = 127U;
+  }
+  else
+  {
+    v = 1U + ((peak - pc->threshold) * 126U) / (uint32_t)(pc->full - pc->threshold);
+  }
+  v = ps->curve[v];
+  return (v != 0U) ? (uint8_t)v : 1U;
+}
+
+static void scan_pad(PAD_ScannerTypeDef *ps, uint8_t pad, const uint16_t *x, uint32_t n)
+{
+  PAD_StateTypeDef *st = &ps->st[pad];
+  const PAD_ConfigTypeDef *pc = &ps->cfg[pad];
+  int32_t base = st->baseline;
+  uint32_t floor = st->floor;
+  int32_t d;
+  uint32_t env;
+
+  for (; n > 0U; n--, x += ps->pads)
+  {
+    d = (int32_t)*x - (base >> 8);
+    env = (uint32_t)((d < 0) ? -d : d);
+
+    switch (st->state)
+    {
+      case PAD_IDLE:
+        floor -= floor >> PAD_RETRIGGER_SHIFT;
+        if ((env > pc->threshold) && (env > (floor >> 16)))
+        {
+          st->state = PAD_SCAN;
+          st->peak = (uint16_t)env;
+          st->count = ps->scan_samples;
+        }
+        else
+        {
+          base += (((int32_t)*x << 8) - base) >> PAD_BASELINE_SHIFT;
+        }
+        break;
+
+      case PAD_SCAN:
+        if (env > st->peak)
+        {
+          st->peak = (uint16_t)env;
+        }
+        if (--st->count == 0U)
+        {
+          st->velocity = velocity(ps, pc, st->peak);
+          floor = (uint32_t)st->peak << 16;
+          ps->send(MIDI_EVENT_CHANNEL(ps->cable, 0x90U | ps->channel, pc->note, st->velocity));
+          ps->stats.strikes++;
+          st->state = PAD_MASK;
+          st->count = ps->mask_samples;
+        }
+        break;
+
+      default:
+        if (--st->count == 0U)
+        {
+          ps->send(MIDI_EVENT_CHANNEL(ps->cable, 0x80U | ps->channel, pc->note, 0x40U));
+          st->state = PAD_IDLE;
+        }
+        break;
+    }
+  }
+  st->baseline = base;
+  st->floor = floor;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Scan a block of samples, pad after pad
+  * @param  ps: scanner instance
+  * @param  frames: nframes frames of ps->pads samples each
+  * @param  nframes: frames in the block
+  * @retval None
+  */
+void PADREF_Process(PAD_ScannerTypeDef *ps, const uint16_t *frames, uint32_t nframes)
+{
+  uint32_t t0 = MCU_CYCLES();
+  uint32_t dt;
+  uint8_t i;
+
+  for (i = 0U; i < ps->pads; i++)
+  {
+    scan_pad(ps, i, &frames[i], nframes);
+  }
+  ps->frame += nframes;
+
+  dt = MCU_CYCLES() - t0;
+  ps->stats.samples += nframes;
+  ps->stats.blocks++;
+  ps->stats.cycles_sum += dt;
+  if (dt > ps->stats.cycles_max)
+  {
+    ps->stats.cycles_max = dt;
+  }
+}
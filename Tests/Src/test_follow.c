@@ -0,0 +1,263 @@
+/**
+  ******************************************************************************
+  * @file           : test_follow.c
+  * @brief          : Clock follower: lock on steady clocks over the tempo
+  *                   range, tempo and phase error on clocks stamped on the
+  *                   1 ms USB frame grid, tempo changes, loss of the
+  *                   master, transport and song position, timer wrap, and
+  *                   the cost per clock.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include "host_test.h"
+#include "midi_follow.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TIMER_HZ                  200000000U
+#define FRAME_COUNTS              (TIMER_HZ / 1000U)
+
+#define EV_CLOCK                  MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, 0xF8U, 0U, 0U)
+#define EV_START                  MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, 0xFAU, 0U, 0U)
+#define EV_CONTINUE               MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, 0xFBU, 0U, 0U)
+#define EV_STOP                   MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, 0xFCU, 0U, 0U)
+#define EV_SONG_POSITION(p)       MIDI_EVENT(0U, MIDI_CIN_SYSCOM_3, 0xF2U, (p) & 0x7FU, (p) >> 7)
+
+/* Private variables ---------------------------------------------------------*/
+static MIDI_FollowTypeDef follow;
+static uint32_t rng = 1U;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t rnd(void)
+{
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static double period_of(double bpm)
+{
+  return (double)TIMER_HZ * 60.0 / (bpm * 24.0);
+}
+
+static double tempo_of(const MIDI_FollowTypeDef *pf)
+{
+  return MIDI_Follow_GetTempo(pf) / 100.0;
+}
+
+static void test_steady(void)
+{
+  static const double bpms[] = { 20.0, 25.0, 29.0, 120.0, 300.0 };
+  double per;
+  uint32_t k, i, now = 0U, pos;
+
+  for (k = 0U; k < sizeof(bpms) / sizeof(bpms[0]); k++)
+  {
+    per = period_of(bpms[k]);
+    MIDI_Follow_Init(&follow, TIMER_HZ);
+    MIDI_Follow_Event(&follow, EV_START, 0U);
+    for (i = 0U; i < 100U; i++)
+    {
+      now = (uint32_t)(1000.0 + i * per);
+      MIDI_Follow_Event(&follow, EV_CLOCK, now);
+      if (i == MIDI_FOLLOW_STAGE_CLOCKS - 2U)
+      {
+        CHECK(!MIDI_Follow_IsLocked(&follow, now));
+      }
+    }
+    CHECK(fabs(tempo_of(&follow) - bpms[k]) <= 0.01);
+    CHECK(MIDI_Follow_IsLocked(&follow, now + 1U));
+    CHECK_EQ(follow.stats.resyncs, 0U);
+    /* 100 clocks since start, half way to the next */
+    pos = MIDI_Follow_GetPosition(&follow, now + (uint32_t)(per / 2.0));
+    CHECK_EQ(pos >> 16, 100U);
+    CHECK(((pos & 0xFFFFU) > 0x7E00U) && ((pos & 0xFFFFU) < 0x8200U));
+  }
+
+  /* a clock slower than MIDI_FOLLOW_PERIOD_MAX never gets a period */
+  per = period_of(1.5);
+  MIDI_Follow_Init(&follow, TIMER_HZ);
+  for (i = 0U; i < 20U; i++)
+  {
+    now = (uint32_t)(uint64_t)(i * per);
+    MIDI_Follow_Event(&follow, EV_CLOCK, now);
+  }
+  CHECK_EQ(MIDI_Follow_GetTempo(&follow), 0U);
+  CHECK(!MIDI_Follow_IsLocked(&follow, now));
+}
+
+/* Clocks are seen at the first frame after they are sent, plus up to
+   125 us of interrupt latency */
+static uint32_t usb_stamp(double ideal)
+{
+  return (uint32_t)(uint64_t)(ceil(ideal / FRAME_COUNTS) * FRAME_COUNTS + rnd() % 25000U);
+}
+
+static void test_jitter(void)
+{
+  static const double bpms[] = { 60.0, 123.45, 174.0, 250.0 };
+  static double phase[2000];
+  double per, ideal, tempo_err, phase_err, phase_mean, e;
+  uint32_t k, i;
+
+  for (k = 0U; k < sizeof(bpms) / sizeof(bpms[0]); k++)
+  {
+    per = period_of(bpms[k]);
+    tempo_err = 0.0;
+    phase_err = 0.0;
+    phase_mean = 0.0;
+    MIDI_Follow_Init(&follow, TIMER_HZ);
+    for (i = 0U; i < 2000U; i++)
+    {
+      ideal = 12345.0 + i * per;
+      MIDI_Follow_Event(&follow, EV_CLOCK, usb_stamp(ideal));
+      phase[i] = (double)(int32_t)(follow.beat_time - (uint32_t)(uint64_t)ideal);
+      if (i >= 200U)
+      {
+        e = fabs(tempo_of(&follow) - bpms[k]);
+        tempo_err = (e > tempo_err) ? e : tempo_err;
+        phase_mean += phase[i] / 1800.0;
+      }
+    }
+    /* the filtered beat sits on the mean delay of the frame grid, which
+       depends on how the clock falls on it; what counts is the wander */
+    for (i = 200U; i < 2000U; i++)
+    {
+      e = fabs(phase[i] - phase_mean);
+      phase_err = (e > phase_err) ? e : phase_err;
+    }
+    printf("jitter: %.2f BPM, tempo within %.3f BPM, beat within %.0f us, "
+           "arrivals within %u us\n", bpms[k], tempo_err, phase_err * 1e6 / TIMER_HZ,
+           (uint32_t)(follow.stats.jitter_max / (TIMER_HZ / 1000000U)));
+    CHECK_EQ(follow.stats.resyncs, 0U);
+    CHECK(MIDI_Follow_IsLocked(&follow, follow.beat_time));
+    CHECK(tempo_err < 0.1 * bpms[k] / 100.0);
+    CHECK(phase_err * 1e6 / TIMER_HZ < 250.0);
+  }
+}
+
+static void test_tempo_change(void)
+{
+  double t = 0.0;
+  uint32_t i, settle = 0U;
+
+  /* a ramp of 2 % is followed, a jump of 10 % acquires again */
+  MIDI_Follow_Init(&follow, TIMER_HZ);
+  for (i = 0U; i < 200U; i++, t += period_of(120.0))
+  {
+    MIDI_Follow_Event(&follow, EV_CLOCK, usb_stamp(t));
+  }
+  for (i = 0U; i < 96U; i++, t += period_of(120.0 + 2.4 * i / 96.0))
+  {
+    MIDI_Follow_Event(&follow, EV_CLOCK, usb_stamp(t));
+  }
+  for (i = 0U; i < 200U; i++, t += period_of(122.4))
+  {
+    MIDI_Follow_Event(&follow, EV_CLOCK, usb_stamp(t));
+  }
+  CHECK_EQ(follow.stats.resyncs, 0U);
+  CHECK(fabs(tempo_of(&follow) - 122.4) < 0.15);
+
+  for (i = 0U; i < 400U; i++, t += period_of(134.64))
+  {
+    MIDI_Follow_Event(&follow, EV_CLOCK, usb_stamp(t));
+    if ((settle == 0U) && MIDI_Follow_IsLocked(&follow, follow.beat_time) &&
+        (fabs(tempo_of(&follow) - 134.64) < 0.15))
+    {
+      settle = i + 1U;
+    }
+  }
+  printf("tempo change: 10 %% jump settled in %u clocks, %u resyncs\n", settle, follow.stats.resyncs);
+  CHECK_EQ(follow.stats.resyncs, 1U);
+  CHECK(settle > 0U);
+  CHECK(settle <= 4U * MIDI_FOLLOW_STAGE_CLOCKS);
+  CHECK(fabs(tempo_of(&follow) - 134.64) < 0.15);
+}
+
+static void test_transport(void)
+{
+  double per = period_of(120.0);
+  uint32_t i, now = 0U, pos;
+
+  MIDI_Follow_Init(&follow, TIMER_HZ);
+  for (i = 0U; i < 48U; i++)
+  {
+    now = (uint32_t)(i * per);
+    MIDI_Follow_Event(&follow, EV_CLOCK, now);
+  }
+  /* stopped: the clock is followed, the position is not moved */
+  CHECK(MIDI_Follow_IsLocked(&follow, now));
+  CHECK_EQ(MIDI_Follow_GetPosition(&follow, now + 1000U), 0U);
+
+  /* song position counts in sixteenths, six clocks each, and only while
+     stopped */
+  MIDI_Follow_Event(&follow, EV_SONG_POSITION(200U), now);
+  CHECK_EQ(MIDI_Follow_GetPosition(&follow, now) >> 16, 1200U);
+  MIDI_Follow_Event(&follow, EV_CONTINUE, now);
+  MIDI_Follow_Event(&follow, EV_SONG_POSITION(5U), now);
+  for (i = 48U; i < 60U; i++)
+  {
+    now = (uint32_t)(i * per);
+    MIDI_Follow_Event(&follow, EV_CLOCK, now);
+  }
+  CHECK_EQ(MIDI_Follow_GetPosition(&follow, now) >> 16, 1212U);
+
+  /* the fraction holds at the next clock if it is late */
+  pos = MIDI_Follow_GetPosition(&follow, now + (uint32_t)(per * 3.0));
+  CHECK_EQ(pos, (1212UL << 16) + 0xFFFFU);
+  MIDI_Follow_Event(&follow, EV_STOP, now);
+  CHECK_EQ(MIDI_Follow_GetPosition(&follow, now + (uint32_t)(per / 2.0)), 1212UL << 16);
+  MIDI_Follow_Event(&follow, EV_START, now);
+  CHECK_EQ(MIDI_Follow_GetPosition(&follow, now), 0U);
+
+  /* the master stops sending */
+  CHECK(MIDI_Follow_IsLocked(&follow, now + (uint32_t)(per * (MIDI_FOLLOW_TIMEOUT_CLOCKS - 1U))));
+  CHECK(!MIDI_Follow_IsLocked(&follow, now + (uint32_t)(per * (MIDI_FOLLOW_TIMEOUT_CLOCKS + 1U))));
+}
+
+static void test_wrap(void)
+{
+  double per = period_of(97.0);
+  uint32_t i, base = 0xFFFFFFFFU - (uint32_t)(50.0 * per);
+
+  /* the timestamps run through 2^32 half way */
+  MIDI_Follow_Init(&follow, TIMER_HZ);
+  for (i = 0U; i < 100U; i++)
+  {
+    MIDI_Follow_Event(&follow, EV_CLOCK, base + (uint32_t)(i * per));
+  }
+  CHECK_EQ(follow.stats.resyncs, 0U);
+  CHECK(fabs(tempo_of(&follow) - 97.0) <= 0.01);
+  CHECK(MIDI_Follow_IsLocked(&follow, base + (uint32_t)(99.0 * per)));
+}
+
+static void bench(void)
+{
+  double per = period_of(133.0), t0;
+  uint32_t i;
+
+  MIDI_Follow_Init(&follow, TIMER_HZ);
+  t0 = test_seconds();
+  for (i = 0U; i < 10000000U; i++)
+  {
+    MIDI_Follow_Event(&follow, EV_CLOCK, (uint32_t)(uint64_t)(i * per) + (i & 0x3FFFU));
+  }
+  printf("bench: %.1f ns per clock (%u BPM x100)\n", (test_seconds() - t0) * 100.0,
+         MIDI_Follow_GetTempo(&follow));
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  test_steady();
+  test_jitter();
+  test_tempo_change();
+  test_transport();
+  test_wrap();
+  bench();
+  return TEST_RESULT();
+}
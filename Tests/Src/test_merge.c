@@ -0,0 +1,338 @@
+/**
+  ******************************************************************************
+  * @file           : test_merge.c
+  * @brief          : Merge engine: SysEx kept whole per cable and order kept
+  *                   per source and cable under random traffic from several
+  *                   sources, real-time cutting through, weights, the SysEx
+  *                   timeout with the tail dropped, full queues, and the
+  *                   cost per event.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "midi_merge.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SOURCES                   4U
+#define CABLES                    3U
+#define LOG_LEN                   64U
+
+/* Private variables ---------------------------------------------------------*/
+static MIDI_MergeTypeDef merge;
+static uint32_t log_ev[LOG_LEN];
+static uint32_t log_n;
+static uint32_t rng = 7U;
+
+/* What the output checker knows of each cable */
+static uint8_t inside[CABLES];
+static uint8_t next_seq[SOURCES][CABLES];
+static uint32_t out_events, out_rt, errors;
+static uint8_t call_sent_other;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t rnd(void)
+{
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static void capture(uint32_t event)
+{
+  if (log_n < LOG_LEN)
+  {
+    log_ev[log_n] = event;
+  }
+  log_n++;
+}
+
+static void discard(uint32_t event)
+{
+  (void)event;
+}
+
+/* Stress traffic carries its source and a sequence number per source and
+   cable: notes as channel and note number, SysEx packets in their data
+   bytes (F0 src seq, src seq 7F, src seq F7). */
+static void check_out(uint32_t event)
+{
+  uint32_t cable = MIDI_EVENT_CABLE(event), cin = MIDI_EVENT_CIN(event);
+  uint32_t status = MIDI_EVENT_STATUS(event), src, seq;
+
+  out_events++;
+  if ((cin == MIDI_CIN_SINGLE_BYTE) && (status >= 0xF8U))
+  {
+    /* real-time goes ahead of everything else of the pass */
+    errors += call_sent_other;
+    out_rt++;
+    return;
+  }
+  call_sent_other = 1U;
+  if (cin == MIDI_CIN_NOTE_ON)
+  {
+    src = status & 0x0FU;
+    seq = MIDI_EVENT_DATA1(event);
+    errors += (inside[cable] != MIDI_MERGE_NO_SOURCE) ? 1U : 0U;
+  }
+  else
+  {
+    src = (status == 0xF0U) ? MIDI_EVENT_DATA1(event) : status;
+    seq = (status == 0xF0U) ? MIDI_EVENT_DATA2(event) : MIDI_EVENT_DATA1(event);
+    if (inside[cable] == MIDI_MERGE_NO_SOURCE)
+    {
+      errors += ((cin != MIDI_CIN_SYSEX_START) || (status != 0xF0U)) ? 1U : 0U;
+    }
+    else
+    {
+      errors += ((inside[cable] != src) || (status == 0xF0U)) ? 1U : 0U;
+    }
+    inside[cable] = (cin == MIDI_CIN_SYSEX_START) ? (uint8_t)src : MIDI_MERGE_NO_SOURCE;
+  }
+  if ((src >= SOURCES) || (next_seq[src][cable] != seq))
+  {
+    errors++;
+    return;
+  }
+  next_seq[src][cable] = (uint8_t)((seq + 1U) & 0x7FU);
+}
+
+/* Push one whole message of random kind, cable and length, if it fits */
+static uint32_t push_message(uint8_t src, uint8_t *seq)
+{
+  uint32_t cable = rnd() % CABLES, len, i, room;
+  uint8_t *ps = &seq[cable];
+
+  len = ((rnd() % 3U) == 0U) ? 2U + rnd() % 9U : 1U;
+  room = MIDI_MERGE_QUEUE_LEN - (uint16_t)(merge.src[src].wp - merge.src[src].rp);
+  if (room < len)
+  {
+    return 0U;
+  }
+  if (len == 1U)
+  {
+    MIDI_Merge_Push(&merge, src, MIDI_EVENT_CHANNEL(cable, 0x90U | src, *ps, 1U));
+    *ps = (uint8_t)((*ps + 1U) & 0x7FU);
+    return 1U;
+  }
+  MIDI_Merge_Push(&merge, src, MIDI_EVENT(cable, MIDI_CIN_SYSEX_START, 0xF0U, src, *ps));
+  *ps = (uint8_t)((*ps + 1U) & 0x7FU);
+  for (i = 2U; i < len; i++)
+  {
+    MIDI_Merge_Push(&merge, src, MIDI_EVENT(cable, MIDI_CIN_SYSEX_START, src, *ps, 0x7FU));
+    *ps = (uint8_t)((*ps + 1U) & 0x7FU);
+  }
+  MIDI_Merge_Push(&merge, src, MIDI_EVENT(cable, MIDI_CIN_SYSEX_END_3, src, *ps, 0xF7U));
+  *ps = (uint8_t)((*ps + 1U) & 0x7FU);
+  return len;
+}
+
+static void test_stress(void)
+{
+  uint8_t push_seq[SOURCES][CABLES];
+  uint32_t step, pushed = 0U, rt = 0U, s, n;
+
+  MIDI_Merge_Init(&merge, check_out);
+  memset(inside, MIDI_MERGE_NO_SOURCE, sizeof(inside));
+  memset(next_seq, 0, sizeof(next_seq));
+  memset(push_seq, 0, sizeof(push_seq));
+  for (s = 0U; s < SOURCES; s++)
+  {
+    MIDI_Merge_SetWeight(&merge, (uint8_t)s, (uint8_t)(1U + s % 3U));
+  }
+
+  /* whole messages go in, as the producers of main.c push them, so the
+     owner of a cable always has the rest of its SysEx queued: nothing may
+     time out, and everything pushed comes out */
+  for (step = 0U; step < 200000U; step++)
+  {
+    for (n = rnd() % 4U; n > 0U; n--)
+    {
+      s = rnd() % SOURCES;
+      pushed += push_message((uint8_t)s, push_seq[s]);
+    }
+    if (((rnd() % 16U) == 0U) &&
+        (MIDI_Merge_Push(&merge, (uint8_t)(rnd() % SOURCES), MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, 0xF8U, 0U, 0U)) == 0))
+    {
+      rt++;
+    }
+    call_sent_other = 0U;
+    MIDI_Merge_Process(&merge, step, 1U + rnd() % 12U);
+  }
+  do
+  {
+    call_sent_other = 0U;
+  } while (MIDI_Merge_Process(&merge, step++, 64U) != 0U);
+
+  CHECK_EQ(errors, 0U);
+  CHECK_EQ(merge.sysex_aborts, 0U);
+  CHECK_EQ(out_events, pushed + rt);
+  CHECK_EQ(out_rt, rt);
+  CHECK(memcmp(next_seq, push_seq, sizeof(next_seq)) == 0);
+  for (s = 0U; s < CABLES; s++)
+  {
+    CHECK_EQ(merge.owner[s], MIDI_MERGE_NO_SOURCE);
+  }
+  n = 0U;
+  for (s = 0U; s < SOURCES; s++)
+  {
+    n += merge.src[s].stats.blocked;
+  }
+  CHECK(n > 0U);
+  printf("stress: %u events, %u real-time, %u passes held by a SysEx\n", out_events, out_rt, n);
+}
+
+static void test_weights(void)
+{
+  uint32_t i;
+
+  MIDI_Merge_Init(&merge, capture);
+  MIDI_Merge_SetWeight(&merge, 0U, 1U);
+  MIDI_Merge_SetWeight(&merge, 1U, 2U);
+  MIDI_Merge_SetWeight(&merge, 2U, 4U);
+  MIDI_Merge_SetWeight(&merge, 3U, 0U);
+  for (i = 0U; i < 20U; i++)
+  {
+    MIDI_Merge_Push(&merge, 0U, MIDI_EVENT_CHANNEL(0U, 0x90U, i, 1U));
+    MIDI_Merge_Push(&merge, 1U, MIDI_EVENT_CHANNEL(1U, 0x90U, i, 1U));
+    MIDI_Merge_Push(&merge, 2U, MIDI_EVENT_CHANNEL(2U, 0x90U, i, 1U));
+    MIDI_Merge_Push(&merge, 3U, MIDI_EVENT_CHANNEL(3U, 0x90U, i, 1U));
+  }
+  /* one round is 1 + 2 + 4, in source order; a parked source waits */
+  log_n = 0U;
+  CHECK_EQ(MIDI_Merge_Process(&merge, 0U, 14U), 14U);
+  CHECK_EQ(MIDI_EVENT_CABLE(log_ev[0]), 0U);
+  CHECK_EQ(MIDI_EVENT_CABLE(log_ev[1]), 1U);
+  CHECK_EQ(MIDI_EVENT_CABLE(log_ev[3]), 2U);
+  CHECK_EQ(MIDI_EVENT_CABLE(log_ev[7]), 0U);
+  CHECK_EQ(merge.src[0].stats.events, 2U);
+  CHECK_EQ(merge.src[1].stats.events, 4U);
+  CHECK_EQ(merge.src[2].stats.events, 8U);
+  CHECK_EQ(merge.src[3].stats.events, 0U);
+}
+
+static void test_timeout(void)
+{
+  MIDI_Merge_Init(&merge, capture);
+
+  /* source 2 starts a SysEx and goes quiet; source 1 waits for cable 0
+     only */
+  MIDI_Merge_Push(&merge, 2U, MIDI_EVENT(0U, MIDI_CIN_SYSEX_START, 0xF0U, 0x01U, 0x02U));
+  MIDI_Merge_Process(&merge, 0U, 16U);
+  CHECK_EQ(merge.owner[0], 2U);
+  log_n = 0U;
+  MIDI_Merge_Push(&merge, 1U, MIDI_EVENT_CHANNEL(0U, 0x90U, 60U, 100U));
+  MIDI_Merge_Push(&merge, 1U, MIDI_EVENT_CHANNEL(1U, 0x90U, 61U, 100U));
+  MIDI_Merge_Process(&merge, 50U, 16U);
+  CHECK_EQ(log_n, 1U);
+  CHECK_EQ(log_ev[0], MIDI_EVENT_CHANNEL(1U, 0x90U, 61U, 100U));
+  CHECK(merge.src[1].stats.blocked > 0U);
+
+  /* past the timeout the SysEx is closed with F7 and the cable freed */
+  log_n = 0U;
+  MIDI_Merge_Process(&merge, 101U, 16U);
+  CHECK_EQ(log_n, 2U);
+  CHECK_EQ(log_ev[0], MIDI_EVENT(0U, MIDI_CIN_SYSEX_END_1, 0xF7U, 0U, 0U));
+  CHECK_EQ(log_ev[1], MIDI_EVENT_CHANNEL(0U, 0x90U, 60U, 100U));
+  CHECK_EQ(merge.sysex_aborts, 1U);
+
+  /* the late tail is dropped, what follows it is not */
+  log_n = 0U;
+  MIDI_Merge_Push(&merge, 2U, MIDI_EVENT(0U, MIDI_CIN_SYSEX_START, 0x03U, 0x04U, 0x05U));
+  MIDI_Merge_Push(&merge, 2U, MIDI_EVENT(0U, MIDI_CIN_SYSEX_END_1, 0xF7U, 0U, 0U));
+  MIDI_Merge_Push(&merge, 2U, MIDI_EVENT_CHANNEL(0U, 0x90U, 62U, 100U));
+  MIDI_Merge_Process(&merge, 102U, 16U);
+  CHECK_EQ(log_n, 1U);
+  CHECK_EQ(log_ev[0], MIDI_EVENT_CHANNEL(0U, 0x90U, 62U, 100U));
+  CHECK_EQ(merge.src[2].stats.discarded, 2U);
+
+  /* a source that gives up on its SysEx and starts a new one with F0 gets
+     the new one out whole */
+  MIDI_Merge_Push(&merge, 2U, MIDI_EVENT(0U, MIDI_CIN_SYSEX_START, 0xF0U, 0x01U, 0x02U));
+  MIDI_Merge_Process(&merge, 200U, 16U);
+  MIDI_Merge_Process(&merge, 400U, 16U);
+  CHECK_EQ(merge.sysex_aborts, 2U);
+  log_n = 0U;
+  MIDI_Merge_Push(&merge, 2U, MIDI_EVENT(0U, MIDI_CIN_SYSEX_START, 0xF0U, 0x0AU, 0x0BU));
+  MIDI_Merge_Push(&merge, 2U, MIDI_EVENT(0U, MIDI_CIN_SYSEX_END_2, 0x0CU, 0xF7U, 0U));
+  MIDI_Merge_Process(&merge, 401U, 16U);
+  CHECK_EQ(log_n, 2U);
+  CHECK_EQ(log_ev[0], MIDI_EVENT(0U, MIDI_CIN_SYSEX_START, 0xF0U, 0x0AU, 0x0BU));
+  CHECK_EQ(log_ev[1], MIDI_EVENT(0U, MIDI_CIN_SYSEX_END_2, 0x0CU, 0xF7U, 0U));
+  CHECK_EQ(merge.src[2].stats.discarded, 2U);
+
+  /* an output that takes nothing does not time out a SysEx that is
+     still queued */
+  MIDI_Merge_Push(&merge, 2U, MIDI_EVENT(0U, MIDI_CIN_SYSEX_START, 0xF0U, 0x01U, 0x02U));
+  MIDI_Merge_Push(&merge, 2U, MIDI_EVENT(0U, MIDI_CIN_SYSEX_END_1, 0xF7U, 0U, 0U));
+  MIDI_Merge_Process(&merge, 500U, 1U);
+  MIDI_Merge_Process(&merge, 1000U, 0U);
+  log_n = 0U;
+  MIDI_Merge_Process(&merge, 1001U, 16U);
+  CHECK_EQ(merge.sysex_aborts, 2U);
+  CHECK_EQ(log_n, 1U);
+  CHECK_EQ(log_ev[0], MIDI_EVENT(0U, MIDI_CIN_SYSEX_END_1, 0xF7U, 0U, 0U));
+}
+
+static void test_overflow(void)
+{
+  uint32_t i;
+
+  MIDI_Merge_Init(&merge, capture);
+  for (i = 0U; i < MIDI_MERGE_QUEUE_LEN; i++)
+  {
+    CHECK_EQ(MIDI_Merge_Push(&merge, 0U, MIDI_EVENT_CHANNEL(0U, 0x90U, i & 0x7FU, 1U)), 0);
+  }
+  CHECK_EQ(MIDI_Merge_Push(&merge, 0U, MIDI_EVENT_CHANNEL(0U, 0x90U, 0U, 1U)), -1);
+  for (i = 0U; i < MIDI_MERGE_RT_QUEUE_LEN; i++)
+  {
+    CHECK_EQ(MIDI_Merge_Push(&merge, 0U, MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, 0xF8U, 0U, 0U)), 0);
+  }
+  CHECK_EQ(MIDI_Merge_Push(&merge, 0U, MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, 0xFEU, 0U, 0U)), -1);
+  CHECK_EQ(merge.src[0].stats.overflows, 2U);
+
+  /* real-time first, and the budget holds across both queues */
+  log_n = 0U;
+  CHECK_EQ(MIDI_Merge_Process(&merge, 0U, 10U), 10U);
+  CHECK_EQ(log_ev[7], MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, 0xF8U, 0U, 0U));
+  CHECK_EQ(log_ev[8], MIDI_EVENT_CHANNEL(0U, 0x90U, 0U, 1U));
+  CHECK_EQ(MIDI_Merge_Push(&merge, 0U, MIDI_EVENT_CHANNEL(0U, 0x90U, 0U, 1U)), 0);
+
+  /* a CIN 0 word with no data is not an event */
+  CHECK_EQ(MIDI_Merge_Push(&merge, 1U, 0x30000000UL), 0);
+  CHECK_EQ(merge.src[1].wp, 0U);
+}
+
+static void bench(void)
+{
+  uint32_t i, s;
+  double t0;
+
+  MIDI_Merge_Init(&merge, discard);
+  t0 = test_seconds();
+  for (i = 0U; i < 1000000U; i++)
+  {
+    for (s = 0U; s < SOURCES; s++)
+    {
+      MIDI_Merge_Push(&merge, (uint8_t)s, MIDI_EVENT_CHANNEL(s, 0x90U, i & 0x7FU, 1U));
+    }
+    MIDI_Merge_Process(&merge, i, 16U);
+  }
+  printf("bench: %.1f ns per event, %u sources\n",
+         (test_seconds() - t0) * 1e9 / (1000000.0 * SOURCES), SOURCES);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  test_stress();
+  test_weights();
+  test_timeout();
+  test_overflow();
+  bench();
+  return TEST_RESULT();
+}
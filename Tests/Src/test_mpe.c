@@ -0,0 +1,196 @@
+/**
+  ******************************************************************************
+  * @file           : test_mpe.c
+  * @brief          : MPE zone manager: configuration messages, LRU channel
+  *                   allocation and stealing in both zones, and the
+  *                   controller budget under a stream of expression data.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "midi_mpe.h"
+
+/* Private define ------------------------------------------------------------*/
+#define LOG_LEN                   4096U
+
+/* Private variables ---------------------------------------------------------*/
+static MPE_ZoneTypeDef zone;
+static uint32_t log_ev[LOG_LEN];
+static uint32_t log_n;
+static uint16_t sent_bend[16];
+static uint8_t sent_pressure[16];
+
+/* Private functions ---------------------------------------------------------*/
+
+static void capture(uint32_t event)
+{
+  if (log_n < LOG_LEN)
+  {
+    log_ev[log_n] = event;
+  }
+  log_n++;
+  if ((MIDI_EVENT_STATUS(event) & 0xF0U) == 0xE0U)
+  {
+    sent_bend[MIDI_EVENT_CHANNEL_NUM(event)] =
+      (uint16_t)(MIDI_EVENT_DATA1(event) | (MIDI_EVENT_DATA2(event) << 7));
+  }
+  else if ((MIDI_EVENT_STATUS(event) & 0xF0U) == 0xD0U)
+  {
+    sent_pressure[MIDI_EVENT_CHANNEL_NUM(event)] = (uint8_t)MIDI_EVENT_DATA1(event);
+  }
+}
+
+static void discard(uint32_t event)
+{
+  (void)event;
+}
+
+static void test_configure(void)
+{
+  uint32_t i;
+
+  MPE_Init(&zone, 2U, MPE_ZONE_LOWER, 3U, capture);
+  log_n = 0U;
+  MPE_Configure(&zone, 48U);
+  /* one six-CC RPN on the manager, then one per member channel */
+  CHECK_EQ(log_n, 6U * 4U);
+  CHECK_EQ(log_ev[0], MIDI_EVENT_CHANNEL(2U, 0xB0U, 101U, 0U));
+  CHECK_EQ(log_ev[1], MIDI_EVENT_CHANNEL(2U, 0xB0U, 100U, 6U));
+  CHECK_EQ(log_ev[2], MIDI_EVENT_CHANNEL(2U, 0xB0U, 6U, 3U));
+  for (i = 1U; i <= 3U; i++)
+  {
+    CHECK_EQ(log_ev[6U * i + 1U], MIDI_EVENT_CHANNEL(2U, 0xB0U | i, 100U, 0U));
+    CHECK_EQ(log_ev[6U * i + 2U], MIDI_EVENT_CHANNEL(2U, 0xB0U | i, 6U, 48U));
+  }
+}
+
+static void test_allocation(void)
+{
+  uint8_t a, b, c, d, e;
+
+  MPE_Init(&zone, 0U, MPE_ZONE_LOWER, 3U, capture);
+  log_n = 0U;
+  a = MPE_NoteOn(&zone, 60U, 100U, MPE_BEND_CENTER, 0U, 64U);
+  /* bend, pressure and timbre go ahead of the note on */
+  CHECK_EQ(log_n, 4U);
+  CHECK_EQ(log_ev[0], MIDI_EVENT_CHANNEL(0U, 0xE0U | a, 0U, 0x40U));
+  CHECK_EQ(log_ev[3], MIDI_EVENT_CHANNEL(0U, 0x90U | a, 60U, 100U));
+  b = MPE_NoteOn(&zone, 62U, 100U, MPE_BEND_CENTER, 0U, 64U);
+  c = MPE_NoteOn(&zone, 64U, 100U, MPE_BEND_CENTER, 0U, 64U);
+  CHECK_EQ(a, 1U);
+  CHECK_EQ(b, 2U);
+  CHECK_EQ(c, 3U);
+
+  /* all busy: the oldest note is stolen, with a note off first */
+  log_n = 0U;
+  d = MPE_NoteOn(&zone, 65U, 100U, MPE_BEND_CENTER, 0U, 64U);
+  CHECK_EQ(d, a);
+  CHECK_EQ(zone.stats.steals, 1U);
+  CHECK_EQ(log_ev[0], MIDI_EVENT_CHANNEL(0U, 0x80U | a, 60U, 0x40U));
+
+  /* a released channel is reused last: c, then b, frees b first */
+  MPE_NoteOff(&zone, c, 0U);
+  MPE_NoteOff(&zone, b, 0U);
+  e = MPE_NoteOn(&zone, 67U, 100U, MPE_BEND_CENTER, 0U, 64U);
+  CHECK_EQ(e, c);
+  e = MPE_NoteOn(&zone, 69U, 100U, MPE_BEND_CENTER, 0U, 64U);
+  CHECK_EQ(e, b);
+
+  /* a note off on a free or foreign channel is ignored */
+  MPE_NoteOff(&zone, b, 0U);
+  log_n = 0U;
+  MPE_NoteOff(&zone, b, 0U);
+  MPE_NoteOff(&zone, 0U, 0U);
+  MPE_NoteOff(&zone, 200U, 0U);
+  CHECK_EQ(log_n, 0U);
+
+  /* the upper zone counts down from channel 15 */
+  MPE_Init(&zone, 0U, MPE_ZONE_UPPER, 15U, capture);
+  CHECK_EQ(MPE_NoteOn(&zone, 60U, 1U, MPE_BEND_CENTER, 0U, 0U), 14U);
+  CHECK_EQ(MPE_NoteOn(&zone, 61U, 1U, MPE_BEND_CENTER, 0U, 0U), 13U);
+}
+
+static void test_budget(void)
+{
+  uint8_t ch[15];
+  uint16_t bend[16];
+  uint8_t pressure[16];
+  uint32_t ms, i, max = 0U, ctrl, sent;
+
+  MPE_Init(&zone, 0U, MPE_ZONE_LOWER, 15U, capture);
+  for (i = 0U; i < 15U; i++)
+  {
+    ch[i] = MPE_NoteOn(&zone, (uint8_t)(40U + i), 100U, MPE_BEND_CENTER, 0U, 64U);
+  }
+  MPE_Process(&zone, 1U);
+  sent = zone.stats.ctrl_sent;
+
+  /* every note moves its bend and pressure each ms: 30 updates per ms
+     against a budget of MPE_EVENTS_PER_MS */
+  for (ms = 2U; ms < 1002U; ms++)
+  {
+    for (i = 0U; i < 15U; i++)
+    {
+      bend[ch[i]] = (uint16_t)((ms * 37U + i * 1000U) & 0x3FFFU);
+      pressure[ch[i]] = (uint8_t)((ms + i) & 0x7FU);
+      MPE_SetBend(&zone, ch[i], bend[ch[i]]);
+      MPE_SetPressure(&zone, ch[i], pressure[ch[i]]);
+    }
+    log_n = 0U;
+    MPE_Process(&zone, ms);
+    max = (log_n > max) ? log_n : max;
+  }
+  /* a full bucket at most at once, MPE_EVENTS_PER_MS on average */
+  CHECK(max <= MPE_EVENTS_BURST);
+  CHECK(zone.stats.ctrl_sent - sent <= 1000U * MPE_EVENTS_PER_MS + MPE_EVENTS_BURST);
+  CHECK(zone.stats.ctrl_coalesced > 0U);
+
+  /* once the updates stop, the last value of every note gets out */
+  ctrl = zone.stats.ctrl_sent;
+  for (; (zone.dirty_mask != 0U) && (ms < 1100U); ms++)
+  {
+    MPE_Process(&zone, ms);
+  }
+  CHECK_EQ(zone.dirty_mask, 0U);
+  for (i = 0U; i < 15U; i++)
+  {
+    CHECK_EQ(sent_bend[ch[i]], bend[ch[i]]);
+    CHECK_EQ(sent_pressure[ch[i]], pressure[ch[i]]);
+  }
+  printf("budget: %u controller events per ms at most, %u sent, %u coalesced, "
+         "%u to drain\n", max, zone.stats.ctrl_sent, zone.stats.ctrl_coalesced,
+         zone.stats.ctrl_sent - ctrl);
+}
+
+static void bench(void)
+{
+  uint32_t i;
+  uint8_t ch;
+  double t0 = test_seconds();
+
+  MPE_Init(&zone, 0U, MPE_ZONE_LOWER, 15U, discard);
+  for (i = 0U; i < 1000000U; i++)
+  {
+    ch = MPE_NoteOn(&zone, (uint8_t)(i & 0x7FU), 100U, MPE_BEND_CENTER, 0U, 64U);
+    if ((i & 1U) != 0U)
+    {
+      MPE_NoteOff(&zone, ch, 0U);
+    }
+  }
+  printf("bench: %.1f ns per note on, %u cycles average, %u max\n",
+         (test_seconds() - t0) * 1e3, zone.stats.alloc_cycles_sum / zone.stats.note_on,
+         zone.stats.alloc_cycles_max);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  test_configure();
+  test_allocation();
+  test_budget();
+  bench();
+  return TEST_RESULT();
+}
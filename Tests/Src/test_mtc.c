@@ -0,0 +1,287 @@
+/**
+  ******************************************************************************
+  * @file           : test_mtc.c
+  * @brief          : MIDI Time Code: frame counts and time codes over a whole
+  *                   day at every rate, generator pacing and quarter frame
+  *                   content, and the chase engine following the generator
+  *                   through the 1 ms USB frame grid, with locate, jumps,
+  *                   dropouts and the cost per event.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <string.h>
+#include "host_test.h"
+#include "midi_mtc.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TIMER_HZ                  200000000U
+#define FRAME_COUNTS              (TIMER_HZ / 1000U)
+
+/* Private variables ---------------------------------------------------------*/
+static const uint32_t frames_per_day[4] = { 2073600UL, 2160000UL, 2589408UL, 2592000UL };
+static MTC_GenTypeDef gen;
+static MTC_ChaseTypeDef chase;
+static uint32_t qf_ev[16];
+static uint32_t qf_n;
+static uint32_t sysex_now;
+static uint32_t rng = 3U;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t rnd(void)
+{
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static void send_qf(uint32_t event)
+{
+  if (qf_n < 16U)
+  {
+    qf_ev[qf_n] = event;
+  }
+  qf_n++;
+}
+
+static void send_sysex(uint32_t event)
+{
+  MTC_Chase_Event(&chase, event, sysex_now);
+}
+
+static void discard(uint32_t event)
+{
+  (void)event;
+}
+
+static double qf_counts(uint8_t rate)
+{
+  static const double fps[4] = { 24.0, 25.0, 30000.0 / 1001.0, 30.0 };
+
+  return TIMER_HZ / (fps[rate] * 4.0);
+}
+
+static uint32_t label(const MTC_TimeTypeDef *pt)
+{
+  return ((pt->hours * 60U + pt->minutes) * 60U + pt->seconds) * 32U + pt->frames;
+}
+
+static void test_convert(void)
+{
+  MTC_TimeTypeDef t;
+  uint32_t rate, f, prev = 0U, bad = 0U;
+
+  for (rate = 0U; rate < 4U; rate++)
+  {
+    for (f = 0U; f < frames_per_day[rate]; f++)
+    {
+      MTC_FramesToTime(f, (uint8_t)rate, &t);
+      bad += (MTC_TimeToFrames(&t) != f) ? 1U : 0U;
+      bad += (t.rate != rate) ? 1U : 0U;
+      bad += ((f > 0U) && (label(&t) <= prev)) ? 1U : 0U;
+      prev = label(&t);
+      /* drop frame skips the labels 0 and 1 at each minute but every
+         tenth */
+      if ((rate == MTC_RATE_2997DF) && (t.seconds == 0U) && (t.frames < 2U) &&
+          ((t.minutes % 10U) != 0U))
+      {
+        bad++;
+      }
+    }
+    /* the day wraps */
+    MTC_FramesToTime(frames_per_day[rate], (uint8_t)rate, &t);
+    CHECK_EQ(label(&t), 0U);
+  }
+  CHECK_EQ(bad, 0U);
+
+  /* an hour of drop frame is 107892 frames, 3.6 ms short of an hour */
+  t.hours = 1U;
+  t.minutes = 0U;
+  t.seconds = 0U;
+  t.frames = 0U;
+  t.rate = MTC_RATE_2997DF;
+  CHECK_EQ(MTC_TimeToFrames(&t), 107892U);
+  t.hours = 0U;
+  t.minutes = 1U;
+  t.frames = 2U;
+  CHECK_EQ(MTC_TimeToFrames(&t), 1800U);
+}
+
+static void test_generator(void)
+{
+  MTC_TimeTypeDef t;
+  uint32_t i, cmp, begin, frame, piece, now, period, bad = 0U;
+  uint8_t nib[8] = { 0 };
+  double ideal;
+
+  MTC_Gen_Init(&gen, 2U, MTC_RATE_2997DF, TIMER_HZ, send_qf, discard);
+  MTC_Gen_Locate(&gen, 17980U);
+  begin = cmp = MTC_Gen_Begin(&gen, 1000U);
+  CHECK_EQ(cmp, 1000U + MTC_MIN_LEAD);
+  MTC_Gen_Start(&gen);
+
+  /* ten minutes of quarter frames, each handled a little late; every
+     cycle describes the frame at its piece 0, two frames on each time */
+  frame = 17980U;
+  for (i = 0U; i < 17982U * 4U; i++)
+  {
+    qf_n = 0U;
+    cmp = MTC_Gen_Tick(&gen, cmp + rnd() % 2000U);
+    piece = MIDI_EVENT_DATA1(qf_ev[0]) >> 4;
+    bad += ((qf_n != 1U) || (piece != (i & 7U))) ? 1U : 0U;
+    bad += (MIDI_EVENT_CABLE(qf_ev[0]) != 2U) || (MIDI_EVENT_STATUS(qf_ev[0]) != 0xF1U) ? 1U : 0U;
+    nib[piece] = MIDI_EVENT_DATA1(qf_ev[0]) & 0x0FU;
+    if (piece == 7U)
+    {
+      MTC_FramesToTime((frame + (i - 7U) / 4U) % frames_per_day[MTC_RATE_2997DF],
+                       MTC_RATE_2997DF, &t);
+      bad += (nib[0] | (nib[1] << 4)) != t.frames;
+      bad += (nib[2] | (nib[3] << 4)) != t.seconds;
+      bad += (nib[4] | (nib[5] << 4)) != t.minutes;
+      bad += (nib[6] | ((nib[7] & 1U) << 4)) != t.hours;
+      bad += (nib[7] >> 1) != MTC_RATE_2997DF;
+    }
+  }
+  CHECK_EQ(bad, 0U);
+  CHECK_EQ(gen.frame, (17980U + 17982U) % frames_per_day[MTC_RATE_2997DF]);
+
+  /* the pacing stays on the exact 29.97 fps grid, no drift; ten minutes
+     wrap the timer many times */
+  ideal = fmod(17982.0 * 4.0 * qf_counts(MTC_RATE_2997DF), 4294967296.0);
+  CHECK(fabs((double)(cmp - begin) - ideal) <= 1.0);
+
+  /* a stall longer than a quarter frame restarts the phase, and the
+     compare is never set closer than MTC_MIN_LEAD */
+  period = (uint32_t)qf_counts(MTC_RATE_2997DF);
+  now = cmp + 10000000U;
+  cmp = MTC_Gen_Tick(&gen, now);
+  CHECK((cmp - now == period) || (cmp - now == period + 1U));
+  CHECK(gen.stats.late_max >= 10000000U);
+  now = cmp + period - 10U;
+  cmp = MTC_Gen_Tick(&gen, now);
+  CHECK_EQ(cmp - now, MTC_MIN_LEAD);
+
+  /* stopped, the compare keeps running but nothing is sent */
+  MTC_Gen_Stop(&gen);
+  qf_n = 0U;
+  MTC_Gen_Tick(&gen, cmp);
+  CHECK_EQ(qf_n, 0U);
+}
+
+/* Run the generator into the chase engine, the quarter frames seen at the
+   first USB frame after they are sent plus interrupt latency; returns the
+   largest position error in 1/256 frame once locked */
+static double run(uint32_t *pcmp, uint32_t n, uint32_t *pqf)
+{
+  uint32_t i, now, arrive, p;
+  double e, err = 0.0;
+
+  for (i = 0U; i < n; i++)
+  {
+    now = *pcmp + rnd() % 400U;
+    qf_n = 0U;
+    *pcmp = MTC_Gen_Tick(&gen, now);
+    arrive = (uint32_t)((now / FRAME_COUNTS + 1U) * FRAME_COUNTS) + rnd() % 25000U;
+    MTC_Chase_Event(&chase, qf_ev[0], arrive);
+    if (chase.locked)
+    {
+      p = MTC_Chase_GetPosition(&chase, arrive);
+      e = fabs((double)(int32_t)(p - *pqf * 64U));
+      err = (e > err) ? e : err;
+    }
+    (*pqf)++;
+  }
+  return err;
+}
+
+static void test_chase(void)
+{
+  MTC_TimeTypeDef t = { 1U, 9U, 59U, 20U, MTC_RATE_2997DF };
+  uint32_t cmp, qf, start = MTC_TimeToFrames(&t), resyncs;
+  double err;
+
+  MTC_Gen_Init(&gen, 0U, MTC_RATE_2997DF, TIMER_HZ, send_qf, send_sysex);
+  MTC_Chase_Init(&chase, TIMER_HZ);
+
+  /* the full frame message of a locate places the chase, unlocked */
+  sysex_now = 0U;
+  MTC_Gen_Locate(&gen, start);
+  CHECK_EQ(chase.stats.full_frames, 1U);
+  CHECK_EQ(MTC_Chase_GetPosition(&chase, 0U), start * 256U);
+  CHECK(!MTC_Chase_IsLocked(&chase, 0U));
+
+  /* locked after the first whole cycle, then within a quarter frame */
+  cmp = MTC_Gen_Begin(&gen, 0U);
+  MTC_Gen_Start(&gen);
+  qf = start * 4U;
+  err = run(&cmp, 4U * 30U * 120U, &qf);
+  printf("chase: locked in %.1f ms, position within %.2f frames, arrivals within %.0f us\n",
+         chase.stats.lock_counts * 1e3 / TIMER_HZ, err / 256.0,
+         chase.stats.drift_max * 1e6 / TIMER_HZ);
+  CHECK(MTC_Chase_IsLocked(&chase, chase.anchor_time));
+  CHECK_EQ(chase.stats.resyncs, 0U);
+  CHECK(chase.stats.lock_counts < (uint32_t)(8.0 * qf_counts(MTC_RATE_2997DF)) + FRAME_COUNTS);
+  CHECK(err < 64.0);
+  CHECK_EQ(chase.anchor_qf / 4U, gen.frame - 1U);
+
+  /* the master jumps without a full frame message: found at the end of
+     the next cycle */
+  gen.send_sysex = discard;
+  MTC_Gen_Locate(&gen, 5000U);
+  MTC_Gen_Start(&gen);
+  qf = 5000U * 4U;
+  err = run(&cmp, 4U * 30U * 10U, &qf);
+  CHECK(chase.stats.resyncs > 0U);
+  CHECK(MTC_Chase_IsLocked(&chase, chase.anchor_time));
+  CHECK_EQ(chase.anchor_qf / 4U, gen.frame - 1U);
+
+  /* a lost quarter frame breaks the cycle; the next one locks again */
+  resyncs = chase.stats.resyncs;
+  qf_n = 0U;
+  cmp = MTC_Gen_Tick(&gen, cmp);
+  qf++;
+  run(&cmp, 3U, &qf);
+  CHECK(chase.stats.resyncs > resyncs);
+  CHECK(!MTC_Chase_IsLocked(&chase, chase.anchor_time));
+  err = run(&cmp, 24U, &qf);
+  CHECK(MTC_Chase_IsLocked(&chase, chase.anchor_time));
+  CHECK(err < 64.0);
+
+  /* the master stops */
+  MTC_Gen_Stop(&gen);
+  CHECK(MTC_Chase_IsLocked(&chase, chase.anchor_time + (uint32_t)(7.0 * qf_counts(MTC_RATE_2997DF))));
+  CHECK(!MTC_Chase_IsLocked(&chase, chase.anchor_time + (uint32_t)(9.0 * qf_counts(MTC_RATE_2997DF))));
+}
+
+static void bench(void)
+{
+  uint32_t i, cmp = 0U;
+  double t0;
+
+  MTC_Gen_Init(&gen, 0U, MTC_RATE_25, TIMER_HZ, send_qf, discard);
+  MTC_Chase_Init(&chase, TIMER_HZ);
+  MTC_Gen_Start(&gen);
+  t0 = test_seconds();
+  for (i = 0U; i < 10000000U; i++)
+  {
+    qf_n = 0U;
+    cmp = MTC_Gen_Tick(&gen, cmp);
+    MTC_Chase_Event(&chase, qf_ev[0], cmp);
+  }
+  printf("bench: %.1f ns per quarter frame generated and chased (%u)\n",
+         (test_seconds() - t0) * 100.0, MTC_Chase_GetPosition(&chase, cmp) >> 8);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  test_convert();
+  test_generator();
+  test_chase();
+  bench();
+  return TEST_RESULT();
+}
@@ -0,0 +1,189 @@
+/**
+  ******************************************************************************
+  * @file           : test_pad_simd.c
+  * @brief          : The pad scanner in 16-bit SIMD lanes against the scalar
+  *                   reference, on recorded strikes.
+  *
+  *                   usage: test_pad_simd <file.raw>...
+  *
+  *                   The lane helpers of mcu_port.h are checked against the
+  *                   per-lane arithmetic of the ARMv7E-M instructions they
+  *                   stand for. Each recording then goes through both
+  *                   detectors, with watch mode off: they must give the same
+  *                   note ons to within a block, with velocities within one
+  *                   step. Both throughputs are printed; on the host the
+  *                   lanes are emulated, so only the M7 shows the gain.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include "host_test.h"
+#include "pad_file.h"
+#include "pad_scan_ref.h"
+#include "mcu_port.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_REPEATS             5U
+
+/* Private variables ---------------------------------------------------------*/
+static PAD_ScannerTypeDef scanner;
+
+/* Private functions ---------------------------------------------------------*/
+
+static int32_t lane(uint32_t w, uint32_t l)
+{
+  return (int16_t)(w >> (16U * l));
+}
+
+static int32_t sat16(int32_t x)
+{
+  return (x > 32767) ? 32767 : ((x < -32768) ? -32768 : x);
+}
+
+static void check_lanes(uint32_t a, uint32_t b)
+{
+  uint32_t l, q = MCU_QSUB16(a, b), s = MCU_ABS16(a), m = MCU_MAX16(a, b), g = MCU_GE16(a, b);
+  int32_t x, y;
+
+  for (l = 0U; l < 2U; l++)
+  {
+    x = lane(a, l);
+    y = lane(b, l);
+    CHECK_EQ(lane(q, l), sat16(x - y));
+    CHECK_EQ(lane(s, l), sat16((x < 0) ? -x : x));
+    CHECK_EQ(lane(m, l), (x >= y) ? x : y);
+    CHECK_EQ((g >> (16U * l)) & 0xFFFFU, (x >= y) ? 0xFFFFU : 0U);
+  }
+}
+
+static void test_lanes(void)
+{
+  static const uint16_t edge[] = { 0x0000U, 0x0001U, 0x7FFEU, 0x7FFFU,
+                                   0x8000U, 0x8001U, 0xFFFEU, 0xFFFFU };
+  uint32_t i, j, r = 1U;
+
+  for (i = 0U; i < 8U; i++)
+  {
+    for (j = 0U; j < 8U; j++)
+    {
+      check_lanes(edge[i] | ((uint32_t)edge[j] << 16), edge[j] | ((uint32_t)edge[i] << 16));
+    }
+  }
+  for (i = 0U; i < 1000000U; i++)
+  {
+    r = r * 1664525U + 1013904223U;
+    j = r * 1664525U + 1013904223U;
+    check_lanes(r, j);
+    r = j;
+  }
+  CHECK_EQ(MCU_USAT(-5, 7U), 0U);
+  CHECK_EQ(MCU_USAT(200, 7U), 127U);
+  CHECK_EQ(MCU_USAT(64, 7U), 64U);
+}
+
+static uint32_t replay(const PADFILE_RecordingTypeDef *rec, PADFILE_ProcessTypeDef process,
+                       PADFILE_HitTypeDef *hits, uint32_t max, PADFILE_ScoreTypeDef *score)
+{
+  uint32_t n;
+
+  PADFILE_Setup(&scanner, rec, NULL);
+  PAD_SetWatch(&scanner, 0U);
+  n = PADFILE_ReplayWith(&scanner, rec, process, hits, max);
+  PADFILE_Score(&scanner, rec, hits, n, score);
+  return n;
+}
+
+static void discard(uint32_t event)
+{
+  (void)event;
+}
+
+static double bench(const PADFILE_RecordingTypeDef *rec, PADFILE_ProcessTypeDef process)
+{
+  double t0;
+  uint32_t r, f;
+
+  PADFILE_Setup(&scanner, rec, discard);
+  PAD_SetWatch(&scanner, 0U);
+  t0 = test_seconds();
+  for (r = 0U; r < BENCH_REPEATS; r++)
+  {
+    for (f = 0U; f + PADFILE_BLOCK <= rec->frames; f += PADFILE_BLOCK)
+    {
+      process(&scanner, &rec->samples[(size_t)f * rec->pads], PADFILE_BLOCK);
+    }
+  }
+  return (double)scanner.stats.samples / (test_seconds() - t0) * 1e-6;
+}
+
+static void test_file(const char *path)
+{
+  PADFILE_RecordingTypeDef rec;
+  PADFILE_ScoreTypeDef simd, ref;
+  PADFILE_HitTypeDef *hs, *hr;
+  uint32_t ns, nr, i, j, max, matched = 0U, vel_diff = 0U;
+  uint8_t *used;
+  int32_t d;
+
+  if (PADFILE_Load(&rec, path, PADFILE_PADS, PADFILE_SAMPLE_HZ) != 0)
+  {
+    printf("%s: cannot read\n", path);
+    test_failures++;
+    return;
+  }
+  max = rec.frames / 8U + 1U;
+  hs = malloc(max * sizeof(*hs));
+  hr = malloc(max * sizeof(*hr));
+  used = calloc(max, 1U);
+  ns = replay(&rec, PAD_Process, hs, max, &simd);
+  nr = replay(&rec, PADREF_Process, hr, max, &ref);
+
+  /* pair the note ons of the two detectors */
+  for (i = 0U; i < nr; i++)
+  {
+    for (j = 0U; j < ns; j++)
+    {
+      d = (int32_t)(hs[j].frame - hr[i].frame);
+      if ((used[j] == 0U) && (hs[j].pad == hr[i].pad) &&
+          (d >= -(int32_t)PADFILE_BLOCK) && (d <= (int32_t)PADFILE_BLOCK))
+      {
+        used[j] = 1U;
+        matched++;
+        d = (int32_t)hs[j].velocity - (int32_t)hr[i].velocity;
+        d = (d < 0) ? -d : d;
+        vel_diff = ((uint32_t)d > vel_diff) ? (uint32_t)d : vel_diff;
+        break;
+      }
+    }
+  }
+  printf("%s: simd %u note ons, %u/%u detected, %u false; scalar %u note ons, "
+         "%u detected, %u false; %u paired, velocity within %u\n",
+         path, ns, simd.detected, simd.strikes, simd.false_hits, nr, ref.detected,
+         ref.false_hits, matched, vel_diff);
+  CHECK(matched * 100U >= ns * 99U);
+  CHECK(matched * 100U >= nr * 99U);
+  CHECK(vel_diff <= 1U);
+  CHECK(simd.detected >= ref.detected);
+  printf("%s: simd %.1f M samples/s per pad, scalar %.1f M samples/s per pad\n",
+         path, bench(&rec, PAD_Process), bench(&rec, PADREF_Process));
+
+  free(used);
+  free(hs);
+  free(hr);
+  PADFILE_Free(&rec);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+  int i;
+
+  test_lanes();
+  for (i = 1; i < argc; i++)
+  {
+    test_file(argv[i]);
+  }
+  return TEST_RESULT();
+}
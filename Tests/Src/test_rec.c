@@ -0,0 +1,452 @@
+/**
+  ******************************************************************************
+  * @file           : test_rec.c
+  * @brief          : Traffic recorder: a random take from thread mode and
+  *                   interrupts, on two cables and both directions, read
+  *                   back as an SMF and parsed against what was captured;
+  *                   the SysEx export, full queues, a full buffer, and the
+  *                   bytes and time per event.
+  *
+  *                   Built with MCU_HOST_CLOCK, so the test sets the cycle
+  *                   counter and the context of every capture.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "midi_rec.h"
+#include "mcu_port.h"
+
+/* Private define ------------------------------------------------------------*/
+#define CPU_HZ                    400000000U
+#define TAKE_EVENTS               100000U
+#define LIST_LEN                  (TAKE_EVENTS + 1000U)
+#define STREAM_LEN                (4U * TAKE_EVENTS)
+#define CYCLES_BASE               123456789U
+
+/* Private types -------------------------------------------------------------*/
+
+/* A message other than SysEx, with its tick */
+typedef struct
+{
+  uint32_t tick;
+  uint8_t  cable;
+  uint8_t  len;
+  uint8_t  b[3];
+} ItemTypeDef;
+
+/* What a track holds: the messages, and the bytes of each cable, SysEx
+   included, in order */
+typedef struct
+{
+  ItemTypeDef item[LIST_LEN];
+  uint32_t items;
+  uint8_t  stream[2][STREAM_LEN];
+  uint32_t bytes[2];
+} ContentTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+volatile uint32_t mcu_host_cycles;
+volatile uint8_t mcu_host_in_isr;
+
+static MIDI_RecorderTypeDef rec;
+static uint8_t buf[1UL << 21];
+static uint8_t file[1UL << 21];
+static uint8_t export_bytes[1UL << 22];
+static uint32_t export_n;
+static ContentTypeDef expect[MIDI_REC_TRACKS], parsed[MIDI_REC_TRACKS];
+static uint32_t rng = 3U;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t rnd(void)
+{
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static void put_bytes(ContentTypeDef *pc, uint8_t cable, const uint8_t *b, uint32_t len)
+{
+  if (pc->bytes[cable] + len <= STREAM_LEN)
+  {
+    memcpy(&pc->stream[cable][pc->bytes[cable]], b, len);
+  }
+  pc->bytes[cable] += len;
+}
+
+static void put_item(ContentTypeDef *pc, uint32_t tick, uint8_t cable, const uint8_t *b, uint8_t len)
+{
+  ItemTypeDef *pi = &pc->item[pc->items % LIST_LEN];
+
+  memset(pi, 0, sizeof(*pi));
+  pi->tick = tick;
+  pi->cable = cable;
+  pi->len = len;
+  memcpy(pi->b, b, len);
+  pc->items++;
+  put_bytes(pc, cable, b, len);
+}
+
+/* Capture an event at a time since the start of the take, and note what
+   the file is to hold */
+static void capture(uint8_t track, uint32_t event, uint64_t cycles)
+{
+  static const uint8_t cin_len[16] = { 0, 0, 2, 3, 3, 1, 2, 3, 3, 3, 3, 3, 2, 2, 3, 1 };
+  uint32_t cin = MIDI_EVENT_CIN(event), status = MIDI_EVENT_STATUS(event);
+  uint8_t b[3], cable = (uint8_t)MIDI_EVENT_CABLE(event);
+
+  mcu_host_cycles = (uint32_t)(CYCLES_BASE + cycles);
+  MIDI_Rec_Capture(&rec, track, event);
+
+  b[0] = (uint8_t)status;
+  b[1] = (uint8_t)MIDI_EVENT_DATA1(event);
+  b[2] = (uint8_t)MIDI_EVENT_DATA2(event);
+  if ((status == 0xF8U) || (status == 0xFEU))
+  {
+    return;  /* filtered by default */
+  }
+  if ((cin == MIDI_CIN_SYSEX_START) || ((cin >= MIDI_CIN_SYSEX_END_1) && (cin <= MIDI_CIN_SYSEX_END_3) &&
+                                        ((cin != MIDI_CIN_SYSEX_END_1) || (status == 0xF7U))))
+  {
+    put_bytes(&expect[track], cable, b, cin_len[cin]);
+  }
+  else
+  {
+    put_item(&expect[track], (uint32_t)(cycles / (CPU_HZ / 1000U)), cable, b, cin_len[cin]);
+  }
+}
+
+static uint32_t read_vlq(const uint8_t **pp)
+{
+  uint32_t v = 0U;
+  uint8_t c;
+
+  do
+  {
+    c = *(*pp)++;
+    v = (v << 7) | (c & 0x7FU);
+  } while (c & 0x80U);
+  return v;
+}
+
+/* Parse one MTrk chunk back into its content; returns the next chunk */
+static const uint8_t *parse_track(const uint8_t *p, ContentTypeDef *pc, uint32_t *pend_ok)
+{
+  const uint8_t *end;
+  uint32_t tick = 0U, len;
+  uint8_t status, running = 0U, cable = 0U, type;
+  uint8_t b[3];
+
+  CHECK(memcmp(p, "MTrk", 4U) == 0);
+  len = ((uint32_t)p[4] << 24) | ((uint32_t)p[5] << 16) | ((uint32_t)p[6] << 8) | p[7];
+  p += 8;
+  end = p + len;
+  *pend_ok = 0U;
+  while (p < end)
+  {
+    tick += read_vlq(&p);
+    status = *p;
+    if (status & 0x80U)
+    {
+      p++;
+    }
+    else
+    {
+      status = running;
+    }
+    if (status == 0xFFU)
+    {
+      type = *p++;
+      len = read_vlq(&p);
+      if (type == 0x21U)
+      {
+        cable = p[0];
+      }
+      *pend_ok = ((type == 0x2FU) && (p + len == end)) ? 1U : 0U;
+      p += len;
+      running = 0U;
+    }
+    else if (status == 0xF0U)
+    {
+      len = read_vlq(&p);
+      put_bytes(pc, cable, &status, 1U);
+      put_bytes(pc, cable, p, len);
+      p += len;
+      running = 0U;
+    }
+    else if (status == 0xF7U)
+    {
+      /* a system message on its own, or more SysEx */
+      len = read_vlq(&p);
+      if ((p[0] > 0xF0U) && (p[0] != 0xF7U))
+      {
+        put_item(pc, tick, cable, p, (uint8_t)len);
+      }
+      else
+      {
+        put_bytes(pc, cable, p, len);
+      }
+      p += len;
+      running = 0U;
+    }
+    else
+    {
+      b[0] = status;
+      b[1] = *p++;
+      len = 2U;
+      if ((status & 0xE0U) != 0xC0U)
+      {
+        b[len++] = *p++;
+      }
+      put_item(pc, tick, cable, b, (uint8_t)len);
+      running = status;
+    }
+  }
+  return end;
+}
+
+static void export_send(uint32_t event)
+{
+  uint32_t cin = MIDI_EVENT_CIN(event), n, i;
+
+  n = (cin == MIDI_CIN_SYSEX_START) ? 3U : cin - 4U;
+  for (i = 0U; i < n; i++)
+  {
+    export_bytes[export_n++] = (uint8_t)(event >> (16U - 8U * i));
+  }
+}
+
+static void test_take(void)
+{
+  uint8_t b[128];
+  uint64_t t = 0U;
+  uint32_t i, k, len, r, size, off, n, tr, bytes, events, end_ok, bad;
+  uint32_t event;
+  const uint8_t *p;
+
+  memset(expect, 0, sizeof(expect));
+  memset(parsed, 0, sizeof(parsed));
+  MIDI_Rec_Init(&rec, buf, sizeof(buf), CPU_HZ);
+  mcu_host_cycles = CYCLES_BASE;
+  MIDI_Rec_Start(&rec);
+
+  /* up to 20 ms between events, the cycle counter wrapping every 10.7 s;
+     a quarter of the captures from interrupts */
+  for (i = 0U; i < TAKE_EVENTS; i++)
+  {
+    t += 1U + rnd() % (CPU_HZ / 50U);
+    tr = ((rnd() % 8U) == 0U) ? MIDI_REC_IN : MIDI_REC_OUT;
+    mcu_host_in_isr = ((rnd() % 4U) == 0U) ? 1U : 0U;
+    r = rnd() % 100U;
+    if (r < 60U)
+    {
+      event = MIDI_EVENT_CHANNEL(0U, 0x90U, rnd() % 128U, rnd() % 128U);
+    }
+    else if (r < 80U)
+    {
+      event = MIDI_EVENT_CHANNEL(0U, 0xB1U, 7U, rnd() % 128U);
+    }
+    else if (r < 85U)
+    {
+      event = MIDI_EVENT_CHANNEL(1U, 0xE0U, rnd() % 128U, rnd() % 128U);
+    }
+    else if (r < 90U)
+    {
+      event = MIDI_EVENT_CHANNEL(0U, 0xC2U, rnd() % 128U, 0U);
+    }
+    else if (r < 94U)
+    {
+      event = MIDI_EVENT(rnd() % 2U, MIDI_CIN_SYSCOM_2, 0xF1U, rnd() % 128U, 0U);
+    }
+    else if (r < 97U)
+    {
+      event = MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, ((r & 1U) != 0U) ? 0xF8U : 0xFAU, 0U, 0U);
+    }
+    else
+    {
+      /* a SysEx on cable 1, longer than a stored piece at times */
+      len = 2U + rnd() % 100U;
+      b[0] = 0xF0U;
+      for (k = 1U; k < len - 1U; k++)
+      {
+        b[k] = (uint8_t)(rnd() % 128U);
+      }
+      b[len - 1U] = 0xF7U;
+      for (k = 0U; k < len; k += 3U)
+      {
+        n = len - k;
+        event = (n > 3U) ? MIDI_EVENT(1U, MIDI_CIN_SYSEX_START, b[k], b[k + 1U], b[k + 2U])
+                         : MIDI_EVENT(1U, MIDI_CIN_SYSEX_END_1 + n - 1U, b[k],
+                                      (n > 1U) ? b[k + 1U] : 0U, (n > 2U) ? b[k + 2U] : 0U);
+        capture((uint8_t)tr, event, t);
+      }
+    }
+    if (r < 97U)
+    {
+      capture((uint8_t)tr, event, t);
+    }
+    if (((rnd() % 8U) == 0U) || ((i % 16U) == 15U) || (r >= 97U))
+    {
+      mcu_host_in_isr = 0U;
+      MIDI_Rec_Process(&rec);
+    }
+  }
+  mcu_host_in_isr = 0U;
+  MIDI_Rec_Stop(&rec);
+  CHECK_EQ(rec.track[0].stats.overflows + rec.track[1].stats.overflows, 0U);
+  CHECK_EQ(rec.track[0].stats.truncated + rec.track[1].stats.truncated, 0U);
+
+  /* read back in odd pieces */
+  size = MIDI_Rec_FileSize(&rec);
+  CHECK(size <= sizeof(file));
+  for (off = 0U; off < size; off += n)
+  {
+    n = MIDI_Rec_Read(&rec, off, &file[off], 1U + rnd() % 300U);
+    if (n == 0U)
+    {
+      break;
+    }
+  }
+  CHECK_EQ(off, size);
+  CHECK_EQ(MIDI_Rec_Read(&rec, size, file, 16U), 0U);
+  CHECK(memcmp(file, "MThd\0\0\0\6\0\1\0\2", 12U) == 0);
+  CHECK_EQ(((uint32_t)file[12] << 8) | file[13], 500000U / MIDI_REC_TICK_US);
+
+  /* the file holds what was captured, with its times */
+  p = &file[14];
+  bad = 0U;
+  for (tr = 0U; tr < MIDI_REC_TRACKS; tr++)
+  {
+    p = parse_track(p, &parsed[tr], &end_ok);
+    CHECK(end_ok);
+    CHECK_EQ(parsed[tr].items, expect[tr].items);
+    for (i = 0U; (i < parsed[tr].items) && (i < LIST_LEN); i++)
+    {
+      bad += (memcmp(&parsed[tr].item[i], &expect[tr].item[i], sizeof(ItemTypeDef)) != 0) ? 1U : 0U;
+    }
+    for (k = 0U; k < 2U; k++)
+    {
+      CHECK_EQ(parsed[tr].bytes[k], expect[tr].bytes[k]);
+      bad += (memcmp(parsed[tr].stream[k], expect[tr].stream[k], expect[tr].bytes[k]) != 0) ? 1U : 0U;
+    }
+  }
+  CHECK_EQ(p, &file[size]);
+  CHECK_EQ(bad, 0U);
+
+  bytes = rec.track[0].stats.bytes + rec.track[1].stats.bytes;
+  events = rec.track[0].stats.events + rec.track[1].stats.events;
+  printf("take: %u events, %u bytes, %.2f bytes per event\n", events, bytes, (double)bytes / events);
+
+  /* the SysEx export decodes to the same file */
+  MIDI_Rec_ExportStart(&rec);
+  CHECK_EQ(MIDI_Rec_ExportSysEx(&rec, 3U, export_send, 10U), 1U);
+  CHECK_EQ(export_n, 0U);
+  while (MIDI_Rec_ExportSysEx(&rec, 3U, export_send, 100U))
+  {
+  }
+  for (i = 0U, n = 0U, k = 0U, bad = 0U; i < export_n; k++)
+  {
+    bad += ((export_bytes[i] != 0xF0U) || (export_bytes[i + 1U] != 0x7DU) ||
+            ((((uint32_t)export_bytes[i + 2U] << 7) | export_bytes[i + 3U]) != (k & 0x3FFFU))) ? 1U : 0U;
+    for (i += 4U; export_bytes[i] != 0xF7U; )
+    {
+      r = export_bytes[i++];
+      for (len = 0U; (len < 7U) && (export_bytes[i] != 0xF7U); len++)
+      {
+        bad += (n >= size) || (file[n] != (export_bytes[i++] | (((r >> len) & 1U) << 7))) ? 1U : 0U;
+        n++;
+      }
+    }
+    i++;
+  }
+  CHECK_EQ(n, size);
+  CHECK_EQ(bad, 0U);
+  CHECK_EQ(k, size / MIDI_REC_EXPORT_BLOCK + 1U);
+}
+
+static void test_limits(void)
+{
+  static uint8_t small[256];
+  const uint8_t *p;
+  uint32_t i, size, end_ok;
+
+  /* a capture queue holds MIDI_REC_QUEUE_LEN events between passes */
+  MIDI_Rec_Init(&rec, buf, sizeof(buf), CPU_HZ);
+  MIDI_Rec_Start(&rec);
+  for (i = 0U; i <= MIDI_REC_QUEUE_LEN; i++)
+  {
+    MIDI_Rec_Capture(&rec, MIDI_REC_OUT, MIDI_EVENT_CHANNEL(0U, 0x90U, 60U, 1U));
+  }
+  mcu_host_in_isr = 1U;
+  MIDI_Rec_Capture(&rec, MIDI_REC_OUT, MIDI_EVENT_CHANNEL(0U, 0x90U, 61U, 1U));
+  mcu_host_in_isr = 0U;
+  MIDI_Rec_Stop(&rec);
+  CHECK_EQ(rec.track[0].stats.overflows, 1U);
+  CHECK_EQ(rec.track[0].stats.events, MIDI_REC_QUEUE_LEN + 1U);
+
+  /* nothing is kept while stopped */
+  MIDI_Rec_Capture(&rec, MIDI_REC_OUT, MIDI_EVENT_CHANNEL(0U, 0x90U, 60U, 1U));
+  CHECK_EQ(rec.track[0].q_thread.wp, rec.track[0].q_thread.rp);
+
+  /* a full buffer drops the rest of the take and still gives a whole
+     file */
+  MIDI_Rec_Init(&rec, small, sizeof(small), CPU_HZ);
+  MIDI_Rec_Start(&rec);
+  for (i = 0U; i < 1000U; i++)
+  {
+    mcu_host_cycles += CPU_HZ / 1000U;
+    MIDI_Rec_Capture(&rec, MIDI_REC_OUT, MIDI_EVENT_CHANNEL(0U, 0x90U, i & 0x7FU, 1U));
+    MIDI_Rec_Process(&rec);
+  }
+  MIDI_Rec_Stop(&rec);
+  CHECK(rec.track[0].stats.truncated > 0U);
+  CHECK(rec.track[0].len <= sizeof(small) / 2U);
+  size = MIDI_Rec_FileSize(&rec);
+  CHECK_EQ(MIDI_Rec_Read(&rec, 0U, file, sizeof(file)), size);
+  memset(parsed, 0, sizeof(parsed));
+  p = parse_track(&file[14], &parsed[0], &end_ok);
+  CHECK(end_ok);
+  CHECK_EQ(parsed[0].items, rec.track[0].stats.events);
+  p = parse_track(p, &parsed[1], &end_ok);
+  CHECK(end_ok);
+  CHECK_EQ(p, &file[size]);
+}
+
+static void bench(void)
+{
+  uint32_t i, k;
+  double t0 = 0.0, t1 = 0.0;
+
+  MIDI_Rec_Init(&rec, buf, sizeof(buf), CPU_HZ);
+  MIDI_Rec_Start(&rec);
+  for (i = 0U; i < 200000U; i += 16U)
+  {
+    t0 -= test_seconds();
+    for (k = 0U; k < 16U; k++)
+    {
+      mcu_host_cycles += rnd() % (CPU_HZ / 100U);
+      MIDI_Rec_Capture(&rec, MIDI_REC_OUT, MIDI_EVENT_CHANNEL(0U, 0x90U, (i + k) & 0x7FU, 100U));
+    }
+    t0 += test_seconds();
+    t1 -= test_seconds();
+    MIDI_Rec_Process(&rec);
+    t1 += test_seconds();
+  }
+  MIDI_Rec_Stop(&rec);
+  printf("bench: %.2f bytes per note, %.1f ns per capture, %.1f ns per event stored\n",
+         (double)rec.track[0].stats.bytes / rec.track[0].stats.events, t0 * 1e9 / i, t1 * 1e9 / i);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  test_take();
+  test_limits();
+  bench();
+  return TEST_RESULT();
+}
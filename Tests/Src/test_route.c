@@ -0,0 +1,233 @@
+/**
+  ******************************************************************************
+  * @file           : test_route.c
+  * @brief          : Routing matrix: the compiled lookup against a walk of
+  *                   the route list on random route sets and events, route
+  *                   list edits, delivery, and the lookup cost.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "midi_route.h"
+
+/* Private variables ---------------------------------------------------------*/
+static MIDI_RouteTypeDef model[MIDI_ROUTE_MAX];
+static uint32_t model_n;
+static uint32_t delivered[MIDI_ROUTE_NUM_PORTS];
+static uint32_t rng = 1U;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t rnd(void)
+{
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static void sink(uint8_t port, uint32_t event)
+{
+  (void)event;
+  delivered[port]++;
+}
+
+static void model_add(uint8_t src, uint8_t dst, uint16_t channels, uint16_t types)
+{
+  uint32_t i;
+
+  for (i = 0U; i < model_n; i++)
+  {
+    if ((model[i].src == src) && (model[i].dst == dst))
+    {
+      break;
+    }
+  }
+  if (i == model_n)
+  {
+    if (model_n == MIDI_ROUTE_MAX)
+    {
+      return;
+    }
+    model_n++;
+  }
+  model[i].src = src;
+  model[i].dst = dst;
+  model[i].channels = channels;
+  model[i].types = types;
+}
+
+static void model_remove(uint8_t src, uint8_t dst)
+{
+  uint32_t i;
+
+  for (i = 0U; i < model_n; i++)
+  {
+    if ((model[i].src == src) && (model[i].dst == dst))
+    {
+      model[i] = model[--model_n];
+      return;
+    }
+  }
+}
+
+/* Destinations of an event by walking the route list */
+static uint32_t model_lookup(uint8_t src, uint32_t event)
+{
+  uint32_t i, cin = MIDI_EVENT_CIN(event), dst = 0U;
+
+  for (i = 0U; i < model_n; i++)
+  {
+    if ((model[i].src != src) || ((model[i].types & (1U << cin)) == 0U))
+    {
+      continue;
+    }
+    if ((cin >= MIDI_CIN_NOTE_OFF) && (cin <= MIDI_CIN_PITCH_BEND) &&
+        ((model[i].channels & (1U << MIDI_EVENT_CHANNEL_NUM(event))) == 0U))
+    {
+      continue;
+    }
+    dst |= 1UL << model[i].dst;
+  }
+  return dst;
+}
+
+static void test_edits(void)
+{
+  uint32_t i;
+
+  MIDI_Route_Init();
+  CHECK_EQ(MIDI_Route_Add(MIDI_ROUTE_NUM_PORTS, 0U, MIDI_ROUTE_CH_ALL, MIDI_ROUTE_TYPE_ALL), -1);
+  CHECK_EQ(MIDI_Route_Add(0U, MIDI_ROUTE_NUM_PORTS, MIDI_ROUTE_CH_ALL, MIDI_ROUTE_TYPE_ALL), -1);
+
+  /* notes on channels 1-2 to the internal port, voice and system on
+     channel 3 to the DIN port */
+  MIDI_Route_Add(MIDI_PORT_USB(0), MIDI_PORT_INTERNAL(0), MIDI_ROUTE_CH(0) | MIDI_ROUTE_CH(1),
+                 MIDI_ROUTE_TYPE_NOTES);
+  MIDI_Route_Add(MIDI_PORT_USB(0), MIDI_PORT_UART(0), MIDI_ROUTE_CH(2),
+                 MIDI_ROUTE_TYPE_VOICE | MIDI_ROUTE_TYPE_SYSTEM);
+  MIDI_Route_Compile();
+  CHECK_EQ(MIDI_Route_Lookup(0U, MIDI_EVENT_CHANNEL(0U, 0x91U, 60U, 1U)),
+           1UL << MIDI_PORT_INTERNAL(0));
+  CHECK_EQ(MIDI_Route_Lookup(0U, MIDI_EVENT_CHANNEL(0U, 0xB2U, 7U, 1U)),
+           1UL << MIDI_PORT_UART(0));
+  CHECK_EQ(MIDI_Route_Lookup(0U, MIDI_EVENT_CHANNEL(0U, 0xB1U, 7U, 1U)), 0U);
+  /* the channel filter does not apply to system messages */
+  CHECK_EQ(MIDI_Route_Lookup(0U, MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, 0xF8U, 0U, 0U)),
+           1UL << MIDI_PORT_UART(0));
+  CHECK_EQ(MIDI_Route_Lookup(1U, MIDI_EVENT_CHANNEL(1U, 0x91U, 60U, 1U)), 0U);
+
+  /* a second add of a pair replaces its filters; edits are live only
+     after the next compile */
+  MIDI_Route_Add(MIDI_PORT_USB(0), MIDI_PORT_INTERNAL(0), MIDI_ROUTE_CH_ALL, MIDI_ROUTE_TYPE_ALL);
+  CHECK_EQ(MIDI_Route_Lookup(0U, MIDI_EVENT_CHANNEL(0U, 0xB1U, 7U, 1U)), 0U);
+  MIDI_Route_Compile();
+  CHECK_EQ(MIDI_Route_Lookup(0U, MIDI_EVENT_CHANNEL(0U, 0xB1U, 7U, 1U)),
+           1UL << MIDI_PORT_INTERNAL(0));
+  MIDI_Route_Remove(MIDI_PORT_USB(0), MIDI_PORT_INTERNAL(0));
+  MIDI_Route_Compile();
+  CHECK_EQ(MIDI_Route_Lookup(0U, MIDI_EVENT_CHANNEL(0U, 0xB1U, 7U, 1U)), 0U);
+
+  /* the list holds MIDI_ROUTE_MAX pairs */
+  MIDI_Route_Init();
+  for (i = 0U; i < MIDI_ROUTE_MAX; i++)
+  {
+    CHECK_EQ(MIDI_Route_Add((uint8_t)(i % 4U), (uint8_t)(i / 4U), MIDI_ROUTE_CH_ALL,
+                            MIDI_ROUTE_TYPE_ALL), 0);
+  }
+  CHECK_EQ(MIDI_Route_Add(31U, 31U, MIDI_ROUTE_CH_ALL, MIDI_ROUTE_TYPE_ALL), -1);
+  CHECK_EQ(MIDI_Route_Add(0U, 0U, MIDI_ROUTE_CH(5), MIDI_ROUTE_TYPE_ALL), 0);
+}
+
+static void test_random(void)
+{
+  uint32_t set, i, ev, mismatch = 0U;
+  uint16_t ch, ty;
+  uint8_t src, d;
+
+  for (set = 0U; set < 200U; set++)
+  {
+    MIDI_Route_Init();
+    model_n = 0U;
+    for (i = rnd() % (2U * MIDI_ROUTE_MAX); i > 0U; i--)
+    {
+      src = (uint8_t)(rnd() % 4U);
+      d = (uint8_t)(rnd() % MIDI_ROUTE_NUM_PORTS);
+      if ((rnd() % 8U) == 0U)
+      {
+        MIDI_Route_Remove(src, d);
+        model_remove(src, d);
+        continue;
+      }
+      ch = (uint16_t)rnd();
+      ty = (uint16_t)rnd();
+      MIDI_Route_Add(src, d, ch, ty);
+      model_add(src, d, ch, ty);
+    }
+    MIDI_Route_Compile();
+    for (i = 0U; i < 1000U; i++)
+    {
+      ev = rnd();
+      src = (uint8_t)(rnd() % 4U);
+      mismatch += (MIDI_Route_Lookup(src, ev) != model_lookup(src, ev)) ? 1U : 0U;
+    }
+  }
+  CHECK_EQ(mismatch, 0U);
+}
+
+static void test_deliver(void)
+{
+  uint32_t p;
+
+  MIDI_Route_Init();
+  for (p = 0U; p < MIDI_ROUTE_NUM_PORTS; p++)
+  {
+    MIDI_Route_SetSink((uint8_t)p, sink);
+  }
+  memset(delivered, 0, sizeof(delivered));
+  MIDI_Route_Add(0U, 3U, MIDI_ROUTE_CH_ALL, MIDI_ROUTE_TYPE_ALL);
+  MIDI_Route_Add(0U, 17U, MIDI_ROUTE_CH_ALL, MIDI_ROUTE_TYPE_NOTES);
+  MIDI_Route_Add(0U, 31U, MIDI_ROUTE_CH(9), MIDI_ROUTE_TYPE_ALL);
+  MIDI_Route_Compile();
+  MIDI_Route_Process(0U, MIDI_EVENT_CHANNEL(0U, 0x99U, 36U, 100U));
+  MIDI_Route_Process(0U, MIDI_EVENT_CHANNEL(0U, 0xB0U, 7U, 100U));
+  CHECK_EQ(delivered[3], 2U);
+  CHECK_EQ(delivered[17], 1U);
+  CHECK_EQ(delivered[31], 1U);
+  CHECK_EQ(MIDI_RouteStats.events, 2U);
+  CHECK_EQ(MIDI_RouteStats.deliveries, 4U);
+}
+
+static void bench(void)
+{
+  uint32_t i, acc = 0U;
+  double t0;
+
+  MIDI_Route_Init();
+  for (i = 0U; i < MIDI_ROUTE_MAX; i++)
+  {
+    MIDI_Route_Add((uint8_t)(i % 16U), (uint8_t)(16U + i % 16U), (uint16_t)(0x1111U << (i % 4U)),
+                   MIDI_ROUTE_TYPE_ALL);
+  }
+  MIDI_Route_Compile();
+  t0 = test_seconds();
+  for (i = 0U; i < 10000000U; i++)
+  {
+    acc ^= MIDI_Route_Lookup((uint8_t)(i & 15U), i * 2654435761U);
+  }
+  printf("bench: %.2f ns per lookup with %u routes (%08x)\n",
+         (test_seconds() - t0) * 100.0, MIDI_ROUTE_MAX, acc);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  test_edits();
+  test_random();
+  test_deliver();
+  bench();
+  return TEST_RESULT();
+}
@@ -0,0 +1,437 @@
+/**
+  ******************************************************************************
+  * @file           : test_smf.c
+  * @brief          : SMF player: track merge order on a large file against a
+  *                   sorted reference, event times through tempo changes
+  *                   and SMPTE division, SysEx split over the budget, header
+  *                   checks, damaged files, and the events per second.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "host_test.h"
+#include "midi_smf.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BIG_TRACKS                16U
+#define BIG_NOTES                 60000U
+#define IMAGE_SIZE                (BIG_TRACKS * BIG_NOTES * 6U + 1024U)
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t tick;
+  uint32_t track;
+  uint8_t  note;
+} NoteTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static SMF_PlayerTypeDef player;
+static uint8_t image[IMAGE_SIZE];
+static uint8_t *wp, *track_start;
+static NoteTypeDef ref[BIG_TRACKS * BIG_NOTES];
+static uint32_t ref_n, out_n, out_bad;
+static uint32_t log_ev[2048];
+static uint32_t log_us[2048];
+static uint32_t log_n, now_us;
+static uint32_t rng = 7U;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t rnd(void)
+{
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+/* A minimal SMF writer */
+static void put_vlq(uint32_t v)
+{
+  uint8_t b[4];
+  uint32_t n = 0U;
+
+  do
+  {
+    b[n++] = v & 0x7FU;
+    v >>= 7;
+  } while (v != 0U);
+  while (n > 1U)
+  {
+    *wp++ = b[--n] | 0x80U;
+  }
+  *wp++ = b[0];
+}
+
+static void put_header(uint16_t format, uint16_t tracks, uint16_t division)
+{
+  wp = image;
+  memcpy(wp, "MThd\0\0\0\6", 8U);
+  wp += 8;
+  *wp++ = (uint8_t)(format >> 8);
+  *wp++ = (uint8_t)format;
+  *wp++ = (uint8_t)(tracks >> 8);
+  *wp++ = (uint8_t)tracks;
+  *wp++ = (uint8_t)(division >> 8);
+  *wp++ = (uint8_t)division;
+}
+
+static void track_begin(void)
+{
+  memcpy(wp, "MTrk", 4U);
+  wp += 8;
+  track_start = wp;
+}
+
+static void track_end(void)
+{
+  uint32_t len;
+
+  put_vlq(0U);
+  *wp++ = 0xFFU;
+  *wp++ = 0x2FU;
+  *wp++ = 0U;
+  len = (uint32_t)(wp - track_start);
+  track_start[-4] = (uint8_t)(len >> 24);
+  track_start[-3] = (uint8_t)(len >> 16);
+  track_start[-2] = (uint8_t)(len >> 8);
+  track_start[-1] = (uint8_t)len;
+}
+
+static void put_tempo(uint32_t delta, uint32_t us)
+{
+  put_vlq(delta);
+  *wp++ = 0xFFU;
+  *wp++ = 0x51U;
+  *wp++ = 3U;
+  *wp++ = (uint8_t)(us >> 16);
+  *wp++ = (uint8_t)(us >> 8);
+  *wp++ = (uint8_t)us;
+}
+
+static uint32_t image_size(void)
+{
+  return (uint32_t)(wp - image);
+}
+
+static void capture(uint32_t event)
+{
+  if (log_n < 2048U)
+  {
+    log_ev[log_n] = event;
+    log_us[log_n] = now_us;
+  }
+  log_n++;
+}
+
+static void check_order(uint32_t event)
+{
+  if (MIDI_EVENT_CIN(event) == MIDI_CIN_NOTE_ON)
+  {
+    out_bad += ((out_n >= ref_n) || (MIDI_EVENT_DATA1(event) != ref[out_n].note) ||
+                (MIDI_EVENT_CHANNEL_NUM(event) != ref[out_n].track - 1U)) ? 1U : 0U;
+    out_n++;
+  }
+}
+
+static void discard(uint32_t event)
+{
+  (void)event;
+}
+
+static int by_tick(const void *a, const void *b)
+{
+  const NoteTypeDef *x = a, *y = b;
+
+  if (x->tick != y->tick)
+  {
+    return (x->tick < y->tick) ? -1 : 1;
+  }
+  return (int)x->track - (int)y->track;
+}
+
+/* A tempo track with a SysEx, then BIG_TRACKS tracks of notes in running
+   status with random gaps, ties across tracks included */
+static void build_big(void)
+{
+  uint32_t t, i, d, tick;
+  uint8_t n;
+
+  put_header(1U, BIG_TRACKS + 1U, 480U);
+  track_begin();
+  put_tempo(0U, 500000U);
+  put_vlq(0U);
+  *wp++ = 0xF0U;
+  *wp++ = 5U;
+  memcpy(wp, "\x7E\x7F\x09\x01\xF7", 5U);
+  wp += 5;
+  track_end();
+  ref_n = 0U;
+  for (t = 1U; t <= BIG_TRACKS; t++)
+  {
+    track_begin();
+    tick = 0U;
+    for (i = 0U; i < BIG_NOTES; i++)
+    {
+      d = rnd() % 40U;
+      tick += d;
+      n = (uint8_t)(rnd() % 128U);
+      put_vlq(d);
+      if (i == 0U)
+      {
+        *wp++ = (uint8_t)(0x90U | (t - 1U));
+      }
+      *wp++ = n;
+      *wp++ = 64U;
+      ref[ref_n].tick = tick;
+      ref[ref_n].track = t;
+      ref[ref_n].note = n;
+      ref_n++;
+    }
+    track_end();
+  }
+  qsort(ref, ref_n, sizeof(ref[0]), by_tick);
+}
+
+static void test_order(void)
+{
+  uint32_t events = 0U;
+  double t0;
+
+  build_big();
+  CHECK_EQ(SMF_Open(&player, image, image_size(), 0U, check_order), 0);
+  CHECK_EQ(player.tracks, BIG_TRACKS + 1U);
+  out_n = 0U;
+  out_bad = 0U;
+  SMF_Start(&player, 0U);
+  t0 = test_seconds();
+  while (player.playing)
+  {
+    events += SMF_Process(&player, 0x7FFFFFFFU, 1000000U);
+  }
+  t0 = test_seconds() - t0;
+  CHECK_EQ(out_n, ref_n);
+  CHECK_EQ(out_bad, 0U);
+  /* the notes, the SysEx packets and the tempo */
+  CHECK_EQ(events, ref_n + 2U + 1U);
+  printf("bench: %u tracks, %u events in %.1f ms, %.1f M events/s, %u bytes of RAM per track\n",
+         player.tracks, events, t0 * 1e3, events / t0 * 1e-6, (uint32_t)sizeof(SMF_TrackTypeDef));
+}
+
+/* Microseconds of a tick under the tempo map of test_tempo() */
+static uint32_t tempo_map(uint32_t tick)
+{
+  if (tick <= 384U)
+  {
+    return tick * 500000U / 96U;
+  }
+  if (tick <= 768U)
+  {
+    return 2000000U + (tick - 384U) * 250000U / 96U;
+  }
+  return 3000000U + (tick - 768U) * 1000000U / 96U;
+}
+
+static void test_tempo(void)
+{
+  uint32_t i, n, bad = 0U;
+
+  /* the tempo halves after four beats and quarters after eight; a note
+     on the tick of a change is timed by the new tempo */
+  put_header(1U, 2U, 96U);
+  track_begin();
+  put_tempo(384U, 250000U);
+  put_tempo(384U, 1000000U);
+  track_end();
+  track_begin();
+  for (i = 0U; i <= 48U; i++)
+  {
+    put_vlq((i == 0U) ? 0U : 24U);
+    *wp++ = 0x90U;
+    *wp++ = (uint8_t)i;
+    *wp++ = 100U;
+  }
+  track_end();
+
+  CHECK_EQ(SMF_Open(&player, image, image_size(), 3U, capture), 0);
+  log_n = 0U;
+  SMF_Start(&player, 5000U);
+  for (now_us = 5000U; player.playing && (now_us < 20000000U); now_us += 100U)
+  {
+    SMF_Process(&player, now_us, 16U);
+  }
+  n = 0U;
+  for (i = 0U; i < log_n; i++)
+  {
+    if (MIDI_EVENT_CIN(log_ev[i]) != MIDI_CIN_NOTE_ON)
+    {
+      continue;
+    }
+    /* out at the first call at or after its time, running status kept */
+    bad += (log_ev[i] != MIDI_EVENT_CHANNEL(3U, 0x90U, n, 100U)) ? 1U : 0U;
+    bad += ((log_us[i] - 5000U - tempo_map(n * 24U)) >= 100U) ? 1U : 0U;
+    n++;
+  }
+  CHECK_EQ(n, 49U);
+  CHECK_EQ(bad, 0U);
+  CHECK(player.stats.late_max < 100U);
+
+  /* SMPTE division: 25 fps and 40 ticks per frame make a tick 1 ms, and
+     tempo events are ignored */
+  put_header(0U, 1U, (uint16_t)(((uint8_t)-25 << 8) | 40U));
+  track_begin();
+  put_tempo(0U, 100000U);
+  put_vlq(1000U);
+  *wp++ = 0xC5U;
+  *wp++ = 7U;
+  track_end();
+  CHECK_EQ(SMF_Open(&player, image, image_size(), 0U, capture), 0);
+  SMF_Start(&player, 0U);
+  log_n = 0U;
+  SMF_Process(&player, 999999U, 16U);
+  CHECK_EQ(log_n, 0U);
+  SMF_Process(&player, 1000000U, 16U);
+  CHECK_EQ(log_n, 1U);
+  CHECK_EQ(log_ev[0], MIDI_EVENT_CHANNEL(0U, 0xC5U, 7U, 0U));
+}
+
+static void test_sysex(void)
+{
+  uint8_t bytes[1100];
+  uint32_t i, j, k, cin, nb = 0U, calls = 0U, most = 0U, before;
+
+  /* a 1000 byte SysEx then a note, through a 64 packet budget */
+  put_header(0U, 1U, 96U);
+  track_begin();
+  put_vlq(0U);
+  *wp++ = 0xF0U;
+  put_vlq(1000U);
+  for (i = 0U; i < 999U; i++)
+  {
+    *wp++ = (uint8_t)(i & 0x7FU);
+  }
+  *wp++ = 0xF7U;
+  put_vlq(0U);
+  *wp++ = 0x90U;
+  *wp++ = 60U;
+  *wp++ = 100U;
+  track_end();
+
+  CHECK_EQ(SMF_Open(&player, image, image_size(), 0U, capture), 0);
+  SMF_Start(&player, 0U);
+  log_n = 0U;
+  while (player.playing && (calls < 100U))
+  {
+    before = log_n;
+    SMF_Process(&player, 1U, 64U);
+    most = ((log_n - before) > most) ? (log_n - before) : most;
+    calls++;
+  }
+  CHECK(most <= 64U);
+  CHECK_EQ(log_n, 334U + 1U);
+  for (i = 0U; i + 1U < log_n; i++)
+  {
+    cin = MIDI_EVENT_CIN(log_ev[i]);
+    CHECK((cin >= MIDI_CIN_SYSEX_START) && (cin <= MIDI_CIN_SYSEX_END_3));
+    k = (cin == MIDI_CIN_SYSEX_START) ? 3U : cin - 4U;
+    for (j = 0U; (j < k) && (nb < sizeof(bytes)); j++)
+    {
+      bytes[nb++] = (uint8_t)(log_ev[i] >> (16U - 8U * j));
+    }
+  }
+  CHECK_EQ(nb, 1001U);
+  CHECK_EQ(bytes[0], 0xF0U);
+  CHECK_EQ(bytes[1000], 0xF7U);
+  k = 0U;
+  for (i = 0U; i < 999U; i++)
+  {
+    k += (bytes[i + 1U] != (i & 0x7FU)) ? 1U : 0U;
+  }
+  CHECK_EQ(k, 0U);
+  CHECK_EQ(log_ev[log_n - 1U], MIDI_EVENT_CHANNEL(0U, 0x90U, 60U, 100U));
+  /* the SysEx, the note and the end of track */
+  CHECK_EQ(player.stats.events, 3U);
+}
+
+static void test_damaged(void)
+{
+  long page = sysconf(_SC_PAGESIZE);
+  uint8_t *guard, *copy;
+  uint32_t size, cut, i, j, runs, opened = 0U;
+
+  put_header(0U, 1U, 96U);
+  track_begin();
+  for (i = 0U; i < 200U; i++)
+  {
+    put_vlq(i & 7U);
+    *wp++ = (uint8_t)(0x90U | (i & 0x0FU));
+    *wp++ = (uint8_t)i & 0x7FU;
+    *wp++ = 1U;
+  }
+  track_end();
+  size = image_size();
+
+  /* header checks */
+  image[4] = 0x7FU;
+  CHECK_EQ(SMF_Open(&player, image, size, 0U, discard), -1);
+  image[4] = 0U;
+  image[7] = (uint8_t)(size - 7U);
+  CHECK_EQ(SMF_Open(&player, image, size, 0U, discard), -1);
+  image[7] = 6U;
+  image[13] = 0U;
+  CHECK_EQ(SMF_Open(&player, image, size, 0U, discard), -1);
+  image[13] = 96U;
+  CHECK_EQ(SMF_Open(&player, image, 13U, 0U, discard), -1);
+  image[14] = 'X';
+  CHECK_EQ(SMF_Open(&player, image, size, 0U, discard), -1);
+  image[14] = 'M';
+  CHECK_EQ(SMF_Open(&player, image, size, 0U, discard), 0);
+
+  /* cut short or with random bytes changed, a file is played without a
+     read past its end, which sits against an unmapped page */
+  guard = mmap(NULL, (size_t)page * 2U, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  CHECK((guard != MAP_FAILED) && ((uint32_t)page >= size));
+  if ((guard == MAP_FAILED) || ((uint32_t)page < size))
+  {
+    return;
+  }
+  mprotect(guard + page, (size_t)page, PROT_NONE);
+  for (runs = 0U; runs < 20000U; runs++)
+  {
+    cut = ((runs & 1U) != 0U) ? size : 15U + rnd() % (size - 15U);
+    copy = guard + page - cut;
+    memcpy(copy, image, cut);
+    for (j = rnd() % 8U; j > 0U; j--)
+    {
+      copy[14U + rnd() % (cut - 14U)] = (uint8_t)rnd();
+    }
+    if (SMF_Open(&player, copy, cut, 0U, discard) != 0)
+    {
+      continue;
+    }
+    opened++;
+    SMF_Start(&player, 0U);
+    for (i = 0U; player.playing && (i < 1000U); i++)
+    {
+      SMF_Process(&player, 0x7FFFFFFFU, 64U);
+    }
+  }
+  munmap(guard, (size_t)page * 2U);
+  CHECK(opened > 10000U);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  test_tempo();
+  test_sysex();
+  test_damaged();
+  test_order();
+  return TEST_RESULT();
+}
@@ -0,0 +1,177 @@
+/**
+  ******************************************************************************
+  * @file           : test_usb_cfg.c
+  * @brief          : Configuration descriptors of the MIDI device per speed:
+  *                   the full speed, high speed and other speed images
+  *                   served over the simulated bus in any order, their
+  *                   structure and endpoint sizes, that they are never
+  *                   written, and the cost of a request.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "usb_sim.h"
+#include "usb_device.h"
+#include "usbd_midi.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_LOOPS               10000000U
+#define BENCH_REQUESTS            1000000U
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint8_t type;          /* bDescriptorType of the image */
+  uint16_t mps;          /* of every bulk endpoint */
+  uint8_t *(*get)(uint16_t *length);
+} CfgTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+extern USBD_HandleTypeDef hUsbDeviceFS;
+static CfgTypeDef cfg[3];
+static uint8_t image[3][USB_MIDI_CONFIG_DESC_SIZ];
+static volatile uintptr_t sink;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* Walks the descriptors of an image; returns the number of problems */
+static uint32_t check_image(const uint8_t *p, uint16_t len, const CfgTypeDef *pc)
+{
+  uint32_t i, eps = 0U, ifs = 0U, bad = 0U;
+
+  bad += (p[0] != 9U) || (p[1] != pc->type) ? 1U : 0U;
+  bad += ((uint16_t)(p[2] | (p[3] << 8)) != len) ? 1U : 0U;
+  for (i = 0U; (i < len) && (p[i] != 0U); i += p[i])
+  {
+    if (p[i + 1U] == USB_DESC_TYPE_INTERFACE)
+    {
+      ifs += (p[i + 3U] == 0U) ? 1U : 0U;
+    }
+    if (p[i + 1U] == USB_DESC_TYPE_ENDPOINT)
+    {
+      bad += ((uint16_t)(p[i + 4U] | (p[i + 5U] << 8)) != pc->mps) ? 1U : 0U;
+      eps++;
+    }
+  }
+  bad += (i != len) ? 1U : 0U;
+  bad += (ifs != p[4]) ? 1U : 0U;
+  bad += (eps != 2U * USBD_MIDI_NUM_PIPES) ? 1U : 0U;
+  return bad;
+}
+
+static uint8_t get_desc(uint8_t type, uint16_t wLength)
+{
+  return USBSIM_Control(&hUsbDeviceFS, 0x80U, USB_REQ_GET_DESCRIPTOR,
+                        (uint16_t)(type << 8), 0U, wLength, NULL);
+}
+
+static void test_images(void)
+{
+  uint16_t len;
+  uint32_t k;
+  uint8_t *p;
+
+  for (k = 0U; k < 3U; k++)
+  {
+    p = cfg[k].get(&len);
+    CHECK_EQ(len, USB_MIDI_CONFIG_DESC_SIZ);
+    CHECK_EQ(check_image(p, len, &cfg[k]), 0U);
+    memcpy(image[k], p, len);
+    /* the same image every time */
+    CHECK(cfg[k].get(&len) == p);
+  }
+  /* the speeds differ only in the type and the packet sizes */
+  for (k = 0U, len = 0U; k < USB_MIDI_CONFIG_DESC_SIZ; k++)
+  {
+    len += (image[0][k] != image[1][k]) ? 1U : 0U;
+  }
+  CHECK_EQ(len, 2U * 2U * USBD_MIDI_NUM_PIPES);
+  CHECK(memcmp(&image[0][2], &image[2][2], USB_MIDI_CONFIG_DESC_SIZ - 2U) == 0);
+}
+
+/* Requests in any order at either speed answer the same bytes: no getter
+   changes what another serves */
+static void test_requests(void)
+{
+  static const uint8_t order[] = { 0U, 1U, 2U, 0U, 2U, 1U, 1U, 0U };
+  uint32_t i, k, bad = 0U;
+
+  CHECK_EQ(USBSIM_Enumerate(&hUsbDeviceFS, USBD_SPEED_HIGH), 0U);
+  for (i = 0U; i < sizeof(order); i++)
+  {
+    k = order[i];
+    /* the device answers at the speed of the bus */
+    if (k == 0U)
+    {
+      (void)USBD_LL_SetSpeed(&hUsbDeviceFS, USBD_SPEED_FULL);
+    }
+    else
+    {
+      (void)USBD_LL_SetSpeed(&hUsbDeviceFS, USBD_SPEED_HIGH);
+    }
+    bad += get_desc(cfg[k].type, 0xFFFFU);
+    bad += (USBSIM.ep0_len != USB_MIDI_CONFIG_DESC_SIZ) ? 1U : 0U;
+    bad += (memcmp(USBSIM.ep0, image[k], USB_MIDI_CONFIG_DESC_SIZ) != 0) ? 1U : 0U;
+  }
+  CHECK_EQ(bad, 0U);
+
+  /* the header alone, as the host asks first */
+  CHECK_EQ(get_desc(USB_DESC_TYPE_CONFIGURATION, 9U), 0U);
+  CHECK_EQ(USBSIM.ep0_len, 9U);
+
+  /* no other speed, nor a qualifier, at full speed */
+  (void)USBD_LL_SetSpeed(&hUsbDeviceFS, USBD_SPEED_FULL);
+  CHECK(get_desc(USB_DESC_TYPE_OTHER_SPEED_CONFIGURATION, 0xFFU) != 0U);
+  CHECK(get_desc(USB_DESC_TYPE_DEVICE_QUALIFIER, 10U) != 0U);
+}
+
+static void bench(void)
+{
+  static const char *const name[3] = { "full speed", "high speed", "other speed" };
+  uint32_t i, k;
+  uint16_t len;
+  double t0, t1;
+
+  for (k = 0U; k < 3U; k++)
+  {
+    t0 = test_seconds();
+    for (i = 0U; i < BENCH_LOOPS; i++)
+    {
+      sink += (uintptr_t)cfg[k].get(&len) + len;
+    }
+    t0 = (test_seconds() - t0) * 1e9 / BENCH_LOOPS;
+
+    (void)USBD_LL_SetSpeed(&hUsbDeviceFS, (k == 0U) ? USBD_SPEED_FULL : USBD_SPEED_HIGH);
+    t1 = test_seconds();
+    for (i = 0U; i < BENCH_REQUESTS; i++)
+    {
+      (void)get_desc(cfg[k].type, 0xFFFFU);
+    }
+    t1 = (test_seconds() - t1) * 1e9 / BENCH_REQUESTS;
+    printf("bench: %s: %.2f ns per getter call, %.0f ns per GET_DESCRIPTOR on the bus\n",
+           name[k], t0, t1);
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  cfg[0].type = USB_DESC_TYPE_CONFIGURATION;
+  cfg[0].mps = MIDI_DATA_FS_MAX_PACKET_SIZE;
+  cfg[0].get = USBD_MIDI.GetFSConfigDescriptor;
+  cfg[1].type = USB_DESC_TYPE_CONFIGURATION;
+  cfg[1].mps = MIDI_DATA_HS_MAX_PACKET_SIZE;
+  cfg[1].get = USBD_MIDI.GetHSConfigDescriptor;
+  cfg[2].type = USB_DESC_TYPE_OTHER_SPEED_CONFIGURATION;
+  cfg[2].mps = MIDI_DATA_FS_MAX_PACKET_SIZE;
+  cfg[2].get = USBD_MIDI.GetOtherSpeedConfigDescriptor;
+
+  MX_USB_DEVICE_Init();
+  test_images();
+  test_requests();
+  bench();
+  return TEST_RESULT();
+}
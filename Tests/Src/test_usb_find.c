@@ -0,0 +1,225 @@
+/**
+  ******************************************************************************
+  * @file           : test_usb_find.c
+  * @brief          : Endpoint and interface lookup of the composite device:
+  *                   the tables USBD_CoreFindEP() and USBD_CoreFindIF() read
+  *                   against the search of the class list they replace, for
+  *                   every address, then the requests and the packets of
+  *                   each function reaching it on the simulated bus, and
+  *                   the cost of a lookup for the first and the last class.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "usb_sim.h"
+#include "usb_device.h"
+#include "usbd_midi.h"
+#include "usbd_midi_if.h"
+#include "usbd_cdc.h"
+
+/* Private define ------------------------------------------------------------*/
+#define CDC_IF                    2U
+#define BENCH_LOOPS               20000000U
+
+/* Private variables ---------------------------------------------------------*/
+extern USBD_HandleTypeDef hUsbDeviceFS;
+static uint32_t rx_event;
+static uint32_t rx_count;
+static volatile uint8_t sink;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* The search of the class list the tables replace: the first active class
+   with a Setup function that lists the endpoint or interface */
+static uint8_t ref_find_ep(USBD_HandleTypeDef *pdev, uint8_t index)
+{
+  for (uint32_t i = 0U; i < USBD_MAX_SUPPORTED_CLASS; i++)
+  {
+    if (pdev->tclasslist[i].Active == 1U)
+    {
+      for (uint32_t j = 0U; j < pdev->tclasslist[i].NumEps; j++)
+      {
+        if ((pdev->tclasslist[i].Eps[j].add == index) && (pdev->pClass[i]->Setup != NULL))
+        {
+          return (uint8_t)i;
+        }
+      }
+    }
+  }
+  return 0xFFU;
+}
+
+static uint8_t ref_find_if(USBD_HandleTypeDef *pdev, uint8_t index)
+{
+  for (uint32_t i = 0U; i < USBD_MAX_SUPPORTED_CLASS; i++)
+  {
+    if (pdev->tclasslist[i].Active == 1U)
+    {
+      for (uint32_t j = 0U; j < pdev->tclasslist[i].NumIf; j++)
+      {
+        if ((pdev->tclasslist[i].Ifs[j] == index) && (pdev->pClass[i]->Setup != NULL))
+        {
+          return (uint8_t)i;
+        }
+      }
+    }
+  }
+  return 0xFFU;
+}
+
+/* Every byte value, as the endpoint and the interface of a request */
+static uint32_t compare_all(USBD_HandleTypeDef *pdev)
+{
+  uint32_t i, bad = 0U;
+
+  for (i = 0U; i < 256U; i++)
+  {
+    bad += (USBD_CoreFindEP(pdev, (uint8_t)i) != ref_find_ep(pdev, (uint8_t)i)) ? 1U : 0U;
+    bad += (USBD_CoreFindIF(pdev, (uint8_t)i) != ref_find_if(pdev, (uint8_t)i)) ? 1U : 0U;
+  }
+  return bad;
+}
+
+static void test_tables(void)
+{
+  USBD_HandleTypeDef *pdev = &hUsbDeviceFS;
+  uint32_t n;
+
+  CHECK_EQ(compare_all(pdev), 0U);
+
+  /* MIDI 0, CDC, MIDI 1, MIDI 2 in class order */
+  for (n = 0U; n < USBD_MIDI_NUM_INSTANCES; n++)
+  {
+    uint8_t cls = (n == 0U) ? 0U : (uint8_t)(n + 1U);
+
+    CHECK_EQ(USBD_CoreFindEP(pdev, MIDI_INST_IN_EP(n)), cls);
+    CHECK_EQ(USBD_CoreFindEP(pdev, MIDI_INST_OUT_EP(n)), cls);
+  }
+  CHECK_EQ(USBD_CoreFindEP(pdev, CDC_IN_EP), 1U);
+  CHECK_EQ(USBD_CoreFindEP(pdev, CDC_OUT_EP), 1U);
+  CHECK_EQ(USBD_CoreFindEP(pdev, CDC_CMD_EP), 1U);
+  CHECK_EQ(USBD_CoreFindIF(pdev, 0U), 0U);
+  CHECK_EQ(USBD_CoreFindIF(pdev, 1U), 0U);
+  CHECK_EQ(USBD_CoreFindIF(pdev, CDC_IF), 1U);
+  CHECK_EQ(USBD_CoreFindIF(pdev, CDC_IF + 1U), 1U);
+
+  /* unused numbers, and the direction bit counts */
+  CHECK_EQ(USBD_CoreFindEP(pdev, 0x8FU), 0xFFU);
+  CHECK_EQ(USBD_CoreFindEP(pdev, 0x03U), 0xFFU);
+  CHECK_EQ(USBD_CoreFindEP(pdev, 0x91U), 0xFFU);
+  CHECK_EQ(USBD_CoreFindIF(pdev, USBD_MAX_NUM_INTERFACES), 0xFFU);
+  CHECK_EQ(USBD_CoreFindIF(pdev, 0xFFU), 0xFFU);
+}
+
+/* Requests to an interface reach its class; the others stall */
+static void test_requests(void)
+{
+  USBD_HandleTypeDef *pdev = &hUsbDeviceFS;
+  static const uint8_t coding[7] = { 0x00U, 0xC2U, 0x01U, 0x00U, 0x00U, 0x00U, 0x08U };
+
+  CHECK_EQ(USBSIM_Enumerate(pdev, USBD_SPEED_FULL), 0U);
+  CHECK_EQ(USBSIM_Control(pdev, 0x21U, CDC_SET_LINE_CODING, 0U, CDC_IF, 7U, coding), 0U);
+  CHECK_EQ(USBSIM_Control(pdev, 0xA1U, CDC_GET_LINE_CODING, 0U, CDC_IF, 7U, NULL), 0U);
+  CHECK_EQ(USBSIM.ep0_len, 7U);
+  CHECK(memcmp(USBSIM.ep0, coding, 7U) == 0);
+  CHECK(USBSIM_Control(pdev, 0xA1U, CDC_GET_LINE_CODING, 0U, 9U, 7U, NULL) != 0U);
+
+  /* GET_STATUS of each endpoint, through the endpoint table */
+  CHECK_EQ(USBSIM_Control(pdev, 0x82U, USB_REQ_GET_STATUS, 0U, MIDI_INST_IN_EP(2U), 2U, NULL), 0U);
+  CHECK_EQ(USBSIM.ep0_len, 2U);
+  CHECK_EQ(USBSIM_Control(pdev, 0x82U, USB_REQ_GET_STATUS, 0U, CDC_CMD_EP, 2U, NULL), 0U);
+}
+
+/* The packets of each function reach its own cable, both ways */
+static void test_routing(void)
+{
+  USBD_HandleTypeDef *pdev = &hUsbDeviceFS;
+  uint8_t pkt[4] = { 0x09U, 0x90U, 0x3CU, 0x64U };
+  uint8_t in[64];
+  uint32_t n, m;
+
+  for (n = 0U; n < USBD_MIDI_NUM_INSTANCES; n++)
+  {
+    rx_count = 0U;
+    CHECK_EQ(USBSIM_Out(pdev, MIDI_INST_OUT_EP(n), pkt, 4U), 1U);
+    CHECK_EQ(rx_count, 1U);
+    CHECK_EQ(rx_event >> 28, n);
+    CHECK_EQ(rx_event & 0x0FFFFFFFU, 0x09903C64U);
+
+    USBMIDI_send(0x09903C64U | (n << 28));
+    for (m = 0U; m < USBD_MIDI_NUM_INSTANCES; m++)
+    {
+      if (m != n)
+      {
+        CHECK_EQ(USBSIM_In(pdev, MIDI_INST_IN_EP(m), in), USBSIM_NAK);
+      }
+    }
+    CHECK_EQ(USBSIM_In(pdev, MIDI_INST_IN_EP(n), in), 4);
+    CHECK(memcmp(in, pkt, 4U) == 0);
+  }
+}
+
+/* Nothing is left to route to once the classes are gone */
+static void test_unregister(void)
+{
+  USBD_HandleTypeDef *pdev = &hUsbDeviceFS;
+  uint32_t i, found = 0U;
+
+  (void)USBD_UnRegisterClassComposite(pdev);
+  CHECK_EQ(compare_all(pdev), 0U);
+  for (i = 0U; i < 256U; i++)
+  {
+    found += (USBD_CoreFindEP(pdev, (uint8_t)i) != 0xFFU) ? 1U : 0U;
+    found += (USBD_CoreFindIF(pdev, (uint8_t)i) != 0xFFU) ? 1U : 0U;
+  }
+  CHECK_EQ(found, 0U);
+}
+
+static double bench_one(uint8_t (*find)(USBD_HandleTypeDef *, uint8_t), uint8_t ep)
+{
+  uint32_t i;
+  uint8_t acc = 0U;
+  double t0 = test_seconds();
+
+  for (i = 0U; i < BENCH_LOOPS; i++)
+  {
+    acc ^= find(&hUsbDeviceFS, (uint8_t)(ep ^ (acc & 0x10U)));
+  }
+  sink = acc;
+  return (test_seconds() - t0) * 1e9 / BENCH_LOOPS;
+}
+
+static void bench(void)
+{
+  static const uint8_t ep[2] = { 0x81U, MIDI_INST_IN_EP(USBD_MIDI_NUM_INSTANCES - 1U) };
+  uint32_t k;
+
+  for (k = 0U; k < 2U; k++)
+  {
+    printf("bench: class %u endpoint %02X: search %.2f ns, table %.2f ns per lookup\n",
+           USBD_CoreFindEP(&hUsbDeviceFS, ep[k]), ep[k],
+           bench_one(ref_find_ep, ep[k]), bench_one(USBD_CoreFindEP, ep[k]));
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int USB_MIDI_isr_decoder(uint32_t event)
+{
+  rx_event = event;
+  rx_count++;
+  return 1;
+}
+
+int main(void)
+{
+  MX_USB_DEVICE_Init();
+  test_tables();
+  test_requests();
+  test_routing();
+  bench();
+  test_unregister();
+  return TEST_RESULT();
+}
@@ -0,0 +1,268 @@
+/**
+  ******************************************************************************
+  * @file           : test_usb_pipes.c
+  * @brief          : A timed stream next to a SysEx dump on the simulated
+  *                   bus: its latency queued behind the dump, through the
+  *                   priority slot and, built with USBD_MIDI_NUM_CABLES_2, on
+  *                   the second endpoint pair; the dump throughput, and the
+  *                   OUT pairs going on when the application holds one up.
+  *
+  *                   The bus gives each 1 ms frame BUS_SLOTS bulk packets,
+  *                   shared round robin by the IN endpoints with data, and
+  *                   the device main loop runs between two of them.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "usb_sim.h"
+#include "usb_device.h"
+#include "usbd_midi.h"
+#include "usbd_midi_if.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BUS_SLOTS                 19U     /* 64-byte bulk packets per frame */
+#define RUN_FRAMES                2000U
+#define DRAIN_FRAMES              100U
+/* The timed stream is on the first cable of the second pair, if any */
+#define TIMED_CABLE               ((USBD_MIDI_NUM_CABLES_2 > 0) ? USBD_MIDI_NUM_CABLES : 0U)
+#define SEQ_MASK                  0x3FFFU
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t sent;         /* timed events */
+  uint32_t received;
+  uint32_t bad;          /* out of order, or not on bus cable 0 */
+  uint32_t lat_max;      /* in bus slots */
+  double   lat_sum;
+  uint32_t dump_events;
+  uint32_t dump_run;     /* of dump_events, while the timed stream ran */
+} StreamTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+extern USBD_HandleTypeDef hUsbDeviceFS;
+static const uint8_t in_ep[USBD_MIDI_NUM_PIPES] =
+{
+  MIDI_IN_EP,
+#if (USBD_MIDI_NUM_PIPES > 1U)
+  MIDI_INST_IN_EP2(0U),
+#endif /* USBD_MIDI_NUM_PIPES */
+};
+static uint32_t sent_slot[SEQ_MASK + 1U];
+static uint32_t now;
+static uint32_t rr;
+static uint32_t dec_cable[16];
+static uint8_t block_cable0;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void host_in(StreamTypeDef *ps, const uint8_t *buf, uint32_t len)
+{
+  uint32_t i, ev, seq, d;
+
+  for (i = 0U; (i + 4U) <= len; i += 4U)
+  {
+    ev = MIDI_EVENT_FROM_BYTES(&buf[i]);
+    /* every pair numbers its cables from 0 on the bus */
+    ps->bad += (MIDI_EVENT_CABLE(ev) != 0U) ? 1U : 0U;
+    if (MIDI_EVENT_CIN(ev) != MIDI_CIN_CONTROL_CHANGE)
+    {
+      ps->dump_events++;
+      continue;
+    }
+    seq = MIDI_EVENT_DATA1(ev) | (MIDI_EVENT_DATA2(ev) << 7);
+    ps->bad += (seq != (ps->received & SEQ_MASK)) ? 1U : 0U;
+    d = now - sent_slot[seq];
+    ps->lat_max = (d > ps->lat_max) ? d : ps->lat_max;
+    ps->lat_sum += d;
+    ps->received++;
+  }
+}
+
+/* One bulk packet slot: the next IN endpoint with data gets it */
+static void bus_slot(StreamTypeDef *ps)
+{
+  uint8_t pkt[64];
+  uint32_t t, n;
+  int32_t len;
+
+  for (t = 0U; t < USBD_MIDI_NUM_PIPES; t++)
+  {
+    n = (rr + t) % USBD_MIDI_NUM_PIPES;
+    len = USBSIM_In(&hUsbDeviceFS, in_ep[n], pkt);
+    if (len != USBSIM_NAK)
+    {
+      rr = n + 1U;
+      host_in(ps, pkt, (uint32_t)len);
+      break;
+    }
+  }
+  now++;
+}
+
+/* Cable 0 saturated by a dump, one timed event per frame on TIMED_CABLE */
+static void run_stream(uint8_t priority, StreamTypeDef *ps)
+{
+  uint32_t f, s, ev, seq = 0U;
+
+  memset(ps, 0, sizeof(*ps));
+  for (f = 0U; f < RUN_FRAMES; f++)
+  {
+    USBSIM.tick++;
+    for (s = 0U; s < BUS_SLOTS; s++)
+    {
+      while (USBMIDI_tx_free() > 1U)
+      {
+        USBMIDI_send(MIDI_EVENT(0U, MIDI_CIN_SYSEX_START, 0x01U, 0x02U, 0x03U));
+      }
+      if (s == 0U)
+      {
+        ev = MIDI_EVENT(TIMED_CABLE, MIDI_CIN_CONTROL_CHANGE, 0xB0U, seq & 0x7FU, (seq >> 7) & 0x7FU);
+        sent_slot[seq & SEQ_MASK] = now;
+        if (priority)
+        {
+          USBMIDI_send_priority(ev);
+        }
+        else
+        {
+          USBMIDI_send(ev);
+        }
+        seq++;
+      }
+      USBMIDI_polling();
+      bus_slot(ps);
+    }
+  }
+  ps->sent = seq;
+  ps->dump_run = ps->dump_events;
+
+  /* the rest of the dump, so the next run starts empty */
+  for (f = 0U; f < (DRAIN_FRAMES * BUS_SLOTS); f++)
+  {
+    USBMIDI_polling();
+    bus_slot(ps);
+  }
+}
+
+static void test_descriptor(void)
+{
+  const uint8_t *c = USBSIM.ep0;
+  uint32_t k, tot, ms_eps = 0U, jack_groups = 0U;
+
+  CHECK_EQ(USBSIM_Control(&hUsbDeviceFS, 0x80U, USB_REQ_GET_DESCRIPTOR,
+                          (uint16_t)(USB_DESC_TYPE_CONFIGURATION << 8), 0U, 0xFFU, NULL), 0U);
+  tot = c[2] | ((uint32_t)c[3] << 8);
+  CHECK_EQ(USBSIM.ep0_len, tot);
+  for (k = 0U; (k < tot) && (c[k] != 0U); k += c[k])
+  {
+    /* the MIDI streaming interface and its class endpoint descriptors */
+    if ((c[k + 1U] == USB_DESC_TYPE_INTERFACE) && (c[k + 5U] == 0x01U) && (c[k + 6U] == 0x03U))
+    {
+      ms_eps = c[k + 4U];
+    }
+    jack_groups += (c[k + 1U] == 0x25U) ? 1U : 0U;
+  }
+  CHECK_EQ(k, tot);
+  CHECK_EQ(ms_eps, 2U * USBD_MIDI_NUM_PIPES);
+  CHECK_EQ(jack_groups, 2U * USBD_MIDI_NUM_PIPES);
+}
+
+/* OUT: with the application holding up cable 0, the other pair delivers */
+static void test_out(void)
+{
+  uint8_t pkt[64];
+  uint32_t i, k, accepted = 0U;
+
+  for (k = 0U; k < 16U; k++)
+  {
+    pkt[4U * k] = MIDI_CIN_CONTROL_CHANGE;
+    pkt[4U * k + 1U] = 0xB0U;
+    pkt[4U * k + 2U] = 7U;
+    pkt[4U * k + 3U] = (uint8_t)k;
+  }
+  block_cable0 = 1U;
+  for (i = 0U; i < 64U; i++)
+  {
+    accepted += USBSIM_Out(&hUsbDeviceFS, MIDI_OUT_EP, pkt, 64U);
+    USBMIDI_polling();
+#if (USBD_MIDI_NUM_PIPES > 1U)
+    CHECK_EQ(USBSIM_Out(&hUsbDeviceFS, MIDI_INST_OUT_EP2(0U), pkt, 16U), 1U);
+    USBMIDI_polling();
+#endif /* USBD_MIDI_NUM_PIPES */
+  }
+  printf("out, cable 0 held: %u of 64 packets taken on the first pair, %u events on the second\n",
+         accepted, (USBD_MIDI_NUM_PIPES > 1U) ? dec_cable[USBD_MIDI_NUM_CABLES] : 0U);
+  /* the ring of the first pair fills, then its endpoint NAKs */
+  CHECK(accepted < 64U);
+  CHECK_EQ(dec_cable[0], 0U);
+  CHECK_EQ(dec_cable[USBD_MIDI_NUM_CABLES], (USBD_MIDI_NUM_PIPES > 1U) ? 64U * 4U : 0U);
+
+  /* and gets going again once the application takes cable 0 */
+  block_cable0 = 0U;
+  for (i = 0U; i < 16U; i++)
+  {
+    USBMIDI_polling();
+  }
+  CHECK_EQ(dec_cable[0], accepted * 16U);
+  CHECK_EQ(USBSIM_Out(&hUsbDeviceFS, MIDI_OUT_EP, pkt, 64U), 1U);
+}
+
+static void test_latency(void)
+{
+  static const char *const name[2] = { "queued", "priority" };
+  StreamTypeDef st[2];
+  uint32_t k;
+
+  for (k = 0U; k < 2U; k++)
+  {
+    run_stream((uint8_t)k, &st[k]);
+    printf("%u pair(s), timed stream on cable %u, %s: latency avg %.2f max %u slots, "
+           "dump %u B/s\n", USBD_MIDI_NUM_PIPES, TIMED_CABLE, name[k],
+           st[k].lat_sum / st[k].received, st[k].lat_max,
+           st[k].dump_run * 3U * 1000U / RUN_FRAMES);
+    CHECK_EQ(st[k].received, st[k].sent);
+    CHECK_EQ(st[k].bad, 0U);
+  }
+  /* the priority slot goes ahead of the ring within the frame */
+  CHECK(st[1].lat_max < BUS_SLOTS);
+#if (USBD_MIDI_NUM_PIPES > 1U)
+  /* a pair of its own waits for one packet of the dump at most */
+  CHECK(st[0].lat_max <= 1U);
+  /* and the dump keeps the same pace either way */
+  CHECK(st[0].dump_run <= st[1].dump_run + (st[1].dump_run / 100U));
+  CHECK(st[1].dump_run <= st[0].dump_run + (st[0].dump_run / 100U));
+#else
+  /* behind the dump it waits for what was queued before it */
+  CHECK(st[0].lat_sum / st[0].received > st[1].lat_sum / st[1].received);
+#endif /* USBD_MIDI_NUM_PIPES */
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/* The application side of the OUT direction; cable 0 can be held up */
+int USB_MIDI_decoder(uint8_t *Buf, uint32_t Len)
+{
+  uint32_t i;
+
+  if (block_cable0 && ((Buf[0] >> 4) == 0U))
+  {
+    return 0;
+  }
+  for (i = 0U; (i + 4U) <= Len; i += 4U)
+  {
+    dec_cable[Buf[i] >> 4]++;
+  }
+  return 1;
+}
+
+int main(void)
+{
+  MX_USB_DEVICE_Init();
+  CHECK_EQ(USBSIM_Enumerate(&hUsbDeviceFS, USBD_SPEED_FULL), 0U);
+  test_descriptor();
+  test_out();
+  test_latency();
+  return TEST_RESULT();
+}
@@ -0,0 +1,342 @@
+/**
+  ******************************************************************************
+  * @file           : test_usb_raw.c
+  * @brief          : Raw MIDI over the CDC port against USB-MIDI, on the
+  *                   simulated bus: bytes on the bus and frames taken by a
+  *                   SysEx dump and by a controller stream, the event
+  *                   sequences arriving exactly, the host to device stream
+  *                   parsed with clocks anywhere, and the switch between
+  *                   records and MIDI.
+  *
+  *                   The bus gives each 1 ms frame BUS_SLOTS bulk packets,
+  *                   and the device main loop runs between two of them.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "usb_sim.h"
+#include "usb_device.h"
+#include "usbd_midi.h"
+#include "usbd_midi_if.h"
+#include "usbd_cdc.h"
+#include "usbd_cdc_if.h"
+#include "midi_stream.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BUS_SLOTS                 19U     /* 64-byte bulk packets per frame */
+#define MAX_FRAMES                100000U
+#define MAX_EVENTS                200000U
+#define CDC_IF                    2U
+#define DUMP_MESSAGES             256U
+#define DUMP_SIZE                 256U
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t bytes;        /* payload on the bus */
+  uint32_t packets;      /* zero length ones included */
+  uint32_t frames;       /* until the host has it all */
+} RunTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+extern USBD_HandleTypeDef hUsbDeviceFS;
+static uint32_t src[MAX_EVENTS];
+static uint32_t src_n;
+static uint32_t host_ev[MAX_EVENTS];
+static uint32_t host_n;
+static uint32_t dev_ev[MAX_EVENTS];
+static uint32_t dev_n;
+static MIDI_StreamParserTypeDef host_parser;
+static uint8_t stream[1U << 20];
+static uint32_t rng = 1U;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t rnd(void)
+{
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static void host_put(uint32_t event)
+{
+  if (host_n < MAX_EVENTS)
+  {
+    host_ev[host_n] = event;
+  }
+  host_n++;
+}
+
+static uint8_t line_coding(uint32_t baud)
+{
+  uint8_t d[7] = { (uint8_t)baud, (uint8_t)(baud >> 8), (uint8_t)(baud >> 16),
+                   (uint8_t)(baud >> 24), 0U, 0U, 8U };
+
+  return USBSIM_Control(&hUsbDeviceFS, 0x21U, CDC_SET_LINE_CODING, 0U, CDC_IF, 7U, d);
+}
+
+/* A SysEx message as USB-MIDI events, 3 bytes each */
+static void add_sysex(const uint8_t *msg, uint32_t len)
+{
+  uint32_t i = 0U, k;
+  uint8_t b[3];
+
+  while (i < len)
+  {
+    k = ((len - i) > 3U) ? 3U : (len - i);
+    memset(b, 0, sizeof(b));
+    memcpy(b, &msg[i], k);
+    i += k;
+    src[src_n++] = MIDI_EVENT(0U, (i == len) ? (MIDI_CIN_SYSEX_START + k) : MIDI_CIN_SYSEX_START,
+                              b[0], b[1], b[2]);
+  }
+}
+
+/* The device sends src[] on one transport while the host reads the IN
+   endpoint; returns 1 when the host got the same events */
+static uint8_t run(uint8_t cdc, RunTypeDef *pr)
+{
+  uint8_t ep = cdc ? CDC_IN_EP : MIDI_IN_EP;
+  uint8_t pkt[64];
+  uint32_t i = 0U, s, room, k;
+  int32_t n;
+
+  memset(pr, 0, sizeof(*pr));
+  host_n = 0U;
+  MIDI_Stream_ParseInit(&host_parser, 0U, host_put);
+  while ((pr->frames < MAX_FRAMES) && ((i < src_n) || (host_n < src_n)))
+  {
+    pr->frames++;
+    USBSIM.tick++;
+    for (s = 0U; s < BUS_SLOTS; s++)
+    {
+      /* main loop: queue what fits, then the polls */
+      room = cdc ? USBCDC_midi_tx_free() : USBMIDI_tx_free();
+      for (; (room > 0U) && (i < src_n); room--, i++)
+      {
+        if (!cdc)
+        {
+          USBMIDI_send(src[i]);
+        }
+        else if (USBCDC_midi_send(src[i]) == 0U)
+        {
+          break;
+        }
+      }
+      USBMIDI_polling();
+      USBCDC_polling();
+
+      n = USBSIM_In(&hUsbDeviceFS, ep, pkt);
+      if (n == USBSIM_NAK)
+      {
+        continue;
+      }
+      pr->bytes += (uint32_t)n;
+      pr->packets++;
+      if (cdc)
+      {
+        MIDI_Stream_Parse(&host_parser, pkt, (uint32_t)n);
+      }
+      else
+      {
+        for (k = 0U; (k + 4U) <= (uint32_t)n; k += 4U)
+        {
+          host_put(MIDI_EVENT_FROM_BYTES(&pkt[k]));
+        }
+      }
+    }
+  }
+  if (host_n != src_n)
+  {
+    return 0U;
+  }
+  return (memcmp(host_ev, src, src_n * sizeof(src[0])) == 0) ? 1U : 0U;
+}
+
+static void test_open(void)
+{
+  CHECK_EQ(USBSIM_Enumerate(&hUsbDeviceFS, USBD_SPEED_FULL), 0U);
+  CHECK_EQ(USBSIM_Control(&hUsbDeviceFS, 0x21U, CDC_SET_CONTROL_LINE_STATE, 1U, CDC_IF, 0U, NULL), 0U);
+  CHECK(USBCDC_is_open());
+  CHECK(!USBCDC_midi_is_open());
+  CHECK_EQ(line_coding(USBCDC_MIDI_BAUDRATE), 0U);
+  CHECK(!USBCDC_is_open());
+  CHECK(USBCDC_midi_is_open());
+}
+
+/* 64 KB of SysEx: three payload bytes in four on USB-MIDI, all of them raw */
+static void test_dump(void)
+{
+  uint8_t msg[DUMP_SIZE];
+  uint32_t m, k;
+  RunTypeDef a, b;
+
+  src_n = 0U;
+  for (m = 0U; m < DUMP_MESSAGES; m++)
+  {
+    msg[0] = 0xF0U;
+    for (k = 1U; k < (DUMP_SIZE - 1U); k++)
+    {
+      msg[k] = (uint8_t)(rnd() & 0x7FU);
+    }
+    msg[DUMP_SIZE - 1U] = 0xF7U;
+    add_sysex(msg, DUMP_SIZE);
+  }
+  CHECK_EQ(run(0U, &a), 1U);
+  CHECK_EQ(run(1U, &b), 1U);
+  printf("sysex dump, %u B: usb-midi %u B in %u packets, %u ms; raw %u B in %u packets, %u ms\n",
+         DUMP_MESSAGES * DUMP_SIZE, a.bytes, a.packets, a.frames, b.bytes, b.packets, b.frames);
+  CHECK_EQ(a.bytes, DUMP_MESSAGES * ((DUMP_SIZE + 2U) / 3U) * 4U);
+  CHECK_EQ(b.bytes, DUMP_MESSAGES * DUMP_SIZE);
+  CHECK(b.frames < a.frames);
+  CHECK_EQ(host_parser.stats.errors, 0U);
+}
+
+/* A controller sweep with notes on another channel: running status
+   drops most status bytes */
+static void test_running_status(void)
+{
+  RunTypeDef a, b;
+  uint32_t k, elided;
+
+  src_n = 0U;
+  for (k = 0U; k < 20000U; k++)
+  {
+    src[src_n++] = MIDI_EVENT_CHANNEL(0U, 0xB0U, 1U, k & 0x7FU);
+    if ((k & 15U) == 0U)
+    {
+      src[src_n++] = MIDI_EVENT_CHANNEL(0U, 0x91U, 60U, 100U);
+      src[src_n++] = MIDI_EVENT_CHANNEL(0U, 0x81U, 60U, 0U);
+    }
+  }
+  elided = USBCDC_MidiEnc.elided;
+  CHECK_EQ(run(0U, &a), 1U);
+  CHECK_EQ(run(1U, &b), 1U);
+  elided = USBCDC_MidiEnc.elided - elided;
+  printf("controllers and notes, %u events: usb-midi %u B, %u ms; raw %u B, %u ms, %u status bytes elided\n",
+         src_n, a.bytes, a.frames, b.bytes, b.frames, elided);
+  CHECK_EQ(a.bytes, src_n * 4U);
+  CHECK_EQ(b.bytes + elided, src_n * 3U);
+  /* a status byte for the first event and three per note pair only */
+  CHECK_EQ(elided, src_n - 1U - 3U * (20000U / 16U));
+
+  /* program changes, clocks, system common and short SysEx, interleaved */
+  src_n = 0U;
+  for (k = 0U; k < 3000U; k++)
+  {
+    static const uint8_t sx[5] = { 0xF0U, 0x7EU, 0x7FU, 0x01U, 0xF7U };
+    uint8_t t[5];
+    uint32_t len = 3U + (k % 3U);
+
+    src[src_n++] = MIDI_EVENT_CHANNEL(0U, 0xC3U, k & 0x7FU, 0U);
+    src[src_n++] = MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, 0xF8U, 0U, 0U);
+    src[src_n++] = MIDI_EVENT(0U, MIDI_CIN_SYSCOM_3, 0xF2U, k & 0x7FU, 1U);
+    src[src_n++] = MIDI_EVENT_CHANNEL(0U, 0xC3U, 5U, 0U);
+    memcpy(t, sx, len - 1U);
+    t[len - 1U] = 0xF7U;
+    add_sysex(t, len);
+    src[src_n++] = MIDI_EVENT(0U, MIDI_CIN_SYSEX_END_1, 0xF6U, 0U, 0U);
+    src[src_n++] = MIDI_EVENT(0U, MIDI_CIN_SYSCOM_2, 0xF1U, k & 0x7FU, 0U);
+  }
+  CHECK_EQ(run(0U, &a), 1U);
+  CHECK_EQ(run(1U, &b), 1U);
+  CHECK_EQ(host_parser.stats.errors, 0U);
+}
+
+/* Host to device, with clocks dropped in at any byte; each OUT packet is
+   parsed by the main loop before the next is taken */
+static void test_receive(void)
+{
+  uint8_t msg[100];
+  MIDI_StreamEncTypeDef enc;
+  uint32_t m, k, len = 0U, clocks = 0U, o, n, j = 0U, bad = 0U, got_clocks = 0U, naks = 0U;
+
+  src_n = 0U;
+  for (m = 0U; m < 64U; m++)
+  {
+    msg[0] = 0xF0U;
+    for (k = 1U; k < 99U; k++)
+    {
+      msg[k] = (uint8_t)((m + k) & 0x7FU);
+    }
+    msg[99] = 0xF7U;
+    add_sysex(msg, 100U);
+    for (k = 0U; k < 50U; k++)
+    {
+      src[src_n++] = MIDI_EVENT_CHANNEL(0U, 0x90U | (k & 1U), k & 0x7FU, (k * 3U) & 0x7FU);
+    }
+  }
+  MIDI_Stream_EncInit(&enc);
+  for (k = 0U; k < src_n; k++)
+  {
+    len += MIDI_Stream_Encode(&enc, src[k], &stream[len]);
+    if ((rnd() % 7U) == 0U)
+    {
+      stream[len++] = 0xF8U;
+      clocks++;
+    }
+  }
+
+  dev_n = 0U;
+  for (o = 0U; o < len; o += n)
+  {
+    n = ((len - o) > 64U) ? 64U : (len - o);
+    CHECK_EQ(USBSIM_Out(&hUsbDeviceFS, CDC_OUT_EP, &stream[o], n), 1U);
+    /* NAKed until the main loop has parsed it */
+    naks += (USBSIM_Out(&hUsbDeviceFS, CDC_OUT_EP, &stream[o], n) == 0U) ? 1U : 0U;
+    USBCDC_polling();
+  }
+  CHECK_EQ(naks, (len + 63U) / 64U);
+
+  for (k = 0U; k < dev_n; k++)
+  {
+    if (dev_ev[k] == MIDI_EVENT(0U, MIDI_CIN_SINGLE_BYTE, 0xF8U, 0U, 0U))
+    {
+      got_clocks++;
+      continue;
+    }
+    bad += ((j >= src_n) || (dev_ev[k] != src[j])) ? 1U : 0U;
+    j++;
+  }
+  CHECK_EQ(j, src_n);
+  CHECK_EQ(bad, 0U);
+  CHECK_EQ(got_clocks, clocks);
+  CHECK_EQ(USBCDC_MidiParser.stats.errors, 0U);
+}
+
+/* Records and MIDI never share the port */
+static void test_switch(void)
+{
+  static const uint8_t rec[8] = { 0 };
+
+  CHECK_EQ(USBCDC_write(USBCDC_STREAM_USER, rec, sizeof(rec)), 0U);
+  CHECK_EQ(line_coding(115200U), 0U);
+  CHECK_EQ(USBCDC_midi_send(MIDI_EVENT_CHANNEL(0U, 0x90U, 1U, 1U)), 0U);
+  CHECK_EQ(USBCDC_write(USBCDC_STREAM_USER, rec, sizeof(rec)), sizeof(rec));
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+void USB_CDC_midi_receive(uint32_t event)
+{
+  if (dev_n < MAX_EVENTS)
+  {
+    dev_ev[dev_n] = event;
+  }
+  dev_n++;
+}
+
+int main(void)
+{
+  MX_USB_DEVICE_Init();
+  test_open();
+  test_dump();
+  test_running_status();
+  test_receive();
+  test_switch();
+  return TEST_RESULT();
+}
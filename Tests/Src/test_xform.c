@@ -0,0 +1,189 @@
+/**
+  ******************************************************************************
+  * @file           : test_xform.c
+  * @brief          : Transform tables: the compile-time curves against libm,
+  *                   the run-time table builders, and MIDI_Xform_Apply()
+  *                   against a direct model over every channel voice event.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "midi_xform.h"
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t vel[128];
+static uint8_t notes[128];
+static uint8_t chans[16];
+
+/* Private functions ---------------------------------------------------------*/
+
+static double exp_curve(double x, double a)
+{
+  return 127.0 * (exp(a * x / 127.0) - 1.0) / (exp(a) - 1.0);
+}
+
+static void test_curves(void)
+{
+  uint32_t i, off = 0U;
+  uint8_t t[128];
+
+  for (i = 0U; i < 128U; i++)
+  {
+    off += (fabs(exp_curve(i, MIDI_XFORM_EXP_SOFT) - MIDI_XformVelSoft[i]) > 0.51) ? 1U : 0U;
+    off += (fabs(exp_curve(i, MIDI_XFORM_EXP_HARD) - MIDI_XformVelHard[i]) > 0.51) ? 1U : 0U;
+    CHECK_EQ(MIDI_XformIdentity[i], i);
+    if (i > 0U)
+    {
+      CHECK(MIDI_XformVelSoft[i] >= MIDI_XformVelSoft[i - 1U]);
+      CHECK(MIDI_XformVelHard[i] >= MIDI_XformVelHard[i - 1U]);
+    }
+  }
+  CHECK_EQ(off, 0U);
+  CHECK_EQ(MIDI_XformVelSoft[127], 127U);
+  CHECK_EQ(MIDI_XformVelHard[127], 127U);
+  CHECK(MIDI_XformVelSoft[64] < 64U);
+  CHECK(MIDI_XformVelHard[64] > 64U);
+
+  /* the run-time builder gives the same curves in float */
+  MIDI_Xform_BuildExp(t, (float)MIDI_XFORM_EXP_SOFT);
+  for (i = 0U; i < 128U; i++)
+  {
+    CHECK(abs((int)t[i] - (int)MIDI_XformVelSoft[i]) <= 1);
+  }
+  MIDI_Xform_BuildExp(t, (float)MIDI_XFORM_EXP_HARD);
+  for (i = 0U; i < 128U; i++)
+  {
+    CHECK(abs((int)t[i] - (int)MIDI_XformVelHard[i]) <= 1);
+  }
+  MIDI_Xform_BuildExp(t, 0.0f);
+  for (i = 0U; i < 128U; i++)
+  {
+    CHECK_EQ(t[i], i);
+  }
+}
+
+static void test_builders(void)
+{
+  static const uint8_t pts[] = { 10, 20, 64, 40, 100, 127 };
+  uint8_t t[128];
+  uint32_t i;
+
+  /* through every point, flat before the first and after the last */
+  MIDI_Xform_BuildBreakpoints(t, pts, 3U);
+  CHECK_EQ(t[0], 20U);
+  CHECK_EQ(t[10], 20U);
+  CHECK_EQ(t[64], 40U);
+  CHECK_EQ(t[100], 127U);
+  CHECK_EQ(t[127], 127U);
+  CHECK_EQ(t[37], 30U);
+  for (i = 1U; i < 128U; i++)
+  {
+    CHECK(t[i] >= t[i - 1U]);
+  }
+
+  /* key range 36..96 moved up an octave, what leaves 0..127 is dropped */
+  MIDI_Xform_BuildNoteMap(t, 12, 36U, 120U);
+  CHECK_EQ(t[35], MIDI_XFORM_NOTE_DROP);
+  CHECK_EQ(t[36], 48U);
+  CHECK_EQ(t[115], 127U);
+  CHECK_EQ(t[116], MIDI_XFORM_NOTE_DROP);
+  CHECK_EQ(t[121], MIDI_XFORM_NOTE_DROP);
+  MIDI_Xform_BuildNoteMap(t, -24, 0U, 127U);
+  CHECK_EQ(t[23], MIDI_XFORM_NOTE_DROP);
+  CHECK_EQ(t[24], 0U);
+}
+
+/* What MIDI_Xform_Apply() is to do, written out */
+static uint32_t model(const MIDI_XformTypeDef *px, uint32_t event)
+{
+  uint32_t cin = MIDI_EVENT_CIN(event);
+  uint32_t d1 = MIDI_EVENT_DATA1(event) & 0x7FU, d2 = MIDI_EVENT_DATA2(event) & 0x7FU;
+
+  if ((cin < MIDI_CIN_NOTE_OFF) || (cin > MIDI_CIN_PITCH_BEND))
+  {
+    return event;
+  }
+  if (cin <= MIDI_CIN_POLY_PRESSURE)
+  {
+    if (px->note[d1] == MIDI_XFORM_NOTE_DROP)
+    {
+      return MIDI_XFORM_DROP;
+    }
+    d1 = px->note[d1];
+    if ((cin == MIDI_CIN_NOTE_ON) && (d2 != 0U))
+    {
+      d2 = (px->velocity[d2] != 0U) ? px->velocity[d2] : 1U;
+    }
+  }
+  return MIDI_EVENT(MIDI_EVENT_CABLE(event), cin,
+                    (MIDI_EVENT_STATUS(event) & 0xF0U) | px->channel[MIDI_EVENT_CHANNEL_NUM(event)],
+                    d1, d2);
+}
+
+static void test_apply(void)
+{
+  MIDI_XformTypeDef x = { vel, notes, chans };
+  uint32_t i, ev, cin, mismatch = 0U;
+
+  /* a velocity curve with zeros, a note map with drops, channels reversed */
+  MIDI_Xform_BuildExp(vel, 4.0f);
+  MIDI_Xform_BuildNoteMap(notes, -5, 20U, 110U);
+  for (i = 0U; i < 16U; i++)
+  {
+    chans[i] = (uint8_t)(15U - i);
+  }
+  CHECK_EQ(vel[1], 0U);
+
+  /* every CIN, status and data byte, high bits included */
+  for (cin = 0U; cin < 16U; cin++)
+  {
+    for (i = 0U; i < 0x10000U * 16U; i += 7U)
+    {
+      ev = ((cin | ((i >> 16) << 4)) << 24) | (((cin << 4) | (i & 0x0FU)) << 16) | ((i * 40503U) & 0xFFFFU);
+      mismatch += (MIDI_Xform_Apply(&x, ev) != model(&x, ev)) ? 1U : 0U;
+    }
+  }
+  CHECK_EQ(mismatch, 0U);
+
+  /* the cases the model is there for */
+  CHECK_EQ(MIDI_Xform_Apply(&x, MIDI_EVENT_CHANNEL(1U, 0x90U, 60U, 1U)),
+           MIDI_EVENT_CHANNEL(1U, 0x9FU, 55U, 1U));
+  CHECK_EQ(MIDI_Xform_Apply(&x, MIDI_EVENT_CHANNEL(1U, 0x90U, 60U, 0U)),
+           MIDI_EVENT_CHANNEL(1U, 0x9FU, 55U, 0U));
+  CHECK_EQ(MIDI_Xform_Apply(&x, MIDI_EVENT_CHANNEL(1U, 0x80U, 10U, 0U)), MIDI_XFORM_DROP);
+  CHECK_EQ(MIDI_Xform_Apply(&x, MIDI_EVENT_CHANNEL(1U, 0x90U, 0xBCU, 0x81U)),
+           MIDI_EVENT_CHANNEL(1U, 0x9FU, 55U, 1U));
+  CHECK_EQ(MIDI_Xform_Apply(&x, MIDI_EVENT_CHANNEL(1U, 0xB3U, 7U, 100U)),
+           MIDI_EVENT_CHANNEL(1U, 0xBCU, 7U, 100U));
+  CHECK_EQ(MIDI_Xform_Apply(&x, MIDI_EVENT(1U, MIDI_CIN_SYSEX_START, 0xF0U, 0x99U, 0x88U)),
+           MIDI_EVENT(1U, MIDI_CIN_SYSEX_START, 0xF0U, 0x99U, 0x88U));
+}
+
+static void bench(void)
+{
+  MIDI_XformTypeDef x = { MIDI_XformVelSoft, notes, MIDI_XformChanIdentity };
+  uint32_t i, acc = 0U;
+  double t0;
+
+  MIDI_Xform_BuildNoteMap(notes, 3, 0U, 127U);
+  t0 = test_seconds();
+  for (i = 0U; i < 10000000U; i++)
+  {
+    acc += MIDI_Xform_Apply(&x, 0x09900000U | ((i * 2654435761U) & 0x7F7FU));
+  }
+  printf("bench: %.2f ns per note on (%08x)\n", (test_seconds() - t0) * 100.0, acc);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  test_curves();
+  test_builders();
+  test_apply();
+  bench();
+  return TEST_RESULT();
+}
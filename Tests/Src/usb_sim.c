@@ -0,0 +1,381 @@
+/**
+  ******************************************************************************
+  * @file           : usb_sim.c
+  * @brief          : Simulated USB bus for the host tests: the low level
+  *                   driver interface of usbd_conf.c and the HAL bits the
+  *                   device stack calls, and the host side of the bus.
+  *
+  *                   Transfers complete when the test moves them: a
+  *                   control transfer runs all its stages in
+  *                   USBSIM_Control(), an IN endpoint sends one packet per
+  *                   USBSIM_In() and an OUT endpoint takes one per
+  *                   USBSIM_Out(), so the test decides what the bus does in
+  *                   each frame.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "usb_sim.h"
+#include "usbd_midi.h"
+#include "usbd_cdc.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STATIC_BLOCK_SIZE         ((sizeof(USBD_MIDI_HandleTypeDef) > sizeof(USBD_CDC_HandleTypeDef)) ? \
+                                   sizeof(USBD_MIDI_HandleTypeDef) : sizeof(USBD_CDC_HandleTypeDef))
+#define STATIC_BLOCKS             4U
+
+/* Exported variables --------------------------------------------------------*/
+USBSIM_BusTypeDef USBSIM;
+PCD_HandleTypeDef USBSIM_Pcd;
+uint32_t USBSIM_DeviceId[3] = { 0x00350024U, 0x3137510AU, 0x38363333U };
+
+/* Private variables ---------------------------------------------------------*/
+static uint64_t static_mem[STATIC_BLOCKS][(STATIC_BLOCK_SIZE / 8U) + 1U];
+static uint8_t static_used[STATIC_BLOCKS];
+
+/* Private functions ---------------------------------------------------------*/
+
+/* The IN data stage of EP0, a packet at a time as the driver sends it */
+static void ep0_in(USBD_HandleTypeDef *pdev)
+{
+  USBSIM_InEpTypeDef *pe = &USBSIM.in[0];
+  uint32_t n, guard;
+
+  for (guard = 0U; (pe->buf != NULL) || (pe->len != 0U); guard++)
+  {
+    if (guard > USBSIM_EP0_SIZE)
+    {
+      printf("usb_sim: EP0 IN does not end\n");
+      abort();
+    }
+    n = (pe->len < pe->mps) ? pe->len : pe->mps;
+    if ((USBSIM.ep0_len + n) <= USBSIM_EP0_SIZE)
+    {
+      memcpy(&USBSIM.ep0[USBSIM.ep0_len], pe->buf, n);
+      USBSIM.ep0_len += (uint16_t)n;
+    }
+    pe->len = 0U;
+    pe->buf = (n != 0U) ? (pe->buf + n) : NULL;
+    (void)USBD_LL_DataInStage(pdev, 0U, pe->buf);
+    if (n == 0U)
+    {
+      break;
+    }
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Run a control transfer on EP0, with all its stages
+  * @param  pdev: device instance
+  * @param  bmRequest, bRequest, wValue, wIndex, wLength: the SETUP packet
+  * @param  data: OUT data stage of wLength bytes, or NULL
+  * @retval 1 if the device stalled the request, 0 otherwise; the IN data
+  *         stage is in USBSIM.ep0, USBSIM.ep0_len bytes
+  */
+uint8_t USBSIM_Control(USBD_HandleTypeDef *pdev, uint8_t bmRequest, uint8_t bRequest,
+                       uint16_t wValue, uint16_t wIndex, uint16_t wLength, const uint8_t *data)
+{
+  uint8_t setup[8];
+  uint32_t stalls, n, done = 0U;
+
+  setup[0] = bmRequest;
+  setup[1] = bRequest;
+  setup[2] = (uint8_t)wValue;
+  setup[3] = (uint8_t)(wValue >> 8);
+  setup[4] = (uint8_t)wIndex;
+  setup[5] = (uint8_t)(wIndex >> 8);
+  setup[6] = (uint8_t)wLength;
+  setup[7] = (uint8_t)(wLength >> 8);
+
+  USBSIM.ep0_len = 0U;
+  USBSIM.in[0].buf = NULL;
+  USBSIM.in[0].len = 0U;
+  stalls = USBSIM.stalls;
+  (void)USBD_LL_SetupStage(pdev, setup);
+  if (USBSIM.stalls != stalls)
+  {
+    return 1U;
+  }
+
+  if ((bmRequest & 0x80U) != 0U)
+  {
+    /* data in, then the status out */
+    ep0_in(pdev);
+    (void)USBD_LL_DataOutStage(pdev, 0U, NULL);
+    return 0U;
+  }
+
+  /* data out, if any, then the status in */
+  while ((data != NULL) && (done < wLength) && (USBSIM.out[0].buf != NULL))
+  {
+    n = wLength - done;
+    n = (n < USBSIM.out[0].mps) ? n : USBSIM.out[0].mps;
+    memcpy(USBSIM.out[0].buf, &data[done], n);
+    done += n;
+    (void)USBD_LL_DataOutStage(pdev, 0U, USBSIM.out[0].buf + n);
+  }
+  stalls = USBSIM.stalls;
+  ep0_in(pdev);
+  return (USBSIM.stalls != stalls) ? 1U : 0U;
+}
+
+/**
+  * @brief  Bus reset at a speed, SET_ADDRESS and SET_CONFIGURATION 1
+  * @param  pdev: device instance, started
+  * @param  speed: USBD_SPEED_FULL or USBD_SPEED_HIGH
+  * @retval 0 when the device is configured
+  */
+uint8_t USBSIM_Enumerate(USBD_HandleTypeDef *pdev, USBD_SpeedTypeDef speed)
+{
+  (void)USBD_LL_Reset(pdev);
+  (void)USBD_LL_SetSpeed(pdev, speed);
+  (void)USBSIM_Control(pdev, 0x00U, USB_REQ_SET_ADDRESS, 1U, 0U, 0U, NULL);
+  (void)USBSIM_Control(pdev, 0x00U, USB_REQ_SET_CONFIGURATION, 1U, 0U, 0U, NULL);
+  return (pdev->dev_state == USBD_STATE_CONFIGURED) ? 0U : 1U;
+}
+
+/**
+  * @brief  The host polls an IN endpoint: one packet of the queued transfer
+  * @param  pdev: device instance
+  * @param  ep_addr: endpoint address
+  * @param  dst: room for a max packet size packet
+  * @retval bytes of the packet, USBSIM_NAK if nothing is queued
+  */
+int32_t USBSIM_In(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *dst)
+{
+  USBSIM_InEpTypeDef *pe = &USBSIM.in[ep_addr & 0xFU];
+  uint32_t n;
+
+  if (pe->buf == NULL)
+  {
+    return USBSIM_NAK;
+  }
+  n = pe->len - pe->sent;
+  n = (n < pe->mps) ? n : pe->mps;
+  memcpy(dst, &pe->buf[pe->sent], n);
+  pe->sent += n;
+  if (pe->sent >= pe->len)
+  {
+    /* the transfer is done: the class may queue the next one from here */
+    pe->buf = NULL;
+    (void)USBD_LL_DataInStage(pdev, ep_addr & 0x7FU, NULL);
+  }
+  return (int32_t)n;
+}
+
+/**
+  * @brief  The host sends a packet to an OUT endpoint
+  * @param  pdev: device instance
+  * @param  ep_addr: endpoint address
+  * @param  data: packet
+  * @param  len: bytes, up to the max packet size
+  * @retval 1 if the endpoint took it, 0 for a NAK
+  */
+uint8_t USBSIM_Out(USBD_HandleTypeDef *pdev, uint8_t ep_addr, const uint8_t *data, uint32_t len)
+{
+  USBSIM_OutEpTypeDef *pe = &USBSIM.out[ep_addr & 0xFU];
+  uint8_t *buf = pe->buf;
+
+  if (buf == NULL)
+  {
+    return 0U;
+  }
+  pe->rx_len = (len < pe->size) ? len : pe->size;
+  memcpy(buf, data, pe->rx_len);
+  pe->buf = NULL;
+  (void)USBD_LL_DataOutStage(pdev, ep_addr & 0xFU, buf);
+  return 1U;
+}
+
+/* Low level driver ----------------------------------------------------------*/
+
+USBD_StatusTypeDef USBD_LL_Init(USBD_HandleTypeDef *pdev)
+{
+  memset(&USBSIM, 0, sizeof(USBSIM));
+  memset(&USBSIM_Pcd, 0, sizeof(USBSIM_Pcd));
+  USBSIM_Pcd.pData = pdev;
+  pdev->pData = &USBSIM_Pcd;
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_DeInit(USBD_HandleTypeDef *pdev)
+{
+  UNUSED(pdev);
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_Start(USBD_HandleTypeDef *pdev)
+{
+  UNUSED(pdev);
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_Stop(USBD_HandleTypeDef *pdev)
+{
+  UNUSED(pdev);
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_OpenEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr,
+                                  uint8_t ep_type, uint16_t ep_mps)
+{
+  UNUSED(pdev);
+  UNUSED(ep_type);
+  if ((ep_addr & 0x80U) != 0U)
+  {
+    USBSIM.in[ep_addr & 0xFU].mps = ep_mps;
+    USBSIM_Pcd.IN_ep[ep_addr & 0xFU].maxpacket = ep_mps;
+  }
+  else
+  {
+    USBSIM.out[ep_addr & 0xFU].mps = ep_mps;
+    USBSIM_Pcd.OUT_ep[ep_addr & 0xFU].maxpacket = ep_mps;
+  }
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_CloseEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  UNUSED(pdev);
+  if ((ep_addr & 0x80U) != 0U)
+  {
+    USBSIM.in[ep_addr & 0xFU].buf = NULL;
+  }
+  else
+  {
+    USBSIM.out[ep_addr & 0xFU].buf = NULL;
+  }
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_FlushEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  UNUSED(pdev);
+  UNUSED(ep_addr);
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_StallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  UNUSED(pdev);
+  UNUSED(ep_addr);
+  USBSIM.stalls++;
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_ClearStallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  UNUSED(pdev);
+  UNUSED(ep_addr);
+  return USBD_OK;
+}
+
+uint8_t USBD_LL_IsStallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  UNUSED(pdev);
+  UNUSED(ep_addr);
+  return 0U;
+}
+
+USBD_StatusTypeDef USBD_LL_SetUSBAddress(USBD_HandleTypeDef *pdev, uint8_t dev_addr)
+{
+  UNUSED(pdev);
+  UNUSED(dev_addr);
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_SetTestMode(USBD_HandleTypeDef *pdev, uint8_t testmode)
+{
+  UNUSED(pdev);
+  UNUSED(testmode);
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_Transmit(USBD_HandleTypeDef *pdev, uint8_t ep_addr,
+                                    uint8_t *pbuf, uint32_t size)
+{
+  USBSIM_InEpTypeDef *pe = &USBSIM.in[ep_addr & 0xFU];
+
+  UNUSED(pdev);
+  if (((ep_addr & 0xFU) != 0U) && (pe->buf != NULL))
+  {
+    printf("usb_sim: EP%02X transmit while busy\n", ep_addr);
+    abort();
+  }
+  /* a zero length packet still needs a buffer to be pending */
+  pe->buf = (pbuf != NULL) ? pbuf : USBSIM.ep0;
+  pe->len = size;
+  pe->sent = 0U;
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_PrepareReceive(USBD_HandleTypeDef *pdev, uint8_t ep_addr,
+                                          uint8_t *pbuf, uint32_t size)
+{
+  UNUSED(pdev);
+  USBSIM.out[ep_addr & 0xFU].buf = pbuf;
+  USBSIM.out[ep_addr & 0xFU].size = size;
+  return USBD_OK;
+}
+
+uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  UNUSED(pdev);
+  return USBSIM.out[ep_addr & 0xFU].rx_len;
+}
+
+void USBD_LL_Delay(uint32_t Delay)
+{
+  UNUSED(Delay);
+}
+
+void *USBD_static_malloc(uint32_t size)
+{
+  for (uint32_t i = 0U; i < STATIC_BLOCKS; i++)
+  {
+    if ((static_used[i] == 0U) && (size <= sizeof(static_mem[i])))
+    {
+      static_used[i] = 1U;
+      return static_mem[i];
+    }
+  }
+  return NULL;
+}
+
+void USBD_static_free(void *p)
+{
+  for (uint32_t i = 0U; i < STATIC_BLOCKS; i++)
+  {
+    if (p == (void *)static_mem[i])
+    {
+      static_used[i] = 0U;
+    }
+  }
+}
+
+/* HAL -----------------------------------------------------------------------*/
+
+uint32_t HAL_GetTick(void)
+{
+  return USBSIM.tick;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+  USBSIM.tick += Delay;
+}
+
+void HAL_PWREx_EnableUSBVoltageDetector(void)
+{
+}
+
+void Error_Handler(void)
+{
+  printf("usb_sim: Error_Handler\n");
+  abort();
+}
@@ -0,0 +1,15 @@
+/**
+  ******************************************************************************
+  * @file           : stm32h7xx.h
+  * @brief          : Host stand-in for the device header; see
+  *                   stm32h7xx_hal.h next to it.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32H7xx_H
+#define __STM32H7xx_H
+
+#include "stm32h7xx_hal.h"
+
+#endif /* __STM32H7xx_H */
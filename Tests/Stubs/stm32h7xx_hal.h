@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file           : stm32h7xx_hal.h
+  * @brief          : Host stand-in for the HAL, with just what the USB device
+  *                   stack and its glue use, so the host tests can build
+  *                   them. Tests/Src/usb_sim.c provides the functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32H7xx_HAL_H
+#define __STM32H7xx_HAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+
+/* Exported macro ------------------------------------------------------------*/
+#define __IO                      volatile
+#define __weak                    __attribute__((weak))
+#define __STATIC_INLINE           static inline
+#define __PACKED                  __attribute__((packed))
+#define UNUSED(X)                 (void)(X)
+
+/* The 96-bit device ID the serial number string is made from */
+extern uint32_t USBSIM_DeviceId[3];
+#define UID_BASE                  ((uintptr_t)USBSIM_DeviceId)
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+  HAL_OK       = 0x00U,
+  HAL_ERROR    = 0x01U,
+  HAL_BUSY     = 0x02U,
+  HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+/* The endpoint state the classes read back from the driver */
+typedef struct
+{
+  uint32_t maxpacket;
+} PCD_EPTypeDef;
+
+typedef struct
+{
+  PCD_EPTypeDef IN_ep[16];
+  PCD_EPTypeDef OUT_ep[16];
+  void *pData;
+} PCD_HandleTypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+
+/* No interrupts to mask on the host */
+static inline uint32_t __get_PRIMASK(void)
+{
+  return 0U;
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+  (void)primask;
+}
+
+static inline void __disable_irq(void)
+{
+}
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+void HAL_PWREx_EnableUSBVoltageDetector(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32H7xx_HAL_H */
@@ -1,101 +1,174 @@
-/* USER CODE BEGIN Header */
-/**
-  ******************************************************************************
-  * @file           : usb_device.c
-  * @version        : v1.0_Cube
-  * @brief          : This file implements the USB Device
-  ******************************************************************************
-  * @attention
-  *
-  * Copyright (c) 2024 STMicroelectronics.
-  * All rights reserved.
-  *
-  * This software is licensed under terms that can be found in the LICENSE file
-  * in the root directory of this software component.
-  * If no LICENSE file comes with this software, it is provided AS-IS.
-  *
-  ******************************************************************************
-  */
-/* USER CODE END Header */
-
-/* Includes ------------------------------------------------------------------*/
-
-#include "usb_device.h"
-#include "usbd_core.h"
-#include "usbd_desc.h"
-#include "usbd_midi.h"
-#include "usbd_midi_if.h"
-
-/* USER CODE BEGIN Includes */
-
-/* USER CODE END Includes */
-
-/* USER CODE BEGIN PV */
-/* Private variables ---------------------------------------------------------*/
-
-/* USER CODE END PV */
-
-/* USER CODE BEGIN PFP */
-/* Private function prototypes -----------------------------------------------*/
-
-/* USER CODE END PFP */
-
-/* USB Device Core handle declaration. */
-USBD_HandleTypeDef hUsbDeviceFS;
-
-/*
- * -- Insert your variables declaration here --
- */
-/* USER CODE BEGIN 0 */
-
-/* USER CODE END 0 */
-
-/*
- * -- Insert your external function declaration here --
- */
-/* USER CODE BEGIN 1 */
-
-/* USER CODE END 1 */
-
-/**
-  * Init USB device Library, add supported class and start the library
-  * @retval None
-  */
-void MX_USB_DEVICE_Init(void)
-{
-  /* USER CODE BEGIN USB_DEVICE_Init_PreTreatment */
-
-  /* USER CODE END USB_DEVICE_Init_PreTreatment */
-
-  /* Init Device Library, add supported class and start the library. */
-  if (USBD_Init(&hUsbDeviceFS, &FS_Desc, DEVICE_FS) != USBD_OK)
-  {
-    Error_Handler();
-  }
-  if (USBD_RegisterClass(&hUsbDeviceFS, &USBD_MIDI) != USBD_OK)
-  {
-    Error_Handler();
-  }
-  if (USBD_MIDI_RegisterInterface(&hUsbDeviceFS, &USBD_Interface_fops_FS) != USBD_OK)
-  {
-    Error_Handler();
-  }
-  if (USBD_Start(&hUsbDeviceFS) != USBD_OK)
-  {
-    Error_Handler();
-  }
-
-  /* USER CODE BEGIN USB_DEVICE_Init_PostTreatment */
-  HAL_PWREx_EnableUSBVoltageDetector();
-
-  /* USER CODE END USB_DEVICE_Init_PostTreatment */
-}
-
-/**
-  * @}
-  */
-
-/**
-  * @}
-  */
-
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : usb_device.c
+  * @version        : v1.0_Cube
+  * @brief          : This file implements the USB Device
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "usb_device.h"
+#include "usbd_core.h"
+#include "usbd_desc.h"
+#include "usbd_midi.h"
+#include "usbd_midi_if.h"
+
+/* USER CODE BEGIN Includes */
+#ifdef USE_USBD_COMPOSITE
+#include "usbd_composite_builder.h"
+#include "usbd_cdc.h"
+#include "usbd_cdc_if.h"
+#endif /* USE_USBD_COMPOSITE */
+/* USER CODE END Includes */
+
+/* USER CODE BEGIN PV */
+/* Private variables ---------------------------------------------------------*/
+#ifdef USE_USBD_COMPOSITE
+/* Endpoints of each function, in the order of its class: kept by the core */
+static uint8_t MIDI_EpAdd_Inst[USBD_MIDI_NUM_INSTANCES][2U * USBD_MIDI_NUM_PIPES];
+static uint8_t CDC_EpAdd_Inst[3] = {CDC_IN_EP, CDC_OUT_EP, CDC_CMD_EP};
+#endif /* USE_USBD_COMPOSITE */
+
+/* USER CODE END PV */
+
+/* USER CODE BEGIN PFP */
+/* Private function prototypes -----------------------------------------------*/
+
+/* USER CODE END PFP */
+
+/* USB Device Core handle declaration. */
+USBD_HandleTypeDef hUsbDeviceFS;
+
+/*
+ * -- Insert your variables declaration here --
+ */
+/* USER CODE BEGIN 0 */
+
+/* USER CODE END 0 */
+
+/*
+ * -- Insert your external function declaration here --
+ */
+/* USER CODE BEGIN 1 */
+#ifdef USE_USBD_COMPOSITE
+/* Registers the functions of the composite device, in place of the single
+   MIDI class of the generated sequence */
+static void USBD_FS_CompositeRegister(void)
+{
+  if (USBD_Init(&hUsbDeviceFS, &FS_Desc, DEVICE_FS) != USBD_OK)
+  {
+    Error_Handler();
+  }
+  /* The CDC port comes right after the first MIDI function, so its
+     interfaces stay 2 and 3 whatever the number of MIDI functions */
+  for (uint32_t n = 0U; n < USBD_MIDI_NUM_INSTANCES; n++)
+  {
+    MIDI_EpAdd_Inst[n][0] = MIDI_INST_IN_EP(n);
+    MIDI_EpAdd_Inst[n][1] = MIDI_INST_OUT_EP(n);
+#if (USBD_MIDI_NUM_PIPES > 1U)
+    MIDI_EpAdd_Inst[n][2] = MIDI_INST_IN_EP2(n);
+    MIDI_EpAdd_Inst[n][3] = MIDI_INST_OUT_EP2(n);
+#endif /* USBD_MIDI_NUM_PIPES */
+    if (USBD_RegisterClassComposite(&hUsbDeviceFS, &USBD_MIDI, CLASS_TYPE_MIDI, MIDI_EpAdd_Inst[n]) != USBD_OK)
+    {
+      Error_Handler();
+    }
+    if ((n == 0U) &&
+        (USBD_RegisterClassComposite(&hUsbDeviceFS, &USBD_CDC, CLASS_TYPE_CDC, CDC_EpAdd_Inst) != USBD_OK))
+    {
+      Error_Handler();
+    }
+  }
+  /* All MIDI functions share one interface, which tells them apart by the
+     class the core is serving */
+  for (uint32_t n = 0U; n < USBD_MIDI_NUM_INSTANCES; n++)
+  {
+    if (USBD_CMPSIT_SetClassID(&hUsbDeviceFS, CLASS_TYPE_MIDI, n) == 0xFFU)
+    {
+      Error_Handler();
+    }
+    if (USBD_MIDI_RegisterInterface(&hUsbDeviceFS, &USBD_Interface_fops_FS) != USBD_OK)
+    {
+      Error_Handler();
+    }
+  }
+  if (USBD_CMPSIT_SetClassID(&hUsbDeviceFS, CLASS_TYPE_CDC, 0) == 0xFFU)
+  {
+    Error_Handler();
+  }
+  if (USBD_CDC_RegisterInterface(&hUsbDeviceFS, &USBD_CDC_Interface_fops_FS) != USBD_OK)
+  {
+    Error_Handler();
+  }
+}
+#endif /* USE_USBD_COMPOSITE */
+/* USER CODE END 1 */
+
+/**
+  * Init USB device Library, add supported class and start the library
+  * @retval None
+  */
+void MX_USB_DEVICE_Init(void)
+{
+  /* USER CODE BEGIN USB_DEVICE_Init_PreTreatment */
+  USBD_FS_StringInit();
+  USBD_FS_SerialInit();
+#ifdef USE_USBD_COMPOSITE
+  USBD_FS_CompositeInit();
+  /* started here: the generated sequence below only knows the MIDI class */
+  USBD_FS_CompositeRegister();
+  if (USBD_Start(&hUsbDeviceFS) != USBD_OK)
+  {
+    Error_Handler();
+  }
+  HAL_PWREx_EnableUSBVoltageDetector();
+  return;
+#endif /* USE_USBD_COMPOSITE */
+
+  /* USER CODE END USB_DEVICE_Init_PreTreatment */
+
+  /* Init Device Library, add supported class and start the library. */
+  if (USBD_Init(&hUsbDeviceFS, &FS_Desc, DEVICE_FS) != USBD_OK)
+  {
+    Error_Handler();
+  }
+  if (USBD_RegisterClass(&hUsbDeviceFS, &USBD_MIDI) != USBD_OK)
+  {
+    Error_Handler();
+  }
+  if (USBD_MIDI_RegisterInterface(&hUsbDeviceFS, &USBD_Interface_fops_FS) != USBD_OK)
+  {
+    Error_Handler();
+  }
+  if (USBD_Start(&hUsbDeviceFS) != USBD_OK)
+  {
+    Error_Handler();
+  }
+
+  /* USER CODE BEGIN USB_DEVICE_Init_PostTreatment */
+  HAL_PWREx_EnableUSBVoltageDetector();
+
+  /* USER CODE END USB_DEVICE_Init_PostTreatment */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
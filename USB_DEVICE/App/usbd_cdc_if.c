@@ -0,0 +1,535 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : usbd_cdc_if.c
+  * @version        : v1.0_Cube
+  * @brief          : Usb device for Virtual Com Port.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_cdc_if.h"
+
+/* USER CODE BEGIN INCLUDE */
+#include "mcu_port.h"
+/* USER CODE END INCLUDE */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+
+/* USER CODE BEGIN PV */
+/* Private variables ---------------------------------------------------------*/
+
+/* USER CODE END PV */
+
+/** @addtogroup STM32_USB_OTG_DEVICE_LIBRARY
+  * @brief Usb device library.
+  * @{
+  */
+
+/** @addtogroup USBD_CDC_IF
+  * @{
+  */
+
+/** @defgroup USBD_CDC_IF_Private_TypesDefinitions USBD_CDC_IF_Private_TypesDefinitions
+  * @brief Private types.
+  * @{
+  */
+
+/* USER CODE BEGIN PRIVATE_TYPES */
+
+/* USER CODE END PRIVATE_TYPES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CDC_IF_Private_Defines USBD_CDC_IF_Private_Defines
+  * @brief Private defines.
+  * @{
+  */
+
+/* USER CODE BEGIN PRIVATE_DEFINES */
+/* USER CODE END PRIVATE_DEFINES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CDC_IF_Private_Macros USBD_CDC_IF_Private_Macros
+  * @brief Private macros.
+  * @{
+  */
+
+/* USER CODE BEGIN PRIVATE_MACRO */
+/* The CDC class takes the class ID in its transmit calls when the device
+   is composite, as the MIDI one does */
+#ifdef USE_USBD_COMPOSITE
+#define CDC_CLASS_ARG , UserCdc_class
+#else
+#define CDC_CLASS_ARG
+#endif /* USE_USBD_COMPOSITE */
+/* USER CODE END PRIVATE_MACRO */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CDC_IF_Private_Variables USBD_CDC_IF_Private_Variables
+  * @brief Private variables.
+  * @{
+  */
+/* Create buffer for reception and transmission           */
+/* It's up to user to redefine and/or remove those define */
+/** Received data over USB are stored in this buffer      */
+uint8_t UserCdcRxBufferFS[APP_CDC_RX_DATA_SIZE];
+
+/** Data to send over USB CDC are stored in this buffer   */
+uint8_t UserCdcTxBufferFS[2][APP_CDC_TX_DATA_SIZE];
+
+/* USER CODE BEGIN PRIVATE_VARIABLES */
+/* Class ID of the CDC function */
+uint8_t UserCdc_class = 0;
+/* Records are appended to half UserCdcTx_fill while the other one is on
+   the bus; the halves trade places when a transfer completes */
+__IO uint16_t UserCdcTx_len[2] = {0, 0};
+__IO uint8_t UserCdcTx_fill = 0;
+__IO uint8_t UserCdcTx_busy = 0;
+/* DTR: a terminal or logger has the port open */
+__IO uint8_t UserCdc_open = 0;
+USBD_CDC_LineCodingTypeDef UserCdc_coding = {115200, 0, 0, 8};
+/* Raw MIDI mode, chosen by the line coding. The OUT packet is then parsed
+   by USBCDC_polling(), which re-arms the endpoint once it is done. */
+__IO uint8_t UserCdc_midi = 0;
+__IO uint8_t UserCdcRx_held = 0;
+__IO uint16_t UserCdcRx_len = 0;
+/* USER CODE END PRIVATE_VARIABLES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CDC_IF_Exported_Variables USBD_CDC_IF_Exported_Variables
+  * @brief Public variables.
+  * @{
+  */
+
+extern USBD_HandleTypeDef hUsbDeviceFS;
+
+/* USER CODE BEGIN EXPORTED_VARIABLES */
+USBCDC_StatsTypeDef USBCDC_Stats;
+MIDI_StreamEncTypeDef USBCDC_MidiEnc;
+MIDI_StreamParserTypeDef USBCDC_MidiParser;
+/* USER CODE END EXPORTED_VARIABLES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CDC_IF_Private_FunctionPrototypes USBD_CDC_IF_Private_FunctionPrototypes
+  * @brief Private functions declaration.
+  * @{
+  */
+
+static int8_t USBCDC_Init_FS(void);
+static int8_t USBCDC_DeInit_FS(void);
+static int8_t USBCDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length);
+static int8_t USBCDC_Receive_FS(uint8_t* pbuf, uint32_t *Len);
+static int8_t USBCDC_TransmitCplt_FS(uint8_t *pbuf, uint32_t *Len, uint8_t epnum);
+
+/* USER CODE BEGIN PRIVATE_FUNCTIONS_DECLARATION */
+static void cdc_kick(void);
+static void cdc_reset(void);
+static void cdc_set_midi(uint8_t midi);
+static void cdc_rx_arm(void);
+/* USER CODE END PRIVATE_FUNCTIONS_DECLARATION */
+
+/**
+  * @}
+  */
+
+USBD_CDC_ItfTypeDef USBD_CDC_Interface_fops_FS =
+{
+  USBCDC_Init_FS,
+  USBCDC_DeInit_FS,
+  USBCDC_Control_FS,
+  USBCDC_Receive_FS,
+  USBCDC_TransmitCplt_FS
+};
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Initializes the CDC media low layer over the FS USB IP
+  * @retval USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t USBCDC_Init_FS(void)
+{
+  /* USER CODE BEGIN 3 */
+  UserCdc_class = (uint8_t)hUsbDeviceFS.classId;
+  cdc_reset();
+  /* Set Application Buffers */
+  USBD_CDC_SetTxBuffer(&hUsbDeviceFS, UserCdcTxBufferFS[0], 0 CDC_CLASS_ARG);
+  USBD_CDC_SetRxBuffer(&hUsbDeviceFS, UserCdcRxBufferFS);
+  return (USBD_OK);
+  /* USER CODE END 3 */
+}
+
+/**
+  * @brief  DeInitializes the CDC media low layer
+  * @retval USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t USBCDC_DeInit_FS(void)
+{
+  /* USER CODE BEGIN 4 */
+  /* a transfer cut by the reset never completes */
+  cdc_reset();
+  return (USBD_OK);
+  /* USER CODE END 4 */
+}
+
+/**
+  * @brief  Manage the CDC class requests
+  * @param  cmd: Command code
+  * @param  pbuf: Buffer containing command data (request parameters)
+  * @param  length: Number of data to be sent (in bytes)
+  * @retval Result of the operation: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t USBCDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
+{
+  /* USER CODE BEGIN 5 */
+  UNUSED(length);
+  switch(cmd)
+  {
+    /*******************************************************************************/
+    /* Line Coding Structure                                                       */
+    /*-----------------------------------------------------------------------------*/
+    /* Offset | Field       | Size | Value  | Description                          */
+    /* 0      | dwDTERate   |   4  | Number |Data terminal rate, in bits per second*/
+    /* 4      | bCharFormat |   1  | Number | Stop bits                            */
+    /*                                        0 - 1 Stop bit                       */
+    /*                                        1 - 1.5 Stop bits                    */
+    /*                                        2 - 2 Stop bits                      */
+    /* 5      | bParityType |  1   | Number | Parity                               */
+    /*                                        0 - None                             */
+    /*                                        1 - Odd                              */
+    /*                                        2 - Even                             */
+    /*                                        3 - Mark                             */
+    /*                                        4 - Space                            */
+    /* 6      | bDataBits  |   1   | Number Data bits (5, 6, 7, 8 or 16).          */
+    /*******************************************************************************/
+    case CDC_SET_LINE_CODING:
+      /* the port has no UART behind it: only the rate means something,
+         it selects between records and raw MIDI */
+      UserCdc_coding.bitrate = (uint32_t)pbuf[0] | ((uint32_t)pbuf[1] << 8) |
+                               ((uint32_t)pbuf[2] << 16) | ((uint32_t)pbuf[3] << 24);
+      UserCdc_coding.format = pbuf[4];
+      UserCdc_coding.paritytype = pbuf[5];
+      UserCdc_coding.datatype = pbuf[6];
+      cdc_set_midi(UserCdc_coding.bitrate == USBCDC_MIDI_BAUDRATE);
+    break;
+
+    case CDC_GET_LINE_CODING:
+      pbuf[0] = (uint8_t)(UserCdc_coding.bitrate);
+      pbuf[1] = (uint8_t)(UserCdc_coding.bitrate >> 8);
+      pbuf[2] = (uint8_t)(UserCdc_coding.bitrate >> 16);
+      pbuf[3] = (uint8_t)(UserCdc_coding.bitrate >> 24);
+      pbuf[4] = UserCdc_coding.format;
+      pbuf[5] = UserCdc_coding.paritytype;
+      pbuf[6] = UserCdc_coding.datatype;
+    break;
+
+    case CDC_SET_CONTROL_LINE_STATE:
+      /* no data stage: pbuf is the setup packet, DTR is bit 0 of wValue */
+      UserCdc_open = (((USBD_SetupReqTypedef *)pbuf)->wValue & 0x0001U) != 0U;
+      /* a new reader starts on a record boundary, not in the middle of
+         what was queued for the previous one */
+      if(!UserCdc_open){
+        UserCdcTx_len[UserCdcTx_fill] = 0;
+        MIDI_Stream_EncInit(&USBCDC_MidiEnc);
+      }
+    break;
+
+    default:
+    break;
+  }
+
+  return (USBD_OK);
+  /* USER CODE END 5 */
+}
+
+/**
+  * @brief  Data received over USB OUT endpoint are sent over CDC interface
+  *         through this function.
+  *
+  *         @note
+  *         This function will issue a NAK packet on any OUT packet received on
+  *         USB endpoint until exiting this function. If you exit this function
+  *         before transfer is complete on CDC interface (ie. using DMA controller)
+  *         it will result in receiving more data while previous ones are still
+  *         not sent.
+  *
+  * @param  Buf: Buffer of data to be received
+  * @param  Len: Number of data received (in bytes)
+  * @retval Result of the operation: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t USBCDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
+{
+  /* USER CODE BEGIN 6 */
+  if(UserCdc_midi){
+    /* NAKed until USBCDC_polling() has parsed it */
+    UserCdcRx_len = (uint16_t)*Len;
+    UserCdcRx_held = 1;
+    return (USBD_OK);
+  }
+  USB_CDC_receive(Buf, *Len);
+  USBD_CDC_SetRxBuffer(&hUsbDeviceFS, UserCdcRxBufferFS);
+  USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+  return (USBD_OK);
+  /* USER CODE END 6 */
+}
+
+/**
+  * @brief  USBCDC_Transmit_FS
+  *         Data to send over USB IN endpoint are sent over CDC interface
+  *         through this function.
+  *         @note
+  *
+  *
+  * @param  Buf: Buffer of data to be sent
+  * @param  Len: Number of data to be sent (in bytes)
+  * @retval USBD_OK if all operations are OK else USBD_FAIL or USBD_BUSY
+  */
+uint8_t USBCDC_Transmit_FS(uint8_t* Buf, uint16_t Len)
+{
+  uint8_t result = USBD_OK;
+  /* USER CODE BEGIN 7 */
+  USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassDataCmsit[UserCdc_class];
+  if (hcdc == NULL || hcdc->TxState != 0){
+    return USBD_BUSY;
+  }
+  UserCdcTx_busy = 1;
+  USBD_CDC_SetTxBuffer(&hUsbDeviceFS, Buf, Len CDC_CLASS_ARG);
+  result = USBD_CDC_TransmitPacket(&hUsbDeviceFS CDC_CLASS_ARG);
+  if (result != USBD_OK)
+    UserCdcTx_busy = 0;
+  /* USER CODE END 7 */
+  return result;
+}
+
+/**
+  * @brief  USBCDC_TransmitCplt_FS
+  *         Data transmitted callback
+  *
+  *         @note
+  *         This function is IN transfer complete callback used to inform user that
+  *         the submitted Data is successfully sent over USB.
+  *
+  * @param  Buf: Buffer of data to be received
+  * @param  Len: Number of data received (in bytes)
+  * @retval Result of the operation: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t USBCDC_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
+{
+  uint8_t result = USBD_OK;
+  /* USER CODE BEGIN 13 */
+  UNUSED(Buf);
+  UNUSED(epnum);
+  USBCDC_Stats.bytes_sent += *Len;
+  UserCdcTx_busy = 0;
+  /* whatever was queued during the transfer goes out in one piece */
+  cdc_kick();
+  /* USER CODE END 13 */
+  return result;
+}
+
+/* USER CODE BEGIN PRIVATE_FUNCTIONS_IMPLEMENTATION */
+/* Hands the half being filled to the endpoint if it is idle, and starts
+   filling the other one. Called with interrupts masked or from the OTG
+   interrupt. */
+static void cdc_kick(void){
+  uint8_t half = UserCdcTx_fill;
+  uint16_t len = UserCdcTx_len[half];
+  if(UserCdcTx_busy || len == 0)
+    return;
+  if(USBCDC_Transmit_FS(UserCdcTxBufferFS[half], len) != USBD_OK)
+    return;
+  UserCdcTx_fill = half ^ 1;
+  UserCdcTx_len[half ^ 1] = 0;
+  USBCDC_Stats.transfers++;
+  if(len > USBCDC_Stats.fill_max)
+    USBCDC_Stats.fill_max = len;
+}
+
+static void cdc_reset(void){
+  UserCdc_open = 0;
+  UserCdcTx_busy = 0;
+  UserCdcTx_fill = 0;
+  UserCdcTx_len[0] = 0;
+  UserCdcTx_len[1] = 0;
+  UserCdcRx_held = 0;
+  MIDI_Stream_EncInit(&USBCDC_MidiEnc);
+  MIDI_Stream_ParseInit(&USBCDC_MidiParser, USBCDC_MIDI_CABLE, USB_CDC_midi_receive);
+}
+
+/* Records and MIDI bytes never share the stream: what was queued in the
+   other format is dropped, and both ends of the MIDI stream restart
+   without running status. From the OTG interrupt. */
+static void cdc_set_midi(uint8_t midi){
+  if(midi == UserCdc_midi)
+    return;
+  UserCdcTx_len[UserCdcTx_fill] = 0;
+  MIDI_Stream_EncInit(&USBCDC_MidiEnc);
+  MIDI_Stream_ParseInit(&USBCDC_MidiParser, USBCDC_MIDI_CABLE, USB_CDC_midi_receive);
+  UserCdc_midi = midi;
+}
+
+/* The CDC class finds its instance through pdev->classId, which is only
+   right inside the core callbacks; outside of them it is set for the call
+   with the OTG interrupt masked */
+static void cdc_rx_arm(void){
+  uint32_t primask = __get_PRIMASK();
+  uint32_t class_id;
+  __disable_irq();
+  class_id = hUsbDeviceFS.classId;
+  hUsbDeviceFS.classId = UserCdc_class;
+  USBD_CDC_SetRxBuffer(&hUsbDeviceFS, UserCdcRxBufferFS);
+  USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+  hUsbDeviceFS.classId = class_id;
+  __set_PRIMASK(primask);
+}
+
+uint8_t USBCDC_is_open(){
+  return UserCdc_open && !UserCdc_midi && hUsbDeviceFS.dev_state == USBD_STATE_CONFIGURED;
+}
+
+uint8_t USBCDC_midi_is_open(){
+  return UserCdc_open && UserCdc_midi && hUsbDeviceFS.dev_state == USBD_STATE_CONFIGURED;
+}
+
+/* Queues one record and starts a transfer if none is running. Callable
+   from any context. Returns len, or 0 when the port is closed or the
+   record does not fit before the current transfer completes. */
+uint16_t USBCDC_write(uint8_t stream, const void *data, uint16_t len){
+  uint32_t primask;
+  uint8_t *p;
+  uint8_t half;
+  uint16_t used;
+  if(!USBCDC_is_open())
+    return 0;
+  primask = __get_PRIMASK();
+  __disable_irq();
+  half = UserCdcTx_fill;
+  used = UserCdcTx_len[half];
+  if((uint32_t)used + USBCDC_RECORD_HDR_SIZE + len > APP_CDC_TX_DATA_SIZE){
+    USBCDC_Stats.dropped++;
+    __set_PRIMASK(primask);
+    return 0;
+  }
+  p = &UserCdcTxBufferFS[half][used];
+  p[0] = USBCDC_RECORD_SYNC;
+  p[1] = stream;
+  p[2] = (uint8_t)len;
+  p[3] = (uint8_t)(len >> 8);
+  memcpy(&p[USBCDC_RECORD_HDR_SIZE], data, len);
+  UserCdcTx_len[half] = used + USBCDC_RECORD_HDR_SIZE + len;
+  USBCDC_Stats.records++;
+  cdc_kick();
+  __set_PRIMASK(primask);
+  return len;
+}
+
+uint16_t USBCDC_log(const char *text){
+  return USBCDC_write(USBCDC_STREAM_LOG, text, (uint16_t)strlen(text));
+}
+
+/* Time-stamped trace point, cheap enough for interrupt handlers */
+void USBCDC_trace(uint16_t id, uint32_t arg){
+  USBCDC_TraceTypeDef t;
+  t.cycles = MCU_CYCLES();
+  t.arg = arg;
+  t.id = id;
+  t.reserved = 0;
+  (void)USBCDC_write(USBCDC_STREAM_TRACE, &t, sizeof(t));
+}
+
+/* Queues one event on the raw MIDI stream, from any context. Events are
+   taken whole or not at all, so running status stays right on a refusal;
+   USBCDC_midi_tx_free() tells how many surely fit. Returns 0 when the port
+   is not open in MIDI mode or the event was refused. */
+uint8_t USBCDC_midi_send(uint32_t event){
+  MIDI_StreamEncTypeDef enc;
+  uint8_t bytes[MIDI_STREAM_MAX_BYTES];
+  uint32_t primask;
+  uint8_t half, n;
+  uint16_t used;
+  if(!USBCDC_midi_is_open())
+    return 0;
+  primask = __get_PRIMASK();
+  __disable_irq();
+  enc = USBCDC_MidiEnc;
+  n = MIDI_Stream_Encode(&enc, event, bytes);
+  half = UserCdcTx_fill;
+  used = UserCdcTx_len[half];
+  if((uint32_t)used + n > APP_CDC_TX_DATA_SIZE){
+    USBCDC_Stats.dropped++;
+    __set_PRIMASK(primask);
+    return 0;
+  }
+  memcpy(&UserCdcTxBufferFS[half][used], bytes, n);
+  UserCdcTx_len[half] = used + n;
+  USBCDC_MidiEnc = enc;
+  cdc_kick();
+  __set_PRIMASK(primask);
+  return 1;
+}
+
+/* Events of any kind that fit in the half being filled */
+uint16_t USBCDC_midi_tx_free(){
+  if(!USBCDC_midi_is_open())
+    return 0;
+  return (APP_CDC_TX_DATA_SIZE - UserCdcTx_len[UserCdcTx_fill]) / MIDI_STREAM_MAX_BYTES;
+}
+
+/* Parses the OUT packet held in MIDI mode and lets the host send the next
+   one. From the main loop, so USB_CDC_midi_receive() runs there too. */
+void USBCDC_polling(){
+  if(!UserCdcRx_held)
+    return;
+  if(UserCdc_midi)
+    MIDI_Stream_Parse(&USBCDC_MidiParser, UserCdcRxBufferFS, UserCdcRx_len);
+  UserCdcRx_held = 0;
+  cdc_rx_arm();
+}
+
+/* Events parsed from the raw MIDI stream, on cable USBCDC_MIDI_CABLE */
+__weak void USB_CDC_midi_receive(uint32_t event){
+  UNUSED(event);
+}
+
+/* Data from the host in record mode, from the OTG interrupt. The port is an
+   output then; this is the place for a command channel if one is needed. */
+__weak void USB_CDC_receive(uint8_t *Buf, uint32_t Len){
+  UNUSED(Buf);
+  UNUSED(Len);
+}
+/* USER CODE END PRIVATE_FUNCTIONS_IMPLEMENTATION */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
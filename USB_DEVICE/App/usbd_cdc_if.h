@@ -0,0 +1,169 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : usbd_cdc_if.h
+  * @version        : v1.0_Cube
+  * @brief          : Header for usbd_cdc_if.c file.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USBD_CDC_IF_H__
+#define __USBD_CDC_IF_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_cdc.h"
+
+/* USER CODE BEGIN INCLUDE */
+#include "midi_stream.h"
+/* USER CODE END INCLUDE */
+
+/** @addtogroup STM32_USB_OTG_DEVICE_LIBRARY
+  * @brief For Usb device.
+  * @{
+  */
+
+/** @defgroup USBD_CDC_IF USBD_CDC_IF
+  * @brief Usb VCP device module
+  * @{
+  */
+
+/** @defgroup USBD_CDC_IF_Exported_Defines USBD_CDC_IF_Exported_Defines
+  * @brief Defines.
+  * @{
+  */
+/* Define size for the receive and transmit buffer over CDC */
+#define APP_CDC_RX_DATA_SIZE  CDC_DATA_FS_MAX_PACKET_SIZE
+#define APP_CDC_TX_DATA_SIZE  2048
+/* USER CODE BEGIN EXPORTED_DEFINES */
+/* The CDC port only carries records from the device: a sync byte, the
+   stream, the payload length (little endian) and the payload. Records are
+   whole or dropped, never cut. */
+#define USBCDC_RECORD_SYNC          0xA5U
+#define USBCDC_RECORD_HDR_SIZE      4U
+/* Streams below 0x10 are the ones of this file; the application numbers its
+   binary telemetry records from USBCDC_STREAM_USER */
+#define USBCDC_STREAM_LOG           0x01U  /* text, no terminator */
+#define USBCDC_STREAM_TRACE         0x02U  /* USBCDC_TraceTypeDef */
+#define USBCDC_STREAM_USER          0x10U
+/* A host opening the port at the DIN MIDI rate gets the raw MIDI byte
+   stream of one cable instead of the records, both ways */
+#define USBCDC_MIDI_BAUDRATE        31250U
+#define USBCDC_MIDI_CABLE           0U
+/* USER CODE END EXPORTED_DEFINES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CDC_IF_Exported_Types USBD_CDC_IF_Exported_Types
+  * @brief Types.
+  * @{
+  */
+
+/* USER CODE BEGIN EXPORTED_TYPES */
+typedef struct
+{
+  uint32_t cycles;           /* MCU_CYCLES() when the point was hit */
+  uint32_t arg;
+  uint16_t id;
+  uint16_t reserved;
+} USBCDC_TraceTypeDef;
+
+typedef struct
+{
+  uint32_t records;          /* queued */
+  uint32_t dropped;          /* record or MIDI event with no room left */
+  uint32_t bytes_sent;
+  uint32_t transfers;
+  uint32_t fill_max;         /* largest transfer, bytes */
+} USBCDC_StatsTypeDef;
+/* USER CODE END EXPORTED_TYPES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CDC_IF_Exported_Macros USBD_CDC_IF_Exported_Macros
+  * @brief Aliases.
+  * @{
+  */
+
+/* USER CODE BEGIN EXPORTED_MACRO */
+
+/* USER CODE END EXPORTED_MACRO */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CDC_IF_Exported_Variables USBD_CDC_IF_Exported_Variables
+  * @brief Public variables.
+  * @{
+  */
+
+/** CDCInterface callback. */
+extern USBD_CDC_ItfTypeDef USBD_CDC_Interface_fops_FS;
+
+/* USER CODE BEGIN EXPORTED_VARIABLES */
+extern USBCDC_StatsTypeDef USBCDC_Stats;
+extern MIDI_StreamEncTypeDef USBCDC_MidiEnc;
+extern MIDI_StreamParserTypeDef USBCDC_MidiParser;
+/* USER CODE END EXPORTED_VARIABLES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_CDC_IF_Exported_FunctionsPrototype USBD_CDC_IF_Exported_FunctionsPrototype
+  * @brief Public functions declaration.
+  * @{
+  */
+
+uint8_t USBCDC_Transmit_FS(uint8_t* Buf, uint16_t Len);
+
+/* USER CODE BEGIN EXPORTED_FUNCTIONS */
+uint8_t USBCDC_is_open(void);
+uint16_t USBCDC_write(uint8_t stream, const void *data, uint16_t len);
+uint16_t USBCDC_log(const char *text);
+void USBCDC_trace(uint16_t id, uint32_t arg);
+void USB_CDC_receive(uint8_t *Buf, uint32_t Len);
+uint8_t USBCDC_midi_is_open(void);
+uint8_t USBCDC_midi_send(uint32_t event);
+uint16_t USBCDC_midi_tx_free(void);
+void USBCDC_polling(void);
+void USB_CDC_midi_receive(uint32_t event);
+/* USER CODE END EXPORTED_FUNCTIONS */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USBD_CDC_IF_H__ */
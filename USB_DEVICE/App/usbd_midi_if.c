@@ -1,327 +1,740 @@
-/* USER CODE BEGIN Header */
-/**
-  ******************************************************************************
-  * @file           : usbd_midi_if.c
-  * @version        : v1.0_Cube
-  * @brief          : Usb device for Virtual Com Port.
-  ******************************************************************************
-  * @attention
-  *
-  * Copyright (c) 2024 STMicroelectronics.
-  * All rights reserved.
-  *
-  * This software is licensed under terms that can be found in the LICENSE file
-  * in the root directory of this software component.
-  * If no LICENSE file comes with this software, it is provided AS-IS.
-  *
-  ******************************************************************************
-  */
-/* USER CODE END Header */
-
-/* Includes ------------------------------------------------------------------*/
-#include "usbd_midi_if.h"
-
-/* USER CODE BEGIN INCLUDE */
-
-/* USER CODE END INCLUDE */
-
-/* Private typedef -----------------------------------------------------------*/
-/* Private define ------------------------------------------------------------*/
-/* Private macro -------------------------------------------------------------*/
-
-/* USER CODE BEGIN PV */
-/* Private variables ---------------------------------------------------------*/
-
-/* USER CODE END PV */
-
-/** @addtogroup STM32_USB_OTG_DEVICE_LIBRARY
-  * @brief Usb device library.
-  * @{
-  */
-
-/** @addtogroup USBD_MIDI_IF
-  * @{
-  */
-
-/** @defgroup USBD_MIDI_IF_Private_TypesDefinitions USBD_MIDI_IF_Private_TypesDefinitions
-  * @brief Private types.
-  * @{
-  */
-
-/* USER CODE BEGIN PRIVATE_TYPES */
-
-/* USER CODE END PRIVATE_TYPES */
-
-/**
-  * @}
-  */
-
-/** @defgroup USBD_MIDI_IF_Private_Defines USBD_MIDI_IF_Private_Defines
-  * @brief Private defines.
-  * @{
-  */
-
-/* USER CODE BEGIN PRIVATE_DEFINES */
-/* USER CODE END PRIVATE_DEFINES */
-
-/**
-  * @}
-  */
-
-/** @defgroup USBD_MIDI_IF_Private_Macros USBD_MIDI_IF_Private_Macros
-  * @brief Private macros.
-  * @{
-  */
-
-/* USER CODE BEGIN PRIVATE_MACRO */
-#define APP_RX_MASK (APP_RX_DATA_SIZE-1)
-#define APP_TX_MASK (APP_TX_DATA_SIZE-1)
-/* USER CODE END PRIVATE_MACRO */
-
-/**
-  * @}
-  */
-
-/** @defgroup USBD_MIDI_IF_Private_Variables USBD_MIDI_IF_Private_Variables
-  * @brief Private variables.
-  * @{
-  */
-/* Create buffer for reception and transmission           */
-/* It's up to user to redefine and/or remove those define */
-/** Received data over USB are stored in this buffer      */
-uint8_t UserRxBufferFS[APP_RX_DATA_SIZE]={0};
-
-/** Data to send over USB CDC are stored in this buffer   */
-uint8_t UserTxBufferFS[APP_TX_DATA_SIZE]={0};
-
-/* USER CODE BEGIN PRIVATE_VARIABLES */
-__IO uint16_t UserRxBufferFS_wp = 0,  UserRxBufferFS_rp = 0;
-__IO uint16_t UserTxBufferFS_wp = 0,  UserTxBufferFS_rp = 0;
-__IO uint8_t UserTx_busy = 0;
-/* USER CODE END PRIVATE_VARIABLES */
-
-/**
-  * @}
-  */
-
-/** @defgroup USBD_MIDI_IF_Exported_Variables USBD_MIDI_IF_Exported_Variables
-  * @brief Public variables.
-  * @{
-  */
-
-extern USBD_HandleTypeDef hUsbDeviceFS;
-
-/* USER CODE BEGIN EXPORTED_VARIABLES */
-
-/* USER CODE END EXPORTED_VARIABLES */
-
-/**
-  * @}
-  */
-
-/** @defgroup USBD_MIDI_IF_Private_FunctionPrototypes USBD_MIDI_IF_Private_FunctionPrototypes
-  * @brief Private functions declaration.
-  * @{
-  */
-
-static int8_t USBMIDI_Init_FS(void);
-static int8_t USBMIDI_DeInit_FS(void);
-static int8_t USBMIDI_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length);
-static int8_t USBMIDI_Receive_FS(uint8_t* pbuf, uint32_t *Len);
-static int8_t USBMIDI_TransmitCplt_FS(uint8_t *pbuf, uint32_t *Len, uint8_t epnum);
-
-/* USER CODE BEGIN PRIVATE_FUNCTIONS_DECLARATION */
-
-/* USER CODE END PRIVATE_FUNCTIONS_DECLARATION */
-
-/**
-  * @}
-  */
-
-USBD_MIDI_ItfTypeDef USBD_Interface_fops_FS =
-{
-  USBMIDI_Init_FS,
-  USBMIDI_DeInit_FS,
-  USBMIDI_Control_FS,
-  USBMIDI_Receive_FS,
-  USBMIDI_TransmitCplt_FS
-};
-
-/* Private functions ---------------------------------------------------------*/
-/**
-  * @brief  Initializes the CDC media low layer over the FS USB IP
-  * @retval USBD_OK if all operations are OK else USBD_FAIL
-  */
-static int8_t USBMIDI_Init_FS(void)
-{
-  /* USER CODE BEGIN 3 */
-  /* Set Application Buffers */
-  USBD_MIDI_SetTxBuffer(&hUsbDeviceFS, UserTxBufferFS, 0);
-  USBD_MIDI_SetRxBuffer(&hUsbDeviceFS, UserRxBufferFS);
-  return (USBD_OK);
-  /* USER CODE END 3 */
-}
-
-/**
-  * @brief  DeInitializes the CDC media low layer
-  * @retval USBD_OK if all operations are OK else USBD_FAIL
-  */
-static int8_t USBMIDI_DeInit_FS(void)
-{
-  /* USER CODE BEGIN 4 */
-  return (USBD_OK);
-  /* USER CODE END 4 */
-}
-
-/**
-  * @brief  Manage the CDC class requests
-  * @param  cmd: Command code
-  * @param  pbuf: Buffer containing command data (request parameters)
-  * @param  length: Number of data to be sent (in bytes)
-  * @retval Result of the operation: USBD_OK if all operations are OK else USBD_FAIL
-  */
-static int8_t USBMIDI_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
-{
-  /* USER CODE BEGIN 5 */
-
-  return (USBD_OK);
-  /* USER CODE END 5 */
-}
-
-/**
-  * @brief  Data received over USB OUT endpoint are sent over CDC interface
-  *         through this function.
-  *
-  *         @note
-  *         This function will issue a NAK packet on any OUT packet received on
-  *         USB endpoint until exiting this function. If you exit this function
-  *         before transfer is complete on CDC interface (ie. using DMA controller)
-  *         it will result in receiving more data while previous ones are still
-  *         not sent.
-  *
-  * @param  Buf: Buffer of data to be received
-  * @param  Len: Number of data received (in bytes)
-  * @retval Result of the operation: USBD_OK if all operations are OK else USBD_FAIL
-  */
-static int8_t USBMIDI_Receive_FS(uint8_t* Buf, uint32_t *Len)
-{
-  /* USER CODE BEGIN 6 */
-  UserRxBufferFS_wp += *Len;
-  return (USBD_OK);
-  /* USER CODE END 6 */
-}
-
-/**
-  * @brief  USBMIDI_Transmit_FS
-  *         Data to send over USB IN endpoint are sent over CDC interface
-  *         through this function.
-  *         @note
-  *
-  *
-  * @param  Buf: Buffer of data to be sent
-  * @param  Len: Number of data to be sent (in bytes)
-  * @retval USBD_OK if all operations are OK else USBD_FAIL or USBD_BUSY
-  */
-uint8_t USBMIDI_Transmit_FS(uint8_t* Buf, uint16_t Len)
-{
-  uint8_t result = USBD_OK;
-  /* USER CODE BEGIN 7 */
-  USBD_MIDI_HandleTypeDef *hcdc = (USBD_MIDI_HandleTypeDef*)hUsbDeviceFS.pClassData;
-  if (hcdc->TxState != 0){
-    return USBD_BUSY;
-  }
-  UserTx_busy = 1;
-  USBD_MIDI_SetTxBuffer(&hUsbDeviceFS, Buf, Len);
-  result = USBD_MIDI_TransmitPacket(&hUsbDeviceFS);
-  /* USER CODE END 7 */
-  return result;
-}
-
-/**
-  * @brief  USBMIDI_TransmitCplt_FS
-  *         Data transmitted callback
-  *
-  *         @note
-  *         This function is IN transfer complete callback used to inform user that
-  *         the submitted Data is successfully sent over USB.
-  *
-  * @param  Buf: Buffer of data to be received
-  * @param  Len: Number of data received (in bytes)
-  * @retval Result of the operation: USBD_OK if all operations are OK else USBD_FAIL
-  */
-static int8_t USBMIDI_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
-{
-  uint8_t result = USBD_OK;
-  /* USER CODE BEGIN 13 */
-  UNUSED(Buf);
-  //UNUSED(Len);
-  UNUSED(epnum);
-  UserTxBufferFS_rp += *Len;
-  UserTx_busy = 0;
-  /* USER CODE END 13 */
-  return result;
-}
-
-/* USER CODE BEGIN PRIVATE_FUNCTIONS_IMPLEMENTATION */
-uint16_t tx_data_len(){
-  if((UserTxBufferFS_wp&APP_TX_MASK) >= (UserTxBufferFS_rp&APP_TX_MASK))
-    return UserTxBufferFS_wp - UserTxBufferFS_rp;
-  return APP_TX_DATA_SIZE  - (UserTxBufferFS_rp&APP_TX_MASK);
-}
-
-void USBMIDI_send(uint32_t event){
-  uint16_t len;
-  if(hUsbDeviceFS.dev_state != USBD_STATE_CONFIGURED){
-    UserTxBufferFS_wp = UserTxBufferFS_rp = 0;
-    return;
-  }
-  UserTxBufferFS[UserTxBufferFS_wp++&APP_TX_MASK] = event>>24;
-  UserTxBufferFS[UserTxBufferFS_wp++&APP_TX_MASK] = event>>16;
-  UserTxBufferFS[UserTxBufferFS_wp++&APP_TX_MASK] = event>>8;
-  UserTxBufferFS[UserTxBufferFS_wp++&APP_TX_MASK] = event;
-  len = tx_data_len();
-  if(len > MIDI_DATA_FS_IN_PACKET_SIZE)
-    len = MIDI_DATA_FS_IN_PACKET_SIZE;
-  if(!UserTx_busy)
-    USBMIDI_Transmit_FS(&UserTxBufferFS[UserTxBufferFS_rp&APP_TX_MASK], len);
-}
-
-uint16_t rx_data_len(){
-  if((UserRxBufferFS_wp&APP_RX_MASK) >= (UserRxBufferFS_rp&APP_RX_MASK))
-    return UserRxBufferFS_wp - UserRxBufferFS_rp;
-  return APP_RX_DATA_SIZE  - (UserRxBufferFS_rp&APP_RX_MASK);
-}
-
-__weak int USB_MIDI_decoder(uint8_t *Buf, uint32_t Len){
-  UNUSED(Buf);
-  UNUSED(Len);
-  return 1;
-}
-
-void USBMIDI_polling(){
-  uint16_t len;
-  if(!UserTx_busy && UserTxBufferFS_wp != UserTxBufferFS_rp){
-    len = tx_data_len();
-    if(len > MIDI_DATA_FS_IN_PACKET_SIZE)
-      len = MIDI_DATA_FS_IN_PACKET_SIZE;
-    USBMIDI_Transmit_FS(&UserTxBufferFS[UserTxBufferFS_rp&APP_TX_MASK], len);
-  }
-  if(UserRxBufferFS_wp != UserRxBufferFS_rp){
-    len = rx_data_len();
-    USBD_MIDI_SetRxBuffer(&hUsbDeviceFS, &UserRxBufferFS[UserRxBufferFS_wp&APP_RX_MASK]);
-    USBD_MIDI_ReceivePacket(&hUsbDeviceFS);
-
-    if(USB_MIDI_decoder(&UserRxBufferFS[UserRxBufferFS_rp&APP_RX_MASK], len)){
-      UserRxBufferFS_rp += len;
-    }
-  }
-}
-/* USER CODE END PRIVATE_FUNCTIONS_IMPLEMENTATION */
-
-/**
-  * @}
-  */
-
-/**
-  * @}
-  */
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : usbd_midi_if.c
+  * @version        : v1.0_Cube
+  * @brief          : Usb device for Virtual Com Port.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_midi_if.h"
+
+/* USER CODE BEGIN INCLUDE */
+#include "mcu_port.h"
+#ifdef USE_USBD_COMPOSITE
+#include "usbd_composite_builder.h"
+#endif /* USE_USBD_COMPOSITE */
+/* USER CODE END INCLUDE */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+
+/* USER CODE BEGIN PV */
+/* Private variables ---------------------------------------------------------*/
+
+/* USER CODE END PV */
+
+/** @addtogroup STM32_USB_OTG_DEVICE_LIBRARY
+  * @brief Usb device library.
+  * @{
+  */
+
+/** @addtogroup USBD_MIDI_IF
+  * @{
+  */
+
+/** @defgroup USBD_MIDI_IF_Private_TypesDefinitions USBD_MIDI_IF_Private_TypesDefinitions
+  * @brief Private types.
+  * @{
+  */
+
+/* USER CODE BEGIN PRIVATE_TYPES */
+/* One endpoint pair of a MIDI function, with queues of its own. Its cables
+   are application cables cable_base and up: every function numbers its own
+   from 0 on the bus, the second pair going on after the first. */
+typedef struct
+{
+  uint8_t class_id;          /* 0 unless the device is composite */
+  uint8_t pipe;              /* endpoint pair within the function */
+  uint8_t cable_base;
+  uint8_t num_cables;        /* of the pair, on the bus */
+  __IO uint16_t rx_wp, rx_rp;
+  __IO uint8_t rx_held;      /* OUT endpoint left NAKing, the ring is full */
+  __IO uint16_t tx_wp, tx_rp;
+  __IO uint8_t tx_busy;
+  /* Priority slot: whole events, sent ahead of the ring */
+  uint32_t prio[APP_TX_PRIO_SIZE];
+  uint32_t prio_stamp[APP_TX_PRIO_SIZE];
+  uint8_t prio_buffer[APP_TX_PRIO_SIZE*4];
+  __IO uint8_t prio_wp, prio_rp;
+  __IO uint8_t tx_prio;
+} USBMIDI_PortTypeDef;
+/* USER CODE END PRIVATE_TYPES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_MIDI_IF_Private_Defines USBD_MIDI_IF_Private_Defines
+  * @brief Private defines.
+  * @{
+  */
+
+/* USER CODE BEGIN PRIVATE_DEFINES */
+/* Ports are numbered function by function, pipe by pipe */
+#define USBMIDI_NUM_PORTS (USBD_MIDI_NUM_INSTANCES * USBD_MIDI_NUM_PIPES)
+/* Application cables of one function */
+#define USBMIDI_CABLES_PER_FUNC (USBD_MIDI_NUM_CABLES + USBD_MIDI_NUM_CABLES_2)
+/* USER CODE END PRIVATE_DEFINES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_MIDI_IF_Private_Macros USBD_MIDI_IF_Private_Macros
+  * @brief Private macros.
+  * @{
+  */
+
+/* USER CODE BEGIN PRIVATE_MACRO */
+#define APP_RX_MASK (APP_RX_DATA_SIZE-1)
+#define APP_TX_MASK (APP_TX_DATA_SIZE-1)
+#define APP_TX_PRIO_MASK (APP_TX_PRIO_SIZE-1)
+/* In the composite device, the calls made outside the class callbacks name
+   the MIDI class: pdev->classId is whichever class the core served last */
+#ifdef USE_USBD_COMPOSITE
+#define MIDI_CLASS_ARG(pp) , (pp)->class_id
+#else
+#define MIDI_CLASS_ARG(pp)
+#endif /* USE_USBD_COMPOSITE */
+/* Port of an endpoint, inside the class callbacks */
+#define PORT_OF_IN_EP(ep) (&UserPort[UserPort_of_in[(ep) & 0x0FU]])
+#define PORT_OF_OUT_EP(ep) (&UserPort[UserPort_of_out[(ep) & 0x0FU]])
+/* USER CODE END PRIVATE_MACRO */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_MIDI_IF_Private_Variables USBD_MIDI_IF_Private_Variables
+  * @brief Private variables.
+  * @{
+  */
+/* Create buffer for reception and transmission           */
+/* It's up to user to redefine and/or remove those define */
+/** Received data over USB are stored in this buffer      */
+uint8_t UserRxBufferFS[USBMIDI_NUM_PORTS][APP_RX_DATA_SIZE]={0};
+
+/** Data to send over USB CDC are stored in this buffer   */
+uint8_t UserTxBufferFS[USBMIDI_NUM_PORTS][APP_TX_DATA_SIZE]={0};
+
+/* USER CODE BEGIN PRIVATE_VARIABLES */
+USBMIDI_PortTypeDef UserPort[USBMIDI_NUM_PORTS];
+/* OUT packets land here and what the interrupt leaves is copied into the
+   ring of the port, which may then wrap anywhere */
+uint8_t UserRxPacketFS[USBMIDI_NUM_PORTS][MIDI_DATA_FS_OUT_PACKET_SIZE];
+/* Index in UserPort of each MIDI endpoint, by endpoint number */
+uint8_t UserPort_of_in[16];
+uint8_t UserPort_of_out[16];
+/* Data stage of vendor requests, both directions. EP0 carries one request
+   at a time, so the functions share it. */
+uint32_t UserVendorBufferFS[APP_VENDOR_DATA_SIZE/4];
+uint16_t UserVendor_loop_len = 0;
+uint32_t UserVendor_t0 = 0;
+__IO uint8_t UserRx_flush = 0;
+__IO uint8_t UserRx_isr_classes = USBMIDI_RX_ISR_CLASSES;
+/* Application cables inside a universal real time SysEx, interrupt only */
+uint16_t UserRx_sysex_rt = 0;
+/* USER CODE END PRIVATE_VARIABLES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_MIDI_IF_Exported_Variables USBD_MIDI_IF_Exported_Variables
+  * @brief Public variables.
+  * @{
+  */
+
+extern USBD_HandleTypeDef hUsbDeviceFS;
+
+/* USER CODE BEGIN EXPORTED_VARIABLES */
+MIDI_NotesTypeDef USBMIDI_TxNotes;
+MIDI_NotesTypeDef USBMIDI_RxNotes;
+USBMIDI_StatsTypeDef USBMIDI_Stats;
+/* USER CODE END EXPORTED_VARIABLES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_MIDI_IF_Private_FunctionPrototypes USBD_MIDI_IF_Private_FunctionPrototypes
+  * @brief Private functions declaration.
+  * @{
+  */
+
+static int8_t USBMIDI_Init_FS(void);
+static int8_t USBMIDI_DeInit_FS(void);
+static int8_t USBMIDI_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length);
+static int8_t USBMIDI_Receive_FS(uint8_t* pbuf, uint32_t *Len, uint8_t epnum);
+static int8_t USBMIDI_TransmitCplt_FS(uint8_t *pbuf, uint32_t *Len, uint8_t epnum);
+static int8_t USBMIDI_Vendor_FS(USBD_SetupReqTypedef *req, uint8_t *pbuf, uint16_t *length);
+
+/* USER CODE BEGIN PRIVATE_FUNCTIONS_DECLARATION */
+static void rx_track_notes(uint8_t *Buf, uint32_t Len);
+static uint32_t rx_dispatch_isr(uint8_t *Buf, uint32_t Len);
+static uint16_t rx_room(USBMIDI_PortTypeDef *pp);
+static uint8_t port_transmit(USBMIDI_PortTypeDef *pp, uint8_t* Buf, uint16_t Len);
+static void tx_kick(USBMIDI_PortTypeDef *pp, uint8_t ring);
+/* USER CODE END PRIVATE_FUNCTIONS_DECLARATION */
+
+/**
+  * @}
+  */
+
+USBD_MIDI_ItfTypeDef USBD_Interface_fops_FS =
+{
+  USBMIDI_Init_FS,
+  USBMIDI_DeInit_FS,
+  USBMIDI_Control_FS,
+  USBMIDI_Receive_FS,
+  USBMIDI_TransmitCplt_FS,
+  USBMIDI_Vendor_FS
+};
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Initializes the CDC media low layer over the FS USB IP
+  * @retval USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t USBMIDI_Init_FS(void)
+{
+  /* USER CODE BEGIN 3 */
+  USBD_MIDI_HandleTypeDef *hmidi = (USBD_MIDI_HandleTypeDef*)hUsbDeviceFS.pClassDataCmsit[hUsbDeviceFS.classId];
+  USBMIDI_PortTypeDef *pp;
+  uint8_t n = 0, p, k;
+#ifdef USE_USBD_COMPOSITE
+  /* functions are numbered in the order of their classes */
+  while(n + 1U < USBD_MIDI_NUM_INSTANCES &&
+        USBD_CMPSIT_GetClassID(&hUsbDeviceFS, CLASS_TYPE_MIDI, n) != hUsbDeviceFS.classId)
+    n++;
+#endif /* USE_USBD_COMPOSITE */
+  for(p = 0; p < USBD_MIDI_NUM_PIPES; p++){
+    k = n * USBD_MIDI_NUM_PIPES + p;
+    pp = &UserPort[k];
+    UserPort_of_in[hmidi->Pipe[p].InEpAdd & 0x0FU] = k;
+    UserPort_of_out[hmidi->Pipe[p].OutEpAdd & 0x0FU] = k;
+    pp->class_id = (uint8_t)hUsbDeviceFS.classId;
+    pp->pipe = p;
+    pp->cable_base = n * USBMIDI_CABLES_PER_FUNC + (p ? USBD_MIDI_NUM_CABLES : 0);
+    pp->num_cables = p ? USBD_MIDI_NUM_CABLES_2 : USBD_MIDI_NUM_CABLES;
+    pp->rx_held = 0;
+    /* Set Application Buffers */
+    USBD_MIDI_SetTxBuffer(&hUsbDeviceFS, p, UserTxBufferFS[k], 0 MIDI_CLASS_ARG(pp));
+    USBD_MIDI_SetRxBuffer(&hUsbDeviceFS, p, UserRxPacketFS[k] MIDI_CLASS_ARG(pp));
+  }
+  USBD_MIDI_SetVendorBuffer(&hUsbDeviceFS, (uint8_t*)UserVendorBufferFS, APP_VENDOR_DATA_SIZE);
+  return (USBD_OK);
+  /* USER CODE END 3 */
+}
+
+/**
+  * @brief  DeInitializes the CDC media low layer
+  * @retval USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t USBMIDI_DeInit_FS(void)
+{
+  /* USER CODE BEGIN 4 */
+  /* The host is gone: release what it left sounding on the next poll */
+  UserRx_flush = 1;
+  return (USBD_OK);
+  /* USER CODE END 4 */
+}
+
+/**
+  * @brief  Manage the CDC class requests
+  * @param  cmd: Command code
+  * @param  pbuf: Buffer containing command data (request parameters)
+  * @param  length: Number of data to be sent (in bytes)
+  * @retval Result of the operation: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t USBMIDI_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
+{
+  /* USER CODE BEGIN 5 */
+
+  return (USBD_OK);
+  /* USER CODE END 5 */
+}
+
+/**
+  * @brief  Data received over USB OUT endpoint are sent over CDC interface
+  *         through this function.
+  *
+  *         @note
+  *         This function will issue a NAK packet on any OUT packet received on
+  *         USB endpoint until exiting this function. If you exit this function
+  *         before transfer is complete on CDC interface (ie. using DMA controller)
+  *         it will result in receiving more data while previous ones are still
+  *         not sent.
+  *
+  * @param  Buf: Buffer of data to be received
+  * @param  Len: Number of data received (in bytes)
+  * @param  epnum: OUT endpoint the data came on
+  * @retval Result of the operation: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t USBMIDI_Receive_FS(uint8_t* Buf, uint32_t *Len, uint8_t epnum)
+{
+  /* USER CODE BEGIN 6 */
+  USBMIDI_PortTypeDef *pp = PORT_OF_OUT_EP(epnum);
+  uint32_t t0 = MCU_CYCLES();
+  uint8_t *ring = UserRxBufferFS[pp - UserPort];
+  uint32_t len = *Len;
+  uint32_t i, out = 0;
+  uint16_t wp;
+  uint8_t cable;
+  /* from here on the events carry application cables; those on a cable the
+     pair does not have are dropped, so they cannot reach another one */
+  for(i = 0; i + 4 <= len; i += 4){
+    cable = Buf[i] >> 4;
+    if(cable >= pp->num_cables){
+      USBMIDI_Stats.rx_bad_cable++;
+      continue;
+    }
+    Buf[out] = ((cable + pp->cable_base) << 4) | (Buf[i] & 0x0F);
+    Buf[out+1] = Buf[i+1];
+    Buf[out+2] = Buf[i+2];
+    Buf[out+3] = Buf[i+3];
+    out += 4;
+  }
+  len = out;
+  rx_track_notes(Buf, len);
+  if(UserRx_isr_classes)
+    len = rx_dispatch_isr(Buf, len);
+  for(i = 0, wp = pp->rx_wp; i < len; i++)
+    ring[wp++ & APP_RX_MASK] = Buf[i];
+  pp->rx_wp = wp;
+  /* take the next packet right away while the ring has room for it */
+  if(rx_room(pp) >= MIDI_DATA_FS_OUT_PACKET_SIZE)
+    USBD_MIDI_ReceivePacket(&hUsbDeviceFS, pp->pipe MIDI_CLASS_ARG(pp));
+  else
+    pp->rx_held = 1;
+  t0 = MCU_CYCLES() - t0;
+  if(t0 > USBMIDI_Stats.rx_cycles_max)
+    USBMIDI_Stats.rx_cycles_max = t0;
+  return (USBD_OK);
+  /* USER CODE END 6 */
+}
+
+/**
+  * @brief  USBMIDI_Transmit_FS
+  *         Data to send over USB IN endpoint are sent over CDC interface
+  *         through this function.
+  *         @note
+  *
+  *
+  * @param  Buf: Buffer of data to be sent
+  * @param  Len: Number of data to be sent (in bytes)
+  * @retval USBD_OK if all operations are OK else USBD_FAIL or USBD_BUSY
+  */
+uint8_t USBMIDI_Transmit_FS(uint8_t* Buf, uint16_t Len)
+{
+  uint8_t result = USBD_OK;
+  /* USER CODE BEGIN 7 */
+  /* the first pair of the first MIDI function; tx_kick() serves all of them */
+  result = port_transmit(&UserPort[0], Buf, Len);
+  /* USER CODE END 7 */
+  return result;
+}
+
+/**
+  * @brief  USBMIDI_TransmitCplt_FS
+  *         Data transmitted callback
+  *
+  *         @note
+  *         This function is IN transfer complete callback used to inform user that
+  *         the submitted Data is successfully sent over USB.
+  *
+  * @param  Buf: Buffer of data to be received
+  * @param  Len: Number of data received (in bytes)
+  * @retval Result of the operation: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t USBMIDI_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
+{
+  uint8_t result = USBD_OK;
+  /* USER CODE BEGIN 13 */
+  UNUSED(Buf);
+  //UNUSED(Len);
+  USBMIDI_PortTypeDef *pp = PORT_OF_IN_EP(epnum);
+  if(pp->tx_prio)
+    pp->tx_prio = 0;
+  else
+    pp->tx_rp += *Len;
+  pp->tx_busy = 0;
+  /* priority events go out right away, the ring waits for the main loop */
+  tx_kick(pp, 0);
+  /* USER CODE END 13 */
+  return result;
+}
+
+/**
+  * @brief  USBMIDI_Vendor_FS
+  *         Vendor requests to the MIDI interface, run in the OTG interrupt
+  *
+  * @param  req: setup packet
+  * @param  pbuf: data stage, APP_VENDOR_DATA_SIZE bytes; NULL when an OUT
+  *         request with data is offered at SETUP, before its data stage
+  * @param  length: data stage length; for IN requests the room in pbuf on
+  *         entry and the reply length on return
+  * @retval USBD_OK, or USBD_FAIL to stall the request (too late once the
+  *         OUT data is in)
+  */
+static int8_t USBMIDI_Vendor_FS(USBD_SetupReqTypedef *req, uint8_t *pbuf, uint16_t *length)
+{
+  /* USER CODE BEGIN 14 */
+  uint8_t in = (req->bmRequest & 0x80U) != 0U;
+  uint32_t now = HAL_GetTick();
+  int ok = 1;
+  if(pbuf == NULL){
+    /* accept or refuse the OUT data stage while it can still be stalled */
+    switch(req->bRequest){
+    case USBMIDI_VREQ_LOOPBACK:
+    case USBMIDI_VREQ_STATS_RESET:
+      break;
+    case USBMIDI_VREQ_STATS:
+      ok = 0;
+      break;
+    default:
+      ok = USB_MIDI_vendor_request(req, NULL, length);
+      break;
+    }
+    if(!ok){
+      USBMIDI_Stats.vendor_stalled++;
+      return (USBD_FAIL);
+    }
+    return (USBD_OK);
+  }
+  switch(req->bRequest){
+  case USBMIDI_VREQ_LOOPBACK:
+    if(in)
+      *length = MIN(*length, UserVendor_loop_len);
+    else
+      UserVendor_loop_len = *length;
+    break;
+  case USBMIDI_VREQ_STATS:
+    if(!in){
+      ok = 0;
+      break;
+    }
+    /* the vendor fields below are updated on return, so the reply holds
+       the counters as they were before this request */
+    *length = MIN(*length, sizeof(USBMIDI_Stats));
+    memcpy(pbuf, &USBMIDI_Stats, *length);
+    break;
+  case USBMIDI_VREQ_STATS_RESET:
+    memset(&USBMIDI_Stats, 0, sizeof(USBMIDI_Stats));
+    return (USBD_OK);
+  default:
+    ok = USB_MIDI_vendor_request(req, pbuf, length);
+    break;
+  }
+  if(!ok){
+    if(!in && (req->wLength != 0U))
+      USBMIDI_Stats.vendor_refused++;  /* data already acknowledged */
+    else
+      USBMIDI_Stats.vendor_stalled++;
+    return (USBD_FAIL);
+  }
+  if(USBMIDI_Stats.vendor_requests++ == 0)
+    UserVendor_t0 = now;
+  USBMIDI_Stats.vendor_ms = now - UserVendor_t0;
+  if(in)
+    USBMIDI_Stats.vendor_bytes_in += *length;
+  else
+    USBMIDI_Stats.vendor_bytes_out += *length;
+  return (USBD_OK);
+  /* USER CODE END 14 */
+}
+
+/* USER CODE BEGIN PRIVATE_FUNCTIONS_IMPLEMENTATION */
+static uint8_t port_transmit(USBMIDI_PortTypeDef *pp, uint8_t* Buf, uint16_t Len){
+  USBD_MIDI_HandleTypeDef *hmidi = (USBD_MIDI_HandleTypeDef*)hUsbDeviceFS.pClassDataCmsit[pp->class_id];
+  if (hmidi == NULL || hmidi->Pipe[pp->pipe].TxState != 0){
+    return USBD_BUSY;
+  }
+  pp->tx_busy = 1;
+  USBD_MIDI_SetTxBuffer(&hUsbDeviceFS, pp->pipe, Buf, Len MIDI_CLASS_ARG(pp));
+  return USBD_MIDI_TransmitPacket(&hUsbDeviceFS, pp->pipe MIDI_CLASS_ARG(pp));
+}
+
+/* Port carrying an application cable, NULL past the last one */
+static USBMIDI_PortTypeDef *port_of_cable(uint32_t event){
+  uint32_t cable = MIDI_EVENT_CABLE(event);
+  uint32_t n = cable / USBMIDI_CABLES_PER_FUNC;
+  uint32_t p = (cable % USBMIDI_CABLES_PER_FUNC) >= USBD_MIDI_NUM_CABLES;
+  return (n < USBD_MIDI_NUM_INSTANCES) ? &UserPort[n * USBD_MIDI_NUM_PIPES + p] : NULL;
+}
+
+static uint16_t tx_data_len(USBMIDI_PortTypeDef *pp){
+  if((pp->tx_wp&APP_TX_MASK) >= (pp->tx_rp&APP_TX_MASK))
+    return pp->tx_wp - pp->tx_rp;
+  return APP_TX_DATA_SIZE  - (pp->tx_rp&APP_TX_MASK);
+}
+
+/* Events that can still be queued without overwriting unsent ones, on any
+   cable: the fullest port sets the figure */
+uint16_t USBMIDI_tx_free(){
+  uint16_t room, min = APP_TX_DATA_SIZE / 4;
+  uint8_t n;
+  for(n = 0; n < USBMIDI_NUM_PORTS; n++){
+    room = (APP_TX_DATA_SIZE - (uint16_t)(UserPort[n].tx_wp - UserPort[n].tx_rp)) / 4;
+    if(room < min)
+      min = room;
+  }
+  return min;
+}
+
+/* Starts the next IN transfer if the endpoint is idle: the priority slot
+   first, then the ring when called from the main loop (ring != 0). An
+   interrupt may find the ring in the middle of an event, so it never looks
+   at it. Interrupts are masked so the main loop and the interrupts using
+   the priority slot never start a transfer at the same time. */
+static void tx_kick(USBMIDI_PortTypeDef *pp, uint8_t ring){
+  uint32_t primask = __get_PRIMASK();
+  uint32_t now, dt;
+  uint16_t len;
+  uint8_t n = 0, rp;
+  __disable_irq();
+  if(!pp->tx_busy){
+    if(pp->prio_wp != pp->prio_rp){
+      now = MCU_CYCLES();
+      for(rp = pp->prio_rp; rp != pp->prio_wp; rp++, n++){
+        pp->prio_buffer[4*n] = pp->prio[rp&APP_TX_PRIO_MASK]>>24;
+        pp->prio_buffer[4*n+1] = pp->prio[rp&APP_TX_PRIO_MASK]>>16;
+        pp->prio_buffer[4*n+2] = pp->prio[rp&APP_TX_PRIO_MASK]>>8;
+        pp->prio_buffer[4*n+3] = pp->prio[rp&APP_TX_PRIO_MASK];
+        dt = now - pp->prio_stamp[rp&APP_TX_PRIO_MASK];
+        if(dt > USBMIDI_Stats.prio_cycles_max)
+          USBMIDI_Stats.prio_cycles_max = dt;
+      }
+      pp->tx_prio = 1;
+      if(port_transmit(pp, pp->prio_buffer, 4*n) == USBD_OK)
+        pp->prio_rp = rp;
+      else
+        pp->tx_prio = 0;
+    }else if(ring && pp->tx_wp != pp->tx_rp){
+      len = tx_data_len(pp);
+      if(len > MIDI_DATA_FS_IN_PACKET_SIZE)
+        len = MIDI_DATA_FS_IN_PACKET_SIZE;
+      port_transmit(pp, &UserTxBufferFS[pp - UserPort][pp->tx_rp&APP_TX_MASK], len);
+    }
+  }
+  __set_PRIMASK(primask);
+}
+
+/* Queue an event ahead of everything in the ring of its port. Callable
+   from any context, meant for real-time messages from timer interrupts. */
+void USBMIDI_send_priority(uint32_t event){
+  USBMIDI_PortTypeDef *pp = port_of_cable(event);
+  uint32_t primask;
+  if(hUsbDeviceFS.dev_state != USBD_STATE_CONFIGURED || pp == NULL)
+    return;
+  event -= (uint32_t)pp->cable_base << 28;
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if((uint8_t)(pp->prio_wp - pp->prio_rp) < APP_TX_PRIO_SIZE){
+    pp->prio[pp->prio_wp&APP_TX_PRIO_MASK] = event;
+    pp->prio_stamp[pp->prio_wp&APP_TX_PRIO_MASK] = MCU_CYCLES();
+    pp->prio_wp++;
+  }else{
+    USBMIDI_Stats.prio_dropped++;
+  }
+  __set_PRIMASK(primask);
+  tx_kick(pp, 0);
+}
+
+void USBMIDI_send(uint32_t event){
+  USBMIDI_PortTypeDef *pp = port_of_cable(event);
+  uint8_t *buf;
+  if(pp == NULL)
+    return;
+  if(hUsbDeviceFS.dev_state != USBD_STATE_CONFIGURED){
+    pp->tx_wp = pp->tx_rp = 0;
+    return;
+  }
+  MIDI_Notes_Update(&USBMIDI_TxNotes, event);
+  event -= (uint32_t)pp->cable_base << 28;
+  buf = UserTxBufferFS[pp - UserPort];
+  buf[pp->tx_wp++&APP_TX_MASK] = event>>24;
+  buf[pp->tx_wp++&APP_TX_MASK] = event>>16;
+  buf[pp->tx_wp++&APP_TX_MASK] = event>>8;
+  buf[pp->tx_wp++&APP_TX_MASK] = event;
+  tx_kick(pp, 1);
+}
+
+static uint16_t rx_room(USBMIDI_PortTypeDef *pp){
+  return APP_RX_DATA_SIZE - (uint16_t)(pp->rx_wp - pp->rx_rp);
+}
+/* Data from rx_rp up to the end of the ring row at most */
+static uint16_t rx_data_len(USBMIDI_PortTypeDef *pp){
+  uint16_t len = pp->rx_wp - pp->rx_rp;
+  if(len > APP_RX_DATA_SIZE - (pp->rx_rp&APP_RX_MASK))
+    return APP_RX_DATA_SIZE - (pp->rx_rp&APP_RX_MASK);
+  return len;
+}
+__weak int USB_MIDI_decoder(uint8_t *Buf, uint32_t Len){
+  UNUSED(Buf);
+  UNUSED(Len);
+  return 1;
+}
+
+static void rx_note_off(uint32_t event){
+  uint8_t pkt[4];
+  pkt[0] = event>>24;
+  pkt[1] = event>>16;
+  pkt[2] = event>>8;
+  pkt[3] = event;
+  USB_MIDI_decoder(pkt, 4);
+}
+
+static void rx_track_notes(uint8_t *Buf, uint32_t Len){
+  for(; Len >= 4; Len -= 4, Buf += 4)
+    MIDI_Notes_Update(&USBMIDI_RxNotes, MIDI_EVENT_FROM_BYTES(Buf));
+}
+
+/* The kind of a SysEx is in its first packet, F0 then the ID: the others
+   of the message on that cable take it from there */
+static uint8_t rx_sysex_class(const uint8_t *p){
+  uint16_t bit = 1U << (p[0] >> 4);
+  uint8_t rt;
+  if(p[1] == 0xF0){
+    if(p[2] == 0x7F)
+      UserRx_sysex_rt |= bit;
+    else
+      UserRx_sysex_rt &= ~bit;
+  }
+  rt = (UserRx_sysex_rt & bit) != 0U;
+  if((p[0] & 0x0F) != MIDI_CIN_SYSEX_START)
+    UserRx_sysex_rt &= ~bit;
+  return rt ? USBMIDI_RX_CLASS_SYSEX_RT : USBMIDI_RX_CLASS_SYSEX;
+}
+
+static uint8_t rx_event_class(const uint8_t *p){
+  switch(p[0]&0x0F){
+  case MIDI_CIN_NOTE_OFF:
+  case MIDI_CIN_NOTE_ON:
+    return USBMIDI_RX_CLASS_NOTE;
+  case MIDI_CIN_POLY_PRESSURE:
+  case MIDI_CIN_CONTROL_CHANGE:
+  case MIDI_CIN_PROGRAM_CHANGE:
+  case MIDI_CIN_CHANNEL_PRESSURE:
+  case MIDI_CIN_PITCH_BEND:
+    return USBMIDI_RX_CLASS_CHANNEL;
+  case MIDI_CIN_SYSEX_START:
+  case MIDI_CIN_SYSEX_END_2:
+  case MIDI_CIN_SYSEX_END_3:
+    return rx_sysex_class(p);
+  case MIDI_CIN_SYSEX_END_1:
+    return (p[1] == 0xF7) ? rx_sysex_class(p) : USBMIDI_RX_CLASS_COMMON;
+  case MIDI_CIN_SINGLE_BYTE:
+    return (p[1] >= 0xF8) ? USBMIDI_RX_CLASS_REALTIME : USBMIDI_RX_CLASS_COMMON;
+  default:
+    return USBMIDI_RX_CLASS_COMMON;
+  }
+}
+
+/* Runs in the OUT endpoint interrupt. Events of the selected classes are
+   offered to USB_MIDI_isr_decoder(); the rest are packed to the front of the
+   packet in their original order for USBMIDI_polling(). Returns the number
+   of bytes left for the main loop. */
+static uint32_t rx_dispatch_isr(uint8_t *Buf, uint32_t Len){
+  uint32_t i, out = 0;
+  uint8_t classes = UserRx_isr_classes;
+  for(i = 0; i + 4 <= Len; i += 4){
+    if((rx_event_class(&Buf[i]) & classes) &&
+       USB_MIDI_isr_decoder(MIDI_EVENT_FROM_BYTES(&Buf[i]))){
+      USBMIDI_Stats.rx_isr_events++;
+      continue;
+    }
+    if(out != i){
+      Buf[out] = Buf[i];
+      Buf[out+1] = Buf[i+1];
+      Buf[out+2] = Buf[i+2];
+      Buf[out+3] = Buf[i+3];
+    }
+    out += 4;
+    USBMIDI_Stats.rx_deferred_events++;
+  }
+  return out;
+}
+
+/* Default ISR decoder declines everything, so all events stay deferred until
+   the application provides one. Return 1 when the event was consumed. */
+__weak int USB_MIDI_isr_decoder(uint32_t event){
+  UNUSED(event);
+  return 0;
+}
+
+/* Vendor requests other than the USBMIDI_VREQ_* ones, from the OTG
+   interrupt. Same contract as USBMIDI_Vendor_FS(), Buf NULL included;
+   return 1 when the request was handled, 0 to stall it. */
+__weak int USB_MIDI_vendor_request(USBD_SetupReqTypedef *req, uint8_t *Buf, uint16_t *Len){
+  UNUSED(req);
+  UNUSED(Buf);
+  UNUSED(Len);
+  return 0;
+}
+
+void USBMIDI_set_rx_isr_classes(uint8_t classes){
+  UserRx_isr_classes = classes;
+}
+
+/* Called by the OTG interrupt handler with its own duration */
+void USBMIDI_isr_cycles(uint32_t cycles){
+  USBMIDI_Stats.isr_cycles_last = cycles;
+  if(cycles > USBMIDI_Stats.isr_cycles_max)
+    USBMIDI_Stats.isr_cycles_max = cycles;
+}
+
+void USBMIDI_all_notes_off(){
+  uint8_t cable;
+  for(cable = 0; cable < USBMIDI_NUM_CABLES; cable++)
+    MIDI_Notes_Flush(&USBMIDI_TxNotes, cable, USBMIDI_send);
+}
+
+void USBMIDI_polling(){
+  USBMIDI_PortTypeDef *pp;
+  uint16_t len;
+  uint8_t cable, n;
+  if(UserRx_flush){
+    UserRx_flush = 0;
+    MIDI_Notes_Reset(&USBMIDI_TxNotes);
+    for(cable = 0; cable < USBMIDI_NUM_CABLES; cable++)
+      MIDI_Notes_Flush(&USBMIDI_RxNotes, cable, rx_note_off);
+  }
+  for(n = 0; n < USBMIDI_NUM_PORTS; n++){
+    pp = &UserPort[n];
+    tx_kick(pp, 1);
+    if(pp->rx_wp != pp->rx_rp){
+      len = rx_data_len(pp);
+      if(USB_MIDI_decoder(&UserRxBufferFS[n][pp->rx_rp&APP_RX_MASK], len)){
+        pp->rx_rp += len;
+      }
+    }
+    if(pp->rx_held && rx_room(pp) >= MIDI_DATA_FS_OUT_PACKET_SIZE){
+      pp->rx_held = 0;
+      USBD_MIDI_ReceivePacket(&hUsbDeviceFS, pp->pipe MIDI_CLASS_ARG(pp));
+    }
+  }
+}
+/* USER CODE END PRIVATE_FUNCTIONS_IMPLEMENTATION */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -1,132 +1,192 @@
-/* USER CODE BEGIN Header */
-/**
-  ******************************************************************************
-  * @file           : usbd_midi_if.h
-  * @version        : v1.0_Cube
-  * @brief          : Header for usbd_midi_if.c file.
-  ******************************************************************************
-  * @attention
-  *
-  * Copyright (c) 2024 STMicroelectronics.
-  * All rights reserved.
-  *
-  * This software is licensed under terms that can be found in the LICENSE file
-  * in the root directory of this software component.
-  * If no LICENSE file comes with this software, it is provided AS-IS.
-  *
-  ******************************************************************************
-  */
-/* USER CODE END Header */
-
-/* Define to prevent recursive inclusion -------------------------------------*/
-#ifndef __USBD_MIDI_IF_H__
-#define __USBD_MIDI_IF_H__
-
-#ifdef __cplusplus
- extern "C" {
-#endif
-
-/* Includes ------------------------------------------------------------------*/
-#include "usbd_midi.h"
-
-/* USER CODE BEGIN INCLUDE */
-
-/* USER CODE END INCLUDE */
-
-/** @addtogroup STM32_USB_OTG_DEVICE_LIBRARY
-  * @brief For Usb device.
-  * @{
-  */
-
-/** @defgroup USBD_MIDI_IF USBD_MIDI_IF
-  * @brief Usb VCP device module
-  * @{
-  */
-
-/** @defgroup USBD_MIDI_IF_Exported_Defines USBD_MIDI_IF_Exported_Defines
-  * @brief Defines.
-  * @{
-  */
-/* Define size for the receive and transmit buffer over CDC */
-#define APP_RX_DATA_SIZE  512
-#define APP_TX_DATA_SIZE  512
-/* USER CODE BEGIN EXPORTED_DEFINES */
-
-/* USER CODE END EXPORTED_DEFINES */
-
-/**
-  * @}
-  */
-
-/** @defgroup USBD_MIDI_IF_Exported_Types USBD_MIDI_IF_Exported_Types
-  * @brief Types.
-  * @{
-  */
-
-/* USER CODE BEGIN EXPORTED_TYPES */
-
-/* USER CODE END EXPORTED_TYPES */
-
-/**
-  * @}
-  */
-
-/** @defgroup USBD_MIDI_IF_Exported_Macros USBD_MIDI_IF_Exported_Macros
-  * @brief Aliases.
-  * @{
-  */
-
-/* USER CODE BEGIN EXPORTED_MACRO */
-
-/* USER CODE END EXPORTED_MACRO */
-
-/**
-  * @}
-  */
-
-/** @defgroup USBD_MIDI_IF_Exported_Variables USBD_MIDI_IF_Exported_Variables
-  * @brief Public variables.
-  * @{
-  */
-
-/** CDC Interface callback. */
-extern USBD_MIDI_ItfTypeDef USBD_Interface_fops_FS;
-
-/* USER CODE BEGIN EXPORTED_VARIABLES */
-
-/* USER CODE END EXPORTED_VARIABLES */
-
-/**
-  * @}
-  */
-
-/** @defgroup USBD_MIDI_IF_Exported_FunctionsPrototype USBD_MIDI_IF_Exported_FunctionsPrototype
-  * @brief Public functions declaration.
-  * @{
-  */
-
-uint8_t USBMIDI_Transmit_FS(uint8_t* Buf, uint16_t Len);
-
-/* USER CODE BEGIN EXPORTED_FUNCTIONS */
-void USBMIDI_send(uint32_t event);
-void USBMIDI_polling(void);
-/* USER CODE END EXPORTED_FUNCTIONS */
-
-/**
-  * @}
-  */
-
-/**
-  * @}
-  */
-
-/**
-  * @}
-  */
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif /* __USBD_MIDI_IF_H__ */
-
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : usbd_midi_if.h
+  * @version        : v1.0_Cube
+  * @brief          : Header for usbd_midi_if.c file.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USBD_MIDI_IF_H__
+#define __USBD_MIDI_IF_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_midi.h"
+
+/* USER CODE BEGIN INCLUDE */
+#include "midi_notes.h"
+/* USER CODE END INCLUDE */
+
+/** @addtogroup STM32_USB_OTG_DEVICE_LIBRARY
+  * @brief For Usb device.
+  * @{
+  */
+
+/** @defgroup USBD_MIDI_IF USBD_MIDI_IF
+  * @brief Usb VCP device module
+  * @{
+  */
+
+/** @defgroup USBD_MIDI_IF_Exported_Defines USBD_MIDI_IF_Exported_Defines
+  * @brief Defines.
+  * @{
+  */
+/* Define size for the receive and transmit buffer over CDC */
+#define APP_RX_DATA_SIZE  512
+#define APP_TX_DATA_SIZE  512
+/* USER CODE BEGIN EXPORTED_DEFINES */
+/* Events waiting in the priority slot, power of two, at most 16 (one packet) */
+#define APP_TX_PRIO_SIZE  16
+/* Longest data stage of a vendor request, see USBD_MIDI_SetVendorBuffer() */
+#define APP_VENDOR_DATA_SIZE  4096
+/* The application sees one space of 16 cables: each MIDI function takes
+   the next USBD_MIDI_NUM_CABLES of them, then USBD_MIDI_NUM_CABLES_2 for
+   its second endpoint pair */
+#define USBMIDI_NUM_CABLES  (USBD_MIDI_NUM_INSTANCES * (USBD_MIDI_NUM_CABLES + USBD_MIDI_NUM_CABLES_2))
+#if USBMIDI_NUM_CABLES > 16
+#error "The MIDI functions have more than 16 cables between them"
+#endif
+/* Notes left sounding are released on every cable at disconnect */
+#if USBMIDI_NUM_CABLES > MIDI_NOTES_NUM_CABLES
+#error "MIDI_NOTES_NUM_CABLES does not cover every USB MIDI cable"
+#endif
+/* Vendor requests (bRequest) served here; the others go to
+   USB_MIDI_vendor_request() */
+#define USBMIDI_VREQ_LOOPBACK       0x01U  /* OUT stores, IN returns the last OUT */
+#define USBMIDI_VREQ_STATS          0x02U  /* IN: USBMIDI_StatsTypeDef */
+#define USBMIDI_VREQ_STATS_RESET    0x03U  /* no data */
+/* Receive message classes, used to choose where each class is dispatched */
+#define USBMIDI_RX_CLASS_REALTIME   0x01U  /* 0xF8..0xFF single bytes */
+#define USBMIDI_RX_CLASS_NOTE       0x02U  /* note on / note off */
+#define USBMIDI_RX_CLASS_CHANNEL    0x04U  /* other channel voice messages */
+#define USBMIDI_RX_CLASS_COMMON     0x08U  /* system common, cable events */
+#define USBMIDI_RX_CLASS_SYSEX      0x10U  /* other system exclusive packets */
+#define USBMIDI_RX_CLASS_SYSEX_RT   0x20U  /* universal real time SysEx, F0 7F */
+
+/* Classes offered to USB_MIDI_isr_decoder() from the OUT endpoint interrupt;
+   the others, and any event the ISR decoder declines, go to USB_MIDI_decoder()
+   from USBMIDI_polling(). Ordering is kept within a class, not across them. */
+#ifndef USBMIDI_RX_ISR_CLASSES
+#define USBMIDI_RX_ISR_CLASSES      (USBMIDI_RX_CLASS_REALTIME | USBMIDI_RX_CLASS_NOTE)
+#endif
+/* USER CODE END EXPORTED_DEFINES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_MIDI_IF_Exported_Types USBD_MIDI_IF_Exported_Types
+  * @brief Types.
+  * @{
+  */
+
+/* USER CODE BEGIN EXPORTED_TYPES */
+typedef struct
+{
+  uint32_t isr_cycles_max;   /* worst OTG interrupt, in CPU cycles */
+  uint32_t isr_cycles_last;
+  uint32_t rx_cycles_max;    /* worst receive callback incl. ISR dispatch */
+  uint32_t rx_isr_events;    /* events handled in interrupt context */
+  uint32_t rx_deferred_events;
+  uint32_t prio_cycles_max;  /* priority event queued to transfer started */
+  uint32_t prio_dropped;
+  uint32_t vendor_requests;  /* vendor control channel */
+  uint32_t vendor_stalled;
+  uint32_t vendor_bytes_out; /* host to device */
+  uint32_t vendor_bytes_in;
+  uint32_t vendor_ms;        /* from the first to the last request since reset */
+  uint32_t rx_bad_cable;     /* events on a cable the endpoint does not have */
+  uint32_t vendor_refused;   /* OUT data refused after it was acknowledged */
+} USBMIDI_StatsTypeDef;
+/* USER CODE END EXPORTED_TYPES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_MIDI_IF_Exported_Macros USBD_MIDI_IF_Exported_Macros
+  * @brief Aliases.
+  * @{
+  */
+
+/* USER CODE BEGIN EXPORTED_MACRO */
+
+/* USER CODE END EXPORTED_MACRO */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_MIDI_IF_Exported_Variables USBD_MIDI_IF_Exported_Variables
+  * @brief Public variables.
+  * @{
+  */
+
+/** CDC Interface callback. */
+extern USBD_MIDI_ItfTypeDef USBD_Interface_fops_FS;
+
+/* USER CODE BEGIN EXPORTED_VARIABLES */
+/** Notes sent to the host (TX) and received from it (RX). */
+extern MIDI_NotesTypeDef USBMIDI_TxNotes;
+extern MIDI_NotesTypeDef USBMIDI_RxNotes;
+extern USBMIDI_StatsTypeDef USBMIDI_Stats;
+/* USER CODE END EXPORTED_VARIABLES */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_MIDI_IF_Exported_FunctionsPrototype USBD_MIDI_IF_Exported_FunctionsPrototype
+  * @brief Public functions declaration.
+  * @{
+  */
+
+uint8_t USBMIDI_Transmit_FS(uint8_t* Buf, uint16_t Len);
+
+/* USER CODE BEGIN EXPORTED_FUNCTIONS */
+void USBMIDI_send(uint32_t event);
+uint16_t USBMIDI_tx_free(void);
+void USBMIDI_send_priority(uint32_t event);
+void USBMIDI_polling(void);
+void USBMIDI_all_notes_off(void);
+void USBMIDI_set_rx_isr_classes(uint8_t classes);
+void USBMIDI_isr_cycles(uint32_t cycles);
+int USB_MIDI_decoder(uint8_t *Buf, uint32_t Len);
+int USB_MIDI_isr_decoder(uint32_t event);
+int USB_MIDI_vendor_request(USBD_SetupReqTypedef *req, uint8_t *Buf, uint16_t *Len);
+/* USER CODE END EXPORTED_FUNCTIONS */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USBD_MIDI_IF_H__ */
+